@@ -74,6 +74,53 @@ namespace TrajectorySL
 			UE_LOG(LogCameraDatasetGen, Warning, TEXT("TrajectorySL: No trajectories found in the world"));
 		}
 
+		return Internal::TrajectoriesToJsonString(World, Trajectories, FPS, bPrettyPrint, OutJsonString);
+	}
+
+	bool SaveTrajectories(const FString& FilePath, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS, bool bPrettyPrint)
+	{
+		FString JsonString;
+		if (!SaveTrajectoriesAsString(JsonString, Trajectories, FPS, bPrettyPrint))
+		{
+			UE_LOG(LogCameraDatasetGen, Error, TEXT("TrajectorySL: Failed to generate JSON string"));
+			return false;
+		}
+
+		if (!FFileHelper::SaveStringToFile(JsonString, *FilePath))
+		{
+			UE_LOG(LogCameraDatasetGen, Error, TEXT("TrajectorySL: Failed to write file: %s"), *FilePath);
+			return false;
+		}
+
+		UE_LOG(LogCameraDatasetGen, Log, TEXT("TrajectorySL: Successfully saved %d trajectories to: %s"),
+			Trajectories.Num(), *FilePath);
+		return true;
+	}
+
+	bool SaveTrajectoriesAsString(FString& OutJsonString, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS, bool bPrettyPrint)
+	{
+		// Level name comes from the world the trajectories live in
+		UWorld* World = nullptr;
+		for (ACDGTrajectory* Trajectory : Trajectories)
+		{
+			if (Trajectory && Trajectory->GetWorld())
+			{
+				World = Trajectory->GetWorld();
+				break;
+			}
+		}
+
+		if (!World)
+		{
+			UE_LOG(LogCameraDatasetGen, Error, TEXT("TrajectorySL: No valid trajectories provided"));
+			return false;
+		}
+
+		return Internal::TrajectoriesToJsonString(World, Trajectories, FPS, bPrettyPrint, OutJsonString);
+	}
+
+	bool Internal::TrajectoriesToJsonString(UWorld* World, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS, bool bPrettyPrint, FString& OutJsonString)
+	{
 		// Create root JSON object
 		TSharedPtr<FJsonObject> RootObject = MakeShared<FJsonObject>();
 
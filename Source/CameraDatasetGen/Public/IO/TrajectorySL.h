@@ -8,6 +8,7 @@
 
 class ACDGTrajectory;
 class ACDGKeyframe;
+class UWorld;
 
 /**
  * Trajectory Save/Load System
@@ -51,6 +52,28 @@ namespace TrajectorySL
 	 */
 	CAMERADATASETGEN_API bool SaveAllTrajectoriesAsString(FString& OutJsonString, int32 FPS = 30, bool bPrettyPrint = true);
 
+	/**
+	 * Save only the given trajectories to a JSON file (same format as SaveAllTrajectories)
+	 * 
+	 * @param FilePath - Full path to the output JSON file
+	 * @param Trajectories - Trajectories to write, in output order
+	 * @param FPS - Frames per second for frame interpolation (default: 30)
+	 * @param bPrettyPrint - Whether to format JSON with indentation (default: true)
+	 * @return true if save was successful, false otherwise
+	 */
+	CAMERADATASETGEN_API bool SaveTrajectories(const FString& FilePath, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS = 30, bool bPrettyPrint = true);
+
+	/**
+	 * Save only the given trajectories to a JSON string
+	 * 
+	 * @param OutJsonString - Output JSON string
+	 * @param Trajectories - Trajectories to write, in output order
+	 * @param FPS - Frames per second for frame interpolation (default: 30)
+	 * @param bPrettyPrint - Whether to format JSON with indentation (default: true)
+	 * @return true if generation was successful, false otherwise
+	 */
+	CAMERADATASETGEN_API bool SaveTrajectoriesAsString(FString& OutJsonString, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS = 30, bool bPrettyPrint = true);
+
 	/**
 	 * Load trajectories from a JSON file (to be implemented)
 	 * 
@@ -62,6 +85,9 @@ namespace TrajectorySL
 	// Internal helper functions
 	namespace Internal
 	{
+		/** Serialize Trajectories (LevelName taken from World) to a JSON string */
+		bool TrajectoriesToJsonString(UWorld* World, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS, bool bPrettyPrint, FString& OutJsonString);
+
 		/** Convert a keyframe to a JSON object */
 		TSharedPtr<FJsonObject> KeyframeToJson(ACDGKeyframe* Keyframe);
 
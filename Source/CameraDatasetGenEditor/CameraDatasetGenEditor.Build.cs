@@ -60,11 +60,13 @@ public class CameraDatasetGenEditor : ModuleRules
 				"LiveLinkHub",
 				"EditorStyle",
 				"DesktopPlatform",  // Required for file save dialog
-				"HTTP",  // Required for FFmpeg download
 				"Json",  // Required for JSON parsing
+				"JsonUtilities",  // Required for inline exporter config in the batch commandlet
 				// ... add private dependencies that you statically link with here ...	
 			}
 		);
+
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");  // Required for the image write pool's PNG encoder
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
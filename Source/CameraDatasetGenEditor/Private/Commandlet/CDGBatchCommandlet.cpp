@@ -0,0 +1,942 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Commandlet/CDGBatchCommandlet.h"
+#include "UI/BatchProcEditor/CDGBatchProcExecService.h"
+#include "UI/BatchProcEditor/CDGBatchJobQueue.h"
+#include "UI/BatchProcEditor/CDGBatchJobSpec.h"
+#include "UI/BatchProcEditor/CDGBatchCheckpoint.h"
+#include "UI/BatchProcEditor/CDGBatchHeartbeat.h"
+#include "UI/BatchProcEditor/CDGBatchComboSampler.h"
+#include "Anchor/CDGLevelSceneAnchor.h"
+#include "Config/BatchProcConfig.h"
+#include "Config/GeneratorStackConfig.h"
+#include "Config/LevelSeqExportConfig.h"
+#include "LogCameraDatasetGenEditor.h"
+
+// Engine
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+
+// JSON
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+#include "JsonObjectConverter.h"
+
+UCDGBatchCommandlet::UCDGBatchCommandlet()
+{
+	IsClient     = false;
+	IsServer     = false;
+	IsEditor     = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Main
+// ─────────────────────────────────────────────────────────────────────────────
+
+int32 UCDGBatchCommandlet::Main(const FString& Params)
+{
+	UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Headless batch commandlet starting"));
+
+	// The registry must be fully scanned before soft paths can be resolved.
+	IAssetRegistry& AR = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AR.SearchAllAssets(/*bSynchronousSearch=*/true);
+
+	// Sharded mode: everything below runs against a job directory.
+	FString JobDir;
+	const bool bSharded = FParse::Value(*Params, TEXT("JobDir="), JobDir);
+	TSharedPtr<FCDGBatchJobQueue> Queue;
+	if (bSharded)
+	{
+		Queue = MakeShared<FCDGBatchJobQueue>(JobDir);
+		if (!Queue->Initialise()) return 1;
+
+		if (FParse::Param(*Params, TEXT("Merge")))
+		{
+			return RunMerge(*Queue);
+		}
+	}
+
+	FBatchProcInput Input;
+	FString ConfigAssetPath;
+	FString ConfigFilePath;
+	FString JobSpecPath;
+
+	// Single-combo worker: run exactly the combo a job spec describes.
+	TSharedRef<bool> bSpecComboFound = MakeShared<bool>(false);
+	if (FParse::Value(*Params, TEXT("JobSpec="), JobSpecPath))
+	{
+		FString SpecComboKey;
+		if (!LoadInputFromJobSpec(JobSpecPath, Input, SpecComboKey)) return 1;
+
+		Input.ClaimCombo = [SpecComboKey, bSpecComboFound](const FString& ComboKey)
+		{
+			const bool bMatch = ComboKey == SpecComboKey;
+			*bSpecComboFound |= bMatch;
+			return bMatch;
+		};
+	}
+	else if (FParse::Value(*Params, TEXT("Config="), ConfigAssetPath))
+	{
+		if (!LoadInputFromAsset(ConfigAssetPath, Input)) return 1;
+	}
+	else if (FParse::Value(*Params, TEXT("ConfigFile="), ConfigFilePath))
+	{
+		if (!LoadInputFromJsonFile(ConfigFilePath, Input)) return 1;
+	}
+	else
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error,
+			TEXT("[CDGBatch] Missing -Config=<BatchProcConfig asset>, -ConfigFile=<batch.json> or -JobSpec=<spec.json>"));
+		return 1;
+	}
+
+	// Sampling switches override the config; parsed before planning uses them.
+	FString SampleMode;
+	if (FParse::Value(*Params, TEXT("Sample="), SampleMode))
+	{
+		const int64 Mode = StaticEnum<ECDGComboSampling>()->GetValueByNameString(SampleMode);
+		if (Mode == INDEX_NONE)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error,
+				TEXT("[CDGBatch] Unknown -Sample=%s (Exhaustive, Uniform, Stratified or LatinHypercube)"), *SampleMode);
+			return 1;
+		}
+		Input.Sampling.Mode = static_cast<ECDGComboSampling>(Mode);
+	}
+	FString SampleBy;
+	if (FParse::Value(*Params, TEXT("SampleBy="), SampleBy))
+	{
+		const int64 Stratum = StaticEnum<ECDGComboStratum>()->GetValueByNameString(SampleBy);
+		if (Stratum == INDEX_NONE)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error,
+				TEXT("[CDGBatch] Unknown -SampleBy=%s (Level, Character or Animation)"), *SampleBy);
+			return 1;
+		}
+		Input.Sampling.Stratum = static_cast<ECDGComboStratum>(Stratum);
+	}
+	FParse::Value(*Params, TEXT("SampleBudget="), Input.Sampling.Budget);
+	FParse::Value(*Params, TEXT("SampleSeed="), Input.Sampling.Seed);
+
+	// Export: one self-contained job spec per combo, for external schedulers.
+	FString SpecDir;
+	if (FParse::Value(*Params, TEXT("ExportJobs="), SpecDir))
+	{
+		FString OutputDirOverride;
+		if (FParse::Value(*Params, TEXT("OutputDir="), OutputDirOverride))
+		{
+			OverrideOutputDir(Input, OutputDirOverride);
+		}
+		FParse::Value(*Params, TEXT("Seed="), Input.BaseSeed);
+		return ExportJobSpecs(Input, SpecDir) ? 0 : 1;
+	}
+
+	FString WorkerId;
+	if (bSharded)
+	{
+		// Coordinator: expand the combo product into pending/ job files, then
+		// optionally launch the workers and merge their shards.
+		if (FParse::Param(*Params, TEXT("Plan")))
+		{
+			if (!PlanJobs(Input, *Queue)) return 1;
+
+			int32 NumWorkers = 0;
+			if (FParse::Value(*Params, TEXT("Spawn="), NumWorkers) && NumWorkers > 0)
+			{
+				return RunSpawnedWorkers(Params, *Queue, NumWorkers);
+			}
+			return 0;
+		}
+
+		if (!FParse::Value(*Params, TEXT("Worker="), WorkerId) || WorkerId.IsEmpty())
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error,
+				TEXT("[CDGBatch] -JobDir needs one of -Plan, -Worker=<id> or -Merge"));
+			return 1;
+		}
+
+		// A restarted worker takes back whatever it had claimed when it died.
+		const int32 NumRequeued = Queue->RequeueClaims(WorkerId);
+		if (NumRequeued > 0)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Display,
+				TEXT("[CDGBatch] Worker %s: re-queued %d stale claim(s)"), *WorkerId, NumRequeued);
+		}
+
+		OverrideOutputDir(Input, Queue->GetShardDir(WorkerId));
+		Input.ShouldProcessLevel = [Queue](const FAssetData& Level)
+		{
+			return Queue->HasPendingJobsForLevel(Level.PackageName.ToString());
+		};
+		Input.ClaimCombo = [Queue, WorkerId](const FString& ComboKey)
+		{
+			return Queue->TryClaim(ComboKey, WorkerId);
+		};
+	}
+	else
+	{
+		// -OutputDir overrides the exporter config on a transient copy so the
+		// asset on disk is never modified.
+		FString OutputDirOverride;
+		if (FParse::Value(*Params, TEXT("OutputDir="), OutputDirOverride))
+		{
+			OverrideOutputDir(Input, OutputDirOverride);
+		}
+	}
+
+	// Rendering is opt-in: the MRQ PIE executor needs a real RHI.
+	Input.bRenderOutputs = FParse::Param(*Params, TEXT("Render"));
+	if (Input.bRenderOutputs && !FApp::CanEverRender())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[CDGBatch] -Render requested but this process cannot render (-nullrhi?) — export only."));
+		Input.bRenderOutputs = false;
+	}
+
+	// Resume from <OutputDir>/CDGBatchCheckpoint.jsonl unless told otherwise.
+	Input.bResumeFromCheckpoint = !FParse::Param(*Params, TEXT("NoResume"));
+	FParse::Value(*Params, TEXT("Seed="), Input.BaseSeed);
+	FParse::Value(*Params, TEXT("LookAhead="), Input.PipelineLookAhead);
+	FParse::Value(*Params, TEXT("CombosPerRender="), Input.MaxCombosPerRender);
+	FParse::Value(*Params, TEXT("FramesPerRender="), Input.MaxFramesPerRender);
+	FParse::Value(*Params, TEXT("RenderAttempts="), Input.MaxRenderAttempts);
+	FParse::Value(*Params, TEXT("MemWatermarkMB="), Input.MemoryWatermarkMB);
+
+	// Supervisor: run the batch in a child process and restart it on crashes.
+	if (FParse::Param(*Params, TEXT("Supervise")))
+	{
+		return RunSupervised(Params, UCDGBatchProcExecService::ResolveRootOutputDir(Input), Queue, WorkerId);
+	}
+
+	UE_LOG(LogCameraDatasetGenEditor, Display,
+		TEXT("[CDGBatch] %d level(s) × %d character(s) × %d animation(s), rendering %s"),
+		Input.Levels.Num(), Input.Characters.Num(), Input.Animations.Num(),
+		Input.bRenderOutputs ? TEXT("ON") : TEXT("OFF"));
+
+	UCDGBatchProcExecService* Service = UCDGBatchProcExecService::Create(GetTransientPackage(), Input);
+	Service->AddToRoot();
+
+	bool bBatchSucceeded = false;
+
+	Service->OnLogMessage.AddLambda([](const FString& Msg)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] %s"), *Msg);
+	});
+
+	Service->OnDetailedProgressUpdated.AddLambda([](const FBatchDetailedProgress& P)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Display,
+			TEXT("[CDGBatch] Progress: level %d/%d  anchor %d/%d  char %d/%d  anim %d/%d  combo %d/%d  shots %d/%d"),
+			P.LevelCurrent, P.LevelTotal, P.AnchorCurrent, P.AnchorTotal,
+			P.CharacterCurrent, P.CharacterTotal, P.AnimCurrent, P.AnimTotal,
+			P.ComboCurrent, P.ComboTotal, P.GlobalShotsRendered, P.GlobalShotsTotal);
+	});
+
+	Service->OnBatchCompleted.AddLambda([&bBatchSucceeded](bool bSuccess)
+	{
+		bBatchSucceeded = bSuccess;
+	});
+
+	if (Queue.IsValid())
+	{
+		Service->OnComboFinished.AddLambda([Queue, WorkerId](const FString& ComboKey, bool bSuccess)
+		{
+			Queue->MarkFinished(ComboKey, WorkerId, bSuccess);
+		});
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	Service->Start();
+	PumpUntilFinished(Service, Input.bRenderOutputs);
+
+	Service->RemoveFromRoot();
+
+	UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Finished %s in %.1f s"),
+		bBatchSucceeded ? TEXT("successfully") : TEXT("with errors / cancelled"),
+		FPlatformTime::Seconds() - StartTime);
+
+	if (!JobSpecPath.IsEmpty() && !*bSpecComboFound)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error,
+			TEXT("[CDGBatch] The combo in %s was not found (level or anchor missing?)"), *JobSpecPath);
+		return 1;
+	}
+
+	return bBatchSucceeded ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Input loading
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool UCDGBatchCommandlet::LoadInputFromAsset(const FString& AssetPath, FBatchProcInput& OutInput) const
+{
+	UBatchProcConfig* Config = LoadObject<UBatchProcConfig>(nullptr, *AssetPath);
+	if (!Config)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Cannot load UBatchProcConfig: %s"), *AssetPath);
+		return false;
+	}
+
+	if (!UCDGBatchProcExecService::BuildInputFromConfig(Config, OutInput))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error,
+			TEXT("[CDGBatch] Batch config %s is incomplete (needs levels, characters, animations and a generator config)"),
+			*AssetPath);
+		return false;
+	}
+	return true;
+}
+
+bool UCDGBatchCommandlet::LoadInputFromJsonFile(const FString& FilePath, FBatchProcInput& OutInput)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *FilePath))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Cannot read batch file: %s"), *FilePath);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Batch file is not valid JSON: %s"), *FilePath);
+		return false;
+	}
+
+	// Build a transient UBatchProcConfig so resolution goes through the same
+	// path as the asset-based workflow.
+	UBatchProcConfig* Config = NewObject<UBatchProcConfig>(GetTransientPackage());
+
+	auto ReadPaths = [&Root](const TCHAR* Key, TArray<FSoftObjectPath>& Out)
+	{
+		TArray<FString> Strings;
+		if (Root->TryGetStringArrayField(Key, Strings))
+		{
+			for (const FString& S : Strings) Out.Add(FSoftObjectPath(S));
+		}
+	};
+	ReadPaths(TEXT("levels"),     Config->Levels);
+	ReadPaths(TEXT("characters"), Config->SkeletalMeshes);
+	ReadPaths(TEXT("animations"), Config->Animations);
+
+	// Optional combo sampling (keys = FCDGComboSamplingSettings property names)
+	const TSharedPtr<FJsonObject>* SamplingObj = nullptr;
+	if (Root->TryGetObjectField(TEXT("sampling"), SamplingObj) && SamplingObj
+		&& !FJsonObjectConverter::JsonObjectToUStruct(SamplingObj->ToSharedRef(), &Config->Sampling))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Invalid \"sampling\" object in %s"), *FilePath);
+		return false;
+	}
+
+	// Generator stack: asset path or inline stack JSON
+	FString GenPath;
+	const TSharedPtr<FJsonObject>* GenObj = nullptr;
+	if (Root->TryGetStringField(TEXT("generatorConfig"), GenPath))
+	{
+		Config->GeneratorConfig = LoadObject<UGeneratorStackConfig>(nullptr, *GenPath);
+		if (!Config->GeneratorConfig)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Cannot load generator config: %s"), *GenPath);
+			return false;
+		}
+	}
+	else if (Root->TryGetObjectField(TEXT("generators"), GenObj) && GenObj)
+	{
+		InlineGeneratorConfig = NewObject<UGeneratorStackConfig>(GetTransientPackage());
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&InlineGeneratorConfig->GeneratorsJson);
+		FJsonSerializer::Serialize(GenObj->ToSharedRef(), Writer);
+		InlineGeneratorConfig->bLetBatchProcessorFill = true;
+		Config->GeneratorConfig = InlineGeneratorConfig;
+	}
+
+	// Exporter: asset path or inline property object (keys = UPROPERTY names)
+	FString ExpPath;
+	const TSharedPtr<FJsonObject>* ExpObj = nullptr;
+	if (Root->TryGetStringField(TEXT("exporterConfig"), ExpPath))
+	{
+		Config->ExporterConfig = LoadObject<ULevelSeqExportConfig>(nullptr, *ExpPath);
+		if (!Config->ExporterConfig)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Cannot load exporter config: %s"), *ExpPath);
+			return false;
+		}
+	}
+	else if (Root->TryGetObjectField(TEXT("exporter"), ExpObj) && ExpObj)
+	{
+		InlineExporterConfig = NewObject<ULevelSeqExportConfig>(GetTransientPackage());
+		InlineExporterConfig->OutputDirectory = FPaths::ProjectSavedDir() / TEXT("BatchProcOutput");
+		if (!FJsonObjectConverter::JsonObjectToUStruct(ExpObj->ToSharedRef(),
+				ULevelSeqExportConfig::StaticClass(), InlineExporterConfig.Get()))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Invalid \"exporter\" object in %s"), *FilePath);
+			return false;
+		}
+		Config->ExporterConfig = InlineExporterConfig;
+	}
+
+	if (!UCDGBatchProcExecService::BuildInputFromConfig(Config, OutInput))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error,
+			TEXT("[CDGBatch] Batch file %s is incomplete (needs levels, characters, animations and generators)"),
+			*FilePath);
+		return false;
+	}
+	return true;
+}
+
+bool UCDGBatchCommandlet::LoadInputFromJobSpec(const FString& FilePath, FBatchProcInput& OutInput, FString& OutComboKey)
+{
+	FCDGBatchJobSpec Spec;
+	if (!FCDGBatchJobSpec::Read(FilePath, Spec))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Cannot read job spec: %s"), *FilePath);
+		return false;
+	}
+
+	// Same transient-config route as the JSON batch file, with one of each.
+	UBatchProcConfig* Config = NewObject<UBatchProcConfig>(GetTransientPackage());
+	Config->Levels.Add(FSoftObjectPath(Spec.Job.Level + TEXT(".") + FPackageName::GetShortName(Spec.Job.Level)));
+	Config->SkeletalMeshes.Add(FSoftObjectPath(Spec.Job.Character));
+	Config->Animations.Add(FSoftObjectPath(Spec.Job.Animation));
+
+	InlineGeneratorConfig = NewObject<UGeneratorStackConfig>(GetTransientPackage());
+	InlineGeneratorConfig->GeneratorsJson         = Spec.GeneratorsJson;
+	InlineGeneratorConfig->bLetBatchProcessorFill = true;
+	Config->GeneratorConfig = InlineGeneratorConfig;
+
+	InlineExporterConfig = NewObject<ULevelSeqExportConfig>(GetTransientPackage());
+	InlineExporterConfig->OutputDirectory = FPaths::ProjectSavedDir() / TEXT("BatchProcOutput");
+	if (Spec.Exporter.IsValid()
+		&& !FJsonObjectConverter::JsonObjectToUStruct(Spec.Exporter.ToSharedRef(),
+			ULevelSeqExportConfig::StaticClass(), InlineExporterConfig.Get()))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Invalid \"Exporter\" object in %s"), *FilePath);
+		return false;
+	}
+	Config->ExporterConfig = InlineExporterConfig;
+
+	if (!UCDGBatchProcExecService::BuildInputFromConfig(Config, OutInput)
+		|| OutInput.Levels.Num() != 1 || OutInput.Characters.Num() != 1 || OutInput.Animations.Num() != 1)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error,
+			TEXT("[CDGBatch] Job spec %s names assets this project does not have"), *FilePath);
+		return false;
+	}
+
+	// Several machines may run specs against the same exporter directory, so
+	// each combo gets its own run directory (checkpoint, heartbeat, log), laid
+	// out like a queue shard.  -OutputDir still overrides it.
+	OverrideOutputDir(OutInput, FPaths::Combine(InlineExporterConfig->OutputDirectory,
+		FCDGBatchJobQueue::ShardsDir, Spec.Job.ComboKey));
+
+	OutInput.BaseSeed = Spec.BaseSeed;
+	OutInput.PinnedComboSeeds.Add(Spec.Job.ComboKey, Spec.Seed);
+	OutComboKey = Spec.Job.ComboKey;
+
+	UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Job spec %s (seed %d)"), *OutComboKey, Spec.Seed);
+	return true;
+}
+
+void UCDGBatchCommandlet::OverrideOutputDir(FBatchProcInput& Input, const FString& OutputDir)
+{
+	ULevelSeqExportConfig* Overridden = Input.ExporterConfig.IsValid()
+		? DuplicateObject<ULevelSeqExportConfig>(Input.ExporterConfig.Get(), GetTransientPackage())
+		: NewObject<ULevelSeqExportConfig>(GetTransientPackage());
+	Overridden->OutputDirectory = FPaths::ConvertRelativePathToFull(OutputDir);
+	InlineExporterConfig  = Overridden;
+	Input.ExporterConfig  = Overridden;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Sharding
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool UCDGBatchCommandlet::PlanJobs(const FBatchProcInput& Input, const FCDGBatchJobQueue& Queue) const
+{
+	// Workers then only open levels that still have pending jobs.
+	int32 NumAdded = 0;
+	const int32 NumKnown = EnumerateCombos(Input, [&](const FCDGBatchJob& Job)
+	{
+		if (Queue.AddJob(Job)) ++NumAdded;
+	});
+
+	UE_LOG(LogCameraDatasetGenEditor, Display,
+		TEXT("[CDGBatch] Job dir %s: %d combo(s), %d newly queued, %d pending in total"),
+		*Queue.GetJobDir(), NumKnown, NumAdded, Queue.Count(FCDGBatchJobQueue::PendingDir));
+	return NumKnown > 0;
+}
+
+bool UCDGBatchCommandlet::ExportJobSpecs(const FBatchProcInput& Input, const FString& SpecDir) const
+{
+	const FString AbsSpecDir = FPaths::ConvertRelativePathToFull(SpecDir);
+	if (!IFileManager::Get().MakeDirectory(*AbsSpecDir, /*Tree=*/true))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Cannot create %s"), *AbsSpecDir);
+		return false;
+	}
+
+	// Everything but the combo itself is shared; resolve it once.
+	FCDGBatchJobSpec Spec;
+	Spec.BaseSeed       = Input.BaseSeed;
+	Spec.GeneratorsJson = Input.GeneratorConfig->GeneratorsJson;
+	Spec.Exporter       = MakeShared<FJsonObject>();
+	const ULevelSeqExportConfig* Exporter = Input.ExporterConfig.IsValid()
+		? Input.ExporterConfig.Get() : GetDefault<ULevelSeqExportConfig>();
+	FJsonObjectConverter::UStructToJsonObject(ULevelSeqExportConfig::StaticClass(), Exporter, Spec.Exporter.ToSharedRef());
+	Spec.Exporter->SetStringField(TEXT("OutputDirectory"), UCDGBatchProcExecService::ResolveRootOutputDir(Input));
+
+	int32 NumFailed = 0;
+	const int32 NumCombos = EnumerateCombos(Input, [&](const FCDGBatchJob& Job)
+	{
+		Spec.Job  = Job;
+		Spec.Seed = UCDGBatchProcExecService::ComputeComboSeed(Job.ComboKey, Input.BaseSeed);
+		if (!Spec.Write(FPaths::Combine(AbsSpecDir, Job.ComboKey + TEXT(".json"))))
+		{
+			++NumFailed;
+		}
+	});
+
+	UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Wrote %d job spec(s) to %s%s"),
+		NumCombos - NumFailed, *AbsSpecDir,
+		NumFailed > 0 ? *FString::Printf(TEXT(" (%d failed)"), NumFailed) : TEXT(""));
+	return NumCombos > 0 && NumFailed == 0;
+}
+
+int32 UCDGBatchCommandlet::EnumerateCombos(const FBatchProcInput& Input,
+                                           TFunctionRef<void(const FCDGBatchJob&)> Visit) const
+{
+	// Anchors are only known once a level is loaded, so each level is opened
+	// once here.
+	int32 NumKnown = 0;
+
+	// Sampled batches only list the combos the service's own sampler would pick.
+	FCDGBatchComboSampler Sampler;
+	{
+		TArray<FName> LevelPackages;
+		for (const FAssetData& Level : Input.Levels) LevelPackages.Add(Level.PackageName);
+		Sampler.Configure(Input.Sampling, LevelPackages, Input.Characters.Num(), Input.Animations.Num());
+	}
+	if (!Sampler.IsExhaustive())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Sampling combos: %s"), *Sampler.Describe());
+	}
+
+	auto AddJob = [&](const FAssetData& Level, const FString& AnchorLabel, const FAssetData& Character,
+	                  const FAssetData& Animation)
+	{
+		FCDGBatchJob Job;
+		Job.ComboKey  = UCDGBatchProcExecService::ComposeComboKey(Level, AnchorLabel, Character, Animation);
+		Job.Level     = Level.PackageName.ToString();
+		Job.Anchor    = AnchorLabel;
+		Job.Character = Character.GetObjectPathString();
+		Job.Animation = Animation.GetObjectPathString();
+
+		++NumKnown;
+		Visit(Job);
+	};
+
+	for (const FAssetData& Level : Input.Levels)
+	{
+		const FString PackageName = Level.PackageName.ToString();
+		FString Filename;
+		if (!FPackageName::TryConvertLongPackageNameToFilename(PackageName, Filename, FPackageName::GetMapPackageExtension()))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[CDGBatch] Cannot resolve %s — skipped"), *PackageName);
+			continue;
+		}
+
+		FEditorFileUtils::LoadMap(Filename, /*bLoadAsTemplate=*/false, /*bShowProgress=*/false);
+		UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+		if (!World) continue;
+
+		// Same order as the service's anchor discovery, so sampled indices agree.
+		TArray<FString> AnchorLabels;
+		for (TActorIterator<ACDGLevelSceneAnchor> It(World); It; ++It)
+		{
+			AnchorLabels.Add(It->GetActorNameOrLabel());
+		}
+		const int32 NumAnchors = AnchorLabels.Num();
+
+		if (Sampler.IsExhaustive())
+		{
+			for (const FString& AnchorLabel : AnchorLabels)
+			{
+				for (const FAssetData& Character : Input.Characters)
+				{
+					for (const FAssetData& Animation : Input.Animations)
+					{
+						AddJob(Level, AnchorLabel, Character, Animation);
+					}
+				}
+			}
+		}
+		else
+		{
+			for (const FIntVector& Sample : Sampler.SampleLevel(Level.PackageName, NumAnchors))
+			{
+				AddJob(Level, AnchorLabels[Sample.X], Input.Characters[Sample.Y], Input.Animations[Sample.Z]);
+			}
+		}
+
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Planned %s: %d anchor(s)"),
+			*FPackageName::GetShortName(PackageName), NumAnchors);
+	}
+	return NumKnown;
+}
+
+/**
+ * This commandlet's arguments in order.  FParse::Token keeps a quoted value
+ * such as -JobDir="C:/My Jobs" in one token with its quotes, and strips the
+ * quotes of a token quoted as a whole ("C:/My Project/Game.uproject").
+ */
+static TArray<FString> TokenizeParams(const FString& Params)
+{
+	TArray<FString> Tokens;
+	const TCHAR* Str = *Params;
+	FString Token;
+	while (FParse::Token(Str, Token, /*UseEscape=*/false))
+	{
+		Tokens.Add(Token);
+	}
+	return Tokens;
+}
+
+/** A token as it goes back onto a child's command line: quoted again when it holds whitespace. */
+static FString QuoteParam(const FString& Token)
+{
+	const bool bWhitespace = Token.Contains(TEXT(" ")) || Token.Contains(TEXT("\t"));
+	return bWhitespace && !Token.Contains(TEXT("\"")) ? TEXT("\"") + Token + TEXT("\"") : Token;
+}
+
+int32 UCDGBatchCommandlet::RunSpawnedWorkers(const FString& Params, const FCDGBatchJobQueue& Queue, int32 NumWorkers) const
+{
+	// Children get this command line minus the coordinator-only switches.
+	const TArray<FString> Tokens = TokenizeParams(Params);
+	FString Forwarded;
+	for (const FString& Token : Tokens)
+	{
+		if (Token.StartsWith(TEXT("-run="), ESearchCase::IgnoreCase)
+			|| Token.Equals(TEXT("-Plan"), ESearchCase::IgnoreCase)
+			|| Token.StartsWith(TEXT("-Spawn="), ESearchCase::IgnoreCase)
+			|| Token.StartsWith(TEXT("-GPUs="), ESearchCase::IgnoreCase)
+			|| Token.EndsWith(TEXT(".uproject"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+		Forwarded += QuoteParam(Token) + TEXT(" ");
+	}
+
+	// -GPUs=<n> spreads workers round-robin over the first n adapters.
+	int32 NumGPUs = 0;
+	FParse::Value(*Params, TEXT("GPUs="), NumGPUs);
+
+	const FString Executable  = FPlatformProcess::ExecutablePath();
+	const FString ProjectFile = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+
+	TArray<FProcHandle> Workers;
+	for (int32 i = 0; i < NumWorkers; ++i)
+	{
+		FString Args = FString::Printf(TEXT("\"%s\" -run=CDGBatch %s-Worker=w%d"), *ProjectFile, *Forwarded, i);
+		if (NumGPUs > 0)
+		{
+			Args += FString::Printf(TEXT(" -graphicsadapter=%d"), i % NumGPUs);
+		}
+
+		FProcHandle Handle = FPlatformProcess::CreateProc(*Executable, *Args,
+			/*bLaunchDetached=*/false, /*bLaunchHidden=*/true, /*bLaunchReallyHidden=*/true,
+			/*OutProcessID=*/nullptr, /*PriorityModifier=*/0,
+			/*OptionalWorkingDirectory=*/nullptr, /*PipeWriteChild=*/nullptr);
+		if (!Handle.IsValid())
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Failed to launch worker w%d"), i);
+			continue;
+		}
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Launched worker w%d"), i);
+		Workers.Add(Handle);
+	}
+
+	if (Workers.IsEmpty()) return 1;
+
+	// Wait for every worker, reporting queue state every few seconds.
+	double NextReport = 0.0;
+	bool bAnyRunning = true;
+	while (bAnyRunning && !IsEngineExitRequested())
+	{
+		bAnyRunning = false;
+		for (FProcHandle& Handle : Workers)
+		{
+			bAnyRunning |= FPlatformProcess::IsProcRunning(Handle);
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		if (Now >= NextReport)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Display,
+				TEXT("[CDGBatch] Jobs: %d pending, %d running, %d done, %d failed"),
+				Queue.Count(FCDGBatchJobQueue::PendingDir), Queue.Count(FCDGBatchJobQueue::ClaimedDir),
+				Queue.Count(FCDGBatchJobQueue::DoneDir), Queue.Count(FCDGBatchJobQueue::FailedDir));
+			NextReport = Now + 10.0;
+		}
+
+		if (bAnyRunning) FPlatformProcess::Sleep(1.f);
+	}
+
+	int32 NumFailedWorkers = 0;
+	for (FProcHandle& Handle : Workers)
+	{
+		int32 ReturnCode = 0;
+		if (!FPlatformProcess::GetProcReturnCode(Handle, &ReturnCode) || ReturnCode != 0)
+		{
+			++NumFailedWorkers;
+		}
+		FPlatformProcess::CloseProc(Handle);
+	}
+
+	const int32 MergeResult = RunMerge(Queue);
+	return (NumFailedWorkers == 0 && MergeResult == 0) ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Supervision
+// ─────────────────────────────────────────────────────────────────────────────
+
+int32 UCDGBatchCommandlet::RunSupervised(const FString& Params, const FString& OutputDir,
+                                         const TSharedPtr<FCDGBatchJobQueue>& Queue, const FString& WorkerId) const
+{
+	double HeartbeatTimeout = 600.0;
+	int32  MaxRestarts      = 50;
+	FParse::Value(*Params, TEXT("HeartbeatTimeout="), HeartbeatTimeout);
+	FParse::Value(*Params, TEXT("MaxRestarts="), MaxRestarts);
+
+	// The child gets this command line minus the supervisor switches; restarts
+	// also drop -NoResume so they continue from the checkpoint.
+	const TArray<FString> Tokens = TokenizeParams(Params);
+	FString Forwarded;
+	FString ForwardedOnRestart;
+	for (const FString& Token : Tokens)
+	{
+		if (Token.StartsWith(TEXT("-run="), ESearchCase::IgnoreCase)
+			|| Token.Equals(TEXT("-Supervise"), ESearchCase::IgnoreCase)
+			|| Token.StartsWith(TEXT("-HeartbeatTimeout="), ESearchCase::IgnoreCase)
+			|| Token.StartsWith(TEXT("-MaxRestarts="), ESearchCase::IgnoreCase)
+			|| Token.EndsWith(TEXT(".uproject"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+		Forwarded += QuoteParam(Token) + TEXT(" ");
+		if (!Token.Equals(TEXT("-NoResume"), ESearchCase::IgnoreCase))
+		{
+			ForwardedOnRestart += QuoteParam(Token) + TEXT(" ");
+		}
+	}
+
+	const FString Executable  = FPlatformProcess::ExecutablePath();
+	const FString ProjectFile = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString AbsOutputDir = FPaths::ConvertRelativePathToFull(OutputDir);
+
+	// A stale heartbeat from an earlier run must not look like this child's.
+	IFileManager::Get().Delete(*FPaths::Combine(AbsOutputDir, FCDGBatchHeartbeat::FileName), false, true, true);
+
+	constexpr int32 kLogTailLines       = 40;
+	constexpr int32 kMaxFruitlessRestarts = 3;
+	int32 NumFruitless   = 0;
+	int32 LastCompleted  = -1;
+
+	for (int32 Attempt = 0; ; ++Attempt)
+	{
+		const FString Args = FString::Printf(TEXT("\"%s\" -run=CDGBatch %s-stdout -unattended"),
+			*ProjectFile, Attempt == 0 ? *Forwarded : *ForwardedOnRestart);
+
+		void* ReadPipe  = nullptr;
+		void* WritePipe = nullptr;
+		FPlatformProcess::CreatePipe(ReadPipe, WritePipe);
+
+		uint32 ChildPid = 0;
+		FProcHandle Child = FPlatformProcess::CreateProc(*Executable, *Args,
+			/*bLaunchDetached=*/false, /*bLaunchHidden=*/true, /*bLaunchReallyHidden=*/true,
+			&ChildPid, /*PriorityModifier=*/0, /*OptionalWorkingDirectory=*/nullptr, WritePipe);
+		if (!Child.IsValid())
+		{
+			FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[CDGBatch] Supervisor: cannot launch the batch worker"));
+			return 1;
+		}
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Supervisor: worker started (pid %u, attempt %d)"),
+			ChildPid, Attempt + 1);
+
+		// ── Watch: process alive, heartbeat fresh; keep the child's last lines ─
+		const FDateTime Launched = FDateTime::UtcNow();
+		TArray<FString> Tail;
+		FString Partial;
+		auto DrainPipe = [&]()
+		{
+			Partial += FPlatformProcess::ReadPipe(ReadPipe);
+			int32 Newline = INDEX_NONE;
+			while (Partial.FindChar(TEXT('\n'), Newline))
+			{
+				Tail.Add(Partial.Left(Newline).TrimEnd());
+				Partial.RightChopInline(Newline + 1);
+				if (Tail.Num() > kLogTailLines) Tail.RemoveAt(0);
+			}
+		};
+
+		FString HangReason;
+		while (FPlatformProcess::IsProcRunning(Child) && !IsEngineExitRequested())
+		{
+			FPlatformProcess::Sleep(1.f);
+			DrainPipe();
+
+			FCDGBatchHeartbeat Beat;
+			const bool bHasBeat = FCDGBatchHeartbeat::Read(AbsOutputDir, Beat) && Beat.Pid == ChildPid;
+			const FDateTime LastSign = bHasBeat && Beat.Utc > Launched ? Beat.Utc : Launched;
+			const double Silence = (FDateTime::UtcNow() - LastSign).GetTotalSeconds();
+			if (Silence > HeartbeatTimeout)
+			{
+				HangReason = FString::Printf(TEXT("no heartbeat for %.0f s"), Silence);
+				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[CDGBatch] Supervisor: worker hung (%s) — killing it"),
+					*HangReason);
+				FPlatformProcess::TerminateProc(Child, /*KillTree=*/true);
+				break;
+			}
+		}
+		FPlatformProcess::WaitForProc(Child);
+		DrainPipe();
+
+		int32 ReturnCode = -1;
+		FPlatformProcess::GetProcReturnCode(Child, &ReturnCode);
+		FPlatformProcess::CloseProc(Child);
+		FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+
+		if (IsEngineExitRequested())
+		{
+			return 1;
+		}
+		if (HangReason.IsEmpty() && ReturnCode == 0)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[CDGBatch] Supervisor: batch finished after %d restart(s)"),
+				Attempt);
+			return 0;
+		}
+
+		// ── Blame the combo the worker was on, so the restart skips it ───────
+		const FString Reason = HangReason.IsEmpty()
+			? FString::Printf(TEXT("worker exited with code %d"), ReturnCode)
+			: HangReason;
+
+		FCDGBatchHeartbeat Beat;
+		const bool bHasBeat = FCDGBatchHeartbeat::Read(AbsOutputDir, Beat) && Beat.Pid == ChildPid;
+		if (bHasBeat && Beat.Stage == TEXT("Finished"))
+		{
+			// Ran to the end but reported failure (e.g. cancelled): nothing to retry.
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[CDGBatch] Supervisor: batch ended unsuccessfully (%s)"),
+				*Reason);
+			return 1;
+		}
+
+		if (bHasBeat && Beat.IsOnCombo())
+		{
+			FCDGBatchCheckpoint Checkpoint;
+			Checkpoint.Load(AbsOutputDir);
+			Checkpoint.MarkCrashed(Beat.Subject, FString::Printf(TEXT("%s while %s\n%s"),
+				*Reason, *Beat.Stage.ToLower(), *FString::Join(Tail, TEXT("\n"))));
+			if (Queue.IsValid())
+			{
+				Queue->MarkFinished(Beat.Subject, WorkerId, /*bSuccess=*/false);
+			}
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[CDGBatch] Supervisor: %s while %s %s — marked crashed"),
+				*Reason, *Beat.Stage.ToLower(), *Beat.Subject);
+		}
+		else
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[CDGBatch] Supervisor: %s (%s)"), *Reason,
+				bHasBeat ? *FString::Printf(TEXT("%s %s"), *Beat.Stage.ToLower(), *Beat.Subject)
+				         : TEXT("before the first heartbeat"));
+		}
+
+		// Give up when restarts stop getting anywhere (e.g. a broken config).
+		const int32 Completed = bHasBeat ? Beat.Completed : -1;
+		const bool bProgressed = (bHasBeat && Beat.IsOnCombo()) || Completed > LastCompleted;
+		LastCompleted = FMath::Max(LastCompleted, Completed);
+		NumFruitless  = bProgressed ? 0 : NumFruitless + 1;
+
+		if (NumFruitless >= kMaxFruitlessRestarts || Attempt + 1 > MaxRestarts)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error,
+				TEXT("[CDGBatch] Supervisor: giving up after %d restart(s)%s"), Attempt,
+				NumFruitless >= kMaxFruitlessRestarts ? TEXT(" without progress") : TEXT(""));
+			return 1;
+		}
+	}
+}
+
+int32 UCDGBatchCommandlet::RunMerge(const FCDGBatchJobQueue& Queue) const
+{
+	int32 NumCombos = 0;
+	if (!Queue.WriteMergedIndex(NumCombos))
+	{
+		return 1;
+	}
+
+	const int32 NumPending = Queue.Count(FCDGBatchJobQueue::PendingDir) + Queue.Count(FCDGBatchJobQueue::ClaimedDir);
+	const int32 NumFailed  = Queue.Count(FCDGBatchJobQueue::FailedDir);
+	UE_LOG(LogCameraDatasetGenEditor, Display,
+		TEXT("[CDGBatch] Merged %d combo(s) into %s (%d failed, %d unfinished)"),
+		NumCombos, *(Queue.GetJobDir() / FCDGBatchJobQueue::MergedIndexFileName), NumFailed, NumPending);
+	return (NumFailed == 0 && NumPending == 0) ? 0 : 1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Main loop
+// ─────────────────────────────────────────────────────────────────────────────
+
+void UCDGBatchCommandlet::PumpUntilFinished(UCDGBatchProcExecService* Service, bool bTickEngine) const
+{
+	// The service advances between combos through FTSTicker, and MRQ needs the
+	// engine tick to drive its PIE executor.  Nothing else ticks in a commandlet.
+	double LastTime = FPlatformTime::Seconds();
+
+	while (Service && Service->IsRunning() && !IsEngineExitRequested())
+	{
+		const double Now   = FPlatformTime::Seconds();
+		const float  Delta = static_cast<float>(Now - LastTime);
+		LastTime = Now;
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FTSTicker::GetCoreTicker().Tick(Delta);
+
+		if (bTickEngine && GEngine)
+		{
+			GEngine->UpdateTimeAndHandleMaxTickRate();
+			GEngine->Tick(FApp::GetDeltaTime(), /*bIdleMode=*/false);
+			++GFrameCounter;
+		}
+		else
+		{
+			FPlatformProcess::Sleep(0.f);
+		}
+	}
+
+	if (Service && Service->IsRunning())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[CDGBatch] Engine exit requested — cancelling batch"));
+		Service->Cancel();
+	}
+}
@@ -0,0 +1,214 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Commandlet/CDGImageWriteBenchCommandlet.h"
+#include "MRQInterface/CDGImageWritePool.h"
+#include "MRQInterface/CDGOutputValidator.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+
+UCDGImageWriteBenchCommandlet::UCDGImageWriteBenchCommandlet()
+{
+	IsClient     = false;
+	IsServer     = false;
+	IsEditor     = true;
+	LogToConsole = true;
+}
+
+namespace
+{
+	/**
+	 * Smooth gradients with a moving pattern and a little noise: compresses
+	 * roughly like a rendered frame, unlike flat colour or pure noise.
+	 */
+	void FillSyntheticFrame(TArray64<uint8>& BGRA, FIntPoint Size, int32 Frame)
+	{
+		BGRA.SetNumUninitialized(int64(Size.X) * Size.Y * 4);
+		ParallelFor(Size.Y, [&](int32 Y)
+		{
+			FRandomStream Noise(Frame * 7919 + Y);
+			uint8* Row = BGRA.GetData() + int64(Y) * Size.X * 4;
+			for (int32 X = 0; X < Size.X; ++X)
+			{
+				const float U = float(X) / Size.X;
+				const float V = float(Y) / Size.Y;
+				const float Wave = 0.5f + 0.5f * FMath::Sin((U * 12.f + V * 5.f) + Frame * 0.1f);
+				const int32 N = Noise.RandRange(-3, 3);
+				Row[X * 4 + 0] = uint8(FMath::Clamp(int32(255.f * V * Wave) + N, 0, 255));
+				Row[X * 4 + 1] = uint8(FMath::Clamp(int32(255.f * (1.f - U) * 0.8f) + N, 0, 255));
+				Row[X * 4 + 2] = uint8(FMath::Clamp(int32(255.f * U * Wave) + N, 0, 255));
+				Row[X * 4 + 3] = 255;
+			}
+		});
+	}
+}
+
+int32 UCDGImageWriteBenchCommandlet::Main(const FString& Params)
+{
+	UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[ImageWriteBench] Starting"));
+
+	FCDGImageWriteSettings Base;
+	FParse::Value(*Params, TEXT("Workers="), Base.NumWorkers);
+	FParse::Value(*Params, TEXT("Queue="), Base.MaxQueuedFrames);
+	Base.bWriteAlpha = FParse::Param(*Params, TEXT("Alpha"));
+
+	FString FilterName;
+	if (FParse::Value(*Params, TEXT("Filter="), FilterName))
+	{
+		const int64 Filter = StaticEnum<ECDGPNGFilter>()->GetValueByNameString(FilterName);
+		if (Filter == INDEX_NONE)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] Unknown -Filter=%s"), *FilterName);
+			return 1;
+		}
+		Base.PNGFilter = static_cast<ECDGPNGFilter>(Filter);
+	}
+
+	int32 NumFrames = 120;
+	FIntPoint Size(1920, 1080);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Width="), Size.X);
+	FParse::Value(*Params, TEXT("Height="), Size.Y);
+	NumFrames = FMath::Max(1, NumFrames);
+	Size      = FIntPoint(FMath::Max(1, Size.X), FMath::Max(1, Size.Y));
+
+	FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("CDGImageWriteBench"));
+	FParse::Value(*Params, TEXT("OutputDir="), OutputDir);
+	const bool bKeep = FParse::Param(*Params, TEXT("Keep"));
+
+	// Runs to make: every codec, and every PNG level for PNG.
+	FString CodecList = TEXT("PNG,QOI,BMP");
+	FString LevelList = TEXT("3");
+	FParse::Value(*Params, TEXT("Codecs="), CodecList);
+	FParse::Value(*Params, TEXT("Levels="), LevelList);
+
+	TArray<FString> CodecNames, LevelNames;
+	CodecList.ParseIntoArray(CodecNames, TEXT(","));
+	LevelList.ParseIntoArray(LevelNames, TEXT(","));
+
+	TArray<FCDGImageWriteSettings> Runs;
+	for (const FString& CodecName : CodecNames)
+	{
+		const int64 Codec = StaticEnum<ECDGImageCodec>()->GetValueByNameString(CodecName.TrimStartAndEnd());
+		if (Codec == INDEX_NONE || Codec == int64(ECDGImageCodec::Engine))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] Unknown codec '%s' (PNG, QOI or BMP)"), *CodecName);
+			return 1;
+		}
+
+		FCDGImageWriteSettings Run = Base;
+		Run.Codec = static_cast<ECDGImageCodec>(Codec);
+		if (Run.Codec != ECDGImageCodec::PNG)
+		{
+			Runs.Add(Run);
+			continue;
+		}
+		for (const FString& Level : LevelNames)
+		{
+			Run.PNGCompressionLevel = FMath::Clamp(FCString::Atoi(*Level), 0, 9);
+			Runs.Add(Run);
+		}
+	}
+
+	if (Runs.IsEmpty())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] Nothing to run (-Codecs=%s -Levels=%s)"), *CodecList, *LevelList);
+		return 1;
+	}
+
+	// A handful of distinct frames, generated up front so the producer costs nothing.
+	constexpr int32 NumDistinct = 8;
+	TArray<TArray64<uint8>> Frames;
+	Frames.SetNum(NumDistinct);
+	for (int32 i = 0; i < NumDistinct; ++i)
+	{
+		FillSyntheticFrame(Frames[i], Size, i);
+	}
+
+	UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[ImageWriteBench] %d frame(s) of %dx%d %s into %s"),
+		NumFrames, Size.X, Size.Y, Base.bWriteAlpha ? TEXT("RGBA") : TEXT("RGB"), *OutputDir);
+
+	// Runs whose writes failed, and frames that did not read back; either fails the commandlet.
+	int32 NumFailedRuns        = 0;
+	int32 NumRoundTripFailures = 0;
+	for (const FCDGImageWriteSettings& Run : Runs)
+	{
+		const FString Label = Run.Codec == ECDGImageCodec::PNG
+			? FString::Printf(TEXT("PNG L%d %s"), Run.PNGCompressionLevel, *StaticEnum<ECDGPNGFilter>()->GetNameStringByValue(int64(Run.PNGFilter)))
+			: FString(FCDGImageWritePool::GetExtension(Run.Codec)).ToUpper();
+		const FString RunDir = FPaths::Combine(OutputDir, Label.Replace(TEXT(" "), TEXT("_")));
+		IFileManager::Get().DeleteDirectory(*RunDir, /*RequireExists=*/false, /*Tree=*/true);
+		IFileManager::Get().MakeDirectory(*RunDir, /*Tree=*/true);
+
+		FCDGImageWriteStats Stats;
+		int32 NumWorkers = 0;
+		const double Start = FPlatformTime::Seconds();
+		{
+			FCDGImageWritePool Pool(Run);
+			NumWorkers = Pool.GetNumWorkers();
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				TArray64<uint8> Copy = Frames[Frame % NumDistinct];
+				Pool.Enqueue(FPaths::Combine(RunDir, FString::Printf(TEXT("Bench.%04d"), Frame)), Size, MoveTemp(Copy));
+			}
+			Pool.Flush();
+			Stats = Pool.GetStats();
+		}
+		const double Seconds = FMath::Max(FPlatformTime::Seconds() - Start, 1e-6);
+
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[ImageWriteBench] %-18s %2d worker(s): %6.1f fps, %7.1f MB/s in | %s"),
+			*Label, NumWorkers, Stats.NumWritten / Seconds, Stats.RawBytes / Seconds / (1024.0 * 1024.0), *Stats.ToString());
+
+		// Round trip: every frame must read back through the validator's header
+		// probe as the codec and size it was encoded with.
+		const FString Extension = FCDGImageWritePool::GetExtension(Run.Codec);
+		int32 NumMismatched = 0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FString Path = FPaths::Combine(RunDir, FString::Printf(TEXT("Bench.%04d.%s"), Frame, *Extension));
+			FCDGMediaInfo Info;
+			FString Error;
+			if (!CDGOutputValidator::ProbeFile(Path, Info, Error))
+			{
+				Error = FString::Printf(TEXT("%s %s"), *FPaths::GetCleanFilename(Path), *Error);
+			}
+			else if (Info.Format != Extension || Info.Size != Size)
+			{
+				Error = FString::Printf(TEXT("%s reads back as %s %dx%d, expected %s %dx%d"), *FPaths::GetCleanFilename(Path),
+					*Info.Format, Info.Size.X, Info.Size.Y, *Extension, Size.X, Size.Y);
+			}
+			if (!Error.IsEmpty() && NumMismatched++ < 5)
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] %s: %s"), *Label, *Error);
+			}
+		}
+		if (NumMismatched > 0)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] %s FAILED: %d of %d frame(s) do not read back"),
+				*Label, NumMismatched, NumFrames);
+		}
+		if (Stats.NumFailed > 0 || Stats.NumWritten != NumFrames)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] %s FAILED: %d of %d frame(s) written, %d failed"),
+				*Label, Stats.NumWritten, NumFrames, Stats.NumFailed);
+		}
+
+		NumRoundTripFailures += NumMismatched;
+		NumFailedRuns        += (Stats.NumFailed > 0 || Stats.NumWritten != NumFrames || NumMismatched > 0) ? 1 : 0;
+		if (!bKeep)
+		{
+			IFileManager::Get().DeleteDirectory(*RunDir, /*RequireExists=*/false, /*Tree=*/true);
+		}
+	}
+
+	if (NumFailedRuns > 0)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[ImageWriteBench] %d of %d run(s) FAILED, %d frame(s) did not round-trip"),
+			NumFailedRuns, Runs.Num(), NumRoundTripFailures);
+	}
+	return (NumFailedRuns > 0 || NumRoundTripFailures > 0) ? 1 : 0;
+}
@@ -0,0 +1,1016 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LevelSequenceInterface/CDGSequenceBuilder.h"
+#include "Trajectory/CDGTrajectory.h"
+#include "Trajectory/CDGKeyframe.h"
+#include "Anchor/CDGCharacterAnchor.h"
+#include "Config/LevelSeqExportConfig.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "LevelSequence.h"
+#include "MovieScene.h"
+#include "MovieScenePossessable.h"
+#include "Tracks/MovieSceneCameraCutTrack.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+#include "Tracks/MovieSceneFloatTrack.h"
+#include "Tracks/MovieSceneSubTrack.h"
+#include "Sections/MovieSceneCameraCutSection.h"
+#include "Sections/MovieScene3DTransformSection.h"
+#include "Sections/MovieSceneFloatSection.h"
+#include "Sections/MovieSceneSubSection.h"
+#include "CineCameraActor.h"
+#include "CineCameraComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/IsSorted.h"
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	FMovieSceneDoubleValue MakeDoubleKey(double Value, ECDGInterpolationMode Mode)
+	{
+		FMovieSceneDoubleValue Key(Value);
+		switch (Mode)
+		{
+		case ECDGInterpolationMode::Linear:        Key.InterpMode = RCIM_Linear;   Key.TangentMode = RCTM_Auto; break;
+		case ECDGInterpolationMode::Constant:      Key.InterpMode = RCIM_Constant; Key.TangentMode = RCTM_Auto; break;
+		case ECDGInterpolationMode::CustomTangent: Key.InterpMode = RCIM_Cubic;    Key.TangentMode = RCTM_User; break;
+		default:                                   Key.InterpMode = RCIM_Cubic;    Key.TangentMode = RCTM_Auto; break;
+		}
+		return Key;
+	}
+
+	FMovieSceneFloatValue MakeFloatKey(float Value, ERichCurveInterpMode InterpMode)
+	{
+		FMovieSceneFloatValue Key(Value);
+		Key.InterpMode  = InterpMode;
+		Key.TangentMode = RCTM_Auto;
+		return Key;
+	}
+
+	/** Channels expect ascending times; only negative key spacing breaks that. */
+	template<typename ValueType>
+	void SortByTime(FCDGBakedCameraKeys::TCurve<ValueType>& Curve)
+	{
+		if (Algo::IsSorted(Curve.Times)) return;
+
+		TArray<int32> Order;
+		Order.Reserve(Curve.Times.Num());
+		for (int32 i = 0; i < Curve.Times.Num(); ++i) Order.Add(i);
+		Algo::StableSortBy(Order, [&Curve](int32 i) { return Curve.Times[i]; });
+
+		FCDGBakedCameraKeys::TCurve<ValueType> Sorted;
+		Sorted.Times.Reserve(Order.Num());
+		Sorted.Values.Reserve(Order.Num());
+		for (int32 i : Order)
+		{
+			Sorted.Times.Add(Curve.Times[i]);
+			Sorted.Values.Add(Curve.Values[i]);
+		}
+		Curve = MoveTemp(Sorted);
+	}
+
+	/**
+	 * Keep the fewest of Curve's keys whose auto-tangent curve stays within
+	 * Tolerance of the full curve at every sample.  Starts from the keys that
+	 * must stay (ends, holds, coincident keys) and, per pass, adds to every
+	 * span that is still out of tolerance the dropped key nearest its worst
+	 * sample, until no span is.  A span between two adjacent kept keys is off
+	 * only because its tangents lost their neighbours, so the nearest dropped
+	 * key outside it comes back instead.  Every pass that finds an error adds
+	 * a key, so the worst case is the full curve, which has none.
+	 */
+	template<typename ChannelType, typename ValueType>
+	void ReduceCurve(FCDGBakedCameraKeys::TCurve<ValueType>& Curve, double Tolerance, double TicksPerSample)
+	{
+		using ScalarType = decltype(ValueType::Value);
+
+		const int32 NumKeys = Curve.Times.Num();
+		if (NumKeys <= 2 || Tolerance <= 0.0 || TicksPerSample <= 0.0) return;
+
+		ChannelType Reference;
+		Reference.Set(Curve.Times, Curve.Values);
+		Reference.AutoSetTangents();
+
+		const double FirstTick = Curve.Times[0].Value;
+		const double LastTick  = Curve.Times.Last().Value;
+		TArray<FFrameTime> SampleTimes;
+		TArray<ScalarType> SampleValues;
+		SampleTimes.Reserve(static_cast<int32>((LastTick - FirstTick) / TicksPerSample) + 1);
+		for (double Tick = FirstTick; Tick <= LastTick; Tick += TicksPerSample)
+		{
+			ScalarType Value = 0;
+			Reference.Evaluate(FFrameTime::FromDecimal(Tick), Value);
+			SampleTimes.Add(FFrameTime::FromDecimal(Tick));
+			SampleValues.Add(Value);
+		}
+
+		TBitArray<> bKeep(false, NumKeys);
+		bKeep[0] = true;
+		bKeep[NumKeys - 1] = true;
+		for (int32 i = 0; i < NumKeys; ++i)
+		{
+			// A hold is a constant key plus the key that ends it.
+			if (Curve.Values[i].InterpMode == RCIM_Constant)
+			{
+				bKeep[i] = true;
+				if (i + 1 < NumKeys) bKeep[i + 1] = true;
+			}
+			if (i > 0 && Curve.Times[i] == Curve.Times[i - 1])
+			{
+				bKeep[i] = bKeep[i - 1] = true;
+			}
+		}
+
+		FCDGBakedCameraKeys::TCurve<ValueType> Kept;
+		for (int32 Pass = 0; Pass < NumKeys; ++Pass)
+		{
+			TArray<int32> KeptIdx;
+			Kept.Times.Reset();
+			Kept.Values.Reset();
+			for (TConstSetBitIterator<> It(bKeep); It; ++It)
+			{
+				KeptIdx.Add(It.GetIndex());
+				Kept.Times.Add(Curve.Times[It.GetIndex()]);
+				Kept.Values.Add(Curve.Values[It.GetIndex()]);
+			}
+			if (KeptIdx.Num() == NumKeys) break;
+
+			ChannelType Candidate;
+			Candidate.Set(Kept.Times, Kept.Values);
+			Candidate.AutoSetTangents();
+
+			// Worst sample per span [KeptIdx[s], KeptIdx[s + 1]]
+			bool bAdded = false;
+			int32  Span       = 0;
+			double WorstError = Tolerance;
+			int32  WorstSample = INDEX_NONE;
+			auto CloseSpan = [&]()
+			{
+				const int32 Lo = KeptIdx[Span];
+				const int32 Hi = KeptIdx[Span + 1];
+				if (WorstSample != INDEX_NONE)
+				{
+					const FFrameNumber WorstTime = SampleTimes[WorstSample].FrameNumber;
+					auto Distance = [&](int32 Key) { return FMath::Abs((Curve.Times[Key] - WorstTime).Value); };
+
+					int32 Pick = INDEX_NONE;
+					if (Hi - Lo > 1)
+					{
+						// Dropped key inside the span closest to the worst sample
+						Pick = FMath::Clamp(Algo::LowerBound(Curve.Times, WorstTime), Lo + 1, Hi - 1);
+						if (Pick - 1 > Lo && Distance(Pick - 1) < Distance(Pick))
+						{
+							--Pick;
+						}
+					}
+					else
+					{
+						// Nearest dropped key on either side of the span
+						int32 Left = Lo - 1;
+						while (Left >= 0 && bKeep[Left]) --Left;
+						int32 Right = Hi + 1;
+						while (Right < NumKeys && bKeep[Right]) ++Right;
+						if (Left >= 0 && (Right >= NumKeys || Distance(Left) <= Distance(Right)))
+						{
+							Pick = Left;
+						}
+						else if (Right < NumKeys)
+						{
+							Pick = Right;
+						}
+					}
+
+					if (Pick != INDEX_NONE)
+					{
+						bKeep[Pick] = true;
+						bAdded = true;
+					}
+				}
+				WorstError  = Tolerance;
+				WorstSample = INDEX_NONE;
+			};
+
+			for (int32 s = 0; s < SampleTimes.Num(); ++s)
+			{
+				while (Span + 2 < KeptIdx.Num() && SampleTimes[s] >= FFrameTime(Curve.Times[KeptIdx[Span + 1]]))
+				{
+					CloseSpan();
+					++Span;
+				}
+				ScalarType Value = 0;
+				Candidate.Evaluate(SampleTimes[s], Value);
+				const double Error = FMath::Abs(static_cast<double>(Value) - static_cast<double>(SampleValues[s]));
+				if (Error > WorstError)
+				{
+					WorstError  = Error;
+					WorstSample = s;
+				}
+			}
+			CloseSpan();
+
+			if (!bAdded) break;
+		}
+
+		if (Kept.Times.Num() < NumKeys)
+		{
+			Curve = MoveTemp(Kept);
+		}
+	}
+
+	/** Largest difference between the auto-tangent curves of Full and Reduced, sampled as ReduceCurve does. */
+	template<typename ChannelType, typename ValueType>
+	double MaxCurveError(const FCDGBakedCameraKeys::TCurve<ValueType>& Full,
+	                     const FCDGBakedCameraKeys::TCurve<ValueType>& Reduced, double TicksPerSample)
+	{
+		using ScalarType = decltype(ValueType::Value);
+
+		if (Full.Times.Num() < 2 || TicksPerSample <= 0.0) return 0.0;
+
+		ChannelType FullChannel, ReducedChannel;
+		FullChannel.Set(Full.Times, Full.Values);
+		FullChannel.AutoSetTangents();
+		ReducedChannel.Set(Reduced.Times, Reduced.Values);
+		ReducedChannel.AutoSetTangents();
+
+		double MaxError = 0.0;
+		for (double Tick = Full.Times[0].Value; Tick <= Full.Times.Last().Value; Tick += TicksPerSample)
+		{
+			ScalarType Expected = 0, Actual = 0;
+			FullChannel.Evaluate(FFrameTime::FromDecimal(Tick), Expected);
+			ReducedChannel.Evaluate(FFrameTime::FromDecimal(Tick), Actual);
+			MaxError = FMath::Max(MaxError, FMath::Abs(static_cast<double>(Actual) - static_cast<double>(Expected)));
+		}
+		return MaxError;
+	}
+
+	/** World location of Actor's character anchor of Type, or the actor's own location. */
+	FVector GetFocusTargetLocation(const AActor& Actor, AnchorType Type)
+	{
+		TArray<UCDGCharacterAnchor*> AnchorComponents;
+		Actor.GetComponents<UCDGCharacterAnchor>(AnchorComponents);
+		for (const UCDGCharacterAnchor* AnchorComponent : AnchorComponents)
+		{
+			if (AnchorComponent && AnchorComponent->Type == Type)
+			{
+				return AnchorComponent->GetComponentLocation();
+			}
+		}
+		return Actor.GetActorLocation();
+	}
+
+	/** First section of Track as SectionType, adding one when there is none. */
+	template<typename SectionType>
+	SectionType* FindOrAddSection(UMovieSceneTrack& Track, int32 DurationTicks)
+	{
+		const TArray<UMovieSceneSection*>& Sections = Track.GetAllSections();
+		SectionType* Section = Sections.Num() > 0 ? Cast<SectionType>(Sections[0]) : nullptr;
+		if (!Section)
+		{
+			Section = Cast<SectionType>(Track.CreateNewSection());
+			if (!Section) return nullptr;
+			Track.AddSection(*Section);
+		}
+		Section->SetRange(TRange<FFrameNumber>(0, DurationTicks));
+		return Section;
+	}
+
+	/** Transform section on Guid over [0, DurationTicks); the track is added when missing. */
+	UMovieScene3DTransformSection* FindOrAddTransformSection(UMovieScene& MovieScene, const FGuid& Guid,
+	                                                         int32 DurationTicks)
+	{
+		UMovieScene3DTransformTrack* Track = MovieScene.FindTrack<UMovieScene3DTransformTrack>(Guid);
+		if (!Track) Track = MovieScene.AddTrack<UMovieScene3DTransformTrack>(Guid);
+		return Track ? FindOrAddSection<UMovieScene3DTransformSection>(*Track, DurationTicks) : nullptr;
+	}
+
+	/** Float property section on Guid over [0, DurationTicks); the track is added when missing. */
+	UMovieSceneFloatSection* FindOrAddFloatPropertySection(UMovieScene& MovieScene, const FGuid& Guid,
+	                                                       const FName& PropertyName, const FString& PropertyPath,
+	                                                       int32 DurationTicks)
+	{
+		UMovieSceneFloatTrack* Track = nullptr;
+		if (const FMovieSceneBinding* Binding = MovieScene.FindBinding(Guid))
+		{
+			for (UMovieSceneTrack* Existing : Binding->GetTracks())
+			{
+				UMovieSceneFloatTrack* FloatTrack = Cast<UMovieSceneFloatTrack>(Existing);
+				if (FloatTrack && FloatTrack->GetPropertyName() == PropertyName)
+				{
+					Track = FloatTrack;
+					break;
+				}
+			}
+		}
+		if (!Track)
+		{
+			Track = MovieScene.AddTrack<UMovieSceneFloatTrack>(Guid);
+			if (!Track) return nullptr;
+			Track->SetPropertyNameAndPath(PropertyName, PropertyPath);
+		}
+		return FindOrAddSection<UMovieSceneFloatSection>(*Track, DurationTicks);
+	}
+
+	/** Camera cut section over [0, DurationTicks); the movie scene's cut track is reused. */
+	UMovieSceneCameraCutSection* FindOrAddCameraCutSection(UMovieScene& MovieScene, int32 DurationTicks)
+	{
+		UMovieSceneCameraCutTrack* CutTrack = nullptr;
+		for (UMovieSceneTrack* Track : MovieScene.GetTracks())
+		{
+			if ((CutTrack = Cast<UMovieSceneCameraCutTrack>(Track)) != nullptr) break;
+		}
+		if (!CutTrack)
+		{
+			CutTrack = MovieScene.AddTrack<UMovieSceneCameraCutTrack>();
+			if (!CutTrack) return nullptr;
+		}
+		// A single section is re-pointed in place; anything else (cuts copied
+		// from a base shot) is replaced by one cut over the whole shot.
+		if (CutTrack->GetAllSections().Num() > 1)
+		{
+			CutTrack->RemoveAllAnimationData();
+		}
+		return FindOrAddSection<UMovieSceneCameraCutSection>(*CutTrack, DurationTicks);
+	}
+
+	/** Name the possessable Guid when MovieScene has it; false when it does not. */
+	bool RenamePossessable(UMovieScene& MovieScene, const FGuid& Guid, const FString& Name)
+	{
+		FMovieScenePossessable* Possessable = Guid.IsValid() ? MovieScene.FindPossessable(Guid) : nullptr;
+		if (!Possessable) return false;
+		Possessable->SetName(Name);
+		return true;
+	}
+}
+
+int32 FCDGBakedCameraKeys::NumKeys() const
+{
+	int32 Num = FocalLength.Times.Num() + Aperture.Times.Num() + FocusDistance.Times.Num();
+	for (const TCurve<FMovieSceneDoubleValue>& Curve : Transform) Num += Curve.Times.Num();
+	return Num;
+}
+
+FCDGKeyReduction FCDGKeyReduction::FromConfig(const ULevelSeqExportConfig* Config)
+{
+	FCDGKeyReduction Out;
+	if (Config)
+	{
+		Out.bEnabled          = Config->bReduceKeys;
+		Out.LocationTolerance = Config->LocationTolerance;
+		Out.RotationTolerance = Config->RotationTolerance;
+		Out.LensTolerance     = Config->LensTolerance;
+		Out.FocusTolerance    = Config->FocusTolerance;
+	}
+	return Out;
+}
+
+FCDGSequenceBuilder::FCDGSequenceBuilder(const FCDGShotLayout& InLayout, const FFrameRate& InDisplayRate,
+                                         double InTickResolution)
+	: Layout(InLayout)
+	, DisplayRate(InDisplayRate)
+	, TickResolution(InTickResolution)
+{
+}
+
+void FCDGSequenceBuilder::PrepareMovieScene(UMovieScene& MovieScene) const
+{
+	MovieScene.SetDisplayRate(DisplayRate);
+	MovieScene.SetTickResolutionDirectly(FFrameRate(static_cast<int32>(TickResolution), 1));
+}
+
+FFrameNumber FCDGSequenceBuilder::SecondsToTicks(double Seconds) const
+{
+	return FFrameNumber(static_cast<int32>(Seconds * TickResolution));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Capture (game thread)
+// ─────────────────────────────────────────────────────────────────────────────
+
+FCDGCameraKeySnapshot FCDGSequenceBuilder::Capture(const ACDGTrajectory& Trajectory, double TimeScale) const
+{
+	check(IsInGameThread());
+
+	FCDGCameraKeySnapshot Snapshot;
+	Snapshot.TrajectoryName = Trajectory.TrajectoryName.ToString();
+
+	const TArray<ACDGKeyframe*> Keyframes = Trajectory.GetSortedKeyframes();
+	Snapshot.Keys.Reserve(Keyframes.Num());
+
+	for (int32 k = 0; k < Keyframes.Num(); ++k)
+	{
+		const ACDGKeyframe* KF = Keyframes[k];
+		if (!KF) continue;
+
+		const FTransform Xform = KF->GetKeyframeTransform();
+		const FCDGCameraLensSettings& Lens = KF->LensSettings;
+
+		FCDGCameraKeySnapshot::FKey& Key = Snapshot.Keys.AddDefaulted_GetRef();
+		// The first keyframe sits at t = 0 whatever its own spacing says.
+		Key.TimeToCurrentFrame = k > 0 ? static_cast<float>(KF->TimeToCurrentFrame * TimeScale) : 0.f;
+		Key.TimeAtCurrentFrame = static_cast<float>(KF->TimeAtCurrentFrame * TimeScale);
+		Key.Location           = Xform.GetLocation();
+		Key.Rotation           = Xform.GetRotation().Rotator();
+		Key.PositionMode       = KF->InterpolationSettings.PositionInterpMode;
+		Key.RotationMode       = KF->InterpolationSettings.RotationInterpMode;
+		Key.FocalLength        = Lens.FocalLength;
+		Key.Aperture           = Lens.Aperture;
+
+		if (const AActor* Target = Lens.AutofocusTargetActor.Get())
+		{
+			Key.FocusDistance  = FVector::Distance(Key.Location,
+				GetFocusTargetLocation(*Target, Lens.AutofocusTargetAnchorType));
+			Key.bFocusOverride = true;
+		}
+		else if (Lens.bUseManualFocusDistance)
+		{
+			Key.FocusDistance  = Lens.FocusDistance;
+			Key.bFocusOverride = true;
+		}
+	}
+
+	// Live tracking follows the character between keys; it needs the anchor
+	// in the target's own space.
+	if (Keyframes.Num() > 0 && Keyframes[0])
+	{
+		const FCDGCameraLensSettings& Lens = Keyframes[0]->LensSettings;
+		if (AActor* Target = Lens.AutofocusTargetActor.Get())
+		{
+			Snapshot.FocusTrackActor  = Target;
+			Snapshot.FocusTrackOffset = Target->GetActorTransform().InverseTransformPosition(
+				GetFocusTargetLocation(*Target, Lens.AutofocusTargetAnchorType));
+		}
+	}
+	return Snapshot;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Bake (any thread)
+// ─────────────────────────────────────────────────────────────────────────────
+
+FCDGBakedCameraKeys FCDGSequenceBuilder::BakeKeys(const FCDGCameraKeySnapshot& Snapshot) const
+{
+	FCDGBakedCameraKeys Out;
+	const bool bBakeFocus = Layout.Focus != ECDGShotFocus::Untouched;
+
+	// A key that holds (TimeAtCurrentFrame > 0) gets a constant key on arrival
+	// and a second key, with the keyframe's own modes, when it leaves.
+	const int32 MaxKeys = Snapshot.Keys.Num() * 2;
+	for (FCDGBakedCameraKeys::TCurve<FMovieSceneDoubleValue>& Curve : Out.Transform)
+	{
+		Curve.Times.Reserve(MaxKeys);
+		Curve.Values.Reserve(MaxKeys);
+	}
+	for (FCDGBakedCameraKeys::TCurve<FMovieSceneFloatValue>* Curve : { &Out.FocalLength, &Out.Aperture, &Out.FocusDistance })
+	{
+		if (Curve == &Out.FocusDistance && !bBakeFocus) continue;
+		Curve->Times.Reserve(MaxKeys);
+		Curve->Values.Reserve(MaxKeys);
+	}
+
+	auto AddKeys = [&](FFrameNumber Time, const FCDGCameraKeySnapshot::FKey& Key, bool bArrivingAtHold)
+	{
+		const ECDGInterpolationMode PositionMode = bArrivingAtHold ? ECDGInterpolationMode::Constant : Key.PositionMode;
+		const ECDGInterpolationMode RotationMode = bArrivingAtHold ? ECDGInterpolationMode::Constant : Key.RotationMode;
+		const double Values[6] = {
+			Key.Location.X, Key.Location.Y, Key.Location.Z,
+			Key.Rotation.Roll, Key.Rotation.Pitch, Key.Rotation.Yaw };
+		for (int32 c = 0; c < 6; ++c)
+		{
+			Out.Transform[c].Times.Add(Time);
+			Out.Transform[c].Values.Add(MakeDoubleKey(Values[c], c < 3 ? PositionMode : RotationMode));
+		}
+
+		const ERichCurveInterpMode LensMode = bArrivingAtHold ? RCIM_Constant : RCIM_Linear;
+		Out.FocalLength.Times.Add(Time);
+		Out.FocalLength.Values.Add(MakeFloatKey(Key.FocalLength, LensMode));
+		Out.Aperture.Times.Add(Time);
+		Out.Aperture.Values.Add(MakeFloatKey(Key.Aperture, LensMode));
+		if (bBakeFocus)
+		{
+			Out.FocusDistance.Times.Add(Time);
+			Out.FocusDistance.Values.Add(MakeFloatKey(Key.FocusDistance, LensMode));
+		}
+	};
+
+	double CurTime = 0.0;
+	for (const FCDGCameraKeySnapshot::FKey& Key : Snapshot.Keys)
+	{
+		CurTime += Key.TimeToCurrentFrame;
+		const bool bStay = Key.TimeAtCurrentFrame > KINDA_SMALL_NUMBER;
+		AddKeys(SecondsToTicks(CurTime), Key, bStay);
+
+		if (bStay)
+		{
+			CurTime += Key.TimeAtCurrentFrame;
+			AddKeys(SecondsToTicks(CurTime), Key, /*bArrivingAtHold=*/false);
+		}
+	}
+
+	for (FCDGBakedCameraKeys::TCurve<FMovieSceneDoubleValue>& Curve : Out.Transform) SortByTime(Curve);
+	SortByTime(Out.FocalLength);
+	SortByTime(Out.Aperture);
+	SortByTime(Out.FocusDistance);
+	return Out;
+}
+
+void FCDGSequenceBuilder::ReduceChannel(FCDGBakedCameraKeys& Keys, int32 Index) const
+{
+	const FCDGKeyReduction& Settings = Layout.KeyReduction;
+	// Two samples per display frame: the rendered frame and the temporal
+	// sub-samples between frames both evaluate the curve.
+	const double TicksPerSample = TickResolution / DisplayRate.AsDecimal() * 0.5;
+
+	if (Index < 6)
+	{
+		ReduceCurve<FMovieSceneDoubleChannel>(Keys.Transform[Index],
+			Index < 3 ? Settings.LocationTolerance : Settings.RotationTolerance, TicksPerSample);
+	}
+	else if (Index == 6)
+	{
+		ReduceCurve<FMovieSceneFloatChannel>(Keys.FocalLength, Settings.LensTolerance, TicksPerSample);
+	}
+	else if (Index == 7)
+	{
+		ReduceCurve<FMovieSceneFloatChannel>(Keys.Aperture, Settings.LensTolerance, TicksPerSample);
+	}
+	else
+	{
+		ReduceCurve<FMovieSceneFloatChannel>(Keys.FocusDistance, Settings.FocusTolerance, TicksPerSample);
+	}
+}
+
+FCDGBakedCameraKeys FCDGSequenceBuilder::Bake(const FCDGCameraKeySnapshot& Snapshot, FBakeStats* OutStats) const
+{
+	FCDGBakedCameraKeys Keys = BakeKeys(Snapshot);
+	const int32 NumBaked = Keys.NumKeys();
+	if (Layout.KeyReduction.bEnabled)
+	{
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel) ReduceChannel(Keys, Channel);
+	}
+	if (OutStats)
+	{
+		OutStats->NumBaked   += NumBaked;
+		OutStats->NumReduced += Keys.NumKeys();
+	}
+	return Keys;
+}
+
+FCDGSequenceBuilder::FBakeStats FCDGSequenceBuilder::BakeAll(TArrayView<const FCDGCameraKeySnapshot> Snapshots,
+                                                             TArray<FCDGBakedCameraKeys>& Out) const
+{
+	FBakeStats Stats;
+	Out.SetNum(Snapshots.Num());
+	ParallelFor(Snapshots.Num(), [&](int32 i)
+	{
+		Out[i] = BakeKeys(Snapshots[i]);
+	});
+	for (const FCDGBakedCameraKeys& Keys : Out) Stats.NumBaked += Keys.NumKeys();
+
+	// Channels are independent once baked, so each one is its own task.
+	if (Layout.KeyReduction.bEnabled)
+	{
+		ParallelFor(Snapshots.Num() * NumChannels, [&](int32 Task)
+		{
+			ReduceChannel(Out[Task / NumChannels], Task % NumChannels);
+		});
+	}
+	for (const FCDGBakedCameraKeys& Keys : Out) Stats.NumReduced += Keys.NumKeys();
+	return Stats;
+}
+
+FCDGSequenceBuilder::FBakeStats& FCDGSequenceBuilder::FBakeStats::operator+=(const FBakeStats& Other)
+{
+	NumBaked   += Other.NumBaked;
+	NumReduced += Other.NumReduced;
+	return *this;
+}
+
+FString FCDGSequenceBuilder::FBakeStats::ToString() const
+{
+	return FString::Printf(TEXT("%lld → %lld keys (%.1f %%)"), NumBaked, NumReduced,
+		NumBaked > 0 ? 100.0 * NumReduced / NumBaked : 100.0);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Build (game thread)
+// ─────────────────────────────────────────────────────────────────────────────
+
+void FCDGSequenceBuilder::ApplyCurve(FMovieSceneDoubleChannel& Channel,
+                                     const FCDGBakedCameraKeys::TCurve<FMovieSceneDoubleValue>& Curve)
+{
+	Channel.Set(Curve.Times, Curve.Values);
+	// One tangent pass over the finished curve (AddCubicKey runs it per key).
+	Channel.AutoSetTangents();
+}
+
+void FCDGSequenceBuilder::ApplyCurve(FMovieSceneFloatChannel& Channel,
+                                     const FCDGBakedCameraKeys::TCurve<FMovieSceneFloatValue>& Curve)
+{
+	Channel.Set(Curve.Times, Curve.Values);
+	Channel.AutoSetTangents();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Shot template (game thread)
+// ─────────────────────────────────────────────────────────────────────────────
+
+void FCDGSequenceBuilder::BuildShotTemplate() const
+{
+	UPackage* Outer = GetTransientPackage();
+	ULevelSequence* Template = NewObject<ULevelSequence>(Outer,
+		MakeUniqueObjectName(Outer, ULevelSequence::StaticClass(), TEXT("CDGShotTemplate")), RF_Transient);
+	Template->Initialize();
+	UMovieScene* MovieScene = Template->GetMovieScene();
+	PrepareMovieScene(*MovieScene);
+
+	// Bindings stay unbound here; BuildCameraShot() binds each copy to its camera.
+	const UCineCameraComponent* DefaultComponent = GetDefault<ACineCameraActor>()->GetCineCameraComponent();
+	TemplateCameraGuid    = MovieScene->AddPossessable(TEXT("ShotCamera"), ACineCameraActor::StaticClass());
+	TemplateComponentGuid = MovieScene->AddPossessable(
+		DefaultComponent ? DefaultComponent->GetName() : TEXT("CameraComponent"), UCineCameraComponent::StaticClass());
+	if (FMovieScenePossessable* ComponentPossessable = MovieScene->FindPossessable(TemplateComponentGuid))
+	{
+		ComponentPossessable->SetParent(TemplateCameraGuid, MovieScene);
+	}
+
+	if (UMovieSceneCameraCutSection* CutSection = FindOrAddCameraCutSection(*MovieScene, 1))
+	{
+		CutSection->SetCameraGuid(TemplateCameraGuid);
+	}
+	FindOrAddTransformSection(*MovieScene, TemplateCameraGuid, 1);
+	FindOrAddFloatPropertySection(*MovieScene, TemplateComponentGuid,
+		GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentFocalLength), TEXT("CurrentFocalLength"), 1);
+	FindOrAddFloatPropertySection(*MovieScene, TemplateComponentGuid,
+		GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentAperture), TEXT("CurrentAperture"), 1);
+	// Tracked focus only writes the distance track for shots with manual keys.
+	if (Layout.Focus == ECDGShotFocus::BakedDistance)
+	{
+		FindOrAddFloatPropertySection(*MovieScene, TemplateComponentGuid,
+			TEXT("FocusSettings.ManualFocusDistance"), TEXT("FocusSettings.ManualFocusDistance"), 1);
+	}
+
+	ShotTemplate.Reset(Template);
+}
+
+ULevelSequence* FCDGSequenceBuilder::CreateShotSequence(UObject* Outer, FName Name, EObjectFlags Flags) const
+{
+	check(IsInGameThread());
+
+	if (!ShotTemplate.IsValid())
+	{
+		BuildShotTemplate();
+	}
+
+	FObjectDuplicationParameters Params = InitStaticDuplicateObjectParams(ShotTemplate.Get(), Outer, Name);
+	Params.FlagMask  &= ~(RF_Transient | RF_Public | RF_Standalone);
+	Params.ApplyFlags = Flags;
+	return Cast<ULevelSequence>(StaticDuplicateObjectEx(Params));
+}
+
+FCDGSequenceBuilder::FBuiltShot FCDGSequenceBuilder::BuildCameraShot(
+	UWorld* World, ULevelSequence& Sequence,
+	const FCDGCameraKeySnapshot& Snapshot, const FCDGBakedCameraKeys& Keys,
+	int32 DurationTicks) const
+{
+	check(IsInGameThread());
+
+	FBuiltShot Shot;
+	UMovieScene* MovieScene = Sequence.GetMovieScene();
+	if (!World || !MovieScene) return Shot;
+
+	// ── Camera actor ─────────────────────────────────────────────────────────
+	const FString CameraName = Layout.CameraLabelPrefix + Snapshot.TrajectoryName;
+	for (TActorIterator<ACineCameraActor> It(World); It; ++It)
+	{
+		if (It->GetActorLabel() == CameraName)
+		{
+			World->EditorDestroyActor(*It, true);
+			break;
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	if (Layout.bNameCameraActor)
+	{
+		SpawnParams.Name = MakeUniqueObjectName(World->GetCurrentLevel(), ACineCameraActor::StaticClass(), FName(*CameraName));
+	}
+	ACineCameraActor* CameraActor = World->SpawnActor<ACineCameraActor>(
+		ACineCameraActor::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	if (!CameraActor)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[SequenceBuilder] Failed to spawn camera actor: %s"), *CameraName);
+		return Shot;
+	}
+	CameraActor->SetActorLabel(CameraName);
+	Shot.Camera = CameraActor;
+
+	// A template copy already has the camera binding; only its name changes.
+	const bool bFromTemplate = RenamePossessable(*MovieScene, TemplateCameraGuid, CameraActor->GetActorLabel());
+	Shot.CameraGuid = bFromTemplate
+		? TemplateCameraGuid
+		: MovieScene->AddPossessable(CameraActor->GetActorLabel(), CameraActor->GetClass());
+	Sequence.BindPossessableObject(Shot.CameraGuid, *CameraActor, World);
+
+	// ── Camera cut (one per movie scene; reused when already there) ──────────
+	if (UMovieSceneCameraCutSection* CutSection = FindOrAddCameraCutSection(*MovieScene, DurationTicks))
+	{
+		CutSection->SetCameraGuid(Shot.CameraGuid);
+	}
+
+	// ── Transform ────────────────────────────────────────────────────────────
+	if (UMovieScene3DTransformSection* TransformSection = FindOrAddTransformSection(*MovieScene, Shot.CameraGuid, DurationTicks))
+	{
+		TArrayView<FMovieSceneDoubleChannel*> Channels =
+			TransformSection->GetChannelProxy().GetChannels<FMovieSceneDoubleChannel>();
+		for (int32 c = 0; c < 6 && c < Channels.Num(); ++c)
+		{
+			if (Channels[c]) ApplyCurve(*Channels[c], Keys.Transform[c]);
+		}
+	}
+
+	// ── Lens (on the camera component) ───────────────────────────────────────
+	if (UCineCameraComponent* CameraComponent = CameraActor->GetCineCameraComponent())
+	{
+		FGuid ComponentGuid = TemplateComponentGuid;
+		if (!bFromTemplate || !RenamePossessable(*MovieScene, ComponentGuid, CameraComponent->GetName()))
+		{
+			ComponentGuid = MovieScene->AddPossessable(CameraComponent->GetName(), CameraComponent->GetClass());
+			if (FMovieScenePossessable* ComponentPossessable = MovieScene->FindPossessable(ComponentGuid))
+			{
+				ComponentPossessable->SetParent(Shot.CameraGuid, MovieScene);
+			}
+		}
+		Sequence.BindPossessableObject(ComponentGuid, *CameraComponent, CameraActor);
+
+		if (UMovieSceneFloatSection* Section = FindOrAddFloatPropertySection(*MovieScene, ComponentGuid,
+				GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentFocalLength), TEXT("CurrentFocalLength"), DurationTicks))
+		{
+			ApplyCurve(Section->GetChannel(), Keys.FocalLength);
+		}
+		if (UMovieSceneFloatSection* Section = FindOrAddFloatPropertySection(*MovieScene, ComponentGuid,
+				GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentAperture), TEXT("CurrentAperture"), DurationTicks))
+		{
+			ApplyCurve(Section->GetChannel(), Keys.Aperture);
+		}
+
+		ApplyFocus(Sequence, *MovieScene, ComponentGuid, *CameraComponent, Snapshot, Keys, DurationTicks);
+	}
+
+	NumKeysWritten += Keys.NumKeys();
+	return Shot;
+}
+
+void FCDGSequenceBuilder::AddSharedSubSequence(ULevelSequence& Shot, ULevelSequence& Shared, int32 DurationTicks)
+{
+	UMovieScene* MovieScene = Shot.GetMovieScene();
+	if (!MovieScene) return;
+
+	// Exact class: cinematic shot tracks are subsequence tracks too.
+	UMovieSceneSubTrack* SubTrack = nullptr;
+	for (UMovieSceneTrack* Track : MovieScene->GetTracks())
+	{
+		if (Track && Track->GetClass() == UMovieSceneSubTrack::StaticClass())
+		{
+			SubTrack = CastChecked<UMovieSceneSubTrack>(Track);
+			break;
+		}
+	}
+	if (!SubTrack)
+	{
+		SubTrack = MovieScene->AddTrack<UMovieSceneSubTrack>();
+		if (!SubTrack) return;
+	}
+
+	if (UMovieSceneSubSection* Section = FindOrAddSection<UMovieSceneSubSection>(*SubTrack, DurationTicks))
+	{
+		Section->SetSequence(&Shared);
+	}
+}
+
+void FCDGSequenceBuilder::ApplyFocus(ULevelSequence& Sequence, UMovieScene& MovieScene, const FGuid& ComponentGuid,
+                                     UCineCameraComponent& CameraComponent, const FCDGCameraKeySnapshot& Snapshot,
+                                     const FCDGBakedCameraKeys& Keys, int32 DurationTicks) const
+{
+	if (Layout.Focus == ECDGShotFocus::Untouched) return;
+
+	// Tracking lets UCineCameraComponent project the anchor every frame, so
+	// focus holds while the character moves between keys.
+	if (Layout.Focus == ECDGShotFocus::TrackAnchor && Snapshot.FocusTrackActor.IsValid())
+	{
+		CameraComponent.FocusSettings.FocusMethod = ECameraFocusMethod::Tracking;
+		CameraComponent.FocusSettings.TrackingFocusSettings.ActorToTrack   = Snapshot.FocusTrackActor.Get();
+		CameraComponent.FocusSettings.TrackingFocusSettings.RelativeOffset = Snapshot.FocusTrackOffset;
+		return;
+	}
+
+	const bool bAnyOverride = Snapshot.Keys.ContainsByPredicate(
+		[](const FCDGCameraKeySnapshot::FKey& Key) { return Key.bFocusOverride; });
+	CameraComponent.FocusSettings.FocusMethod = bAnyOverride ? ECameraFocusMethod::Manual : ECameraFocusMethod::Disable;
+
+	// The exporter window always writes the track so the shot can be edited
+	// later; tracked shots without a target only need it when it does something.
+	if (Layout.Focus == ECDGShotFocus::BakedDistance || bAnyOverride)
+	{
+		if (UMovieSceneFloatSection* Section = FindOrAddFloatPropertySection(MovieScene, ComponentGuid,
+				TEXT("FocusSettings.ManualFocusDistance"), TEXT("FocusSettings.ManualFocusDistance"), DurationTicks))
+		{
+			ApplyCurve(Section->GetChannel(), Keys.FocusDistance);
+		}
+	}
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Benchmark
+//
+//   CDG.SequenceBuilder.Benchmark [Shots=64] [KeysPerShot=256]
+//
+// Times synthetic trajectories through BakeAll() and the bulk channel writes,
+// against the per-key AddCubicKey path the exporters used before, and logs
+// keys written per second for each, then how long key reduction takes and
+// how many keys it keeps.  The reduction's error bound is checked by the
+// CameraDatasetGen.SequenceBuilder.KeyReduction automation test below.
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** Random-walk camera paths with occasional holds; Smooth gives slow sine paths reduction can thin out. */
+static TArray<FCDGCameraKeySnapshot> MakeSyntheticSnapshots(int32 NumShots, int32 KeysPerShot, int32 Seed, bool bSmooth = false)
+{
+	FRandomStream Rng(Seed);
+	TArray<FCDGCameraKeySnapshot> Snapshots;
+	Snapshots.SetNum(NumShots);
+	for (FCDGCameraKeySnapshot& Snapshot : Snapshots)
+	{
+		const float Phase = Rng.FRandRange(0.f, 2.f * PI);
+		for (int32 k = 0; k < KeysPerShot; ++k)
+		{
+			FCDGCameraKeySnapshot::FKey& Key = Snapshot.Keys.AddDefaulted_GetRef();
+			if (bSmooth)
+			{
+				const float T = k * 0.1f + Phase;
+				Key.TimeToCurrentFrame = k > 0 ? 0.1f : 0.f;
+				Key.Location           = FVector(1000.f * FMath::Sin(T), 500.f * FMath::Cos(0.5f * T), 20.f * T);
+				Key.Rotation           = FRotator(10.f * FMath::Sin(T), 30.f * T, 0.f);
+				Key.FocusDistance      = 500.f + 200.f * FMath::Sin(0.3f * T);
+				continue;
+			}
+			Key.TimeToCurrentFrame = k > 0 ? Rng.FRandRange(0.05f, 0.5f) : 0.f;
+			Key.TimeAtCurrentFrame = Rng.FRand() < 0.1f ? 0.25f : 0.f;
+			Key.Location           = (k > 0 ? Snapshot.Keys[k - 1].Location : FVector::ZeroVector) + Rng.VRand() * 50.f;
+			Key.Rotation           = FRotator(Rng.FRandRange(-30.f, 30.f), Rng.FRandRange(-180.f, 180.f), 0.f);
+			Key.FocusDistance      = Rng.FRandRange(100.f, 1000.f);
+		}
+	}
+	return Snapshots;
+}
+
+static FAutoConsoleCommand GCDGSequenceBuilderBenchmark(
+	TEXT("CDG.SequenceBuilder.Benchmark"),
+	TEXT("Measure sequence builder throughput in keys/s.  Args: [Shots=64] [KeysPerShot=256]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumShots    = FMath::Max(1, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64);
+		const int32 KeysPerShot = FMath::Max(2, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 256);
+
+		FCDGShotLayout Layout;
+		Layout.Focus = ECDGShotFocus::BakedDistance;
+		const FCDGSequenceBuilder Builder(Layout, FFrameRate(30, 1));
+		const TArray<FCDGCameraKeySnapshot> Snapshots = MakeSyntheticSnapshots(NumShots, KeysPerShot, 12345);
+
+		// Bake
+		double Start = FPlatformTime::Seconds();
+		TArray<FCDGBakedCameraKeys> Baked;
+		Builder.BakeAll(Snapshots, Baked);
+		const double BakeSeconds = FPlatformTime::Seconds() - Start;
+
+		int64 NumKeys = 0;
+		for (const FCDGBakedCameraKeys& Keys : Baked) NumKeys += Keys.NumKeys();
+
+		// Bulk channel writes, as BuildCameraShot() does them
+		TArray<FMovieSceneDoubleChannel> DoubleChannels;
+		TArray<FMovieSceneFloatChannel>  FloatChannels;
+		DoubleChannels.SetNum(6);
+		FloatChannels.SetNum(3);
+
+		Start = FPlatformTime::Seconds();
+		for (const FCDGBakedCameraKeys& Keys : Baked)
+		{
+			for (int32 c = 0; c < 6; ++c) FCDGSequenceBuilder::ApplyCurve(DoubleChannels[c], Keys.Transform[c]);
+			FCDGSequenceBuilder::ApplyCurve(FloatChannels[0], Keys.FocalLength);
+			FCDGSequenceBuilder::ApplyCurve(FloatChannels[1], Keys.Aperture);
+			FCDGSequenceBuilder::ApplyCurve(FloatChannels[2], Keys.FocusDistance);
+		}
+		const double ApplySeconds = FPlatformTime::Seconds() - Start;
+
+		// Per-key baseline (one tangent pass per cubic key)
+		Start = FPlatformTime::Seconds();
+		for (const FCDGBakedCameraKeys& Keys : Baked)
+		{
+			for (int32 c = 0; c < 6; ++c)
+			{
+				FMovieSceneDoubleChannel Channel;
+				const FCDGBakedCameraKeys::TCurve<FMovieSceneDoubleValue>& Curve = Keys.Transform[c];
+				for (int32 i = 0; i < Curve.Times.Num(); ++i)
+				{
+					Channel.AddCubicKey(Curve.Times[i], Curve.Values[i].Value);
+				}
+			}
+			for (const FCDGBakedCameraKeys::TCurve<FMovieSceneFloatValue>* Curve : { &Keys.FocalLength, &Keys.Aperture, &Keys.FocusDistance })
+			{
+				FMovieSceneFloatChannel Channel;
+				for (int32 i = 0; i < Curve->Times.Num(); ++i)
+				{
+					Channel.AddLinearKey(Curve->Times[i], Curve->Values[i].Value);
+				}
+			}
+		}
+		const double PerKeySeconds = FPlatformTime::Seconds() - Start;
+
+		auto Rate = [NumKeys](double Seconds) { return Seconds > 0.0 ? NumKeys / Seconds : 0.0; };
+		UE_LOG(LogCameraDatasetGenEditor, Display,
+			TEXT("[SequenceBuilder] %d shot(s) x %d keyframe(s) = %lld channel keys: bake %.0f keys/s, bulk write %.0f keys/s (bake + write %.0f keys/s), per-key write %.0f keys/s"),
+			NumShots, KeysPerShot, NumKeys, Rate(BakeSeconds), Rate(ApplySeconds),
+			Rate(BakeSeconds + ApplySeconds), Rate(PerKeySeconds));
+
+		// Key reduction cost and yield
+		FCDGShotLayout ReducedLayout = Layout;
+		ReducedLayout.KeyReduction.bEnabled = true;
+		const FCDGSequenceBuilder ReducingBuilder(ReducedLayout, FFrameRate(30, 1));
+
+		Start = FPlatformTime::Seconds();
+		TArray<FCDGBakedCameraKeys> Reduced;
+		const FCDGSequenceBuilder::FBakeStats ReduceStats = ReducingBuilder.BakeAll(Snapshots, Reduced);
+		UE_LOG(LogCameraDatasetGenEditor, Display, TEXT("[SequenceBuilder] Bake + key reduction: %s in %.3f s"),
+			*ReduceStats.ToString(), FPlatformTime::Seconds() - Start);
+	}));
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Every reduced channel must stay within its tolerance of the full curve at
+// every sample the reducer checks, for rough and smooth paths alike.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCDGKeyReductionTest, "CameraDatasetGen.SequenceBuilder.KeyReduction",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCDGKeyReductionTest::RunTest(const FString& Parameters)
+{
+	FCDGShotLayout Layout;
+	Layout.Focus = ECDGShotFocus::BakedDistance;
+	const FCDGSequenceBuilder FullBuilder(Layout, FFrameRate(30, 1));
+	Layout.KeyReduction.bEnabled = true;
+	const FCDGKeyReduction& Tolerances = Layout.KeyReduction;
+	const FCDGSequenceBuilder ReducingBuilder(Layout, FFrameRate(30, 1));
+	const double TicksPerSample = FCDGSequenceBuilder::DefaultTickResolution / 30.0 * 0.5;
+
+	static const TCHAR* ChannelNames[9] = { TEXT("X"), TEXT("Y"), TEXT("Z"), TEXT("Roll"), TEXT("Pitch"), TEXT("Yaw"),
+	                                        TEXT("FocalLength"), TEXT("Aperture"), TEXT("FocusDistance") };
+
+	for (const bool bSmooth : { false, true })
+	{
+		for (const int32 Seed : { 1, 12345, 777 })
+		{
+			const TArray<FCDGCameraKeySnapshot> Snapshots = MakeSyntheticSnapshots(8, 128, Seed, bSmooth);
+			TArray<FCDGBakedCameraKeys> Full, Reduced;
+			FullBuilder.BakeAll(Snapshots, Full);
+			const FCDGSequenceBuilder::FBakeStats Stats = ReducingBuilder.BakeAll(Snapshots, Reduced);
+			if (bSmooth)
+			{
+				TestTrue(FString::Printf(TEXT("Smooth paths (seed %d) lose keys: %s"), Seed, *Stats.ToString()),
+					Stats.NumReduced < Stats.NumBaked);
+			}
+
+			for (int32 Shot = 0; Shot < Snapshots.Num(); ++Shot)
+			{
+				double Errors[9];
+				double Limits[9];
+				for (int32 c = 0; c < 6; ++c)
+				{
+					Errors[c] = MaxCurveError<FMovieSceneDoubleChannel>(Full[Shot].Transform[c], Reduced[Shot].Transform[c], TicksPerSample);
+					Limits[c] = c < 3 ? Tolerances.LocationTolerance : Tolerances.RotationTolerance;
+				}
+				Errors[6] = MaxCurveError<FMovieSceneFloatChannel>(Full[Shot].FocalLength, Reduced[Shot].FocalLength, TicksPerSample);
+				Errors[7] = MaxCurveError<FMovieSceneFloatChannel>(Full[Shot].Aperture, Reduced[Shot].Aperture, TicksPerSample);
+				Errors[8] = MaxCurveError<FMovieSceneFloatChannel>(Full[Shot].FocusDistance, Reduced[Shot].FocusDistance, TicksPerSample);
+				Limits[6] = Limits[7] = Tolerances.LensTolerance;
+				Limits[8] = Tolerances.FocusTolerance;
+
+				for (int32 c = 0; c < 9; ++c)
+				{
+					TestTrue(FString::Printf(TEXT("%s seed %d shot %d %s off by %g (tolerance %g)"),
+						bSmooth ? TEXT("Smooth") : TEXT("Rough"), Seed, Shot, ChannelNames[c], Errors[c], Limits[c]),
+						Errors[c] <= Limits[c] * (1.0 + 1e-6));
+				}
+			}
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,755 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MRQInterface/CDGFrameSink.h"
+#include "MRQInterface/CDGOutputValidator.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+
+int32 GetFramePixelBytes(ECDGFramePixelFormat Format)
+{
+	switch (Format)
+	{
+	case ECDGFramePixelFormat::BGRA8:   return 4;
+	case ECDGFramePixelFormat::RGBA16F: return 8;
+	case ECDGFramePixelFormat::RGBA32F: return 16;
+	}
+	return 4;
+}
+
+const TCHAR* GetFramePixelFormatName(ECDGFramePixelFormat Format)
+{
+	switch (Format)
+	{
+	case ECDGFramePixelFormat::BGRA8:   return TEXT("bgra8");
+	case ECDGFramePixelFormat::RGBA16F: return TEXT("rgba16f");
+	case ECDGFramePixelFormat::RGBA32F: return TEXT("rgba32f");
+	}
+	return TEXT("unknown");
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Factory
+// ─────────────────────────────────────────────────────────────────────────────
+
+static TFunction<TUniquePtr<ICDGFrameSink>()> GCustomFrameSinkFactory;
+
+void SetCustomFrameSinkFactory(TFunction<TUniquePtr<ICDGFrameSink>()> Factory)
+{
+	GCustomFrameSinkFactory = MoveTemp(Factory);
+}
+
+TUniquePtr<ICDGFrameSink> MakeFrameSink(const FCDGFrameSinkSettings& Settings)
+{
+	switch (Settings.Kind)
+	{
+	case ECDGFrameSinkKind::EncoderPipe:
+		return MakeUnique<FCDGEncoderPipeFrameSink>(Settings.EncoderPath, Settings.EncoderArgs);
+	case ECDGFrameSinkKind::RawChunks:
+		return MakeUnique<FCDGChunkedFileFrameSink>(/*bYUV420=*/false, Settings.FramesPerChunk);
+	case ECDGFrameSinkKind::YUVChunks:
+		return MakeUnique<FCDGChunkedFileFrameSink>(/*bYUV420=*/true, Settings.FramesPerChunk);
+	case ECDGFrameSinkKind::TarShards:
+		return MakeUnique<FCDGTarShardFrameSink>(Settings.ImageWrite, Settings.ShardSizeMB, Settings.ShardSetName);
+	case ECDGFrameSinkKind::Custom:
+		return GCustomFrameSinkFactory ? GCustomFrameSinkFactory() : nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Encoder pipe
+// ─────────────────────────────────────────────────────────────────────────────
+
+FCDGEncoderPipeFrameSink::FCDGEncoderPipeFrameSink(const FString& InEncoderPath, const FString& InEncoderArgs)
+	: EncoderPath(InEncoderPath)
+	, EncoderArgs(InEncoderArgs)
+{
+}
+
+FCDGEncoderPipeFrameSink::~FCDGEncoderPipeFrameSink()
+{
+	Close();
+}
+
+void FCDGEncoderPipeFrameSink::Close()
+{
+	if (StdinRead || StdinWrite)
+	{
+		FPlatformProcess::ClosePipe(StdinRead, StdinWrite);
+		StdinRead = StdinWrite = nullptr;
+	}
+	if (Process.IsValid())
+	{
+		if (FPlatformProcess::IsProcRunning(Process))
+		{
+			FPlatformProcess::TerminateProc(Process, /*KillTree=*/true);
+		}
+		FPlatformProcess::CloseProc(Process);
+	}
+}
+
+bool FCDGEncoderPipeFrameSink::Begin(const FCDGFrameStreamInfo& Info)
+{
+	Close();
+	bFailed    = false;
+	FrameBytes = Info.GetFrameBytes();
+
+	if (Info.Format != ECDGFramePixelFormat::BGRA8 || FrameBytes <= 0)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Encoder pipe needs 8-bit BGRA frames, got %s %dx%d"),
+			GetFramePixelFormatName(Info.Format), Info.Size.X, Info.Size.Y);
+		return false;
+	}
+
+	IFileManager::Get().MakeDirectory(*Info.OutputDir, /*Tree=*/true);
+	OutputPath = FPaths::ConvertRelativePathToFull(FPaths::Combine(Info.OutputDir, Info.BaseName + TEXT(".mp4")));
+
+	// Raw frames in on stdin, the encoder arguments decide the output; without
+	// any, the encoder's default MP4 codec in a widely playable pixel format.
+	const FString Args = FString::Printf(
+		TEXT("-y -hide_banner -loglevel error -f rawvideo -pix_fmt bgra -video_size %dx%d -framerate %d/%d -i - %s \"%s\""),
+		Info.Size.X, Info.Size.Y, Info.FrameRate.Numerator, Info.FrameRate.Denominator,
+		EncoderArgs.IsEmpty() ? TEXT("-pix_fmt yuv420p -movflags +faststart") : *EncoderArgs, *OutputPath);
+
+	if (!FPlatformProcess::CreatePipe(StdinRead, StdinWrite, /*bWritePipeLocal=*/true))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Could not create the encoder's stdin pipe"));
+		return false;
+	}
+
+	Process = FPlatformProcess::CreateProc(*EncoderPath, *Args, /*bLaunchDetached=*/false, /*bLaunchHidden=*/true,
+		/*bLaunchReallyHidden=*/true, nullptr, 0, nullptr, /*PipeWriteChild=*/nullptr, /*PipeReadChild=*/StdinRead);
+	if (!Process.IsValid())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Could not start encoder: %s %s"), *EncoderPath, *Args);
+		Close();
+		return false;
+	}
+
+	UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[FrameSink] Encoding %dx%d @ %s into %s"),
+		Info.Size.X, Info.Size.Y, *Info.FrameRate.ToPrettyText().ToString(), *OutputPath);
+	return true;
+}
+
+bool FCDGEncoderPipeFrameSink::Write(const FCDGFrame& Frame)
+{
+	if (bFailed || !Process.IsValid()) return false;
+
+	if (Frame.Pixels.Num() != FrameBytes)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Frame %d has %d bytes, expected %lld"),
+			Frame.FrameNumber, Frame.Pixels.Num(), FrameBytes);
+		bFailed = true;
+		return false;
+	}
+
+	// The pipe takes what fits; the encoder drains it as it goes.
+	const uint8* Data      = Frame.Pixels.GetData();
+	int64        Remaining = FrameBytes;
+	while (Remaining > 0)
+	{
+		int32 Written = 0;
+		FPlatformProcess::WritePipe(StdinWrite, Data, static_cast<int32>(FMath::Min<int64>(Remaining, 1 << 20)), &Written);
+		if (Written > 0)
+		{
+			Data      += Written;
+			Remaining -= Written;
+			continue;
+		}
+		if (!FPlatformProcess::IsProcRunning(Process))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Encoder exited while writing frame %d of %s"),
+				Frame.FrameNumber, *OutputPath);
+			bFailed = true;
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
+
+bool FCDGEncoderPipeFrameSink::End()
+{
+	if (!Process.IsValid()) return false;
+
+	// End of stdin is the encoder's end of input.
+	FPlatformProcess::ClosePipe(StdinRead, StdinWrite);
+	StdinRead = StdinWrite = nullptr;
+
+	FPlatformProcess::WaitForProc(Process);
+	int32 ReturnCode = -1;
+	FPlatformProcess::GetProcReturnCode(Process, &ReturnCode);
+	FPlatformProcess::CloseProc(Process);
+
+	const bool bOK = !bFailed && ReturnCode == 0 && IFileManager::Get().FileSize(*OutputPath) > 0;
+	if (!bOK)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Encoder failed (exit code %d): %s"), ReturnCode, *OutputPath);
+	}
+	return bOK;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Chunked raw / YUV files
+// ─────────────────────────────────────────────────────────────────────────────
+
+FCDGChunkedFileFrameSink::FCDGChunkedFileFrameSink(bool bInYUV420, int32 InFramesPerChunk)
+	: bYUV420(bInYUV420)
+	, FramesPerChunk(FMath::Max(1, InFramesPerChunk))
+{
+}
+
+FCDGChunkedFileFrameSink::~FCDGChunkedFileFrameSink()
+{
+	Chunk.Reset();
+}
+
+void FCDGChunkedFileFrameSink::ConvertBGRA8ToI420(const uint8* Src, FIntPoint Size, TArray<uint8>& Out)
+{
+	const int32 W  = Size.X;
+	const int32 H  = Size.Y;
+	const int32 CW = (W + 1) / 2;
+	const int32 CH = (H + 1) / 2;
+	Out.SetNumUninitialized(W * H + 2 * CW * CH);
+
+	uint8* PlaneY = Out.GetData();
+	uint8* PlaneU = PlaneY + W * H;
+	uint8* PlaneV = PlaneU + CW * CH;
+
+	// One task per pair of rows: both luma rows and the chroma row they share.
+	ParallelFor(CH, [&](int32 CY)
+	{
+		for (int32 Y = CY * 2; Y < FMath::Min(CY * 2 + 2, H); ++Y)
+		{
+			const uint8* Row  = Src + int64(Y) * W * 4;
+			uint8*       RowY = PlaneY + int64(Y) * W;
+			for (int32 X = 0; X < W; ++X)
+			{
+				const int32 B = Row[X * 4 + 0], G = Row[X * 4 + 1], R = Row[X * 4 + 2];
+				RowY[X] = static_cast<uint8>(((66 * R + 129 * G + 25 * B + 128) >> 8) + 16);
+			}
+		}
+
+		for (int32 CX = 0; CX < CW; ++CX)
+		{
+			int32 R = 0, G = 0, B = 0, N = 0;
+			for (int32 Y = CY * 2; Y < FMath::Min(CY * 2 + 2, H); ++Y)
+			{
+				for (int32 X = CX * 2; X < FMath::Min(CX * 2 + 2, W); ++X)
+				{
+					const uint8* Pixel = Src + (int64(Y) * W + X) * 4;
+					B += Pixel[0]; G += Pixel[1]; R += Pixel[2]; ++N;
+				}
+			}
+			R /= N; G /= N; B /= N;
+			PlaneU[CY * CW + CX] = static_cast<uint8>(((-38 * R - 74 * G + 112 * B + 128) >> 8) + 128);
+			PlaneV[CY * CW + CX] = static_cast<uint8>(((112 * R - 94 * G - 18 * B + 128) >> 8) + 128);
+		}
+	});
+}
+
+bool FCDGChunkedFileFrameSink::Begin(const FCDGFrameStreamInfo& InInfo)
+{
+	Chunk.Reset();
+	ChunkFiles.Reset();
+	Info          = InInfo;
+	FramesInChunk = 0;
+	NumFrames     = 0;
+	FirstFrame    = INDEX_NONE;
+	bFailed       = false;
+
+	if (Info.GetFrameBytes() <= 0 || (bYUV420 && Info.Format != ECDGFramePixelFormat::BGRA8))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] %s chunks cannot take %s %dx%d frames"),
+			bYUV420 ? TEXT("YUV") : TEXT("Raw"), GetFramePixelFormatName(Info.Format), Info.Size.X, Info.Size.Y);
+		return false;
+	}
+
+	IFileManager::Get().MakeDirectory(*Info.OutputDir, /*Tree=*/true);
+	ManifestPath = FPaths::Combine(Info.OutputDir, Info.BaseName + TEXT(".frames.json"));
+	return true;
+}
+
+bool FCDGChunkedFileFrameSink::OpenChunk()
+{
+	if (Chunk.IsValid())
+	{
+		Chunk->Close();
+		if (Chunk->IsError()) return false;
+	}
+
+	const FString Path = FPaths::Combine(Info.OutputDir, FString::Printf(TEXT("%s.%04d.%s"),
+		*Info.BaseName, ChunkFiles.Num(), bYUV420 ? TEXT("yuv") : TEXT("raw")));
+	Chunk.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Chunk.IsValid()) return false;
+
+	ChunkFiles.Add(FPaths::ConvertRelativePathToFull(Path));
+	FramesInChunk = 0;
+	return true;
+}
+
+bool FCDGChunkedFileFrameSink::Write(const FCDGFrame& Frame)
+{
+	if (bFailed) return false;
+
+	if (Frame.Pixels.Num() != Info.GetFrameBytes()
+		|| ((!Chunk.IsValid() || FramesInChunk >= FramesPerChunk) && !OpenChunk()))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Could not write frame %d of %s"),
+			Frame.FrameNumber, *Info.BaseName);
+		bFailed = true;
+		return false;
+	}
+
+	if (bYUV420)
+	{
+		ConvertBGRA8ToI420(Frame.Pixels.GetData(), Info.Size, Converted);
+		Chunk->Serialize(Converted.GetData(), Converted.Num());
+	}
+	else
+	{
+		Chunk->Serialize(const_cast<uint8*>(Frame.Pixels.GetData()), Frame.Pixels.Num());
+	}
+
+	if (FirstFrame == INDEX_NONE) FirstFrame = Frame.FrameNumber;
+	++FramesInChunk;
+	++NumFrames;
+	bFailed = Chunk->IsError();
+	return !bFailed;
+}
+
+bool FCDGChunkedFileFrameSink::End()
+{
+	if (Chunk.IsValid())
+	{
+		Chunk->Close();
+		bFailed |= Chunk->IsError();
+		Chunk.Reset();
+	}
+	return !bFailed && NumFrames > 0 && WriteManifest();
+}
+
+TArray<FString> FCDGChunkedFileFrameSink::GetOutputFiles() const
+{
+	TArray<FString> Files = ChunkFiles;
+	Files.Add(FPaths::ConvertRelativePathToFull(ManifestPath));
+	return Files;
+}
+
+bool FCDGChunkedFileFrameSink::WriteManifest() const
+{
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Width"),          Info.Size.X);
+	Root->SetNumberField(TEXT("Height"),         Info.Size.Y);
+	Root->SetStringField(TEXT("PixelFormat"),    bYUV420 ? TEXT("yuv420p") : GetFramePixelFormatName(Info.Format));
+	Root->SetStringField(TEXT("FrameRate"),      FString::Printf(TEXT("%d/%d"), Info.FrameRate.Numerator, Info.FrameRate.Denominator));
+	Root->SetNumberField(TEXT("FrameBytes"),     bYUV420 ? Converted.Num() : Info.GetFrameBytes());
+	Root->SetNumberField(TEXT("FirstFrame"),     FirstFrame);
+	Root->SetNumberField(TEXT("FrameCount"),     NumFrames);
+	Root->SetNumberField(TEXT("FramesPerChunk"), FramesPerChunk);
+
+	TArray<TSharedPtr<FJsonValue>> Chunks;
+	for (const FString& File : ChunkFiles)
+	{
+		Chunks.Add(MakeShared<FJsonValueString>(FPaths::GetCleanFilename(File)));
+	}
+	Root->SetArrayField(TEXT("Chunks"), Chunks);
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	return FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)
+		&& FFileHelper::SaveStringToFile(JsonText, *ManifestPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Tar shards
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Shared sets by <full OutputDir>/<ShardSetName>.  MRQ renders a combo's shots
+// as separate jobs, each with its own sink, so the set has to outlive them.
+static TMap<FString, TSharedPtr<FCDGTarShardWriter>> GTarShardSets;
+
+static TSharedPtr<FCDGTarShardWriter> AcquireTarShardSet(const FString& OutputDir, const FString& Name, int64 MaxShardBytes)
+{
+	const FString SetPath = FPaths::Combine(FPaths::ConvertRelativePathToFull(OutputDir), Name);
+	if (const TSharedPtr<FCDGTarShardWriter>* Existing = GTarShardSets.Find(SetPath))
+	{
+		return *Existing;
+	}
+
+	TSharedPtr<FCDGTarShardWriter> Writer = MakeShared<FCDGTarShardWriter>();
+	if (!Writer->Begin(OutputDir, Name, MaxShardBytes))
+	{
+		return nullptr;
+	}
+	GTarShardSets.Add(SetPath, Writer);
+	return Writer;
+}
+
+bool CloseTarShardSets(const FString& OutputDir)
+{
+	check(IsInGameThread());
+
+	const FString Dir = OutputDir.IsEmpty() ? FString() : FPaths::ConvertRelativePathToFull(OutputDir);
+	bool bOK = true;
+	for (auto It = GTarShardSets.CreateIterator(); It; ++It)
+	{
+		if (!Dir.IsEmpty() && FPaths::GetPath(It.Key()) != Dir)
+		{
+			continue;
+		}
+		if (!It.Value()->End())
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Could not close the tar shard set %s"), *It.Key());
+			bOK = false;
+		}
+		else
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[FrameSink] Closed tar shard set %s: %d sample(s) in %d file(s)"),
+				*It.Key(), It.Value()->GetNumSamples(), It.Value()->GetOutputFiles().Num() - 1);
+		}
+		It.RemoveCurrent();
+	}
+	return bOK;
+}
+
+FCDGTarShardFrameSink::FCDGTarShardFrameSink(const FCDGImageWriteSettings& InImageWrite, int32 InShardSizeMB, const FString& InShardSetName)
+	: ImageWrite(InImageWrite)
+	, MaxShardBytes(int64(FMath::Max(1, InShardSizeMB)) * 1024 * 1024)
+	, MaxInFlight(FMath::Max(2, FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 2))
+	, ShardSetName(InShardSetName)
+{
+	if (ImageWrite.Codec == ECDGImageCodec::Engine)
+	{
+		ImageWrite.Codec = ECDGImageCodec::PNG;
+	}
+}
+
+FCDGTarShardFrameSink::~FCDGTarShardFrameSink()
+{
+	// Encodes reference nothing of ours once launched, but wait so none outlive the sink.
+	for (FPendingFrame& Frame : Pending)
+	{
+		Frame.Image.Wait();
+	}
+}
+
+bool FCDGTarShardFrameSink::Begin(const FCDGFrameStreamInfo& InInfo)
+{
+	Pending.Reset();
+	Info       = InInfo;
+	NumFrames  = 0;
+	NumWritten = 0;
+	bFailed    = false;
+
+	if (Info.Format != ECDGFramePixelFormat::BGRA8 || Info.GetFrameBytes() <= 0)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Tar shards need 8-bit BGRA frames, got %s %dx%d"),
+			GetFramePixelFormatName(Info.Format), Info.Size.X, Info.Size.Y);
+		return false;
+	}
+
+	// A set of its own is opened by the first stream and kept for the next ones.
+	if (!Writer.IsValid() || !Writer->IsOpen())
+	{
+		if (ShardSetName.IsEmpty())
+		{
+			Writer = MakeShared<FCDGTarShardWriter>();
+			if (!Writer->Begin(Info.OutputDir, Info.BaseName, MaxShardBytes))
+			{
+				Writer.Reset();
+			}
+		}
+		else
+		{
+			Writer = AcquireTarShardSet(Info.OutputDir, ShardSetName, MaxShardBytes);
+		}
+	}
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] No open tar shard set for %s"), *Info.BaseName);
+		return false;
+	}
+	Writer->BeginStream(Info.BaseName);
+	return true;
+}
+
+bool FCDGTarShardFrameSink::Write(const FCDGFrame& Frame)
+{
+	if (bFailed) return false;
+
+	if (Frame.Pixels.Num() != Info.GetFrameBytes())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Frame %d has %d bytes, expected %lld"),
+			Frame.FrameNumber, Frame.Pixels.Num(), Info.GetFrameBytes());
+		bFailed = true;
+		return false;
+	}
+
+	// Bounded: the oldest frame is written before another encode starts.
+	if (Pending.Num() >= MaxInFlight && !WriteOldest())
+	{
+		return false;
+	}
+
+	TArray64<uint8> Pixels(Frame.Pixels.GetData(), Frame.Pixels.Num());
+	FPendingFrame& Entry = Pending.AddDefaulted_GetRef();
+	Entry.FrameNumber = Frame.FrameNumber;
+	Entry.StreamIndex = NumFrames++;
+	Entry.Image = Async(EAsyncExecution::ThreadPool,
+		[Settings = ImageWrite, Size = Info.Size, Pixels = MoveTemp(Pixels)]()
+		{
+			TArray64<uint8> Encoded;
+			FCDGImageWritePool::Encode(Settings, Size, Pixels.GetData(), Encoded);
+			return Encoded;
+		});
+	return true;
+}
+
+bool FCDGTarShardFrameSink::WriteOldest()
+{
+	FPendingFrame Frame = MoveTemp(Pending[0]);
+	Pending.RemoveAt(0);
+
+	const TArray64<uint8>& Image = Frame.Image.Get();
+	if (Image.Num() == 0)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[FrameSink] Could not encode frame %d of %s"), Frame.FrameNumber, *Info.BaseName);
+		bFailed = true;
+		return false;
+	}
+
+	// Trajectory index entry for this frame, or just its number when there is none.
+	const FString Metadata = Info.FrameMetadata.IsValidIndex(Frame.StreamIndex)
+		? Info.FrameMetadata[Frame.StreamIndex]
+		: FString::Printf(TEXT("{\"FrameIndex\":%d}"), Frame.FrameNumber);
+	const FTCHARToUTF8 MetadataUtf8(*Metadata);
+
+	const FCDGTarMember Members[] =
+	{
+		{ FCDGImageWritePool::GetExtension(ImageWrite.Codec), TConstArrayView64<uint8>(Image) },
+		{ TEXT("json"), TConstArrayView64<uint8>(reinterpret_cast<const uint8*>(MetadataUtf8.Get()), MetadataUtf8.Length()) },
+	};
+	bFailed = !Writer->WriteSample(FCDGTarShardWriter::MakeKey(Info.BaseName, Frame.FrameNumber), Members);
+	NumWritten += bFailed ? 0 : 1;
+	return !bFailed;
+}
+
+bool FCDGTarShardFrameSink::End()
+{
+	while (Pending.Num() > 0)
+	{
+		if (!WriteOldest())
+		{
+			for (FPendingFrame& Frame : Pending) Frame.Image.Wait();
+			Pending.Reset();
+			break;
+		}
+	}
+	// The set stays open for the next stream; Finish() or CloseTarShardSets() closes it.
+	return !bFailed && NumWritten > 0;
+}
+
+bool FCDGTarShardFrameSink::Finish()
+{
+	// A shared set is left to CloseTarShardSets(); the next shot may still write into it.
+	return !Writer.IsValid() || !ShardSetName.IsEmpty() || Writer->End();
+}
+
+TArray<FString> FCDGTarShardFrameSink::GetOutputFiles() const
+{
+	return Writer.IsValid() ? Writer->GetOutputFiles() : TArray<FString>();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Callback
+// ─────────────────────────────────────────────────────────────────────────────
+
+FCDGCallbackFrameSink::FCDGCallbackFrameSink(FOnFrame InOnFrame, TFunction<bool(const FCDGFrameStreamInfo&)> InOnEnd)
+	: OnFrame(MoveTemp(InOnFrame))
+	, OnEnd(MoveTemp(InOnEnd))
+{
+}
+
+bool FCDGCallbackFrameSink::Begin(const FCDGFrameStreamInfo& InInfo)
+{
+	Info    = InInfo;
+	bFailed = !OnFrame;
+	return !bFailed;
+}
+
+bool FCDGCallbackFrameSink::Write(const FCDGFrame& Frame)
+{
+	if (bFailed) return false;
+	bFailed = !OnFrame(Info, Frame);
+	return !bFailed;
+}
+
+bool FCDGCallbackFrameSink::End()
+{
+	return !bFailed && (!OnEnd || OnEnd(Info));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Tests
+// ─────────────────────────────────────────────────────────────────────────────
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Pushes two short synthetic streams through every built-in sink (the encoder
+// pipe only when FFmpeg is found), no rendering or GPU involved, into
+// <Saved>/CDGFrameSinkTest/.  Every call must succeed and each stream's output
+// must read back through CDGOutputValidator as the frames and size pushed;
+// tar streams are checked both in a set of their own and in a shared set.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCDGFrameSinkStreamsTest, "CameraDatasetGen.FrameSink.Streams",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCDGFrameSinkStreamsTest::RunTest(const FString& Parameters)
+{
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("CDGFrameSinkTest"));
+	IFileManager::Get().DeleteDirectory(*OutputDir, /*RequireExists=*/false, /*Tree=*/true);
+
+	constexpr int32 NumFrames = 12;
+	const FIntPoint Size(64, 36);
+
+	// Moving gradient, so encoders see motion rather than a still frame.
+	auto PushStream = [&](ICDGFrameSink& Sink, const FString& BaseName)
+	{
+		FCDGFrameStreamInfo Info;
+		Info.OutputDir = OutputDir;
+		Info.BaseName  = BaseName;
+		Info.Size      = Size;
+		Info.Format    = ECDGFramePixelFormat::BGRA8;
+		if (!TestTrue(FString::Printf(TEXT("%s: Begin"), *BaseName), Sink.Begin(Info)))
+		{
+			return;
+		}
+
+		TArray<uint8> Pixels;
+		Pixels.SetNumUninitialized(Info.GetFrameBytes());
+		bool bWritten = true;
+		for (int32 Frame = 0; Frame < NumFrames && bWritten; ++Frame)
+		{
+			for (int32 Y = 0; Y < Size.Y; ++Y)
+			{
+				uint8* Row = Pixels.GetData() + int64(Y) * Size.X * 4;
+				for (int32 X = 0; X < Size.X; ++X)
+				{
+					Row[X * 4 + 0] = static_cast<uint8>(X + Frame * 4);
+					Row[X * 4 + 1] = static_cast<uint8>(Y + Frame * 2);
+					Row[X * 4 + 2] = static_cast<uint8>((X ^ Y) + Frame);
+					Row[X * 4 + 3] = 255;
+				}
+			}
+			bWritten = Sink.Write(FCDGFrame{ Frame, Pixels });
+		}
+		TestTrue(FString::Printf(TEXT("%s: every Write"), *BaseName), bWritten);
+		TestTrue(FString::Printf(TEXT("%s: End"), *BaseName), Sink.End());
+	};
+
+	auto CheckOutput = [&](ECDGOutputKind Kind, const FString& BaseName, const FString& ShardSetName = FString())
+	{
+		FCDGExpectedOutput Expected;
+		Expected.ShotName     = BaseName;
+		Expected.OutputDir    = OutputDir;
+		Expected.FileNameBase = BaseName;
+		Expected.ShardSetName = ShardSetName;
+		Expected.Kind         = Kind;
+		Expected.Size         = Size;
+		Expected.NumFrames    = NumFrames;
+		const FCDGValidationResult Result = CDGOutputValidator::ValidateOutput(Expected);
+		TestTrue(FString::Printf(TEXT("%s validates (%s)"), *BaseName, *FString::Join(Result.Errors, TEXT("; "))), Result.bValid);
+		if (Kind != ECDGOutputKind::Video) // clips may be a frame off, which the validator allows
+		{
+			TestEqual(FString::Printf(TEXT("%s: frames read back"), *BaseName), Result.NumFrames, NumFrames);
+		}
+		TestTrue(FString::Printf(TEXT("%s: size read back as %dx%d"), *BaseName, Result.Size.X, Result.Size.Y), Result.Size == Size);
+	};
+
+	for (const ECDGFrameSinkKind Kind : { ECDGFrameSinkKind::RawChunks, ECDGFrameSinkKind::YUVChunks,
+	                                      ECDGFrameSinkKind::TarShards, ECDGFrameSinkKind::EncoderPipe })
+	{
+		FCDGFrameSinkSettings Settings;
+		Settings.Kind           = Kind;
+		Settings.FramesPerChunk = 5;
+		if (Kind == ECDGFrameSinkKind::EncoderPipe)
+		{
+			// Same codec pick and arguments a render job's encoder pipe gets
+			if (!CDGMRQInterface::Internal::EnsureFFmpegAvailable(Settings.EncoderPath))
+			{
+				AddWarning(TEXT("FFmpeg not found; the encoder pipe sink was not tested"));
+				continue;
+			}
+			Settings.EncoderArgs = CDGMRQInterface::Internal::MakeEncoderPipeArgs(Settings.EncoderPath, FCDGVideoEncodeSettings());
+		}
+
+		// One sink, two streams: sinks are reused from shot to shot
+		const FString KindName = StaticEnum<ECDGFrameSinkKind>()->GetNameStringByValue(int64(Kind));
+		const FString Bases[2] = { KindName + TEXT(".ShotA"), KindName + TEXT(".ShotB") };
+		TUniquePtr<ICDGFrameSink> Sink = MakeFrameSink(Settings);
+		if (!TestNotNull(*FString::Printf(TEXT("%s sink"), *KindName), Sink.Get()))
+		{
+			continue;
+		}
+		for (const FString& Base : Bases)
+		{
+			PushStream(*Sink, Base);
+		}
+		TestTrue(FString::Printf(TEXT("%s: Finish"), *KindName), Sink->Finish());
+		for (const FString& File : Sink->GetOutputFiles())
+		{
+			TestTrue(FString::Printf(TEXT("%s: %s is written"), *KindName, *FPaths::GetCleanFilename(File)),
+				IFileManager::Get().FileSize(*File) > 0);
+		}
+
+		const ECDGOutputKind OutputKind = Kind == ECDGFrameSinkKind::EncoderPipe ? ECDGOutputKind::Video
+			: Kind == ECDGFrameSinkKind::TarShards ? ECDGOutputKind::TarShards
+			: ECDGOutputKind::Chunks;
+		for (const FString& Base : Bases)
+		{
+			// A tar sink without a set name keeps its first stream's set for the next one
+			CheckOutput(OutputKind, Base, Kind == ECDGFrameSinkKind::TarShards ? Bases[0] : FString());
+		}
+	}
+
+	// Two sinks, one shared set: one index, and each stream still reads back on its own
+	{
+		FCDGFrameSinkSettings Settings;
+		Settings.Kind         = ECDGFrameSinkKind::TarShards;
+		Settings.ShardSetName = TEXT("Shared");
+		const FString Bases[2] = { TEXT("Shared.ShotA"), TEXT("Shared.ShotB") };
+		for (const FString& Base : Bases)
+		{
+			TUniquePtr<ICDGFrameSink> Sink = MakeFrameSink(Settings);
+			PushStream(*Sink, Base);
+			TestTrue(FString::Printf(TEXT("%s: Finish"), *Base), Sink->Finish());
+		}
+		TestFalse(TEXT("The shared index waits for CloseTarShardSets"),
+			IFileManager::Get().FileExists(*FPaths::Combine(OutputDir, TEXT("Shared.shards.json"))));
+		TestTrue(TEXT("CloseTarShardSets"), CloseTarShardSets(OutputDir));
+
+		for (const FString& Base : Bases)
+		{
+			CheckOutput(ECDGOutputKind::TarShards, Base, Settings.ShardSetName);
+		}
+		TArray<FString> Indices;
+		IFileManager::Get().FindFiles(Indices, *FPaths::Combine(OutputDir, TEXT("Shared*.shards.json")), true, false);
+		TestEqual(TEXT("Shared set index files"), Indices.Num(), 1);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,466 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MRQInterface/CDGImageWritePool.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/IQueuedWork.h"
+#include "Misc/QueuedThreadPool.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+static constexpr double kBytesPerMB = 1024.0 * 1024.0;
+
+FString FCDGImageWriteStats::ToString() const
+{
+	return FString::Printf(TEXT("%d frame(s), %.1f MB (%.1f %% of raw): %.1f s encoding, %.1f s writing, %.1f s stalled (%d failed)"),
+		NumWritten, FileBytes / kBytesPerMB, RawBytes > 0 ? 100.0 * FileBytes / RawBytes : 0.0,
+		EncodeSeconds, WriteSeconds, StallSeconds, NumFailed);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Pool
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** One frame; deletes itself once done or abandoned. */
+class FCDGImageWritePool::FWriteWork : public IQueuedWork
+{
+public:
+	FWriteWork(FCDGImageWritePool& InPool, FString InFilename, FIntPoint InSize, TArray64<uint8>&& InBGRA)
+		: Pool(InPool), Filename(MoveTemp(InFilename)), Size(InSize), BGRA(MoveTemp(InBGRA))
+	{
+	}
+
+	virtual void DoThreadedWork() override
+	{
+		Pool.Process(Filename, Size, BGRA);
+		delete this;
+	}
+
+	virtual void Abandon() override
+	{
+		// Only happens when the pool shuts down with work queued; count it as lost.
+		{
+			FScopeLock Lock(&Pool.StatsLock);
+			++Pool.Stats.NumFailed;
+		}
+		--Pool.InFlight;
+		Pool.SlotFreed->Trigger();
+		delete this;
+	}
+
+private:
+	FCDGImageWritePool& Pool;
+	FString             Filename;
+	FIntPoint           Size;
+	TArray64<uint8>     BGRA;
+};
+
+FCDGImageWritePool::FCDGImageWritePool(const FCDGImageWriteSettings& InSettings)
+	: Settings(InSettings)
+{
+	NumWorkers = Settings.NumWorkers > 0
+		? Settings.NumWorkers
+		: FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 2);
+	MaxQueued  = Settings.MaxQueuedFrames > 0 ? Settings.MaxQueuedFrames : NumWorkers * 2;
+
+	SlotFreed = FPlatformProcess::GetSynchEventFromPool(/*bIsManualReset=*/false);
+	Workers   = FQueuedThreadPool::Allocate();
+	Workers->Create(NumWorkers, 128 * 1024, TPri_BelowNormal, TEXT("CDGImageWritePool"));
+}
+
+FCDGImageWritePool::~FCDGImageWritePool()
+{
+	Flush();
+	Workers->Destroy();
+	delete Workers;
+	FPlatformProcess::ReturnSynchEventToPool(SlotFreed);
+}
+
+void FCDGImageWritePool::Enqueue(const FString& FilenameNoExt, FIntPoint Size, TArray64<uint8>&& BGRA)
+{
+	// Back-pressure: the render thread waits here rather than queueing unbounded frames.
+	if (InFlight.load() >= MaxQueued)
+	{
+		const double Start = FPlatformTime::Seconds();
+		while (InFlight.load() >= MaxQueued)
+		{
+			SlotFreed->Wait(10);
+		}
+		FScopeLock Lock(&StatsLock);
+		Stats.StallSeconds += FPlatformTime::Seconds() - Start;
+	}
+
+	++InFlight;
+	const FString Filename = FilenameNoExt + TEXT(".") + GetExtension(Settings.Codec);
+	Workers->AddQueuedWork(new FWriteWork(*this, Filename, Size, MoveTemp(BGRA)));
+}
+
+void FCDGImageWritePool::Flush()
+{
+	while (InFlight.load() > 0)
+	{
+		SlotFreed->Wait(10);
+	}
+}
+
+FCDGImageWriteStats FCDGImageWritePool::GetStats() const
+{
+	FScopeLock Lock(&StatsLock);
+	return Stats;
+}
+
+void FCDGImageWritePool::Process(const FString& Filename, FIntPoint Size, const TArray64<uint8>& BGRA)
+{
+	const double EncodeStart = FPlatformTime::Seconds();
+	TArray64<uint8> File;
+	bool bOK = BGRA.Num() == int64(Size.X) * Size.Y * 4 && Encode(Settings, Size, BGRA.GetData(), File);
+
+	const double WriteStart = FPlatformTime::Seconds();
+	bOK = bOK && FFileHelper::SaveArrayToFile(File, *Filename);
+	const double WriteEnd = FPlatformTime::Seconds();
+
+	if (!bOK)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Could not write %s"), *Filename);
+	}
+
+	{
+		FScopeLock Lock(&StatsLock);
+		(bOK ? Stats.NumWritten : Stats.NumFailed)++;
+		Stats.RawBytes      += bOK ? BGRA.Num() : 0;
+		Stats.FileBytes     += bOK ? File.Num() : 0;
+		Stats.EncodeSeconds += WriteStart - EncodeStart;
+		Stats.WriteSeconds  += WriteEnd - WriteStart;
+	}
+
+	--InFlight;
+	SlotFreed->Trigger();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Encoders
+// ─────────────────────────────────────────────────────────────────────────────
+
+const TCHAR* FCDGImageWritePool::GetExtension(ECDGImageCodec Codec)
+{
+	switch (Codec)
+	{
+	case ECDGImageCodec::QOI: return TEXT("qoi");
+	case ECDGImageCodec::BMP: return TEXT("bmp");
+	default:                  return TEXT("png");
+	}
+}
+
+bool FCDGImageWritePool::Encode(const FCDGImageWriteSettings& InSettings, FIntPoint Size, const uint8* BGRA, TArray64<uint8>& Out)
+{
+	if (Size.X <= 0 || Size.Y <= 0 || !BGRA) return false;
+
+	switch (InSettings.Codec)
+	{
+	case ECDGImageCodec::PNG:
+		EncodePNG(Size, BGRA, InSettings.bWriteAlpha, InSettings.PNGCompressionLevel, InSettings.PNGFilter, Out);
+		return Out.Num() > 0;
+	case ECDGImageCodec::QOI:
+		EncodeQOI(Size, BGRA, InSettings.bWriteAlpha, Out);
+		return true;
+	case ECDGImageCodec::BMP:
+		EncodeBMP(Size, BGRA, InSettings.bWriteAlpha, Out);
+		return true;
+	default:
+		return false;
+	}
+}
+
+namespace
+{
+	void AppendBE32(TArray64<uint8>& Out, uint32 Value)
+	{
+		Out.Add(uint8(Value >> 24));
+		Out.Add(uint8(Value >> 16));
+		Out.Add(uint8(Value >> 8));
+		Out.Add(uint8(Value));
+	}
+
+	void AppendLE32(TArray64<uint8>& Out, uint32 Value)
+	{
+		Out.Add(uint8(Value));
+		Out.Add(uint8(Value >> 8));
+		Out.Add(uint8(Value >> 16));
+		Out.Add(uint8(Value >> 24));
+	}
+
+	void AppendLE16(TArray64<uint8>& Out, uint16 Value)
+	{
+		Out.Add(uint8(Value));
+		Out.Add(uint8(Value >> 8));
+	}
+
+	/** Length, type, data, CRC over type + data. */
+	void AppendPNGChunk(TArray64<uint8>& Out, const char (&Type)[5], const uint8* Data, uint32 Len)
+	{
+		AppendBE32(Out, Len);
+		Out.Append(reinterpret_cast<const uint8*>(Type), 4);
+		if (Len > 0) Out.Append(Data, Len);
+
+		uLong Crc = crc32(0L, reinterpret_cast<const Bytef*>(Type), 4);
+		if (Len > 0) Crc = crc32(Crc, Data, Len);
+		AppendBE32(Out, uint32(Crc));
+	}
+
+	uint8 Paeth(int32 A, int32 B, int32 C)
+	{
+		const int32 P  = A + B - C;
+		const int32 PA = FMath::Abs(P - A);
+		const int32 PB = FMath::Abs(P - B);
+		const int32 PC = FMath::Abs(P - C);
+		return uint8(PA <= PB && PA <= PC ? A : (PB <= PC ? B : C));
+	}
+
+	/** Filter one row of Stride bytes into Dst (type byte excluded); returns the sum of |signed byte|. */
+	uint64 FilterRow(ECDGPNGFilter Filter, const uint8* Cur, const uint8* Prev, int32 Stride, int32 Bpp, uint8* Dst)
+	{
+		uint64 Sum = 0;
+		for (int32 i = 0; i < Stride; ++i)
+		{
+			const int32 A = i >= Bpp ? Cur[i - Bpp] : 0;
+			const int32 B = Prev[i];
+			const int32 C = i >= Bpp ? Prev[i - Bpp] : 0;
+
+			uint8 Value = Cur[i];
+			switch (Filter)
+			{
+			case ECDGPNGFilter::Sub:     Value -= uint8(A);              break;
+			case ECDGPNGFilter::Up:      Value -= uint8(B);              break;
+			case ECDGPNGFilter::Average: Value -= uint8((A + B) >> 1);   break;
+			case ECDGPNGFilter::Paeth:   Value -= Paeth(A, B, C);        break;
+			default:                                                     break;
+			}
+			Dst[i] = Value;
+			Sum += FMath::Abs(int32(int8(Value)));
+		}
+		return Sum;
+	}
+}
+
+void FCDGImageWritePool::EncodePNG(FIntPoint Size, const uint8* BGRA, bool bAlpha, int32 Level, ECDGPNGFilter Filter, TArray64<uint8>& Out)
+{
+	const int32 W      = Size.X;
+	const int32 H      = Size.Y;
+	const int32 Bpp    = bAlpha ? 4 : 3;
+	const int32 Stride = W * Bpp;
+
+	// BGRA → RGB(A), then filter each row against the unfiltered row above.
+	TArray64<uint8> Raw;
+	Raw.SetNumUninitialized(int64(Stride) * H);
+	for (int64 i = 0, N = int64(W) * H; i < N; ++i)
+	{
+		uint8* Dst = Raw.GetData() + i * Bpp;
+		Dst[0] = BGRA[i * 4 + 2];
+		Dst[1] = BGRA[i * 4 + 1];
+		Dst[2] = BGRA[i * 4 + 0];
+		if (bAlpha) Dst[3] = BGRA[i * 4 + 3];
+	}
+
+	TArray64<uint8> Filtered;
+	Filtered.SetNumUninitialized(int64(Stride + 1) * H);
+	TArray<uint8> ZeroRow;
+	ZeroRow.SetNumZeroed(Stride);
+	TArray<uint8> Trial;
+	Trial.SetNumUninitialized(Stride);
+
+	for (int32 Y = 0; Y < H; ++Y)
+	{
+		const uint8* Cur  = Raw.GetData() + int64(Y) * Stride;
+		const uint8* Prev = Y > 0 ? Cur - Stride : ZeroRow.GetData();
+		uint8*       Dst  = Filtered.GetData() + int64(Y) * (Stride + 1);
+
+		if (Filter != ECDGPNGFilter::Adaptive)
+		{
+			Dst[0] = uint8(Filter);
+			FilterRow(Filter, Cur, Prev, Stride, Bpp, Dst + 1);
+			continue;
+		}
+
+		uint64 Best = MAX_uint64;
+		for (ECDGPNGFilter Candidate : { ECDGPNGFilter::None, ECDGPNGFilter::Sub, ECDGPNGFilter::Up, ECDGPNGFilter::Average, ECDGPNGFilter::Paeth })
+		{
+			const uint64 Sum = FilterRow(Candidate, Cur, Prev, Stride, Bpp, Trial.GetData());
+			if (Sum < Best)
+			{
+				Best   = Sum;
+				Dst[0] = uint8(Candidate);
+				FMemory::Memcpy(Dst + 1, Trial.GetData(), Stride);
+			}
+		}
+	}
+
+	uLongf CompressedSize = compressBound(uLong(Filtered.Num()));
+	TArray64<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (compress2(Compressed.GetData(), &CompressedSize, Filtered.GetData(), uLong(Filtered.Num()), FMath::Clamp(Level, 0, 9)) != Z_OK)
+	{
+		Out.Reset();
+		return;
+	}
+
+	static const uint8 Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	Out.Reset(CompressedSize + 64);
+	Out.Append(Signature, 8);
+
+	TArray64<uint8> Header;
+	AppendBE32(Header, W);
+	AppendBE32(Header, H);
+	Header.Add(8);                  // bit depth
+	Header.Add(bAlpha ? 6 : 2);     // RGBA / RGB
+	Header.Add(0);                  // deflate
+	Header.Add(0);                  // adaptive filtering
+	Header.Add(0);                  // no interlace
+	AppendPNGChunk(Out, "IHDR", Header.GetData(), uint32(Header.Num()));
+
+	// IDAT in 1 MB pieces keeps every chunk far below the 2^31 limit.
+	constexpr int64 MaxIDAT = 1 << 20;
+	for (int64 Offset = 0; Offset < int64(CompressedSize); Offset += MaxIDAT)
+	{
+		AppendPNGChunk(Out, "IDAT", Compressed.GetData() + Offset, uint32(FMath::Min<int64>(MaxIDAT, CompressedSize - Offset)));
+	}
+	AppendPNGChunk(Out, "IEND", nullptr, 0);
+}
+
+void FCDGImageWritePool::EncodeQOI(FIntPoint Size, const uint8* BGRA, bool bAlpha, TArray64<uint8>& Out)
+{
+	// https://qoiformat.org/qoi-specification.pdf
+	struct FPixel { uint8 R, G, B, A; bool operator==(const FPixel& O) const { return FMemory::Memcmp(this, &O, 4) == 0; } };
+
+	const int64 NumPixels = int64(Size.X) * Size.Y;
+	Out.Reset(14 + NumPixels * (bAlpha ? 5 : 4) + 8);
+
+	Out.Append(reinterpret_cast<const uint8*>("qoif"), 4);
+	AppendBE32(Out, Size.X);
+	AppendBE32(Out, Size.Y);
+	Out.Add(bAlpha ? 4 : 3);
+	Out.Add(0);   // sRGB with linear alpha
+
+	FPixel Index[64];
+	FMemory::Memzero(Index, sizeof(Index));
+	FPixel Prev = { 0, 0, 0, 255 };
+	int32  Run  = 0;
+
+	for (int64 i = 0; i < NumPixels; ++i)
+	{
+		const uint8* Src = BGRA + i * 4;
+		const FPixel Px  = { Src[2], Src[1], Src[0], bAlpha ? Src[3] : uint8(255) };
+
+		if (Px == Prev)
+		{
+			if (++Run == 62 || i == NumPixels - 1)
+			{
+				Out.Add(uint8(0xC0 | (Run - 1)));   // QOI_OP_RUN
+				Run = 0;
+			}
+			continue;
+		}
+
+		if (Run > 0)
+		{
+			Out.Add(uint8(0xC0 | (Run - 1)));
+			Run = 0;
+		}
+
+		const int32 Hash = (Px.R * 3 + Px.G * 5 + Px.B * 7 + Px.A * 11) % 64;
+		if (Index[Hash] == Px)
+		{
+			Out.Add(uint8(Hash));                 // QOI_OP_INDEX
+		}
+		else
+		{
+			Index[Hash] = Px;
+
+			if (Px.A == Prev.A)
+			{
+				const int8 VR  = int8(Px.R - Prev.R);
+				const int8 VG  = int8(Px.G - Prev.G);
+				const int8 VB  = int8(Px.B - Prev.B);
+				const int8 VGR = int8(VR - VG);
+				const int8 VGB = int8(VB - VG);
+
+				if (VR >= -2 && VR <= 1 && VG >= -2 && VG <= 1 && VB >= -2 && VB <= 1)
+				{
+					Out.Add(uint8(0x40 | (VR + 2) << 4 | (VG + 2) << 2 | (VB + 2)));   // QOI_OP_DIFF
+				}
+				else if (VGR >= -8 && VGR <= 7 && VG >= -32 && VG <= 31 && VGB >= -8 && VGB <= 7)
+				{
+					Out.Add(uint8(0x80 | (VG + 32)));                                  // QOI_OP_LUMA
+					Out.Add(uint8((VGR + 8) << 4 | (VGB + 8)));
+				}
+				else
+				{
+					const uint8 RGB[4] = { 0xFE, Px.R, Px.G, Px.B };                    // QOI_OP_RGB
+					Out.Append(RGB, 4);
+				}
+			}
+			else
+			{
+				const uint8 RGBA[5] = { 0xFF, Px.R, Px.G, Px.B, Px.A };                 // QOI_OP_RGBA
+				Out.Append(RGBA, 5);
+			}
+		}
+		Prev = Px;
+	}
+
+	static const uint8 Padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+	Out.Append(Padding, 8);
+}
+
+void FCDGImageWritePool::EncodeBMP(FIntPoint Size, const uint8* BGRA, bool bAlpha, TArray64<uint8>& Out)
+{
+	// BITMAPFILEHEADER + BITMAPINFOHEADER, bottom-up rows padded to 4 bytes.
+	const int32  Bpp       = bAlpha ? 4 : 3;
+	const int32  RowBytes  = (Size.X * Bpp + 3) & ~3;
+	const uint32 PixelSize = uint32(RowBytes) * Size.Y;
+	const uint32 Offset    = 14 + 40;
+
+	Out.Reset(Offset + PixelSize);
+	Out.Add('B');
+	Out.Add('M');
+	AppendLE32(Out, Offset + PixelSize);
+	AppendLE32(Out, 0);
+	AppendLE32(Out, Offset);
+
+	AppendLE32(Out, 40);
+	AppendLE32(Out, Size.X);
+	AppendLE32(Out, Size.Y);
+	AppendLE16(Out, 1);
+	AppendLE16(Out, uint16(Bpp * 8));
+	AppendLE32(Out, 0);           // BI_RGB
+	AppendLE32(Out, PixelSize);
+	AppendLE32(Out, 2835);        // 72 DPI
+	AppendLE32(Out, 2835);
+	AppendLE32(Out, 0);
+	AppendLE32(Out, 0);
+
+	const int64 Start = Out.Num();
+	Out.AddZeroed(PixelSize);
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		const uint8* Src = BGRA + int64(Size.Y - 1 - Y) * Size.X * 4;
+		uint8*       Dst = Out.GetData() + Start + int64(Y) * RowBytes;
+		if (bAlpha)
+		{
+			FMemory::Memcpy(Dst, Src, int64(Size.X) * 4);
+			continue;
+		}
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			Dst[X * 3 + 0] = Src[X * 4 + 0];
+			Dst[X * 3 + 1] = Src[X * 4 + 1];
+			Dst[X * 3 + 2] = Src[X * 4 + 2];
+		}
+	}
+}
@@ -1,6 +1,9 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "MRQInterface/CDGMRQInterface.h"
+#include "MRQInterface/CDGMoviePipelineFrameSinkOutput.h"
+#include "MRQInterface/CDGMoviePipelineImageWriteOutput.h"
+#include "MRQInterface/CDGOutputValidator.h"
 #include "Trajectory/CDGTrajectory.h"
 #include "Trajectory/CDGKeyframe.h"
 #include "Trajectory/CDGTrajectorySubsystem.h"
@@ -8,6 +11,7 @@
 #include "IO/TrajectorySL.h"
 #include "LogCameraDatasetGenEditor.h"
 #include "LevelSequenceInterface/CDGLevelSeqSubsystem.h"
+#include "LevelSequenceInterface/CDGSequenceBuilder.h"
 
 #include "MoviePipelineQueue.h"
 #include "MoviePipelineQueueEngineSubsystem.h"
@@ -50,13 +54,12 @@
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "UObject/SavePackage.h"
 
-#include "HttpModule.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Interfaces/IHttpResponse.h"
 #include "Misc/FileHelper.h"
 #include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "Async/Async.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/PlatformMisc.h"
 
 #if WITH_EDITOR
 #include "Editor.h"
@@ -102,23 +105,13 @@ namespace CDGMRQInterface
 
 	bool RenderTrajectoriesWithSequence(ULevelSequence* MasterSequence, const TArray<ACDGTrajectory*>& Trajectories, const FTrajectoryRenderConfig& Config, TFunction<void(bool)> OnCompleted, TFunction<void()> OnShotRendered)
 	{
-		// Delegate to the base implementation but intercept the executor's finish event.
-		// We duplicate the executor-binding logic here so that OnCompleted fires after the
-		// existing visualizer-restore and video-cleanup callbacks already in the base overload.
-		// The simplest way is to wrap it: call the base overload on a separate path, but that
-		// would double-bind OnExecutorFinished.  Instead we just implement the full body here
-		// and call the base variant only when no callback is supplied.
-		if (!OnCompleted && !OnShotRendered)
-		{
-			return RenderTrajectoriesWithSequence(MasterSequence, Trajectories, Config);
-		}
-
 		if (Trajectories.Num() == 0)
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: No trajectories provided"));
 			return false;
 		}
 
+		// Validate config
 		if (Config.DestinationRootDir.IsEmpty())
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Destination root directory is empty"));
@@ -131,6 +124,7 @@ namespace CDGMRQInterface
 			return false;
 		}
 
+		// Get world
 		UWorld* World = nullptr;
 #if WITH_EDITOR
 		if (GEditor)
@@ -138,22 +132,33 @@ namespace CDGMRQInterface
 			World = GEditor->GetEditorWorldContext().World();
 		}
 #endif
+
 		if (!World)
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: No valid world context found"));
 			return false;
 		}
 
+		// Get level name (use override from config if provided)
 		FString LevelName = Config.LevelNameOverride.IsEmpty()
 			? [&]{ FString N = World->GetMapName(); N.RemoveFromStart(World->StreamingLevelsPrefix); return N; }()
 			: Config.LevelNameOverride;
 
+		// Validate the provided master sequence
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Validating provided master sequence..."));
+		
 		if (!Internal::ValidateMasterSequence(MasterSequence, Trajectories, LevelName))
 		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Master sequence validation failed."));
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Master sequence validation failed. Please ensure:"));
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  1. All trajectories have corresponding shot sequences"));
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  2. Shot sequences match trajectory data (duration, keyframes)"));
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  3. Re-export the level sequence if trajectories have changed"));
 			return false;
 		}
+		
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Master sequence validation passed"));
 
+		// Setup output directory structure
 		FString LevelOutputDir = Internal::SetupOutputDirectory(Config.DestinationRootDir, LevelName);
 		if (LevelOutputDir.IsEmpty())
 		{
@@ -161,6 +166,7 @@ namespace CDGMRQInterface
 			return false;
 		}
 
+		// Get MRQ subsystem
 		UMoviePipelineQueueEngineSubsystem* MRQSubsystem = GEngine->GetEngineSubsystem<UMoviePipelineQueueEngineSubsystem>();
 		if (!MRQSubsystem)
 		{
@@ -168,12 +174,14 @@ namespace CDGMRQInterface
 			return false;
 		}
 
+		// Guard against starting a new queue while another render is still active.
 		if (UMoviePipelineExecutorBase* ActiveExecutor = MRQSubsystem->GetActiveExecutor())
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Render request ignored because MRQ is already rendering."));
 			return false;
 		}
 
+		// Get or create queue
 		UMoviePipelineQueue* Queue = MRQSubsystem->GetQueue();
 		if (!Queue)
 		{
@@ -181,40 +189,58 @@ namespace CDGMRQInterface
 			return false;
 		}
 
+		// MRQ queue is persistent across runs; clear it so old jobs do not get re-rendered.
 		Queue->DeleteAllJobs();
 
+		// Create jobs for each trajectory using existing shot sequences
 		TArray<UMoviePipelineExecutorJob*> CreatedJobs;
+		TArray<FCDGExpectedOutput> ExpectedOutputs;
 		for (ACDGTrajectory* Trajectory : Trajectories)
 		{
-			if (!Trajectory) continue;
+			if (!Trajectory)
+			{
+				continue;
+			}
 
+			// Find existing shot sequence for this trajectory
 			ULevelSequence* ShotSequence = nullptr;
-			if (!Internal::FindExistingShotSequence(Trajectory, LevelName, ShotSequence))
+			if (!Internal::FindExistingShotSequence(Trajectory, LevelName, ShotSequence, MasterSequence))
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to find shot sequence for trajectory: %s"),
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to find shot sequence for trajectory: %s"), 
 					*Trajectory->TrajectoryName.ToString());
 				continue;
 			}
 
+			// Allocate job
 			UMoviePipelineExecutorJob* Job = Queue->AllocateNewJob(UMoviePipelineExecutorJob::StaticClass());
 			if (!Job)
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to allocate job for trajectory: %s"),
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to allocate job for trajectory: %s"), 
 					*Trajectory->TrajectoryName.ToString());
 				continue;
 			}
 
+			// Set sequence to the shot sequence
 			Job->Sequence = FSoftObjectPath(ShotSequence);
 			Job->Map = FSoftObjectPath(World);
 
+			// Configure job
 			if (!Internal::ConfigureMoviePipelineJob(Job, Trajectory, Config, LevelName))
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to configure job for trajectory: %s"),
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to configure job for trajectory: %s"), 
 					*Trajectory->TrajectoryName.ToString());
 				continue;
 			}
 
 			CreatedJobs.Add(Job);
+
+			FCDGExpectedOutput Expected;
+			if (Internal::MakeExpectedOutput(ShotSequence, Trajectory, Config, LevelName, Expected))
+			{
+				ExpectedOutputs.Add(MoveTemp(Expected));
+			}
+			UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Created render job for trajectory: %s"), 
+				*Trajectory->TrajectoryName.ToString());
 		}
 
 		if (CreatedJobs.Num() == 0)
@@ -223,11 +249,13 @@ namespace CDGMRQInterface
 			return false;
 		}
 
+		// Export Index.json if requested
 		if (Config.bExportIndexJSON)
 		{
 			Internal::ExportIndexJSON(LevelOutputDir, Trajectories, Config.OutputFramerateOverride);
 		}
 
+		// Disable trajectory/keyframe debug visualizers while rendering so overlays do not appear in output.
 		UCDGTrajectorySubsystem* TrajectorySubsystem = World->GetSubsystem<UCDGTrajectorySubsystem>();
 		const bool bRestoreVisualizersAfterRender = (TrajectorySubsystem != nullptr);
 		if (TrajectorySubsystem)
@@ -235,8 +263,9 @@ namespace CDGMRQInterface
 			TrajectorySubsystem->DisableAllVisualizers();
 		}
 
+		// Execute the queue using PIE executor (for editor usage)
 		UMoviePipelinePIEExecutor* Executor = Cast<UMoviePipelinePIEExecutor>(MRQSubsystem->RenderQueueWithExecutor(UMoviePipelinePIEExecutor::StaticClass()));
-
+		
 		if (Executor)
 		{
 			const TWeakObjectPtr<UCDGTrajectorySubsystem> WeakTrajectorySubsystem = TrajectorySubsystem;
@@ -244,50 +273,80 @@ namespace CDGMRQInterface
 			// Per-shot callback: fires each time one MRQ job (one shot) completes.
 			// OnIndividualJobWorkFinished() is the non-deprecated per-job delegate
 			// on UMoviePipelinePIEExecutor; it receives FMoviePipelineOutputData.
-			if (OnShotRendered)
-			{
-				Executor->OnIndividualJobWorkFinished().AddLambda(
-					[OnShotRendered](FMoviePipelineOutputData /*Data*/)
+			// A frame sink failure fails the whole render even when MRQ itself succeeded.
+			const TSharedRef<bool> bAnySinkFailed = MakeShared<bool>(false);
+			Executor->OnIndividualJobWorkFinished().AddLambda(
+				[OnShotRendered, bAnySinkFailed](FMoviePipelineOutputData Data)
+				{
+					*bAnySinkFailed |= Internal::FrameSinkFailed(Data.Job);
+					if (OnShotRendered)
 					{
 						OnShotRendered();
-					});
-			}
+					}
+				});
 
-			Executor->OnExecutorFinished().AddLambda([LevelOutputDir, Config, bRestoreVisualizersAfterRender, WeakTrajectorySubsystem, OnCompleted = MoveTemp(OnCompleted)](UMoviePipelineExecutorBase* InExecutor, bool bSuccess)
+			// Bind callback for when all rendering completes
+			Executor->OnExecutorFinished().AddLambda([ExpectedOutputs, bRestoreVisualizersAfterRender, WeakTrajectorySubsystem, bAnySinkFailed, OnCompleted = MoveTemp(OnCompleted)](UMoviePipelineExecutorBase* InExecutor, bool bExecutorSuccess)
 			{
+				// Every shot has rendered: the tar shard sets they shared get their last shard and index
+				*bAnySinkFailed |= !CloseTarShardSets();
+
+				const bool bSuccess = bExecutorSuccess && !*bAnySinkFailed;
+				if (*bAnySinkFailed)
+				{
+					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: A frame sink failed during the render; reporting it as failed"));
+				}
+
 				if (bRestoreVisualizersAfterRender && WeakTrajectorySubsystem.IsValid())
 				{
 					WeakTrajectorySubsystem->RestoreVisualizerStates();
 				}
 
-				if (bSuccess && Config.ExportFormat == ECDGRenderOutputFormat::H264_Video)
+				if (!bSuccess || ExpectedOutputs.IsEmpty())
 				{
-					Internal::ValidateAndCleanupVideoOutput(LevelOutputDir);
+					if (OnCompleted)
+					{
+						OnCompleted(bSuccess);
+					}
+					return;
 				}
 
-				if (OnCompleted)
+				// Outputs are checked on worker threads; OnCompleted follows on the game thread
+				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Render completed, validating %d output(s) in the background..."), ExpectedOutputs.Num());
+				CDGOutputValidator::ValidateAsync(ExpectedOutputs, [OnCompleted](const TArray<FCDGValidationResult>& Results)
 				{
-					OnCompleted(bSuccess);
-				}
+					const bool bAllValid = Internal::ReportInvalidOutputs(Results);
+					if (OnCompleted)
+					{
+						OnCompleted(bAllValid);
+					}
+				});
 			});
 		}
 		else
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to start Movie Render Queue executor"));
+
 			if (bRestoreVisualizersAfterRender && TrajectorySubsystem)
 			{
 				TrajectorySubsystem->RestoreVisualizerStates();
 			}
+
 			return false;
 		}
 
-		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Started rendering %d trajectories to: %s"),
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Started rendering %d trajectories to: %s"), 
 			CreatedJobs.Num(), *LevelOutputDir);
 
 		return true;
 	}
 
 	bool RenderTrajectoriesWithSequence(ULevelSequence* MasterSequence, const TArray<ACDGTrajectory*>& Trajectories, const FTrajectoryRenderConfig& Config)
+	{
+		return RenderTrajectoriesWithSequence(MasterSequence, Trajectories, Config, nullptr, nullptr);
+	}
+
+	bool RenderTrajectories(const TArray<ACDGTrajectory*>& Trajectories, const FTrajectoryRenderConfig& Config)
 	{
 		if (Trajectories.Num() == 0)
 		{
@@ -302,12 +361,6 @@ namespace CDGMRQInterface
 			return false;
 		}
 
-		if (!MasterSequence)
-		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Master sequence is null"));
-			return false;
-		}
-
 		// Get world
 		UWorld* World = nullptr;
 #if WITH_EDITOR
@@ -323,34 +376,48 @@ namespace CDGMRQInterface
 			return false;
 		}
 
-		// Get level name (use override from config if provided)
-		FString LevelName = Config.LevelNameOverride.IsEmpty()
-			? [&]{ FString N = World->GetMapName(); N.RemoveFromStart(World->StreamingLevelsPrefix); return N; }()
-			: Config.LevelNameOverride;
-
-		// Validate the provided master sequence
-		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Validating provided master sequence..."));
+		// Check for existing master sequence from CDGLevelSeqSubsystem
+		UCDGLevelSeqSubsystem* LevelSeqSubsystem = World->GetSubsystem<UCDGLevelSeqSubsystem>();
+		ULevelSequence* MasterSequence = nullptr;
 		
-		if (!Internal::ValidateMasterSequence(MasterSequence, Trajectories, LevelName))
+		if (LevelSeqSubsystem)
 		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Master sequence validation failed. Please ensure:"));
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  1. All trajectories have corresponding shot sequences"));
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  2. Shot sequences match trajectory data (duration, keyframes)"));
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  3. Re-export the level sequence if trajectories have changed"));
+			LevelSeqSubsystem->InitLevelSequence();
+			MasterSequence = LevelSeqSubsystem->GetActiveLevelSequence();
+		}
+
+		if (!MasterSequence)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: No existing master sequence found"));
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  Please export the level sequence first using the Level Sequence Exporter"));
 			return false;
 		}
-		
-		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Master sequence validation passed"));
 
-		// Setup output directory structure
-		FString LevelOutputDir = Internal::SetupOutputDirectory(Config.DestinationRootDir, LevelName);
-		if (LevelOutputDir.IsEmpty())
+		// Use the new function that accepts a sequence
+		return RenderTrajectoriesWithSequence(MasterSequence, Trajectories, Config);
+	}
+
+	bool RenderTrajectoryBatch(const TArray<FCDGRenderBatchEntry>& Entries, FCDGRenderBatchCallbacks Callbacks)
+	{
+		if (Entries.Num() == 0)
 		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to setup output directory"));
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: No batch entries provided"));
+			return false;
+		}
+
+		UWorld* World = nullptr;
+#if WITH_EDITOR
+		if (GEditor)
+		{
+			World = GEditor->GetEditorWorldContext().World();
+		}
+#endif
+		if (!World)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: No valid world context found"));
 			return false;
 		}
 
-		// Get MRQ subsystem
 		UMoviePipelineQueueEngineSubsystem* MRQSubsystem = GEngine->GetEngineSubsystem<UMoviePipelineQueueEngineSubsystem>();
 		if (!MRQSubsystem)
 		{
@@ -358,14 +425,12 @@ namespace CDGMRQInterface
 			return false;
 		}
 
-		// Guard against starting a new queue while another render is still active.
-		if (UMoviePipelineExecutorBase* ActiveExecutor = MRQSubsystem->GetActiveExecutor())
+		if (MRQSubsystem->GetActiveExecutor())
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Render request ignored because MRQ is already rendering."));
 			return false;
 		}
 
-		// Get or create queue
 		UMoviePipelineQueue* Queue = MRQSubsystem->GetQueue();
 		if (!Queue)
 		{
@@ -373,167 +438,242 @@ namespace CDGMRQInterface
 			return false;
 		}
 
-		// MRQ queue is persistent across runs; clear it so old jobs do not get re-rendered.
 		Queue->DeleteAllJobs();
 
-		// Create jobs for each trajectory using existing shot sequences
-		TArray<UMoviePipelineExecutorJob*> CreatedJobs;
-		for (ACDGTrajectory* Trajectory : Trajectories)
+		// Shared between the executor callbacks: which entry each job belongs
+		// to and how many of its jobs are still outstanding.
+		struct FBatchState
 		{
-			if (!Trajectory)
+			TMap<const UMoviePipelineExecutorJob*, int32> JobToEntry;
+			TArray<int32>   JobsLeft;
+			TArray<bool>    bEntryOK;
+			TArray<bool>    bEntryStarted;
+			TArray<bool>    bEntryFinished;
+			TArray<TArray<FCDGExpectedOutput>> ExpectedOutputs;
+			/** Each entry's OUTPUTS directory, where its tar shard set is closed */
+			TArray<FString> OutputDirs;
+		};
+		TSharedRef<FBatchState> State = MakeShared<FBatchState>();
+		State->JobsLeft.Init(0, Entries.Num());
+		State->bEntryOK.Init(true, Entries.Num());
+		State->bEntryStarted.Init(false, Entries.Num());
+		State->bEntryFinished.Init(false, Entries.Num());
+		State->ExpectedOutputs.SetNum(Entries.Num());
+		State->OutputDirs.SetNum(Entries.Num());
+
+		TArray<int32> RejectedEntries;
+		int32 TotalJobs = 0;
+
+		for (int32 EntryIdx = 0; EntryIdx < Entries.Num(); ++EntryIdx)
+		{
+			const FCDGRenderBatchEntry& Entry = Entries[EntryIdx];
+			const FTrajectoryRenderConfig& Config = Entry.Config;
+
+			const FString LevelName = Config.LevelNameOverride.IsEmpty()
+				? [&]{ FString N = World->GetMapName(); N.RemoveFromStart(World->StreamingLevelsPrefix); return N; }()
+				: Config.LevelNameOverride;
+
+			if (!Entry.MasterSequence || Entry.Trajectories.Num() == 0 || Config.DestinationRootDir.IsEmpty()
+				|| !Internal::ValidateMasterSequence(Entry.MasterSequence, Entry.Trajectories, LevelName))
 			{
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Batch entry %s is invalid — skipped"), *LevelName);
+				RejectedEntries.Add(EntryIdx);
 				continue;
 			}
 
-			// Find existing shot sequence for this trajectory
-			ULevelSequence* ShotSequence = nullptr;
-			if (!Internal::FindExistingShotSequence(Trajectory, LevelName, ShotSequence))
+			const FString LevelOutputDir = Internal::SetupOutputDirectory(Config.DestinationRootDir, LevelName);
+			if (LevelOutputDir.IsEmpty())
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to find shot sequence for trajectory: %s"), 
-					*Trajectory->TrajectoryName.ToString());
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to setup output directory for %s"), *LevelName);
+				RejectedEntries.Add(EntryIdx);
 				continue;
 			}
+			State->OutputDirs[EntryIdx] = FPaths::Combine(Config.DestinationRootDir, LevelName, TEXT("OUTPUTS"));
 
-			// Allocate job
-			UMoviePipelineExecutorJob* Job = Queue->AllocateNewJob(UMoviePipelineExecutorJob::StaticClass());
-			if (!Job)
+			for (ACDGTrajectory* Trajectory : Entry.Trajectories)
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to allocate job for trajectory: %s"), 
-					*Trajectory->TrajectoryName.ToString());
-				continue;
-			}
+				if (!Trajectory) continue;
 
-			// Set sequence to the shot sequence
-			Job->Sequence = FSoftObjectPath(ShotSequence);
-			Job->Map = FSoftObjectPath(World);
+				ULevelSequence* ShotSequence = nullptr;
+				if (!Internal::FindExistingShotSequence(Trajectory, LevelName, ShotSequence, Entry.MasterSequence))
+				{
+					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to find shot sequence for trajectory: %s"),
+						*Trajectory->TrajectoryName.ToString());
+					continue;
+				}
 
-			// Configure job
-			if (!Internal::ConfigureMoviePipelineJob(Job, Trajectory, Config, LevelName))
+				UMoviePipelineExecutorJob* Job = Queue->AllocateNewJob(UMoviePipelineExecutorJob::StaticClass());
+				if (!Job) continue;
+
+				Job->Sequence = FSoftObjectPath(ShotSequence);
+				Job->Map = FSoftObjectPath(World);
+
+				if (!Internal::ConfigureMoviePipelineJob(Job, Trajectory, Config, LevelName))
+				{
+					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to configure job for trajectory: %s"),
+						*Trajectory->TrajectoryName.ToString());
+					Queue->DeleteJob(Job);
+					continue;
+				}
+
+				State->JobToEntry.Add(Job, EntryIdx);
+				++State->JobsLeft[EntryIdx];
+
+				FCDGExpectedOutput Expected;
+				if (Internal::MakeExpectedOutput(ShotSequence, Trajectory, Config, LevelName, Expected))
+				{
+					State->ExpectedOutputs[EntryIdx].Add(MoveTemp(Expected));
+				}
+			}
+
+			if (State->JobsLeft[EntryIdx] == 0)
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to configure job for trajectory: %s"), 
-					*Trajectory->TrajectoryName.ToString());
+				RejectedEntries.Add(EntryIdx);
 				continue;
 			}
+			TotalJobs += State->JobsLeft[EntryIdx];
 
-			CreatedJobs.Add(Job);
-			UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Created render job for trajectory: %s"), 
-				*Trajectory->TrajectoryName.ToString());
+			if (Config.bExportIndexJSON)
+			{
+				Internal::ExportIndexJSON(LevelOutputDir, Entry.Trajectories, Config.OutputFramerateOverride);
+			}
 		}
 
-		if (CreatedJobs.Num() == 0)
+		if (TotalJobs == 0)
 		{
 			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: No jobs were created"));
 			return false;
 		}
 
-		// Export Index.json if requested
-		if (Config.bExportIndexJSON)
-		{
-			Internal::ExportIndexJSON(LevelOutputDir, Trajectories, Config.OutputFramerateOverride);
-		}
-
-		// Disable trajectory/keyframe debug visualizers while rendering so overlays do not appear in output.
 		UCDGTrajectorySubsystem* TrajectorySubsystem = World->GetSubsystem<UCDGTrajectorySubsystem>();
-		const bool bRestoreVisualizersAfterRender = (TrajectorySubsystem != nullptr);
 		if (TrajectorySubsystem)
 		{
 			TrajectorySubsystem->DisableAllVisualizers();
 		}
 
-		// Execute the queue using PIE executor (for editor usage)
 		UMoviePipelinePIEExecutor* Executor = Cast<UMoviePipelinePIEExecutor>(MRQSubsystem->RenderQueueWithExecutor(UMoviePipelinePIEExecutor::StaticClass()));
-		
-		if (Executor)
+		if (!Executor)
 		{
-			const TWeakObjectPtr<UCDGTrajectorySubsystem> WeakTrajectorySubsystem = TrajectorySubsystem;
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to start Movie Render Queue executor"));
+			if (TrajectorySubsystem)
+			{
+				TrajectorySubsystem->RestoreVisualizerStates();
+			}
+			return false;
+		}
 
-			// Bind callback for when all rendering completes
-			Executor->OnExecutorFinished().AddLambda([LevelOutputDir, Config, bRestoreVisualizersAfterRender, WeakTrajectorySubsystem](UMoviePipelineExecutorBase* InExecutor, bool bSuccess)
+		const TSharedRef<FCDGRenderBatchCallbacks> SharedCallbacks = MakeShared<FCDGRenderBatchCallbacks>(MoveTemp(Callbacks));
+
+		// A rendered entry is finished only once its outputs have been checked
+		// on worker threads; the game thread carries on rendering meanwhile.
+		auto FinishEntry = [State, SharedCallbacks](int32 EntryIdx, bool bSuccess)
+		{
+			if (State->bEntryFinished[EntryIdx]) return;
+			State->bEntryFinished[EntryIdx] = true;
+
+			// The entry's shots have all rendered, so its tar shard set is complete
+			if (!State->OutputDirs[EntryIdx].IsEmpty())
 			{
-				if (bRestoreVisualizersAfterRender && WeakTrajectorySubsystem.IsValid())
+				bSuccess = CloseTarShardSets(State->OutputDirs[EntryIdx]) && bSuccess;
+			}
+
+			if (!bSuccess || State->ExpectedOutputs[EntryIdx].IsEmpty())
+			{
+				if (SharedCallbacks->OnEntryFinished)
 				{
-					WeakTrajectorySubsystem->RestoreVisualizerStates();
+					SharedCallbacks->OnEntryFinished(EntryIdx, bSuccess);
 				}
+				return;
+			}
 
-				if (bSuccess && Config.ExportFormat == ECDGRenderOutputFormat::H264_Video)
+			CDGOutputValidator::ValidateAsync(State->ExpectedOutputs[EntryIdx], [SharedCallbacks, EntryIdx](const TArray<FCDGValidationResult>& Results)
+			{
+				const TArray<FString> FailedShots = CDGOutputValidator::GetFailedShots(Results);
+				Internal::ReportInvalidOutputs(Results);
+				if (!FailedShots.IsEmpty() && SharedCallbacks->OnOutputsInvalid)
+				{
+					SharedCallbacks->OnOutputsInvalid(EntryIdx, FailedShots);
+				}
+				if (SharedCallbacks->OnEntryFinished)
 				{
-					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Render completed, validating MP4 files and cleaning up PNG frames..."));
-					Internal::ValidateAndCleanupVideoOutput(LevelOutputDir);
+					SharedCallbacks->OnEntryFinished(EntryIdx, FailedShots.IsEmpty());
 				}
 			});
-		}
-		else
-		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to start Movie Render Queue executor"));
+		};
 
-			if (bRestoreVisualizersAfterRender && TrajectorySubsystem)
+		// Jobs of one entry are contiguous, so the first job of an entry marks
+		// the hand-over from the previous one.  The PIE world for that job is
+		// only duplicated on a later tick, after this callback has run.
+		Executor->OnIndividualJobStarted().AddLambda([State, SharedCallbacks](UMoviePipelineExecutorJob* Job)
+		{
+			const int32* EntryIdx = State->JobToEntry.Find(Job);
+			if (!EntryIdx || State->bEntryStarted[*EntryIdx]) return;
+			State->bEntryStarted[*EntryIdx] = true;
+			if (SharedCallbacks->OnEntryStarted)
 			{
-				TrajectorySubsystem->RestoreVisualizerStates();
+				SharedCallbacks->OnEntryStarted(*EntryIdx);
 			}
+		});
 
-			return false;
-		}
-
-		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Started rendering %d trajectories to: %s"), 
-			CreatedJobs.Num(), *LevelOutputDir);
+		Executor->OnIndividualJobWorkFinished().AddLambda([State, SharedCallbacks, FinishEntry](FMoviePipelineOutputData Data)
+		{
+			const int32* EntryIdx = State->JobToEntry.Find(Data.Job);
+			if (!EntryIdx) return;
 
-		return true;
-	}
+			State->bEntryOK[*EntryIdx] &= Data.bSuccess && !Internal::FrameSinkFailed(Data.Job);
+			if (SharedCallbacks->OnShotRendered)
+			{
+				SharedCallbacks->OnShotRendered(*EntryIdx);
+			}
+			if (--State->JobsLeft[*EntryIdx] == 0)
+			{
+				FinishEntry(*EntryIdx, State->bEntryOK[*EntryIdx]);
+			}
+		});
 
-	bool RenderTrajectories(const TArray<ACDGTrajectory*>& Trajectories, const FTrajectoryRenderConfig& Config)
-	{
-		if (Trajectories.Num() == 0)
+		const TWeakObjectPtr<UCDGTrajectorySubsystem> WeakTrajectorySubsystem = TrajectorySubsystem;
+		Executor->OnExecutorFinished().AddLambda([State, SharedCallbacks, FinishEntry, WeakTrajectorySubsystem](UMoviePipelineExecutorBase* InExecutor, bool bSuccess)
 		{
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: No trajectories provided"));
-			return false;
-		}
+			if (WeakTrajectorySubsystem.IsValid())
+			{
+				WeakTrajectorySubsystem->RestoreVisualizerStates();
+			}
 
-		// Validate config
-		if (Config.DestinationRootDir.IsEmpty())
-		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Destination root directory is empty"));
-			return false;
-		}
+			// Entries cut short by a cancelled / failed executor.
+			for (int32 EntryIdx = 0; EntryIdx < State->bEntryFinished.Num(); ++EntryIdx)
+			{
+				FinishEntry(EntryIdx, false);
+			}
+			CloseTarShardSets();
 
-		// Get world
-		UWorld* World = nullptr;
-#if WITH_EDITOR
-		if (GEditor)
-		{
-			World = GEditor->GetEditorWorldContext().World();
-		}
-#endif
+			if (SharedCallbacks->OnCompleted)
+			{
+				SharedCallbacks->OnCompleted(bSuccess);
+			}
+		});
 
-		if (!World)
-		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: No valid world context found"));
-			return false;
-		}
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Started rendering %d job(s) from %d sequence(s) in one session"),
+			TotalJobs, Entries.Num() - RejectedEntries.Num());
 
-		// Check for existing master sequence from CDGLevelSeqSubsystem
-		UCDGLevelSeqSubsystem* LevelSeqSubsystem = World->GetSubsystem<UCDGLevelSeqSubsystem>();
-		ULevelSequence* MasterSequence = nullptr;
-		
-		if (LevelSeqSubsystem)
+		for (int32 EntryIdx : RejectedEntries)
 		{
-			LevelSeqSubsystem->InitLevelSequence();
-			MasterSequence = LevelSeqSubsystem->GetActiveLevelSequence();
+			FinishEntry(EntryIdx, false);
 		}
 
-		if (!MasterSequence)
-		{
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: No existing master sequence found"));
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("  Please export the level sequence first using the Level Sequence Exporter"));
-			return false;
-		}
+		return true;
+	}
 
-		// Use the new function that accepts a sequence
-		return RenderTrajectoriesWithSequence(MasterSequence, Trajectories, Config);
+	bool IsRenderInProgress()
+	{
+		UMoviePipelineQueueEngineSubsystem* MRQSubsystem = GEngine
+			? GEngine->GetEngineSubsystem<UMoviePipelineQueueEngineSubsystem>() : nullptr;
+		return MRQSubsystem && MRQSubsystem->GetActiveExecutor() != nullptr;
 	}
 
 	namespace Internal
 	{
-		bool FindExistingShotSequence(ACDGTrajectory* Trajectory, const FString& LevelName, ULevelSequence*& OutSequence)
+		bool FindExistingShotSequence(ACDGTrajectory* Trajectory, const FString& LevelName, ULevelSequence*& OutSequence,
+			const ULevelSequence* MasterSequence)
 		{
 			if (!Trajectory)
 			{
@@ -560,8 +700,12 @@ namespace CDGMRQInterface
 				return false;
 			}
 
-			// Get the master sequence package path
-			FString MasterPackageName = LevelSeqSubsystem->GetSequencePackageName();
+			// Get the master sequence package path.  Shots live next to the master
+			// they were exported under, which is not necessarily the active one
+			// (the batch processor keeps one master per in-flight combo).
+			FString MasterPackageName = MasterSequence
+				? MasterSequence->GetOutermost()->GetName()
+				: LevelSeqSubsystem->GetSequencePackageName();
 			if (MasterPackageName.IsEmpty())
 			{
 				return false;
@@ -707,7 +851,7 @@ namespace CDGMRQInterface
 
 				// Find shot sequence for this trajectory
 				ULevelSequence* ShotSequence = nullptr;
-				if (!FindExistingShotSequence(Trajectory, LevelName, ShotSequence))
+				if (!FindExistingShotSequence(Trajectory, LevelName, ShotSequence, MasterSequence))
 				{
 					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Missing shot sequence for trajectory: %s"), 
 						*Trajectory->TrajectoryName.ToString());
@@ -790,262 +934,28 @@ namespace CDGMRQInterface
 				return false;
 			}
 
-			// Set framerate
-			FFrameRate FrameRate(FPS, 1);
-			const double TickResolution = 24000.0; // Standard tick resolution
-			MovieScene->SetDisplayRate(FrameRate);
-			MovieScene->SetTickResolutionDirectly(FFrameRate(TickResolution, 1));
+			// Same builder as the exporters; MRQ focuses by tracking the autofocus
+			// anchor live and names the camera so it can be found again.
+			FCDGShotLayout ShotLayout;
+			ShotLayout.CameraLabelPrefix = TEXT("Cam_MRQ_");
+			ShotLayout.bNameCameraActor  = true;
+			ShotLayout.Focus             = ECDGShotFocus::TrackAnchor;
+			const FCDGSequenceBuilder Builder(ShotLayout, FFrameRate(FPS, 1));
+			const double TickResolution = Builder.GetTickResolution();
+			Builder.PrepareMovieScene(*MovieScene);
 
 			// Calculate duration
 			float Duration = Trajectory->GetTrajectoryDuration();
 			int32 NumFrames = FMath::Max(1, FMath::RoundToInt(Duration * FPS));
 			int32 DurationInTicks = NumFrames * (TickResolution / FPS);
 
-			// Create camera actor
-			FString CameraName = FString::Printf(TEXT("Cam_MRQ_%s"), *Trajectory->TrajectoryName.ToString());
-			
-			// Cleanup existing camera with the same name
-			for (TActorIterator<ACineCameraActor> It(World); It; ++It)
-			{
-				if (It->GetActorLabel() == CameraName)
-				{
-					World->EditorDestroyActor(*It, true);
-					break;
-				}
-			}
-
-			// Spawn new camera
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Name = FName(*CameraName);
-			ACineCameraActor* CameraActor = World->SpawnActor<ACineCameraActor>(ACineCameraActor::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
-			if (!CameraActor)
+			// Camera, camera cut, transform, lens and focus
+			const FCDGCameraKeySnapshot Snapshot = Builder.Capture(*Trajectory);
+			if (!Builder.BuildCameraShot(World, *OutSequence, Snapshot, Builder.Bake(Snapshot), DurationInTicks).Camera)
 			{
 				return false;
 			}
 
-			CameraActor->SetActorLabel(CameraName);
-
-			// Add camera to sequence
-			FGuid CameraGuid = MovieScene->AddPossessable(CameraActor->GetActorLabel(), CameraActor->GetClass());
-			OutSequence->BindPossessableObject(CameraGuid, *CameraActor, World);
-
-			// Add camera cut track
-			UMovieSceneCameraCutTrack* CameraCutTrack = MovieScene->AddTrack<UMovieSceneCameraCutTrack>();
-			if (CameraCutTrack)
-			{
-				UMovieSceneCameraCutSection* CutSection = Cast<UMovieSceneCameraCutSection>(CameraCutTrack->CreateNewSection());
-				if (CutSection)
-				{
-					CutSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-					CutSection->SetCameraGuid(CameraGuid);
-					CameraCutTrack->AddSection(*CutSection);
-				}
-			}
-
-			// Add transform track
-			UMovieScene3DTransformTrack* TransformTrack = MovieScene->AddTrack<UMovieScene3DTransformTrack>(CameraGuid);
-			if (TransformTrack)
-			{
-				UMovieScene3DTransformSection* TransformSection = Cast<UMovieScene3DTransformSection>(TransformTrack->CreateNewSection());
-				if (TransformSection)
-				{
-					TransformTrack->AddSection(*TransformSection);
-					TransformSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-
-					// Get channels
-					FMovieSceneChannelProxy& ChannelProxy = TransformSection->GetChannelProxy();
-					TArrayView<FMovieSceneDoubleChannel*> DoubleChannels = ChannelProxy.GetChannels<FMovieSceneDoubleChannel>();
-
-					if (DoubleChannels.Num() >= 6)
-					{
-						// Populate keyframes
-						TArray<ACDGKeyframe*> TrajectoryKeyframes = Trajectory->GetSortedKeyframes();
-						double CurrentTimeSeconds = 0.0;
-
-						for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-						{
-							ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-							if (!Keyframe) continue;
-
-							if (k > 0)
-							{
-								CurrentTimeSeconds += Keyframe->TimeToCurrentFrame;
-							}
-
-							FFrameNumber KeyTime = FFrameNumber(static_cast<int32>(CurrentTimeSeconds * TickResolution));
-							FTransform KeyTransform = Keyframe->GetKeyframeTransform();
-							FVector Loc = KeyTransform.GetLocation();
-							FRotator Rot = KeyTransform.GetRotation().Rotator();
-
-							bool bHasStay = Keyframe->TimeAtCurrentFrame > KINDA_SMALL_NUMBER;
-
-							// Add arrival key
-							DoubleChannels[0]->AddLinearKey(KeyTime, Loc.X);
-							DoubleChannels[1]->AddLinearKey(KeyTime, Loc.Y);
-							DoubleChannels[2]->AddLinearKey(KeyTime, Loc.Z);
-							DoubleChannels[3]->AddLinearKey(KeyTime, Rot.Roll);
-							DoubleChannels[4]->AddLinearKey(KeyTime, Rot.Pitch);
-							DoubleChannels[5]->AddLinearKey(KeyTime, Rot.Yaw);
-
-							// Add stay key if needed
-							if (bHasStay)
-							{
-								CurrentTimeSeconds += Keyframe->TimeAtCurrentFrame;
-								FFrameNumber EndKeyTime = FFrameNumber(static_cast<int32>(CurrentTimeSeconds * TickResolution));
-
-								DoubleChannels[0]->AddLinearKey(EndKeyTime, Loc.X);
-								DoubleChannels[1]->AddLinearKey(EndKeyTime, Loc.Y);
-								DoubleChannels[2]->AddLinearKey(EndKeyTime, Loc.Z);
-								DoubleChannels[3]->AddLinearKey(EndKeyTime, Rot.Roll);
-								DoubleChannels[4]->AddLinearKey(EndKeyTime, Rot.Pitch);
-								DoubleChannels[5]->AddLinearKey(EndKeyTime, Rot.Yaw);
-							}
-						}
-					}
-				}
-			}
-
-			// Add lens tracks
-			UCineCameraComponent* CameraComponent = CameraActor->GetCineCameraComponent();
-			if (CameraComponent)
-			{
-				FGuid ComponentGuid = MovieScene->AddPossessable(CameraComponent->GetName(), CameraComponent->GetClass());
-				FMovieScenePossessable* ChildPossessable = MovieScene->FindPossessable(ComponentGuid);
-				if (ChildPossessable)
-				{
-					ChildPossessable->SetParent(CameraGuid, MovieScene);
-				}
-				OutSequence->BindPossessableObject(ComponentGuid, *CameraComponent, CameraActor);
-
-			TArray<ACDGKeyframe*> TrajectoryKeyframes = Trajectory->GetSortedKeyframes();
-
-				auto AddLensKeyWithStay = [&](FMovieSceneFloatChannel& Channel, double& CurrentTimeSeconds, const ACDGKeyframe* Keyframe, float Value)
-				{
-					const FFrameNumber KeyTime = FFrameNumber(static_cast<int32>(CurrentTimeSeconds * TickResolution));
-					Channel.AddLinearKey(KeyTime, Value);
-					if (Keyframe->TimeAtCurrentFrame > KINDA_SMALL_NUMBER)
-					{
-						CurrentTimeSeconds += Keyframe->TimeAtCurrentFrame;
-						const FFrameNumber EndKeyTime = FFrameNumber(static_cast<int32>(CurrentTimeSeconds * TickResolution));
-						Channel.AddLinearKey(EndKeyTime, Value);
-					}
-				};
-
-				if (UMovieSceneFloatTrack* FocalLengthTrack = MovieScene->AddTrack<UMovieSceneFloatTrack>(ComponentGuid))
-				{
-					FocalLengthTrack->SetPropertyNameAndPath(GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentFocalLength), "CurrentFocalLength");
-					UMovieSceneFloatSection* FocalSection = Cast<UMovieSceneFloatSection>(FocalLengthTrack->CreateNewSection());
-					FocalLengthTrack->AddSection(*FocalSection);
-					FocalSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-
-					FMovieSceneFloatChannel& FocalChannel = FocalSection->GetChannel();
-					double CurrentTimeSeconds = 0.0;
-					for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-					{
-						const ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-						if (!Keyframe) continue;
-						if (k > 0)
-						{
-							CurrentTimeSeconds += Keyframe->TimeToCurrentFrame;
-						}
-						AddLensKeyWithStay(FocalChannel, CurrentTimeSeconds, Keyframe, Keyframe->LensSettings.FocalLength);
-					}
-				}
-
-				if (UMovieSceneFloatTrack* ApertureTrack = MovieScene->AddTrack<UMovieSceneFloatTrack>(ComponentGuid))
-				{
-					ApertureTrack->SetPropertyNameAndPath(GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentAperture), "CurrentAperture");
-					UMovieSceneFloatSection* ApertureSection = Cast<UMovieSceneFloatSection>(ApertureTrack->CreateNewSection());
-					ApertureTrack->AddSection(*ApertureSection);
-					ApertureSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-
-					FMovieSceneFloatChannel& ApertureChannel = ApertureSection->GetChannel();
-					double CurrentTimeSeconds = 0.0;
-					for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-					{
-						const ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-						if (!Keyframe) continue;
-						if (k > 0)
-						{
-							CurrentTimeSeconds += Keyframe->TimeToCurrentFrame;
-						}
-						AddLensKeyWithStay(ApertureChannel, CurrentTimeSeconds, Keyframe, Keyframe->LensSettings.Aperture);
-					}
-				}
-
-				// ---- Focus setup ----
-				// If the first keyframe has an autofocus actor, use UE's native Tracking
-				// focus mode — UCineCameraComponent::GetDesiredFocusDistance() then
-				// projects the tracked world point onto the camera's optical axis every
-				// frame, so focus remains correct even as the character moves.
-				// Otherwise fall back to a baked ManualFocusDistance track.
-				const ACDGKeyframe* FirstKF = TrajectoryKeyframes.Num() > 0 ? TrajectoryKeyframes[0] : nullptr;
-				AActor* AutofocusActor = FirstKF ? FirstKF->LensSettings.AutofocusTargetActor.Get() : nullptr;
-
-				if (AutofocusActor)
-				{
-					// Compute the anchor's position in the actor's local space.
-					// UCineCameraComponent::GetDesiredFocusDistance does:
-					//   FocusPoint = TrackedActor->GetActorTransform().TransformPosition(RelativeOffset)
-					// so RelativeOffset must be in actor-local space.
-					FVector AnchorLocalOffset = FVector::ZeroVector;
-					{
-						const AnchorType AnchorTypeToUse = FirstKF->LensSettings.AutofocusTargetAnchorType;
-						TArray<UCDGCharacterAnchor*> AnchorComponents;
-						AutofocusActor->GetComponents<UCDGCharacterAnchor>(AnchorComponents);
-						for (const UCDGCharacterAnchor* AnchorComp : AnchorComponents)
-						{
-							if (AnchorComp && AnchorComp->Type == AnchorTypeToUse)
-							{
-								AnchorLocalOffset = AutofocusActor->GetActorTransform()
-									.InverseTransformPosition(AnchorComp->GetComponentLocation());
-								break;
-							}
-						}
-					}
-
-					CameraComponent->FocusSettings.FocusMethod = ECameraFocusMethod::Tracking;
-					CameraComponent->FocusSettings.TrackingFocusSettings.ActorToTrack    = AutofocusActor;
-					CameraComponent->FocusSettings.TrackingFocusSettings.RelativeOffset  = AnchorLocalOffset;
-				}
-				else
-				{
-					// No autofocus actor — use manual distance or disable DOF entirely.
-					const bool bAnyManualFocus = TrajectoryKeyframes.ContainsByPredicate([](const ACDGKeyframe* KF)
-					{
-						return KF && KF->LensSettings.bUseManualFocusDistance;
-					});
-					CameraComponent->FocusSettings.FocusMethod =
-						bAnyManualFocus ? ECameraFocusMethod::Manual : ECameraFocusMethod::Disable;
-
-					if (bAnyManualFocus)
-					{
-						if (UMovieSceneFloatTrack* ManualFocusTrack = MovieScene->AddTrack<UMovieSceneFloatTrack>(ComponentGuid))
-						{
-							ManualFocusTrack->SetPropertyNameAndPath(TEXT("FocusSettings.ManualFocusDistance"), TEXT("FocusSettings.ManualFocusDistance"));
-							UMovieSceneFloatSection* ManualFocusSection = Cast<UMovieSceneFloatSection>(ManualFocusTrack->CreateNewSection());
-							ManualFocusTrack->AddSection(*ManualFocusSection);
-							ManualFocusSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-
-							FMovieSceneFloatChannel& ManualFocusChannel = ManualFocusSection->GetChannel();
-							double CurrentTimeSeconds = 0.0;
-							for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-							{
-								const ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-								if (!Keyframe) continue;
-								if (k > 0)
-								{
-									CurrentTimeSeconds += Keyframe->TimeToCurrentFrame;
-								}
-								const float Dist = Keyframe->LensSettings.bUseManualFocusDistance
-									? Keyframe->LensSettings.FocusDistance : 0.0f;
-								AddLensKeyWithStay(ManualFocusChannel, CurrentTimeSeconds, Keyframe, Dist);
-							}
-						}
-					}
-				}
-			}
-
 			// Set playback range
 			MovieScene->SetPlaybackRange(TRange<FFrameNumber>(0, DurationInTicks));
 
@@ -1121,8 +1031,52 @@ namespace CDGMRQInterface
 				AntiAliasingSetting->TemporalSampleCount = Config.TemporalSampleCount;
 			}
 
+			// Frame sink: frames go straight from the render into the sink, no image files
+			FString SinkEncoderPath;
+			const bool bUseFrameSink = Config.FrameSink != ECDGFrameSinkKind::None
+				&& (Config.FrameSink != ECDGFrameSinkKind::EncoderPipe || Internal::EnsureFFmpegAvailable(SinkEncoderPath, Config.VideoEncode.EncoderPath));
+
+			if (Config.FrameSink != ECDGFrameSinkKind::None && !bUseFrameSink)
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Encoder pipe needs FFmpeg, falling back to the export format"));
+			}
+
 			// Configure output format based on the selected export format
-			if (bIsVideoFormat)
+			if (bUseFrameSink)
+			{
+				UCDGMoviePipelineFrameSinkOutput* SinkOutput = Cast<UCDGMoviePipelineFrameSinkOutput>(
+					PipelineConfig->FindOrAddSettingByClass(UCDGMoviePipelineFrameSinkOutput::StaticClass())
+				);
+
+				if (SinkOutput)
+				{
+					SinkOutput->SinkKind        = Config.FrameSink;
+					SinkOutput->OutputDirectory = FPaths::Combine(Config.DestinationRootDir, LevelName, TEXT("OUTPUTS"));
+					SinkOutput->FileNameBase    = FString::Printf(TEXT("%s.%s"), *LevelName, *Trajectory->TrajectoryName.ToString());
+					SinkOutput->EncoderPath     = SinkEncoderPath;
+					if (!SinkEncoderPath.IsEmpty())
+					{
+						SinkOutput->EncoderArgs = Internal::MakeEncoderPipeArgs(SinkEncoderPath, Config.VideoEncode);
+					}
+					SinkOutput->FramesPerChunk  = Config.FramesPerChunk;
+					SinkOutput->ImageWrite      = Config.ImageWrite;
+					SinkOutput->ShardSizeMB     = Config.ShardSizeMB;
+
+					// Tar shards: the level's shots share one set, so shards fill up to
+					// ShardSizeMB; each frame's trajectory index entry goes next to its image
+					if (Config.FrameSink == ECDGFrameSinkKind::TarShards)
+					{
+						SinkOutput->ShardSetName  = LevelName;
+						const int32 FPS = Config.OutputFramerateOverride > 0 ? Config.OutputFramerateOverride : 30;
+						SinkOutput->FrameMetadata = Internal::MakeFrameMetadata(Trajectory, FPS, LevelName);
+					}
+
+					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Streaming frames to %s sink: %s"),
+						*StaticEnum<ECDGFrameSinkKind>()->GetDisplayNameTextByValue(int64(Config.FrameSink)).ToString(),
+						*FPaths::Combine(SinkOutput->OutputDirectory, SinkOutput->FileNameBase));
+				}
+			}
+			else if (bIsVideoFormat)
 			{
 				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT(""));
 				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("*************************************************************"));
@@ -1137,8 +1091,8 @@ namespace CDGMRQInterface
 				
 				if (EncoderSettings)
 				{
-					// Try to ensure FFmpeg is available (will download if needed)
-					bFFmpegAvailable = Internal::EnsureFFmpegAvailable(FFmpegPath);
+					// Look for a local FFmpeg (configured path, bundled locations, PATH)
+					bFFmpegAvailable = Internal::EnsureFFmpegAvailable(FFmpegPath, Config.VideoEncode.EncoderPath);
 					
 					if (!bFFmpegAvailable)
 					{
@@ -1151,12 +1105,18 @@ namespace CDGMRQInterface
 						UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!"));
 						UE_LOG(LogCameraDatasetGenEditor, Error, TEXT(""));
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("=== HOW TO ENABLE VIDEO ENCODING ==="));
+#if PLATFORM_LINUX
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("1. Install FFmpeg with the system package manager (e.g. apt install ffmpeg)"));
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("2. Make sure 'ffmpeg' is on PATH, or set VideoEncode.EncoderPath"));
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("3. Restart Unreal Editor"));
+#else
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("1. Download FFmpeg from: https://github.com/BtbN/FFmpeg-Builds/releases/latest"));
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("2. Download: ffmpeg-master-latest-win64-gpl.zip"));
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("3. Extract the complete zip (includes bin folder)"));
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("4. Copy to: %s"), *FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/")));
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("   Final path: Engine/Binaries/ThirdParty/FFmpeg/Win64/bin/ffmpeg.exe"));
-						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("5. Restart Unreal Editor"));
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("5. Restart Unreal Editor (or set VideoEncode.EncoderPath)"));
+#endif
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("===================================="));
 						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT(""));
 					}
@@ -1167,22 +1127,30 @@ namespace CDGMRQInterface
 					
 					if (bFFmpegAvailable)
 					{
-						// Set H.264 codec settings
-						EncoderSettings->VideoCodec = TEXT("libx264");
+						// Set H.264 codec settings (whatever this FFmpeg build can encode with)
+						const FString VideoCodec = Internal::PickVideoCodec(FFmpegPath, Config.VideoEncode.VideoCodec);
+						EncoderSettings->VideoCodec = VideoCodec;
 						EncoderSettings->AudioCodec = TEXT("aac");
 						EncoderSettings->OutputFileExtension = TEXT("mp4");
 						EncoderSettings->ExecutablePath = FFmpegPath;
+
+						// Spelled out rather than inherited, so a project override cannot break
+						// them; every path is quoted to survive argument splitting on Linux
+						EncoderSettings->CommandLineFormat = TEXT("-hide_banner -y -loglevel error {AdditionalLocalArgs} {VideoInputs} {AudioInputs} -acodec {AudioCodec} -vcodec {VideoCodec} {Quality} \"{OutputPath}\"");
+						EncoderSettings->VideoInputStringFormat = TEXT("-f concat -safe 0 -i \"{InputFile}\" -r {FrameRate}");
+						EncoderSettings->AudioInputStringFormat = TEXT("-f concat -safe 0 -i \"{InputFile}\"");
 						
-						// Override quality settings for H.264
+						// Override quality settings for H.264; the jobs render at High, which
+						// takes CRF / preset / threads from the render config
 						EncoderSettings->EncodeSettings_Low = TEXT("-crf 28 -preset fast -pix_fmt yuv420p");
 						EncoderSettings->EncodeSettings_Med = TEXT("-crf 23 -preset medium -pix_fmt yuv420p");
-						EncoderSettings->EncodeSettings_High = TEXT("-crf 18 -preset slow -pix_fmt yuv420p -movflags +faststart");
+						EncoderSettings->EncodeSettings_High = Internal::MakeVideoEncodeArgs(Config.VideoEncode, VideoCodec);
 						EncoderSettings->EncodeSettings_Epic = TEXT("-crf 16 -preset slower -pix_fmt yuv420p -movflags +faststart");
 						
 						// Save settings to config
 						EncoderSettings->SaveConfig();
 						
-						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("*** Configured H.264 encoder settings"));
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("*** Configured %s encoder settings: %s"), *VideoCodec, *EncoderSettings->EncodeSettings_High);
 					}
 				}
 				else
@@ -1252,8 +1220,33 @@ namespace CDGMRQInterface
 					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT(""));
 				}
 			}
+			else if (Internal::UsesImageWritePool(Config))
+			{
+				// Plugin worker pool: configurable PNG / QOI / BMP encoding with back-pressure
+				UCDGMoviePipelineImageWriteOutput* ImageWriteOutput = Cast<UCDGMoviePipelineImageWriteOutput>(
+					PipelineConfig->FindOrAddSettingByClass(UCDGMoviePipelineImageWriteOutput::StaticClass())
+				);
+
+				if (ImageWriteOutput)
+				{
+					ImageWriteOutput->Settings        = Config.ImageWrite;
+					ImageWriteOutput->OutputDirectory = FPaths::Combine(Config.DestinationRootDir, LevelName, TEXT("OUTPUTS"));
+					ImageWriteOutput->FileNameBase    = FString::Printf(TEXT("%s.%s"), *LevelName, *Trajectory->TrajectoryName.ToString());
+
+					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Image write pool: %s, PNG level %d, filter %s"),
+						FCDGImageWritePool::GetExtension(Config.ImageWrite.Codec), Config.ImageWrite.PNGCompressionLevel,
+						*StaticEnum<ECDGPNGFilter>()->GetNameStringByValue(int64(Config.ImageWrite.PNGFilter)));
+				}
+			}
 			else
 			{
+				// The pool quantizes to 8 bits; HDR frames stay with MRQ's EXR writer
+				if (Config.ImageWrite.Codec != ECDGImageCodec::Engine && Config.ExportFormat == ECDGRenderOutputFormat::EXR_Sequence)
+				{
+					UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Image write codec %s is 8-bit only; writing EXR with MRQ's writer instead"),
+						FCDGImageWritePool::GetExtension(Config.ImageWrite.Codec));
+				}
+
 				// Add specific image sequence output based on format
 				// Use FindObject to get the class without including headers
 				UClass* OutputClass = nullptr;
@@ -1340,6 +1333,12 @@ namespace CDGMRQInterface
 				   Format == ECDGRenderOutputFormat::CommandLineEncoder;
 		}
 
+		bool UsesImageWritePool(const FTrajectoryRenderConfig& Config)
+		{
+			return Config.ImageWrite.Codec != ECDGImageCodec::Engine
+				&& (Config.ExportFormat == ECDGRenderOutputFormat::PNG_Sequence || Config.ExportFormat == ECDGRenderOutputFormat::BMP_Sequence);
+		}
+
 		bool ExportIndexJSON(const FString& OutputDir, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS)
 		{
 			// Create a temporary array to pass to TrajectorySL
@@ -1362,6 +1361,44 @@ namespace CDGMRQInterface
 			return bSuccess;
 		}
 
+		TArray<FString> MakeFrameMetadata(ACDGTrajectory* Trajectory, int32 FPS, const FString& LevelName)
+		{
+			TArray<FString> FrameMetadata;
+
+			// Same per-frame entries as Index.json, for this trajectory only
+			FString IndexJson;
+			if (!Trajectory || !TrajectorySL::SaveTrajectoriesAsString(IndexJson, { Trajectory }, FPS, false))
+			{
+				return FrameMetadata;
+			}
+
+			TSharedPtr<FJsonObject> Root;
+			const TArray<TSharedPtr<FJsonValue>>* TrajectoriesArray = nullptr;
+			const TArray<TSharedPtr<FJsonValue>>* FramesArray = nullptr;
+			if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(IndexJson), Root) || !Root.IsValid()
+				|| !Root->TryGetArrayField(TEXT("Trajectories"), TrajectoriesArray) || TrajectoriesArray->Num() == 0
+				|| !(*TrajectoriesArray)[0]->AsObject()->TryGetArrayField(TEXT("Frames"), FramesArray))
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: No frame data for %s"), *Trajectory->TrajectoryName.ToString());
+				return FrameMetadata;
+			}
+
+			FrameMetadata.Reserve(FramesArray->Num());
+			for (const TSharedPtr<FJsonValue>& FrameValue : *FramesArray)
+			{
+				TSharedPtr<FJsonObject> FrameObj = FrameValue->AsObject();
+				FrameObj->SetStringField(TEXT("LevelName"), LevelName);
+				FrameObj->SetStringField(TEXT("TrajectoryName"), Trajectory->TrajectoryName.ToString());
+
+				FString FrameJson;
+				TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+					TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&FrameJson);
+				FJsonSerializer::Serialize(FrameObj.ToSharedRef(), Writer);
+				FrameMetadata.Add(MoveTemp(FrameJson));
+			}
+			return FrameMetadata;
+		}
+
 		FString SetupOutputDirectory(const FString& RootDir, const FString& LevelName)
 		{
 			// Create directory structure: <RootDir>/<LevelName>/OUTPUTS/
@@ -1394,273 +1431,254 @@ namespace CDGMRQInterface
 		}
 
 		/**
-		 * Download FFmpeg from reliable source
-		 * @param DestinationPath - Where to save the downloaded file
-		 * @param OnComplete - Callback when download completes (success, error message)
+		 * Find a local FFmpeg; see the declaration for the search order
+		 * @return true if FFmpeg is available, false otherwise
 		 */
-		void DownloadFFmpeg(const FString& DestinationPath, TFunction<void(bool, const FString&)> OnComplete)
+		bool EnsureFFmpegAvailable(FString& OutFFmpegPath, const FString& ConfiguredPath)
 		{
-			UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Starting FFmpeg download..."));
+#if PLATFORM_WINDOWS
+			const FString ExeName = TEXT("ffmpeg.exe");
+#else
+			const FString ExeName = TEXT("ffmpeg");
+#endif
 
-			// Use BtbN/FFmpeg-Builds which provides direct download links
-			// This is a reliable, frequently updated source
-			FString DownloadURL = TEXT("https://github.com/BtbN/FFmpeg-Builds/releases/download/latest/ffmpeg-master-latest-win64-gpl.zip");
-			
-			TSharedRef<IHttpRequest> HttpRequest = FHttpModule::Get().CreateRequest();
-			HttpRequest->SetURL(DownloadURL);
-			HttpRequest->SetVerb(TEXT("GET"));
-			HttpRequest->SetTimeout(300.0f); // 5 minute timeout for large file
-			
-			HttpRequest->OnProcessRequestComplete().BindLambda([DestinationPath, OnComplete](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+			// 1. Explicitly configured executable (or the directory holding it)
+			TArray<FString> PossiblePaths;
+			if (!ConfiguredPath.IsEmpty())
 			{
-				if (!bWasSuccessful || !Response.IsValid())
-				{
-					FString Error = TEXT("Failed to download FFmpeg: Network error");
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: %s"), *Error);
-					OnComplete(false, Error);
-					return;
-				}
+				PossiblePaths.Add(FPaths::DirectoryExists(ConfiguredPath) ? FPaths::Combine(ConfiguredPath, ExeName) : ConfiguredPath);
+			}
 
-				if (Response->GetResponseCode() != 200)
+			// 2. Locations bundled with the engine or project
+#if PLATFORM_WINDOWS
+			PossiblePaths.Add(FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/bin/ffmpeg.exe")));
+			PossiblePaths.Add(FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/ffmpeg.exe")));
+			PossiblePaths.Add(FPaths::Combine(FPaths::ProjectDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/bin/ffmpeg.exe")));
+			PossiblePaths.Add(FPaths::Combine(FPaths::ProjectDir(), TEXT("Binaries/Win64/ffmpeg.exe")));
+#else
+			PossiblePaths.Add(FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg"), FPlatformProcess::GetBinariesSubdirectory(), ExeName));
+			PossiblePaths.Add(FPaths::Combine(FPaths::ProjectDir(), TEXT("Binaries/ThirdParty/FFmpeg"), FPlatformProcess::GetBinariesSubdirectory(), ExeName));
+			PossiblePaths.Add(FPaths::Combine(FPaths::ProjectDir(), TEXT("Binaries"), FPlatformProcess::GetBinariesSubdirectory(), ExeName));
+#endif
+
+			// 3. Every PATH entry; editors started from a desktop launcher may have a
+			// short PATH, so the usual system locations are tried as well
+			TArray<FString> PathDirs;
+			FPlatformMisc::GetEnvironmentVariable(TEXT("PATH")).ParseIntoArray(PathDirs, FPlatformMisc::GetPathVarDelimiter());
+#if PLATFORM_LINUX
+			PathDirs.Append({ TEXT("/usr/local/bin"), TEXT("/usr/bin"), TEXT("/snap/bin") });
+#endif
+			for (const FString& Dir : PathDirs)
+			{
+				PossiblePaths.AddUnique(FPaths::Combine(Dir, ExeName));
+			}
+
+			// Running the binary once is cheap, but not once per job
+			static TMap<FString, bool> VerifiedPaths;
+
+			for (const FString& Path : PossiblePaths)
+			{
+				if (!FPaths::FileExists(Path))
 				{
-					FString Error = FString::Printf(TEXT("Failed to download FFmpeg: HTTP %d"), Response->GetResponseCode());
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: %s"), *Error);
-					OnComplete(false, Error);
-					return;
+					continue;
 				}
 
-				// Save the downloaded zip file
-				if (FFileHelper::SaveArrayToFile(Response->GetContent(), *DestinationPath))
+				bool* bVerified = VerifiedPaths.Find(Path);
+				if (!bVerified)
 				{
-					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: FFmpeg downloaded to: %s"), *DestinationPath);
-					OnComplete(true, FString());
+					int32 ReturnCode = -1;
+					FString StdOut, StdErr;
+					const bool bRan = FPlatformProcess::ExecProcess(*Path, TEXT("-hide_banner -version"), &ReturnCode, &StdOut, &StdErr);
+					bVerified = &VerifiedPaths.Add(Path, bRan && ReturnCode == 0);
+
+					FString FirstLine;
+					StdOut.Split(TEXT("\n"), &FirstLine, nullptr);
+					if (*bVerified)
+					{
+						UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: %s"), *(FirstLine.IsEmpty() ? StdOut : FirstLine).TrimEnd());
+					}
+					else
+					{
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: %s exists but does not run (exit code %d)"), *Path, ReturnCode);
+					}
 				}
-				else
+
+				if (*bVerified)
 				{
-					FString Error = FString::Printf(TEXT("Failed to save FFmpeg to: %s"), *DestinationPath);
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: %s"), *Error);
-					OnComplete(false, Error);
+					OutFFmpegPath = FPaths::ConvertRelativePathToFull(Path);
+					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Found FFmpeg at: %s"), *OutFFmpegPath);
+					return true;
 				}
-			});
+			}
+			
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: FFmpeg not found in any expected location"));
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Checked paths:"));
+			for (const FString& Path : PossiblePaths)
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("  - %s"), *Path);
+			}
+
+#if PLATFORM_WINDOWS
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Download FFmpeg from: https://github.com/BtbN/FFmpeg-Builds/releases/latest"));
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Extract ffmpeg.exe to: %s"),
+				*FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/bin")));
+#else
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Install FFmpeg with the system package manager (e.g. apt install ffmpeg)"));
+#endif
+			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: or point VideoEncode.EncoderPath at an FFmpeg executable"));
 
-			HttpRequest->ProcessRequest();
+			return false;
 		}
 
-		/**
-		 * Extract FFmpeg executable from downloaded zip
-		 * @param ZipPath - Path to the downloaded zip file
-		 * @param DestinationDir - Directory to extract to
-		 * @return Path to extracted ffmpeg.exe, or empty string on failure
-		 */
-		FString ExtractFFmpegFromZip(const FString& ZipPath, const FString& DestinationDir)
+		FString PickVideoCodec(const FString& FFmpegPath, const FString& Preferred)
 		{
-			UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Extracting FFmpeg from: %s"), *ZipPath);
+			static TMap<FString, FString> EncoderLists;
 
-			// Unreal doesn't have built-in zip extraction, so we'll use Windows PowerShell
-			FString PowerShellCommand = FString::Printf(
-				TEXT("powershell -Command \"Expand-Archive -Path '%s' -DestinationPath '%s' -Force\""),
-				*ZipPath, *DestinationDir
-			);
+			FString* Encoders = EncoderLists.Find(FFmpegPath);
+			if (!Encoders)
+			{
+				int32 ReturnCode = -1;
+				FString StdOut, StdErr;
+				FPlatformProcess::ExecProcess(*FFmpegPath, TEXT("-hide_banner -encoders"), &ReturnCode, &StdOut, &StdErr);
+				Encoders = &EncoderLists.Add(FFmpegPath, ReturnCode == 0 ? StdOut : FString());
+			}
 
-			int32 ReturnCode = 0;
-			FString StdOut;
-			FString StdErr;
+			// Without a listing there is nothing to check against; trust the preference
+			if (Encoders->IsEmpty())
+			{
+				return Preferred;
+			}
 
-			if (FPlatformProcess::ExecProcess(TEXT("cmd.exe"), *FString::Printf(TEXT("/c %s"), *PowerShellCommand), &ReturnCode, &StdOut, &StdErr))
+			// Encoder lines look like " V....D libx264   libx264 H.264 / AVC ..."
+			for (const FString& Codec : { Preferred, FString(TEXT("libx264")), FString(TEXT("libopenh264")), FString(TEXT("mpeg4")) })
 			{
-				if (ReturnCode == 0)
+				if (!Codec.IsEmpty() && Encoders->Contains(FString::Printf(TEXT(" %s "), *Codec), ESearchCase::CaseSensitive))
 				{
-					// Find ffmpeg.exe in the extracted directory
-					// BtbN builds have structure: ffmpeg-master-latest-win64-gpl/bin/ffmpeg.exe
-					TArray<FString> PossiblePaths = {
-						FPaths::Combine(DestinationDir, TEXT("ffmpeg-master-latest-win64-gpl/bin/ffmpeg.exe")),
-						FPaths::Combine(DestinationDir, TEXT("bin/ffmpeg.exe")),
-						FPaths::Combine(DestinationDir, TEXT("ffmpeg.exe"))
-					};
-
-					for (const FString& Path : PossiblePaths)
+					if (Codec != Preferred)
 					{
-						if (FPaths::FileExists(Path))
-						{
-							UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Found ffmpeg.exe at: %s"), *Path);
-							return Path;
-						}
+						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: FFmpeg at %s has no %s encoder, using %s"),
+							*FFmpegPath, *Preferred, *Codec);
 					}
-
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: ffmpeg.exe not found in extracted files"));
-					return FString();
-				}
-				else
-				{
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Extraction failed with code %d: %s"), ReturnCode, *StdErr);
-					return FString();
+					return Codec;
 				}
 			}
-
-			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Failed to start extraction process"));
-			return FString();
+			return Preferred;
 		}
 
-		/**
-		 * Automatically download and install FFmpeg if not found
-		 * @param TargetPath - Where FFmpeg should be installed
-		 * @return true if FFmpeg is available (either found or downloaded), false otherwise
-		 */
-		bool EnsureFFmpegAvailable(FString& OutFFmpegPath)
+		FString MakeVideoEncodeArgs(const FCDGVideoEncodeSettings& Settings, const FString& VideoCodec)
 		{
-			// Check multiple possible FFmpeg locations
-			TArray<FString> PossiblePaths = {
-				FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/bin/ffmpeg.exe")),
-				FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/ffmpeg.exe")),
-				FPaths::Combine(FPaths::ProjectDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64/bin/ffmpeg.exe")),
-				FPaths::Combine(FPaths::ProjectDir(), TEXT("Binaries/Win64/ffmpeg.exe"))
-			};
-			
-			for (const FString& Path : PossiblePaths)
+			FString Args;
+			if (VideoCodec == TEXT("libx264") || VideoCodec == TEXT("libx265"))
 			{
-				if (FPaths::FileExists(Path))
-				{
-					OutFFmpegPath = Path;
-					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Found FFmpeg at: %s"), *Path);
-					return true;
-				}
+				Args = FString::Printf(TEXT("-crf %d -preset %s"), Settings.CRF, *Settings.Preset);
 			}
-			
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: FFmpeg not found in any expected location"));
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Checked paths:"));
-			for (const FString& Path : PossiblePaths)
+			else
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("  - %s"), *Path);
+				// No CRF outside x264 / x265; a fixed high-quality quantizer instead
+				Args = TEXT("-q:v 2");
 			}
 
-			// FFmpeg not found, download it
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: FFmpeg not found, downloading automatically..."));
-
-			FString DownloadDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FFmpeg"));
-			FString ZipPath = FPaths::Combine(DownloadDir, TEXT("ffmpeg.zip"));
-			FString ExtractDir = FPaths::Combine(DownloadDir, TEXT("extracted"));
-			FString FinalPath = FPaths::Combine(FPaths::EngineDir(), TEXT("Binaries/ThirdParty/FFmpeg/Win64"));
-
-			// Create directories
-			IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-			PlatformFile.CreateDirectoryTree(*DownloadDir);
-			PlatformFile.CreateDirectoryTree(*ExtractDir);
-			PlatformFile.CreateDirectoryTree(*FinalPath);
+			if (Settings.Threads > 0)
+			{
+				Args += FString::Printf(TEXT(" -threads %d"), Settings.Threads);
+			}
+			Args += TEXT(" -pix_fmt yuv420p -movflags +faststart");
 
-			// Download FFmpeg (synchronous for simplicity)
-			bool bDownloadSuccess = false;
-			FString DownloadError;
-			
-			// We need to block and wait for the download
-			// For now, we'll log the instruction and return false
-			// A full async implementation would require more complex state management
-			
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Automatic FFmpeg download requires async implementation"));
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Please manually download FFmpeg from: https://github.com/BtbN/FFmpeg-Builds/releases/latest"));
-			UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Extract ffmpeg.exe to: %s"), *FinalPath);
+			if (!Settings.ExtraArgs.IsEmpty())
+			{
+				Args += TEXT(" ") + Settings.ExtraArgs;
+			}
+			return Args;
+		}
 
-			return false;
+		FString MakeEncoderPipeArgs(const FString& FFmpegPath, const FCDGVideoEncodeSettings& Settings)
+		{
+			const FString VideoCodec = PickVideoCodec(FFmpegPath, Settings.VideoCodec);
+			return FString::Printf(TEXT("-c:v %s %s"), *VideoCodec, *MakeVideoEncodeArgs(Settings, VideoCodec));
 		}
 		
-		/**
-		 * Validate MP4 files and cleanup PNG frames
-		 * Checks that:
-		 * 1. MP4 file exists
-		 * 2. MP4 file has reasonable size (> 1KB)
-		 * 3. If valid, deletes corresponding PNG frames
-		 */
-		int32 ValidateAndCleanupVideoOutput(const FString& OutputDir)
+		bool MakeExpectedOutput(ULevelSequence* ShotSequence, ACDGTrajectory* Trajectory, const FTrajectoryRenderConfig& Config,
+			const FString& LevelName, FCDGExpectedOutput& OutExpected)
 		{
-			IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-			
-			// Find OUTPUTS subdirectory
-			FString OutputsDir = FPaths::Combine(OutputDir, TEXT("OUTPUTS"));
-			if (!PlatformFile.DirectoryExists(*OutputsDir))
-			{
-				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: OUTPUTS directory not found: %s"), *OutputsDir);
-				return 0;
-			}
-			
-			// Find all MP4 files
-			TArray<FString> MP4Files;
-			IFileManager& FileManager = IFileManager::Get();
-			FString SearchPattern = FPaths::Combine(OutputsDir, TEXT("*.mp4"));
-			FileManager.FindFiles(MP4Files, *SearchPattern, true, false);
-			
-			if (MP4Files.Num() == 0)
+			if (!Trajectory || Config.FrameSink == ECDGFrameSinkKind::Custom)
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: No MP4 files found in: %s"), *OutputsDir);
-				return 0;
+				return false;
 			}
-			
-			int32 TotalPNGsDeleted = 0;
-			
-			for (const FString& MP4File : MP4Files)
+
+			OutExpected = FCDGExpectedOutput();
+			OutExpected.ShotName     = Trajectory->TrajectoryName.ToString();
+			OutExpected.OutputDir    = FPaths::Combine(Config.DestinationRootDir, LevelName, TEXT("OUTPUTS"));
+			OutExpected.FileNameBase = FString::Printf(TEXT("%s.%s"), *LevelName, *OutExpected.ShotName);
+			OutExpected.Size         = Config.OutputResolutionOverride;
+
+			// Frames in the shot's playback range at the output frame rate
+			if (const UMovieScene* MovieScene = ShotSequence ? ShotSequence->GetMovieScene() : nullptr)
 			{
-				FString FullMP4Path = FPaths::Combine(OutputsDir, MP4File);
-				
-				// Validate MP4 file
-				int64 FileSize = PlatformFile.FileSize(*FullMP4Path);
-				
-				if (FileSize <= 0)
-				{
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: MP4 file has invalid size: %s (size: %lld)"), *MP4File, FileSize);
-					continue;
-				}
-				
-				// Minimum size check - MP4 files should be at least 1KB
-				const int64 MinValidSize = 1024;
-				if (FileSize < MinValidSize)
+				const TRange<FFrameNumber> Range = MovieScene->GetPlaybackRange();
+				if (Range.HasLowerBound() && Range.HasUpperBound() && !Range.IsEmpty())
 				{
-					UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: MP4 file too small (possibly corrupt): %s (size: %lld bytes)"), *MP4File, FileSize);
-					continue;
+					const FFrameRate OutputRate = Config.OutputFramerateOverride > 0
+						? FFrameRate(Config.OutputFramerateOverride, 1)
+						: MovieScene->GetDisplayRate();
+					const FFrameTime Ticks(Range.GetUpperBoundValue() - Range.GetLowerBoundValue());
+					OutExpected.NumFrames = FFrameRate::TransformTime(Ticks, MovieScene->GetTickResolution(), OutputRate).RoundToFrame().Value;
 				}
-				
-				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Validated MP4 file: %s (size: %.2f MB)"), 
-					*MP4File, FileSize / (1024.0 * 1024.0));
-				
-				// Extract base name without extension
-				// Format: <LevelName>_<TrajectoryName>.mp4
-				FString BaseName = FPaths::GetBaseFilename(MP4File);
-				
-				// Find all corresponding PNG files
-				// Format: <LevelName>_<TrajectoryName>.####.png
-				TArray<FString> PNGFiles;
-				FString PNGSearchPattern = FPaths::Combine(OutputsDir, BaseName + TEXT(".*.png"));
-				FileManager.FindFiles(PNGFiles, *PNGSearchPattern, true, false);
-				
-				int32 PNGsDeleted = 0;
-				for (const FString& PNGFile : PNGFiles)
-				{
-					FString FullPNGPath = FPaths::Combine(OutputsDir, PNGFile);
-					
-					if (PlatformFile.DeleteFile(*FullPNGPath))
-					{
-						PNGsDeleted++;
-					}
-					else
-					{
-						UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("CDGMRQInterface: Failed to delete PNG frame: %s"), *PNGFile);
-					}
-				}
-				
-				if (PNGsDeleted > 0)
+			}
+
+			// Same choices as ConfigureMoviePipelineJob (FFmpeg lookups are cached)
+			FString FFmpegPath;
+			if (Config.FrameSink != ECDGFrameSinkKind::None
+				&& (Config.FrameSink != ECDGFrameSinkKind::EncoderPipe || EnsureFFmpegAvailable(FFmpegPath, Config.VideoEncode.EncoderPath)))
+			{
+				OutExpected.Kind = Config.FrameSink == ECDGFrameSinkKind::EncoderPipe ? ECDGOutputKind::Video
+					: Config.FrameSink == ECDGFrameSinkKind::TarShards ? ECDGOutputKind::TarShards
+					: ECDGOutputKind::Chunks;
+				if (OutExpected.Kind == ECDGOutputKind::TarShards)
 				{
-					UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Cleaned up %d PNG frames for: %s"), PNGsDeleted, *MP4File);
-					TotalPNGsDeleted += PNGsDeleted;
+					OutExpected.ShardSetName = LevelName;
 				}
 			}
-			
-			if (TotalPNGsDeleted > 0)
+			else if (Config.ExportFormat == ECDGRenderOutputFormat::H264_Video && EnsureFFmpegAvailable(FFmpegPath, Config.VideoEncode.EncoderPath))
 			{
-				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT(""));
-				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("*************************************************************"));
-				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("*** VIDEO ENCODING COMPLETE - CLEANED UP %d PNG FRAMES ***"), TotalPNGsDeleted);
-				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("*************************************************************"));
-				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT(""));
+				OutExpected.Kind                 = ECDGOutputKind::Video;
+				OutExpected.bDeleteIntermediates = true;
 			}
-			
-			return TotalPNGsDeleted;
+			else if (IsVideoFormat(Config.ExportFormat))
+			{
+				OutExpected.Extension = TEXT("png");
+			}
+			else if (UsesImageWritePool(Config))
+			{
+				OutExpected.Extension = FCDGImageWritePool::GetExtension(Config.ImageWrite.Codec);
+			}
+			else
+			{
+				OutExpected.Extension = Config.ExportFormat == ECDGRenderOutputFormat::BMP_Sequence ? TEXT("bmp")
+					: Config.ExportFormat == ECDGRenderOutputFormat::EXR_Sequence ? TEXT("exr")
+					: TEXT("png");
+			}
+			return true;
+		}
+
+		bool ReportInvalidOutputs(const TArray<FCDGValidationResult>& Results)
+		{
+			const TArray<FString> FailedShots = CDGOutputValidator::GetFailedShots(Results);
+			if (FailedShots.IsEmpty())
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: All %d rendered output(s) validated"), Results.Num());
+				return true;
+			}
+
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: %d of %d shot(s) have missing or broken output and need a re-render (see %s): %s"),
+				FailedShots.Num(), Results.Num(), CDGOutputValidator::ReportFileName, *FString::Join(FailedShots, TEXT(", ")));
+			return false;
+		}
+
+		bool FrameSinkFailed(const UMoviePipelineExecutorJob* Job)
+		{
+			UMoviePipelinePrimaryConfig* JobConfig = Job ? Job->GetConfiguration() : nullptr;
+			const UCDGMoviePipelineFrameSinkOutput* Sink = JobConfig ? JobConfig->FindSetting<UCDGMoviePipelineFrameSinkOutput>() : nullptr;
+			return Sink && !Sink->Succeeded();
 		}
 	}
 }
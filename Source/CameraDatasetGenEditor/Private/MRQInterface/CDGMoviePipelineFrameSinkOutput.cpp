@@ -0,0 +1,166 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MRQInterface/CDGMoviePipelineFrameSinkOutput.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "ImagePixelData.h"
+#include "MoviePipeline.h"
+#include "MoviePipelineImageQuantization.h"
+#include "MoviePipelinePrimaryConfig.h"
+#include "MovieRenderPipelineDataTypes.h"
+
+bool UCDGMoviePipelineFrameSinkOutput::BeginStream(int32 ShotIndex, FIntPoint Size, ECDGFramePixelFormat Format)
+{
+	EndStream();
+	StreamShotIndex = ShotIndex;
+	NumFrames       = 0;
+	bStreamFailed   = true;
+
+	// One sink for every shot of the job; Finish() runs when the job finalizes.
+	if (!Sink)
+	{
+		FCDGFrameSinkSettings Settings;
+		Settings.Kind           = SinkKind;
+		Settings.EncoderPath    = EncoderPath;
+		Settings.EncoderArgs    = EncoderArgs;
+		Settings.FramesPerChunk = FramesPerChunk;
+		Settings.ImageWrite     = ImageWrite;
+		Settings.ShardSizeMB    = ShardSizeMB;
+		Settings.ShardSetName   = ShardSetName;
+		Sink = MakeFrameSink(Settings);
+	}
+	if (!Sink)
+	{
+		FailStream(FString::Printf(TEXT("no frame sink for kind %s"),
+			*StaticEnum<ECDGFrameSinkKind>()->GetNameStringByValue(int64(SinkKind))));
+		return false;
+	}
+
+	FCDGFrameStreamInfo Info;
+	Info.OutputDir = OutputDirectory;
+	Info.BaseName  = ShotIndex > 0 ? FString::Printf(TEXT("%s.shot%d"), *FileNameBase, ShotIndex) : FileNameBase;
+	Info.Size      = Size;
+	Info.Format    = Format;
+	if (ShotIndex == 0)
+	{
+		Info.FrameMetadata = FrameMetadata;
+	}
+	if (const UMoviePipeline* Pipeline = GetPipeline())
+	{
+		Info.FrameRate = Pipeline->GetPipelinePrimaryConfig()->GetEffectiveFrameRate(Pipeline->GetTargetSequence());
+	}
+
+	bStreamFailed = !Sink->Begin(Info);
+	if (bStreamFailed)
+	{
+		FailStream(FString::Printf(TEXT("could not start %s"), *Info.BaseName));
+	}
+	return !bStreamFailed;
+}
+
+void UCDGMoviePipelineFrameSinkOutput::EndStream()
+{
+	if (!Sink || StreamShotIndex == INDEX_NONE) return;
+
+	const bool bOK = Sink->End() && !bStreamFailed;
+	if (!bOK && !bStreamFailed)
+	{
+		FailStream(FString::Printf(TEXT("could not finish %s"), *FileNameBase));
+	}
+	for (const FString& File : Sink->GetOutputFiles())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Frame sink wrote %s"), *File);
+	}
+	UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Frame sink stream %s (%d frame(s)) %s"),
+		*FileNameBase, NumFrames, bOK ? TEXT("complete") : TEXT("FAILED"));
+
+	StreamShotIndex = INDEX_NONE;
+}
+
+void UCDGMoviePipelineFrameSinkOutput::OnReceiveImageDataImpl(FMoviePipelineMergerOutputFrame* InMergedOutputFrame)
+{
+	if (!InMergedOutputFrame || InMergedOutputFrame->ImageOutputData.Num() == 0)
+	{
+		return;
+	}
+
+	// First pass only (the final image for the default deferred pass).
+	const FImagePixelData* Data = InMergedOutputFrame->ImageOutputData.CreateConstIterator()->Value.Get();
+	if (!Data)
+	{
+		return;
+	}
+
+	// The encoder and YUV sinks take 8-bit BGRA; raw chunks keep the pass's own precision.
+	TUniquePtr<FImagePixelData> Quantized;
+	if (SinkKind != ECDGFrameSinkKind::RawChunks && Data->GetType() != EImagePixelType::Color)
+	{
+		Quantized = UE::MoviePipeline::QuantizeImagePixelDataToBitDepth(Data, 8);
+		Data      = Quantized.Get();
+	}
+
+	ECDGFramePixelFormat Format = ECDGFramePixelFormat::BGRA8;
+	switch (Data->GetType())
+	{
+	case EImagePixelType::Color:   Format = ECDGFramePixelFormat::BGRA8;   break;
+	case EImagePixelType::Float16: Format = ECDGFramePixelFormat::RGBA16F; break;
+	case EImagePixelType::Float32: Format = ECDGFramePixelFormat::RGBA32F; break;
+	}
+
+	const int32 ShotIndex = InMergedOutputFrame->FrameOutputState.ShotIndex;
+	if (ShotIndex != StreamShotIndex && !BeginStream(ShotIndex, Data->GetSize(), Format))
+	{
+		return;
+	}
+	if (bStreamFailed)
+	{
+		return;
+	}
+
+	const void* RawData  = nullptr;
+	int64       RawBytes = 0;
+	Data->GetRawData(RawData, RawBytes);
+
+	FCDGFrame Frame;
+	Frame.FrameNumber = InMergedOutputFrame->FrameOutputState.OutputFrameNumber;
+	Frame.Pixels      = TConstArrayView<uint8>(static_cast<const uint8*>(RawData), static_cast<int32>(RawBytes));
+	bStreamFailed = !Sink->Write(Frame);
+	if (bStreamFailed)
+	{
+		FailStream(FString::Printf(TEXT("could not write frame %d of %s"), Frame.FrameNumber, *FileNameBase));
+	}
+	++NumFrames;
+}
+
+void UCDGMoviePipelineFrameSinkOutput::FailStream(const FString& Reason)
+{
+	bStreamFailed = true;
+	bAnyFailed    = true;
+	UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("CDGMRQInterface: Frame sink (%s) failed: %s"),
+		*StaticEnum<ECDGFrameSinkKind>()->GetNameStringByValue(int64(SinkKind)), *Reason);
+
+	// Frames still to come would only be dropped; end the job as failed.
+	if (!bShutdownRequested)
+	{
+		if (UMoviePipeline* Pipeline = GetPipeline())
+		{
+			bShutdownRequested = true;
+			Pipeline->RequestShutdown(/*bIsError=*/true);
+		}
+	}
+}
+
+void UCDGMoviePipelineFrameSinkOutput::OnShotFinishedImpl(const UMoviePipelineExecutorShot* InShot, const bool bFlushToDisk)
+{
+	EndStream();
+}
+
+void UCDGMoviePipelineFrameSinkOutput::BeginFinalizeImpl()
+{
+	EndStream();
+	if (Sink && !Sink->Finish())
+	{
+		FailStream(FString::Printf(TEXT("could not finish the output of %s"), *FileNameBase));
+	}
+	Sink.Reset();
+}
@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MRQInterface/CDGMoviePipelineImageWriteOutput.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "ImagePixelData.h"
+#include "MoviePipelineImageQuantization.h"
+#include "MovieRenderPipelineDataTypes.h"
+#include "Misc/Paths.h"
+
+void UCDGMoviePipelineImageWriteOutput::OnReceiveImageDataImpl(FMoviePipelineMergerOutputFrame* InMergedOutputFrame)
+{
+	if (!InMergedOutputFrame || InMergedOutputFrame->ImageOutputData.Num() == 0)
+	{
+		return;
+	}
+
+	// First pass only (the final image for the default deferred pass).
+	const FImagePixelData* Data = InMergedOutputFrame->ImageOutputData.CreateConstIterator()->Value.Get();
+	if (!Data)
+	{
+		return;
+	}
+
+	TUniquePtr<FImagePixelData> Quantized;
+	if (Data->GetType() != EImagePixelType::Color)
+	{
+		Quantized = UE::MoviePipeline::QuantizeImagePixelDataToBitDepth(Data, 8);
+		Data      = Quantized.Get();
+	}
+
+	if (!Pool)
+	{
+		IFileManager::Get().MakeDirectory(*OutputDirectory, /*Tree=*/true);
+		Pool = MakeUnique<FCDGImageWritePool>(Settings);
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Writing %s frames with %d worker(s), up to %d queued"),
+			FCDGImageWritePool::GetExtension(Settings.Codec), Pool->GetNumWorkers(), Pool->GetMaxQueuedFrames());
+	}
+
+	const void* RawData  = nullptr;
+	int64       RawBytes = 0;
+	Data->GetRawData(RawData, RawBytes);
+
+	// The quantized buffer is owned by this frame, so the pixels are copied for the worker.
+	TArray64<uint8> Pixels;
+	Pixels.Append(static_cast<const uint8*>(RawData), RawBytes);
+
+	FString FrameNumber = FString::FromInt(InMergedOutputFrame->FrameOutputState.OutputFrameNumber);
+	while (FrameNumber.Len() < ZeroPadFrameNumbers)
+	{
+		FrameNumber.InsertAt(0, TEXT('0'));
+	}
+	Pool->Enqueue(FPaths::Combine(OutputDirectory, FileNameBase + TEXT(".") + FrameNumber), Data->GetSize(), MoveTemp(Pixels));
+}
+
+void UCDGMoviePipelineImageWriteOutput::OnShotFinishedImpl(const UMoviePipelineExecutorShot* InShot, const bool bFlushToDisk)
+{
+	if (Pool && bFlushToDisk)
+	{
+		Pool->Flush();
+	}
+}
+
+void UCDGMoviePipelineImageWriteOutput::BeginFinalizeImpl()
+{
+	if (!Pool) return;
+
+	Pool->Flush();
+	UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("CDGMRQInterface: Image write pool: %s"), *Pool->GetStats().ToString());
+	Pool.Reset();
+}
+
+bool UCDGMoviePipelineImageWriteOutput::HasFinishedProcessingImpl()
+{
+	return !Pool || Pool->IsIdle();
+}
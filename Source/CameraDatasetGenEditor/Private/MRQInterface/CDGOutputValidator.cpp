@@ -0,0 +1,1367 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MRQInterface/CDGOutputValidator.h"
+#include "MRQInterface/CDGImageWritePool.h"
+#include "MRQInterface/CDGTarShardWriter.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "Algo/AllOf.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/LargeMemoryReader.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+
+const TCHAR* CDGOutputValidator::ReportFileName = TEXT("CDGValidation.json");
+
+namespace
+{
+	/** Errors listed per shot before the rest are summarised. */
+	constexpr int32 MaxErrorsPerShot = 10;
+
+	/** Bytes read for an image header (EXR headers carry every attribute). */
+	constexpr int64 ImageHeaderBytes = 256 * 1024;
+
+	constexpr uint32 FourCC(const char* Code)
+	{
+		return (uint32(uint8(Code[0])) << 24) | (uint32(uint8(Code[1])) << 16) | (uint32(uint8(Code[2])) << 8) | uint32(uint8(Code[3]));
+	}
+
+	uint32 ReadBE32(const uint8* P) { return (uint32(P[0]) << 24) | (uint32(P[1]) << 16) | (uint32(P[2]) << 8) | uint32(P[3]); }
+	uint64 ReadBE64(const uint8* P) { return (uint64(ReadBE32(P)) << 32) | ReadBE32(P + 4); }
+	uint16 ReadLE16(const uint8* P) { return uint16(P[0] | (P[1] << 8)); }
+	uint32 ReadLE32(const uint8* P) { return uint32(P[0]) | (uint32(P[1]) << 8) | (uint32(P[2]) << 16) | (uint32(P[3]) << 24); }
+	uint64 ReadLE64(const uint8* P) { return uint64(ReadLE32(P)) | (uint64(ReadLE32(P + 4)) << 32); }
+
+	FString FourCCToString(uint32 Type)
+	{
+		FString Out;
+		for (int32 Shift = 24; Shift >= 0; Shift -= 8)
+		{
+			const TCHAR Char = TCHAR((Type >> Shift) & 0xFF);
+			Out.AppendChar(Char >= 32 && Char < 127 ? Char : TEXT('?'));
+		}
+		return Out;
+	}
+
+	/** Num bytes at Offset; false when the archive is shorter. */
+	bool ReadAt(FArchive& Ar, int64 Offset, void* Dest, int64 Num)
+	{
+		if (Offset < 0 || Num < 0 || Offset + Num > Ar.TotalSize()) return false;
+		Ar.Seek(Offset);
+		Ar.Serialize(Dest, Num);
+		return !Ar.IsError();
+	}
+
+	// ── MP4 boxes ────────────────────────────────────────────────────────────
+
+	struct FBox
+	{
+		uint32 Type        = 0;
+		int64  Offset      = 0;
+		int64  HeaderBytes = 0;
+		int64  Size        = 0;
+
+		int64 PayloadOffset() const { return Offset + HeaderBytes; }
+		int64 PayloadSize()   const { return Size - HeaderBytes; }
+		int64 End()           const { return Offset + Size; }
+	};
+
+	/** Box header at Offset inside [.., End); false for a malformed or truncated box. */
+	bool ReadBoxHeader(FArchive& Ar, int64 Offset, int64 End, FBox& Out, FString& OutError)
+	{
+		uint8 Header[16];
+		if (Offset + 8 > End || !ReadAt(Ar, Offset, Header, 8))
+		{
+			OutError = FString::Printf(TEXT("%lld stray byte(s) at offset %lld, file truncated"), End - Offset, Offset);
+			return false;
+		}
+
+		Out.Offset      = Offset;
+		Out.Type        = ReadBE32(Header + 4);
+		Out.HeaderBytes = 8;
+		uint64 Size     = ReadBE32(Header);
+		if (Size == 1)
+		{
+			if (Offset + 16 > End || !ReadAt(Ar, Offset + 8, Header + 8, 8))
+			{
+				OutError = FString::Printf(TEXT("'%s' box at %lld is cut off"), *FourCCToString(Out.Type), Offset);
+				return false;
+			}
+			Size            = ReadBE64(Header + 8);
+			Out.HeaderBytes = 16;
+		}
+		else if (Size == 0)
+		{
+			// Runs to the end of the enclosing box
+			Size = uint64(End - Offset);
+		}
+
+		if (Size < uint64(Out.HeaderBytes) || Size > uint64(End - Offset))
+		{
+			OutError = FString::Printf(TEXT("'%s' box at %lld claims %llu bytes but only %lld remain, file truncated"),
+				*FourCCToString(Out.Type), Offset, Size, End - Offset);
+			return false;
+		}
+		Out.Size = int64(Size);
+		return true;
+	}
+
+	/**
+	 * Calls Visit(Box) for each child of Parent until it returns false.
+	 * False only when a child box is malformed.
+	 */
+	template<typename FunctorType>
+	bool ForEachChild(FArchive& Ar, const FBox& Parent, FString& OutError, FunctorType&& Visit)
+	{
+		int64 Offset = Parent.PayloadOffset();
+		while (Offset < Parent.End())
+		{
+			FBox Box;
+			if (!ReadBoxHeader(Ar, Offset, Parent.End(), Box, OutError)) return false;
+			if (!Visit(Box)) return true;
+			Offset = Box.End();
+		}
+		return true;
+	}
+
+	bool FindChild(FArchive& Ar, const FBox& Parent, uint32 Type, FBox& Out)
+	{
+		FString Ignored;
+		bool bFound = false;
+		ForEachChild(Ar, Parent, Ignored, [&](const FBox& Box)
+		{
+			bFound = Box.Type == Type;
+			if (bFound) Out = Box;
+			return !bFound;
+		});
+		return bFound;
+	}
+
+	/** Up to MaxBytes of a box's payload. */
+	bool ReadPayload(FArchive& Ar, const FBox& Box, int64 MaxBytes, TArray<uint8>& Out)
+	{
+		const int64 Num = FMath::Min(Box.PayloadSize(), MaxBytes);
+		Out.SetNumUninitialized(int32(Num));
+		return Num == 0 || ReadAt(Ar, Box.PayloadOffset(), Out.GetData(), Num);
+	}
+
+	/** Seconds from an mvhd / mdhd payload (version 0 or 1). */
+	double ReadBoxDuration(const TArray<uint8>& P)
+	{
+		uint32 TimeScale = 0;
+		uint64 Duration  = 0;
+		if (P.Num() >= 32 && P[0] == 1)
+		{
+			TimeScale = ReadBE32(&P[20]);
+			Duration  = ReadBE64(&P[24]);
+		}
+		else if (P.Num() >= 20)
+		{
+			TimeScale = ReadBE32(&P[12]);
+			Duration  = ReadBE32(&P[16]);
+		}
+		return TimeScale > 0 ? double(Duration) / TimeScale : 0.0;
+	}
+
+	/** Size, sample count and duration of Trak; false when it is not a video track. */
+	bool ReadVideoTrack(FArchive& Ar, const FBox& Trak, FCDGMediaInfo& Out)
+	{
+		TArray<uint8> P;
+		FBox Mdia, Hdlr;
+		if (!FindChild(Ar, Trak, FourCC("mdia"), Mdia) || !FindChild(Ar, Mdia, FourCC("hdlr"), Hdlr)
+			|| !ReadPayload(Ar, Hdlr, 12, P) || P.Num() < 12 || ReadBE32(&P[8]) != FourCC("vide"))
+		{
+			return false;
+		}
+
+		// Presentation size, 16.16 fixed point at the end of tkhd
+		FBox Box;
+		if (FindChild(Ar, Trak, FourCC("tkhd"), Box) && ReadPayload(Ar, Box, 96, P))
+		{
+			const int32 SizeAt = P.Num() > 0 && P[0] == 1 ? 88 : 76;
+			if (P.Num() >= SizeAt + 8)
+			{
+				Out.Size = FIntPoint(int32(ReadBE32(&P[SizeAt]) >> 16), int32(ReadBE32(&P[SizeAt + 4]) >> 16));
+			}
+		}
+
+		if (FindChild(Ar, Mdia, FourCC("mdhd"), Box) && ReadPayload(Ar, Box, 32, P))
+		{
+			Out.DurationSeconds = ReadBoxDuration(P);
+		}
+
+		FBox Minf, Stbl;
+		if (!FindChild(Ar, Mdia, FourCC("minf"), Minf) || !FindChild(Ar, Minf, FourCC("stbl"), Stbl))
+		{
+			return true;
+		}
+
+		// Coded size from the first visual sample entry when tkhd has none
+		if ((Out.Size.X <= 0 || Out.Size.Y <= 0) && FindChild(Ar, Stbl, FourCC("stsd"), Box) && ReadPayload(Ar, Box, 44, P) && P.Num() >= 44)
+		{
+			Out.Size = FIntPoint((P[40] << 8) | P[41], (P[42] << 8) | P[43]);
+		}
+
+		// Sample count: stsz / stz2, else the stts run lengths
+		if ((FindChild(Ar, Stbl, FourCC("stsz"), Box) || FindChild(Ar, Stbl, FourCC("stz2"), Box))
+			&& ReadPayload(Ar, Box, 12, P) && P.Num() >= 12)
+		{
+			Out.NumFrames = int32(FMath::Min<uint32>(ReadBE32(&P[8]), MAX_int32));
+		}
+		if (Out.NumFrames <= 0 && FindChild(Ar, Stbl, FourCC("stts"), Box) && ReadPayload(Ar, Box, 8 * 1024 * 1024, P) && P.Num() >= 8)
+		{
+			const uint32 NumEntries = ReadBE32(&P[4]);
+			int64 Samples = 0;
+			for (int32 Entry = 0; uint32(Entry) < NumEntries && 16 + Entry * 8 <= P.Num(); ++Entry)
+			{
+				Samples += ReadBE32(&P[8 + Entry * 8]);
+			}
+			Out.NumFrames = int32(FMath::Min<int64>(Samples, MAX_int32));
+		}
+		return true;
+	}
+
+	// ── Images ───────────────────────────────────────────────────────────────
+
+	/** What an image header implies about the rest of the file. */
+	struct FImageLayout
+	{
+		/** Smallest complete file the header allows */
+		int64 MinFileBytes = 0;
+		/** EXR: where the chunk offset table starts */
+		int64 HeaderEnd = 0;
+		/** EXR single-part scanline: entries in the offset table (0 = not checked) */
+		int32 NumChunks = 0;
+	};
+
+	bool ParseImageHeader(TConstArrayView<uint8> H, FCDGMediaInfo& Out, FImageLayout& Layout, FString& OutError)
+	{
+		static const uint8 PNGMagic[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+		static const uint8 EXRMagic[4] = { 0x76, 0x2F, 0x31, 0x01 };
+
+		Out.NumFrames = 1;
+		if (H.Num() >= 8 && FMemory::Memcmp(H.GetData(), PNGMagic, 8) == 0)
+		{
+			Out.Format = TEXT("png");
+			if (H.Num() < 33 || ReadBE32(&H[12]) != FourCC("IHDR"))
+			{
+				OutError = TEXT("PNG has no IHDR chunk");
+				return false;
+			}
+			Out.Size            = FIntPoint(int32(ReadBE32(&H[16])), int32(ReadBE32(&H[20])));
+			Layout.MinFileBytes = 8 + 25 + 12; // signature, IHDR, IEND
+		}
+		else if (H.Num() >= 2 && H[0] == 'B' && H[1] == 'M')
+		{
+			Out.Format = TEXT("bmp");
+			if (H.Num() < 26)
+			{
+				OutError = TEXT("BMP header is cut off");
+				return false;
+			}
+			const uint32 FileBytes  = ReadLE32(&H[2]);
+			const uint32 DataOffset = ReadLE32(&H[10]);
+			const uint32 InfoBytes  = ReadLE32(&H[14]);
+			int32  Height      = 0;
+			uint16 BitCount    = 0;
+			uint32 Compression = 0;
+			if (InfoBytes == 12)
+			{
+				Out.Size.X = ReadLE16(&H[18]);
+				Height     = ReadLE16(&H[20]);
+				BitCount   = ReadLE16(&H[24]);
+			}
+			else if (H.Num() >= 34)
+			{
+				Out.Size.X  = int32(ReadLE32(&H[18]));
+				Height      = int32(ReadLE32(&H[22]));
+				BitCount    = ReadLE16(&H[28]);
+				Compression = ReadLE32(&H[30]);
+			}
+			else
+			{
+				OutError = TEXT("BMP info header is cut off");
+				return false;
+			}
+			Out.Size.Y          = FMath::Abs(Height);
+			Layout.MinFileBytes = FMath::Max<int64>(FileBytes, DataOffset);
+
+			// Uncompressed rows are padded to 4 bytes
+			if (Compression == 0 || Compression == 3)
+			{
+				const int64 RowBytes = (int64(Out.Size.X) * BitCount + 31) / 32 * 4;
+				Layout.MinFileBytes = FMath::Max<int64>(Layout.MinFileBytes, DataOffset + RowBytes * Out.Size.Y);
+			}
+		}
+		else if (H.Num() >= 4 && FMemory::Memcmp(H.GetData(), "qoif", 4) == 0)
+		{
+			Out.Format = TEXT("qoi");
+			if (H.Num() < 14 || (H[12] != 3 && H[12] != 4))
+			{
+				OutError = TEXT("QOI header is cut off or invalid");
+				return false;
+			}
+			Out.Size            = FIntPoint(int32(ReadBE32(&H[4])), int32(ReadBE32(&H[8])));
+			Layout.MinFileBytes = 14 + 8; // header, end marker
+		}
+		else if (H.Num() >= 8 && FMemory::Memcmp(H.GetData(), EXRMagic, 4) == 0)
+		{
+			Out.Format = TEXT("exr");
+			const uint32 Flags = ReadLE32(&H[4]);
+			const bool bSinglePartScanline = (Flags & (0x200 | 0x800 | 0x1000)) == 0; // not tiled, deep or multi-part
+
+			// Lines per chunk by compression: none, RLE, ZIPS, ZIP, PIZ, PXR24, B44, B44A, DWAA, DWAB
+			static const int32 LinesPerChunk[] = { 1, 1, 1, 16, 32, 16, 32, 32, 32, 256 };
+			int32 Lines = 1;
+			bool bHasWindow = false;
+
+			// Attributes: name\0 type\0 size value ... then an empty name
+			int32 Pos = 8;
+			auto ReadString = [&H, &Pos](FString& Str)
+			{
+				int32 End = Pos;
+				while (End < H.Num() && H[End] != 0) ++End;
+				if (End >= H.Num()) return false;
+				Str = ANSI_TO_TCHAR(reinterpret_cast<const ANSICHAR*>(&H[Pos]));
+				Pos = End + 1;
+				return true;
+			};
+			for (;;)
+			{
+				if (Pos >= H.Num())
+				{
+					OutError = TEXT("EXR header is cut off");
+					return false;
+				}
+				if (H[Pos] == 0)
+				{
+					++Pos;
+					break;
+				}
+
+				FString Name, Type;
+				if (!ReadString(Name) || !ReadString(Type) || Pos + 4 > H.Num())
+				{
+					OutError = TEXT("EXR header is cut off");
+					return false;
+				}
+				const int32 ValueBytes = int32(ReadLE32(&H[Pos]));
+				Pos += 4;
+				if (ValueBytes < 0 || Pos + ValueBytes > H.Num())
+				{
+					OutError = FString::Printf(TEXT("EXR attribute '%s' is cut off"), *Name);
+					return false;
+				}
+
+				if (Name == TEXT("dataWindow") && Type == TEXT("box2i") && ValueBytes == 16)
+				{
+					const int32 MinX = int32(ReadLE32(&H[Pos])),     MinY = int32(ReadLE32(&H[Pos + 4]));
+					const int32 MaxX = int32(ReadLE32(&H[Pos + 8])), MaxY = int32(ReadLE32(&H[Pos + 12]));
+					Out.Size   = FIntPoint(MaxX - MinX + 1, MaxY - MinY + 1);
+					bHasWindow = true;
+				}
+				else if (Name == TEXT("compression") && ValueBytes == 1 && H[Pos] < UE_ARRAY_COUNT(LinesPerChunk))
+				{
+					Lines = LinesPerChunk[H[Pos]];
+				}
+				Pos += ValueBytes;
+			}
+
+			if (!bHasWindow)
+			{
+				OutError = TEXT("EXR header has no dataWindow");
+				return false;
+			}
+			Layout.HeaderEnd    = Pos;
+			Layout.NumChunks    = bSinglePartScanline && Out.Size.Y > 0 ? FMath::DivideAndRoundUp(Out.Size.Y, Lines) : 0;
+			Layout.MinFileBytes = Pos + int64(Layout.NumChunks) * 8;
+		}
+		else
+		{
+			OutError = TEXT("not a PNG, BMP, QOI or EXR image");
+			return false;
+		}
+
+		if (Out.Size.X <= 0 || Out.Size.Y <= 0)
+		{
+			OutError = FString::Printf(TEXT("%s header has size %dx%d"), *Out.Format.ToUpper(), Out.Size.X, Out.Size.Y);
+			return false;
+		}
+		return true;
+	}
+
+	/** Probe the image stored at [Start, Start + Size) of Ar: header, then whether the file is complete. */
+	bool ProbeImageAt(FArchive& Ar, int64 Start, int64 Size, FCDGMediaInfo& Out, FString& OutError)
+	{
+		Out = FCDGMediaInfo();
+		if (Size <= 0)
+		{
+			OutError = TEXT("file is empty");
+			return false;
+		}
+
+		TArray<uint8> Head;
+		Head.SetNumUninitialized(int32(FMath::Min(Size, ImageHeaderBytes)));
+		FImageLayout Layout;
+		if (!ReadAt(Ar, Start, Head.GetData(), Head.Num()))
+		{
+			OutError = TEXT("could not be read");
+			return false;
+		}
+		if (!ParseImageHeader(Head, Out, Layout, OutError))
+		{
+			return false;
+		}
+		if (Size < Layout.MinFileBytes)
+		{
+			OutError = FString::Printf(TEXT("%s is %lld bytes, its header needs at least %lld, file truncated"),
+				*Out.Format.ToUpper(), Size, Layout.MinFileBytes);
+			return false;
+		}
+
+		// Trailers written last by each encoder
+		uint8 Tail[8];
+		if (Out.Format == TEXT("png") || Out.Format == TEXT("qoi"))
+		{
+			static const uint8 QOIEnd[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+			const bool bComplete = ReadAt(Ar, Start + Size - 8, Tail, 8)
+				&& (Out.Format == TEXT("png") ? ReadBE32(Tail) == FourCC("IEND") : FMemory::Memcmp(Tail, QOIEnd, 8) == 0);
+			if (!bComplete)
+			{
+				OutError = FString::Printf(TEXT("%s has no end marker, file truncated"), *Out.Format.ToUpper());
+				return false;
+			}
+		}
+		else if (Layout.NumChunks > 0)
+		{
+			// Every scanline chunk must start inside the file
+			TArray<uint8> Offsets;
+			Offsets.SetNumUninitialized(Layout.NumChunks * 8);
+			if (!ReadAt(Ar, Start + Layout.HeaderEnd, Offsets.GetData(), Offsets.Num()))
+			{
+				OutError = TEXT("EXR offset table is cut off");
+				return false;
+			}
+			for (int32 Chunk = 0; Chunk < Layout.NumChunks; ++Chunk)
+			{
+				const uint64 Offset = ReadLE64(&Offsets[Chunk * 8]);
+				if (Offset < uint64(Layout.MinFileBytes) || Offset >= uint64(Size))
+				{
+					OutError = FString::Printf(TEXT("EXR chunk %d of %d starts at %llu, past the end (%lld bytes), file truncated"),
+						Chunk, Layout.NumChunks, Offset, Size);
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// ── Shot checks ──────────────────────────────────────────────────────────
+
+	void AddError(FCDGValidationResult& Result, const FString& Error)
+	{
+		if (Result.Errors.Num() < MaxErrorsPerShot)
+		{
+			Result.Errors.Add(Error);
+		}
+		else if (Result.Errors.Num() == MaxErrorsPerShot)
+		{
+			Result.Errors.Add(TEXT("... further errors not listed"));
+		}
+	}
+
+	/** Size and frame count against what the shot was set up to produce. */
+	void CheckExpected(const FCDGExpectedOutput& Expected, FCDGValidationResult& Result)
+	{
+		if (Result.NumFrames <= 0)
+		{
+			AddError(Result, TEXT("no frames"));
+		}
+		else if (Expected.NumFrames > 0 && FMath::Abs(Result.NumFrames - Expected.NumFrames) > CDGOutputValidator::FrameCountTolerance)
+		{
+			AddError(Result, FString::Printf(TEXT("%d frame(s), expected %d"), Result.NumFrames, Expected.NumFrames));
+		}
+		if (Expected.Size.X > 0 && Expected.Size.Y > 0 && Result.Size != Expected.Size && Result.Size != FIntPoint::ZeroValue)
+		{
+			AddError(Result, FString::Printf(TEXT("size %dx%d, expected %dx%d"), Result.Size.X, Result.Size.Y, Expected.Size.X, Expected.Size.Y));
+		}
+	}
+
+	/** A probed file's size against the first one's (or the expected one). */
+	void CheckFrameSize(const FString& File, const FCDGMediaInfo& Info, FCDGValidationResult& Result)
+	{
+		if (Result.Size == FIntPoint::ZeroValue)
+		{
+			Result.Size = Info.Size;
+		}
+		else if (Info.Size != Result.Size)
+		{
+			AddError(Result, FString::Printf(TEXT("%s: size %dx%d, other frames are %dx%d"),
+				*File, Info.Size.X, Info.Size.Y, Result.Size.X, Result.Size.Y));
+		}
+	}
+
+	TSharedPtr<FJsonObject> LoadJson(const FString& Path)
+	{
+		FString Text;
+		TSharedPtr<FJsonObject> Root;
+		if (!FFileHelper::LoadFileToString(Text, *Path) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root))
+		{
+			return nullptr;
+		}
+		return Root;
+	}
+
+	void ValidateVideo(const FCDGExpectedOutput& Expected, FCDGValidationResult& Result)
+	{
+		const FString File = Expected.FileNameBase + TEXT(".mp4");
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*FPaths::Combine(Expected.OutputDir, File)));
+		if (!Ar)
+		{
+			AddError(Result, File + TEXT(" is missing"));
+			return;
+		}
+
+		++Result.NumFilesChecked;
+		FCDGMediaInfo Info;
+		FString Error;
+		if (!CDGOutputValidator::ProbeMP4(*Ar, Info, Error))
+		{
+			AddError(Result, File + TEXT(": ") + Error);
+			return;
+		}
+		Result.Size      = Info.Size;
+		Result.NumFrames = Info.NumFrames;
+		CheckExpected(Expected, Result);
+	}
+
+	void ValidateImageSequence(const FCDGExpectedOutput& Expected, FCDGValidationResult& Result)
+	{
+		const FString Prefix = Expected.FileNameBase + TEXT(".");
+		const FString Suffix = TEXT(".") + Expected.Extension;
+
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *FPaths::Combine(Expected.OutputDir, Prefix + TEXT("*") + Suffix), true, false);
+
+		// <Base>.<Frame>.<Extension> only; another trajectory's name may extend the base
+		TArray<TPair<int32, FString>> Frames;
+		for (const FString& File : Files)
+		{
+			FString Number = File;
+			if (Number.RemoveFromStart(Prefix) && Number.RemoveFromEnd(Suffix) && !Number.IsEmpty()
+				&& Algo::AllOf(Number, [](TCHAR Char) { return FChar::IsDigit(Char); }))
+			{
+				Frames.Emplace(FCString::Atoi(*Number), File);
+			}
+		}
+		Frames.Sort([](const TPair<int32, FString>& A, const TPair<int32, FString>& B) { return A.Key < B.Key; });
+
+		for (int32 Index = 1; Index < Frames.Num(); ++Index)
+		{
+			const int32 Missing = Frames[Index].Key - Frames[Index - 1].Key - 1;
+			if (Missing > 0)
+			{
+				AddError(Result, Missing == 1
+					? FString::Printf(TEXT("frame %d is missing"), Frames[Index - 1].Key + 1)
+					: FString::Printf(TEXT("frames %d-%d are missing"), Frames[Index - 1].Key + 1, Frames[Index].Key - 1));
+			}
+		}
+
+		for (const TPair<int32, FString>& Frame : Frames)
+		{
+			++Result.NumFilesChecked;
+			FCDGMediaInfo Info;
+			FString Error;
+			if (!CDGOutputValidator::ProbeFile(FPaths::Combine(Expected.OutputDir, Frame.Value), Info, Error))
+			{
+				AddError(Result, Frame.Value + TEXT(": ") + Error);
+				continue;
+			}
+			CheckFrameSize(Frame.Value, Info, Result);
+		}
+		Result.NumFrames = Frames.Num();
+		CheckExpected(Expected, Result);
+	}
+
+	void ValidateChunks(const FCDGExpectedOutput& Expected, FCDGValidationResult& Result)
+	{
+		const FString ManifestFile = Expected.FileNameBase + TEXT(".frames.json");
+		const TSharedPtr<FJsonObject> Manifest = LoadJson(FPaths::Combine(Expected.OutputDir, ManifestFile));
+		if (!Manifest.IsValid())
+		{
+			AddError(Result, ManifestFile + TEXT(" is missing or unreadable"));
+			return;
+		}
+
+		const int64 FrameBytes = int64(Manifest->GetNumberField(TEXT("FrameBytes")));
+		Result.Size      = FIntPoint(int32(Manifest->GetNumberField(TEXT("Width"))), int32(Manifest->GetNumberField(TEXT("Height"))));
+		Result.NumFrames = int32(Manifest->GetNumberField(TEXT("FrameCount")));
+		if (FrameBytes <= 0)
+		{
+			AddError(Result, ManifestFile + TEXT(" has no frame size"));
+			return;
+		}
+
+		// The chunks together hold exactly FrameCount frames
+		int64 TotalBytes = 0;
+		const TArray<TSharedPtr<FJsonValue>>* Chunks = nullptr;
+		if (Manifest->TryGetArrayField(TEXT("Chunks"), Chunks))
+		{
+			for (const TSharedPtr<FJsonValue>& Chunk : *Chunks)
+			{
+				const FString File = Chunk->AsString();
+				const int64 Bytes = IFileManager::Get().FileSize(*FPaths::Combine(Expected.OutputDir, File));
+				++Result.NumFilesChecked;
+				if (Bytes <= 0)
+				{
+					AddError(Result, File + (Bytes < 0 ? TEXT(" is missing") : TEXT(" is empty")));
+				}
+				else if (Bytes % FrameBytes != 0)
+				{
+					AddError(Result, FString::Printf(TEXT("%s: %lld bytes is not a whole number of %lld-byte frames"), *File, Bytes, FrameBytes));
+				}
+				TotalBytes += FMath::Max<int64>(Bytes, 0);
+			}
+		}
+		if (TotalBytes != Result.NumFrames * FrameBytes)
+		{
+			AddError(Result, FString::Printf(TEXT("chunks hold %lld frame(s), manifest lists %d"), TotalBytes / FrameBytes, Result.NumFrames));
+		}
+		CheckExpected(Expected, Result);
+	}
+
+	int64 ParseOctal(const uint8* Field, int32 Width)
+	{
+		int64 Value = 0;
+		for (int32 i = 0; i < Width && Field[i] != 0 && Field[i] != ' '; ++i)
+		{
+			if (Field[i] < '0' || Field[i] > '7') return -1;
+			Value = Value * 8 + (Field[i] - '0');
+		}
+		return Value;
+	}
+
+	/** True for the keys FCDGTarShardWriter::MakeKey() gives a stream: <KeyPrefix><frame number>. */
+	bool IsStreamKey(const FString& Key, const FString& KeyPrefix)
+	{
+		if (KeyPrefix.IsEmpty()) return true;
+		if (Key.Len() <= KeyPrefix.Len() || !Key.StartsWith(KeyPrefix, ESearchCase::CaseSensitive)) return false;
+		for (int32 i = KeyPrefix.Len(); i < Key.Len(); ++i)
+		{
+			if (!FChar::IsDigit(Key[i])) return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Walk one ustar shard: header checksums, member bounds, samples, and the
+	 * header of each image member whose key belongs to the stream (every one
+	 * when KeyPrefix is empty).  Returns all samples; the stream's are added
+	 * to OutStreamSamples.
+	 */
+	int32 ValidateTarShard(const FString& Path, const FString& KeyPrefix, FCDGValidationResult& Result, int32& OutStreamSamples)
+	{
+		const FString File = FPaths::GetCleanFilename(Path);
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Path));
+		if (!Ar)
+		{
+			AddError(Result, File + TEXT(" is missing"));
+			return 0;
+		}
+		++Result.NumFilesChecked;
+
+		const int64 FileSize = Ar->TotalSize();
+		int32   NumSamples = 0;
+		FString LastKey;
+		int64   Offset = 0;
+		uint8   Header[512];
+		while (Offset + 512 <= FileSize && ReadAt(*Ar, Offset, Header, 512))
+		{
+			uint32 Sum = 0;
+			bool bZero = true;
+			for (int32 i = 0; i < 512; ++i)
+			{
+				Sum  += (i >= 148 && i < 156) ? uint32(' ') : uint32(Header[i]);
+				bZero = bZero && Header[i] == 0;
+			}
+			if (bZero)
+			{
+				return NumSamples; // end-of-archive block
+			}
+			if (ParseOctal(Header + 148, 8) != int64(Sum))
+			{
+				AddError(Result, FString::Printf(TEXT("%s: bad header checksum at offset %lld"), *File, Offset));
+				return NumSamples;
+			}
+
+			const int64 DataBytes  = ParseOctal(Header + 124, 12);
+			const int64 DataOffset = Offset + 512;
+			if (DataBytes < 0 || DataOffset + DataBytes > FileSize)
+			{
+				AddError(Result, FString::Printf(TEXT("%s: member at offset %lld runs past the end, file truncated"), *File, Offset));
+				return NumSamples;
+			}
+
+			// WebDataset: <key>.<ext>, the key ends at the first dot of the file name
+			if (Header[156] == '0' || Header[156] == 0)
+			{
+				const int32 NameLen = FCStringAnsi::Strnlen(reinterpret_cast<const ANSICHAR*>(Header), 100);
+				const FUTF8ToTCHAR Name(reinterpret_cast<const ANSICHAR*>(Header), NameLen);
+				FString Key(Name.Length(), Name.Get());
+				FString Extension;
+				int32 Dot = INDEX_NONE;
+				if (Key.FindChar(TEXT('.'), Dot))
+				{
+					Extension = Key.Mid(Dot + 1);
+					Key.LeftInline(Dot);
+				}
+				const bool bStreamKey = IsStreamKey(Key, KeyPrefix);
+				if (Key != LastKey || NumSamples == 0)
+				{
+					LastKey = Key;
+					++NumSamples;
+					OutStreamSamples += bStreamKey ? 1 : 0;
+				}
+
+				if (bStreamKey && (Extension == TEXT("png") || Extension == TEXT("qoi") || Extension == TEXT("bmp")))
+				{
+					FCDGMediaInfo Info;
+					FString Error;
+					if (!ProbeImageAt(*Ar, DataOffset, DataBytes, Info, Error))
+					{
+						AddError(Result, FString::Printf(TEXT("%s: %s.%s: %s"), *File, *Key, *Extension, *Error));
+					}
+					else
+					{
+						CheckFrameSize(Key + TEXT(".") + Extension, Info, Result);
+					}
+				}
+			}
+			Offset = DataOffset + Align(DataBytes, 512);
+		}
+
+		AddError(Result, File + TEXT(" has no end-of-archive block, file truncated"));
+		return NumSamples;
+	}
+
+	/**
+	 * A whole set (ShardSetName empty) or one shot's stream in a shared set:
+	 * only the shards the index lists for the stream are walked, and only the
+	 * stream's samples count as its frames.
+	 */
+	void ValidateTarShards(const FCDGExpectedOutput& Expected, FCDGValidationResult& Result)
+	{
+		const bool bStream = !Expected.ShardSetName.IsEmpty();
+		const FString IndexFile = (bStream ? Expected.ShardSetName : Expected.FileNameBase) + TEXT(".shards.json");
+		const TSharedPtr<FJsonObject> Index = LoadJson(FPaths::Combine(Expected.OutputDir, IndexFile));
+		if (!Index.IsValid())
+		{
+			AddError(Result, IndexFile + TEXT(" is missing or unreadable"));
+			return;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Shards = nullptr;
+		Index->TryGetArrayField(TEXT("Shards"), Shards);
+		const int32 NumShards = Shards ? Shards->Num() : 0;
+
+		// Shards to walk and the sample count the index promises for them
+		TArray<int32> ShardIndices;
+		FString KeyPrefix;
+		int32   Listed = 0;
+		if (bStream)
+		{
+			const TArray<TSharedPtr<FJsonValue>>* Streams = nullptr;
+			TSharedPtr<FJsonObject> Stream;
+			if (Index->TryGetArrayField(TEXT("Streams"), Streams))
+			{
+				for (const TSharedPtr<FJsonValue>& StreamValue : *Streams)
+				{
+					const TSharedPtr<FJsonObject> Candidate = StreamValue->AsObject();
+					if (Candidate.IsValid() && Candidate->GetStringField(TEXT("Name")) == Expected.FileNameBase)
+					{
+						Stream = Candidate;
+					}
+				}
+			}
+			if (!Stream.IsValid())
+			{
+				AddError(Result, FString::Printf(TEXT("%s lists no stream %s"), *IndexFile, *Expected.FileNameBase));
+				return;
+			}
+
+			const TArray<TSharedPtr<FJsonValue>>* StreamShards = nullptr;
+			if (Stream->TryGetArrayField(TEXT("Shards"), StreamShards))
+			{
+				for (const TSharedPtr<FJsonValue>& ShardIndex : *StreamShards)
+				{
+					ShardIndices.AddUnique(int32(ShardIndex->AsNumber()));
+				}
+			}
+			KeyPrefix = FCDGTarShardWriter::MakeKey(Expected.FileNameBase, 0).LeftChop(6);
+			Listed    = int32(Stream->GetNumberField(TEXT("Samples")));
+		}
+		else
+		{
+			for (int32 ShardIndex = 0; ShardIndex < NumShards; ++ShardIndex)
+			{
+				ShardIndices.Add(ShardIndex);
+			}
+			Listed = int32(Index->GetNumberField(TEXT("Samples")));
+		}
+
+		for (int32 ShardIndex : ShardIndices)
+		{
+			if (ShardIndex < 0 || ShardIndex >= NumShards)
+			{
+				AddError(Result, FString::Printf(TEXT("%s lists shard %d of %d"), *IndexFile, ShardIndex, NumShards));
+				continue;
+			}
+			const TSharedPtr<FJsonObject> Shard = (*Shards)[ShardIndex]->AsObject();
+			const FString File        = Shard->GetStringField(TEXT("File"));
+			const int32   ShardListed = int32(Shard->GetNumberField(TEXT("Samples")));
+			int32 StreamSamples = 0;
+			const int32 Found = ValidateTarShard(FPaths::Combine(Expected.OutputDir, File), KeyPrefix, Result, StreamSamples);
+			if (Found != ShardListed)
+			{
+				AddError(Result, FString::Printf(TEXT("%s holds %d sample(s), index lists %d"), *File, Found, ShardListed));
+			}
+			Result.NumFrames += StreamSamples;
+		}
+
+		if (Result.NumFrames != Listed)
+		{
+			AddError(Result, FString::Printf(TEXT("shards hold %d sample(s) of %s, index lists %d"),
+				Result.NumFrames, *Expected.FileNameBase, Listed));
+		}
+		CheckExpected(Expected, Result);
+	}
+
+	/** After a clip validates: the PNG frames it was encoded from. */
+	int32 DeleteIntermediates(const FCDGExpectedOutput& Expected)
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *FPaths::Combine(Expected.OutputDir, Expected.FileNameBase + TEXT(".*.png")), true, false);
+
+		int32 NumDeleted = 0;
+		for (const FString& File : Files)
+		{
+			NumDeleted += IFileManager::Get().Delete(*FPaths::Combine(Expected.OutputDir, File)) ? 1 : 0;
+		}
+		return NumDeleted;
+	}
+}
+
+bool CDGOutputValidator::ProbeMP4(FArchive& Ar, FCDGMediaInfo& Out, FString& OutError)
+{
+	Out = FCDGMediaInfo();
+	Out.Format = TEXT("mp4");
+
+	const int64 FileSize = Ar.TotalSize();
+	if (FileSize <= 0)
+	{
+		OutError = TEXT("file is empty");
+		return false;
+	}
+
+	// ── Top level: ftyp first, then moov and mdat in either order ─────────────
+	FBox File;
+	File.Size = FileSize;
+
+	FBox  Moov;
+	bool  bHasFtyp  = false;
+	bool  bHasMoov  = false;
+	int32 NumBoxes  = 0;
+	int64 MdatBytes = 0;
+	const bool bWellFormed = ForEachChild(Ar, File, OutError, [&](const FBox& Box)
+	{
+		bHasFtyp |= NumBoxes++ == 0 && Box.Type == FourCC("ftyp");
+		if (Box.Type == FourCC("moov") && !bHasMoov)
+		{
+			Moov     = Box;
+			bHasMoov = true;
+		}
+		if (Box.Type == FourCC("mdat"))
+		{
+			MdatBytes += Box.PayloadSize();
+		}
+		return true;
+	});
+
+	if (!bWellFormed)
+	{
+		return false;
+	}
+	if (!bHasFtyp)
+	{
+		OutError = TEXT("no leading ftyp box, not an MP4 file");
+		return false;
+	}
+	if (!bHasMoov)
+	{
+		OutError = TEXT("no moov box, the encoder did not finish");
+		return false;
+	}
+	if (MdatBytes <= 0)
+	{
+		OutError = TEXT("mdat is missing or empty");
+		return false;
+	}
+
+	// ── Movie header and the first video track ───────────────────────────────
+	TArray<uint8> Payload;
+	FBox Mvhd;
+	if (FindChild(Ar, Moov, FourCC("mvhd"), Mvhd) && ReadPayload(Ar, Mvhd, 32, Payload))
+	{
+		Out.DurationSeconds = ReadBoxDuration(Payload);
+	}
+
+	bool bHasVideo = false;
+	ForEachChild(Ar, Moov, OutError, [&](const FBox& Box)
+	{
+		FCDGMediaInfo Track;
+		bHasVideo = Box.Type == FourCC("trak") && ReadVideoTrack(Ar, Box, Track);
+		if (bHasVideo)
+		{
+			Out.Size            = Track.Size;
+			Out.NumFrames       = Track.NumFrames;
+			Out.DurationSeconds = Track.DurationSeconds > 0.0 ? Track.DurationSeconds : Out.DurationSeconds;
+		}
+		return !bHasVideo;
+	});
+
+	if (!bHasVideo)
+	{
+		OutError = TEXT("no video track");
+		return false;
+	}
+	if (Out.NumFrames <= 0)
+	{
+		OutError = TEXT("video track has no samples");
+		return false;
+	}
+	if (Out.Size.X <= 0 || Out.Size.Y <= 0)
+	{
+		OutError = TEXT("video track has no size");
+		return false;
+	}
+	OutError.Reset();
+	return true;
+}
+
+bool CDGOutputValidator::ProbeImage(FArchive& Ar, FCDGMediaInfo& Out, FString& OutError)
+{
+	return ProbeImageAt(Ar, 0, Ar.TotalSize(), Out, OutError);
+}
+
+bool CDGOutputValidator::ProbeFile(const FString& Path, FCDGMediaInfo& Out, FString& OutError)
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Path));
+	if (!Ar)
+	{
+		Out = FCDGMediaInfo();
+		OutError = TEXT("is missing");
+		return false;
+	}
+
+	uint8 Magic[8] = {};
+	const bool bMP4 = ReadAt(*Ar, 0, Magic, 8) && ReadBE32(Magic + 4) == FourCC("ftyp");
+	return bMP4 ? ProbeMP4(*Ar, Out, OutError) : ProbeImage(*Ar, Out, OutError);
+}
+
+FCDGValidationResult CDGOutputValidator::ValidateOutput(const FCDGExpectedOutput& Expected)
+{
+	FCDGValidationResult Result;
+	Result.ShotName     = Expected.ShotName;
+	Result.FileNameBase = Expected.FileNameBase;
+
+	switch (Expected.Kind)
+	{
+	case ECDGOutputKind::Video:         ValidateVideo(Expected, Result);         break;
+	case ECDGOutputKind::ImageSequence: ValidateImageSequence(Expected, Result); break;
+	case ECDGOutputKind::Chunks:        ValidateChunks(Expected, Result);        break;
+	case ECDGOutputKind::TarShards:     ValidateTarShards(Expected, Result);     break;
+	}
+	Result.bValid = Result.Errors.IsEmpty();
+
+	if (Result.bValid && Expected.Kind == ECDGOutputKind::Video && Expected.bDeleteIntermediates)
+	{
+		Result.NumIntermediatesDeleted = DeleteIntermediates(Expected);
+	}
+
+	if (Result.bValid)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[Validate] OK %s: %d frame(s) %dx%d in %d file(s)%s"),
+			*Expected.FileNameBase, Result.NumFrames, Result.Size.X, Result.Size.Y, Result.NumFilesChecked,
+			Result.NumIntermediatesDeleted > 0 ? *FString::Printf(TEXT(", %d intermediate frame(s) deleted"), Result.NumIntermediatesDeleted) : TEXT(""));
+	}
+	else
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[Validate] FAILED %s: %s"),
+			*Expected.FileNameBase, *FString::Join(Result.Errors, TEXT("; ")));
+	}
+	return Result;
+}
+
+void CDGOutputValidator::ValidateAsync(TArray<FCDGExpectedOutput> Expected,
+	TFunction<void(const TArray<FCDGValidationResult>&)> OnValidated)
+{
+	Async(EAsyncExecution::ThreadPool, [Expected = MoveTemp(Expected), OnValidated = MoveTemp(OnValidated)]() mutable
+	{
+		TArray<FCDGValidationResult> Results;
+		Results.SetNum(Expected.Num());
+		ParallelFor(Expected.Num(), [&Expected, &Results](int32 Index)
+		{
+			Results[Index] = ValidateOutput(Expected[Index]);
+		});
+
+		// One report per OUTPUTS directory
+		TMap<FString, TArray<FCDGValidationResult>> ByDir;
+		for (int32 Index = 0; Index < Expected.Num(); ++Index)
+		{
+			ByDir.FindOrAdd(Expected[Index].OutputDir).Add(Results[Index]);
+		}
+		for (const TPair<FString, TArray<FCDGValidationResult>>& Dir : ByDir)
+		{
+			WriteReport(Dir.Key, Dir.Value);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [Results = MoveTemp(Results), OnValidated = MoveTemp(OnValidated)]()
+		{
+			if (OnValidated)
+			{
+				OnValidated(Results);
+			}
+		});
+	});
+}
+
+bool CDGOutputValidator::WriteReport(const FString& OutputDir, const TArray<FCDGValidationResult>& Results)
+{
+	const FString Path = FPaths::Combine(OutputDir, ReportFileName);
+
+	// Shots validated earlier (before a re-render of the others) stay in the report
+	TMap<FString, TSharedPtr<FJsonObject>> Shots;
+	TArray<FString> Order;
+	if (const TSharedPtr<FJsonObject> Existing = LoadJson(Path))
+	{
+		const TArray<TSharedPtr<FJsonValue>>* ShotArray = nullptr;
+		if (Existing->TryGetArrayField(TEXT("Shots"), ShotArray))
+		{
+			for (const TSharedPtr<FJsonValue>& Value : *ShotArray)
+			{
+				const TSharedPtr<FJsonObject> Shot = Value->AsObject();
+				const FString Output = Shot.IsValid() ? Shot->GetStringField(TEXT("Output")) : FString();
+				if (!Output.IsEmpty() && !Shots.Contains(Output))
+				{
+					Shots.Add(Output, Shot);
+					Order.Add(Output);
+				}
+			}
+		}
+	}
+
+	for (const FCDGValidationResult& Result : Results)
+	{
+		TSharedPtr<FJsonObject> Shot = MakeShared<FJsonObject>();
+		Shot->SetStringField(TEXT("Shot"),   Result.ShotName);
+		Shot->SetStringField(TEXT("Output"), Result.FileNameBase);
+		Shot->SetBoolField(TEXT("Valid"),    Result.bValid);
+		Shot->SetNumberField(TEXT("Frames"), Result.NumFrames);
+		Shot->SetNumberField(TEXT("Width"),  Result.Size.X);
+		Shot->SetNumberField(TEXT("Height"), Result.Size.Y);
+		Shot->SetNumberField(TEXT("Files"),  Result.NumFilesChecked);
+
+		TArray<TSharedPtr<FJsonValue>> Errors;
+		for (const FString& Error : Result.Errors)
+		{
+			Errors.Add(MakeShared<FJsonValueString>(Error));
+		}
+		Shot->SetArrayField(TEXT("Errors"), Errors);
+
+		if (!Shots.Contains(Result.FileNameBase))
+		{
+			Order.Add(Result.FileNameBase);
+		}
+		Shots.Add(Result.FileNameBase, Shot);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> ShotArray;
+	TArray<TSharedPtr<FJsonValue>> Failed;
+	for (const FString& Output : Order)
+	{
+		const TSharedPtr<FJsonObject>& Shot = Shots[Output];
+		ShotArray.Add(MakeShared<FJsonValueObject>(Shot));
+		if (!Shot->GetBoolField(TEXT("Valid")))
+		{
+			Failed.Add(MakeShared<FJsonValueString>(Shot->GetStringField(TEXT("Shot"))));
+		}
+	}
+
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetBoolField(TEXT("Valid"), Failed.IsEmpty());
+	Root->SetArrayField(TEXT("Failed"), Failed);
+	Root->SetArrayField(TEXT("Shots"), ShotArray);
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	return FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)
+		&& FFileHelper::SaveStringToFile(JsonText, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+TArray<FString> CDGOutputValidator::GetFailedShots(const TArray<FCDGValidationResult>& Results)
+{
+	TArray<FString> Failed;
+	for (const FCDGValidationResult& Result : Results)
+	{
+		if (!Result.bValid)
+		{
+			Failed.Add(Result.ShotName);
+		}
+	}
+	return Failed;
+}
+
+TArray<FCDGExpectedOutput> CDGOutputValidator::DiscoverOutputs(const FString& OutputDir)
+{
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *FPaths::Combine(OutputDir, TEXT("*")), true, false);
+	Files.Sort();
+
+	TArray<FCDGExpectedOutput> Outputs;
+	TSet<FString> Seen;
+	auto Add = [&](const FString& Base, ECDGOutputKind Kind, const FString& Extension)
+	{
+		if (Seen.Contains(Base + TEXT("|") + Extension)) return;
+		Seen.Add(Base + TEXT("|") + Extension);
+
+		FCDGExpectedOutput& Output = Outputs.AddDefaulted_GetRef();
+		Output.ShotName     = Base;
+		Output.OutputDir    = OutputDir;
+		Output.FileNameBase = Base;
+		Output.Kind         = Kind;
+		Output.Extension    = Extension;
+	};
+
+	for (const FString& File : Files)
+	{
+		FString Base = File;
+		if (Base.RemoveFromEnd(TEXT(".mp4")))
+		{
+			Add(Base, ECDGOutputKind::Video, TEXT("mp4"));
+		}
+		else if (Base.RemoveFromEnd(TEXT(".frames.json")))
+		{
+			Add(Base, ECDGOutputKind::Chunks, TEXT("json"));
+		}
+		else if (Base.RemoveFromEnd(TEXT(".shards.json")))
+		{
+			Add(Base, ECDGOutputKind::TarShards, TEXT("json"));
+		}
+		else
+		{
+			// <Base>.<Frame>.<png|exr|bmp|qoi>
+			const FString Extension = FPaths::GetExtension(File);
+			FString Number;
+			Base = FPaths::GetBaseFilename(File);
+			if ((Extension == TEXT("png") || Extension == TEXT("exr") || Extension == TEXT("bmp") || Extension == TEXT("qoi"))
+				&& Base.Split(TEXT("."), &Base, &Number, ESearchCase::CaseSensitive, ESearchDir::FromEnd)
+				&& !Number.IsEmpty() && Algo::AllOf(Number, [](TCHAR Char) { return FChar::IsDigit(Char); }))
+			{
+				Add(Base, ECDGOutputKind::ImageSequence, Extension);
+			}
+		}
+	}
+	return Outputs;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Console commands
+//
+//   CDG.Validate.Probe <File>
+//   CDG.Validate.Dir <OUTPUTS directory>
+//
+// Probe prints what the header probes read from one file.  Dir validates every
+// clip, image sequence, chunk set and shard set it finds (without size or
+// length expectations) on the thread pool and writes the report there, so
+// sample outputs can be checked without rendering or an encoder.  Failures
+// are logged as errors.
+// ─────────────────────────────────────────────────────────────────────────────
+
+static FAutoConsoleCommand GCDGValidateProbe(
+	TEXT("CDG.Validate.Probe"),
+	TEXT("Print the header facts of an MP4 / PNG / BMP / QOI / EXR file.  Args: <File>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[Validate] Usage: CDG.Validate.Probe <File>"));
+			return;
+		}
+
+		const FString Path = FString::Join(Args, TEXT(" "));
+		FCDGMediaInfo Info;
+		FString Error;
+		if (CDGOutputValidator::ProbeFile(Path, Info, Error))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[Validate] %s: %s %dx%d, %d frame(s), %.3f s"),
+				*Path, *Info.Format, Info.Size.X, Info.Size.Y, Info.NumFrames, Info.DurationSeconds);
+		}
+		else
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[Validate] %s: %s"), *Path, *Error);
+		}
+	}));
+
+static FAutoConsoleCommand GCDGValidateDir(
+	TEXT("CDG.Validate.Dir"),
+	TEXT("Validate every rendered output found in a directory on worker threads.  Args: <OUTPUTS directory>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[Validate] Usage: CDG.Validate.Dir <OUTPUTS directory>"));
+			return;
+		}
+
+		const FString Dir = FString::Join(Args, TEXT(" "));
+		TArray<FCDGExpectedOutput> Outputs = CDGOutputValidator::DiscoverOutputs(Dir);
+		if (Outputs.IsEmpty())
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[Validate] No rendered outputs in %s"), *Dir);
+			return;
+		}
+
+		CDGOutputValidator::ValidateAsync(MoveTemp(Outputs), [Dir](const TArray<FCDGValidationResult>& Results)
+		{
+			const TArray<FString> Failed = CDGOutputValidator::GetFailedShots(Results);
+			if (Failed.IsEmpty())
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[Validate] %s: all %d output(s) valid"), *Dir, Results.Num());
+			}
+			else
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[Validate] %s: %d of %d output(s) FAILED: %s"),
+					*Dir, Failed.Num(), Results.Num(), *FString::Join(Failed, TEXT(", ")));
+			}
+		});
+	}));
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Tests
+// ─────────────────────────────────────────────────────────────────────────────
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Encodes frames in memory with every image codec, with and without alpha, at
+// an odd and an even size (row padding, width/height mix-ups): the probe must
+// read back the codec and size and reject a copy missing its last 8 bytes.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCDGValidateImageProbeTest, "CameraDatasetGen.Validate.ImageProbe",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCDGValidateImageProbeTest::RunTest(const FString& Parameters)
+{
+	const FIntPoint Sizes[] = { FIntPoint(37, 19), FIntPoint(256, 128) };
+
+	for (const ECDGImageCodec Codec : { ECDGImageCodec::PNG, ECDGImageCodec::QOI, ECDGImageCodec::BMP })
+	{
+		for (const bool bAlpha : { false, true })
+		{
+			for (const FIntPoint& Size : Sizes)
+			{
+				const FString Case = FString::Printf(TEXT("%s %s %dx%d"), FCDGImageWritePool::GetExtension(Codec),
+					bAlpha ? TEXT("RGBA") : TEXT("RGB"), Size.X, Size.Y);
+
+				TArray64<uint8> BGRA;
+				BGRA.SetNumUninitialized(int64(Size.X) * Size.Y * 4);
+				for (int64 i = 0; i < BGRA.Num(); ++i) BGRA[i] = uint8((i * 7) ^ (i >> 5));
+
+				FCDGImageWriteSettings Settings;
+				Settings.Codec       = Codec;
+				Settings.bWriteAlpha = bAlpha;
+				TArray64<uint8> File;
+				if (!TestTrue(Case + TEXT(": encodes"), FCDGImageWritePool::Encode(Settings, Size, BGRA.GetData(), File)))
+				{
+					continue;
+				}
+
+				FCDGMediaInfo Info;
+				FString Error;
+				FLargeMemoryReader Whole(File.GetData(), File.Num());
+				TestTrue(FString::Printf(TEXT("%s: probe accepts it (%s)"), *Case, *Error), CDGOutputValidator::ProbeImage(Whole, Info, Error));
+				TestEqual(Case + TEXT(": probed format"), Info.Format, FString(FCDGImageWritePool::GetExtension(Codec)));
+				TestEqual(Case + TEXT(": probed width"),  Info.Size.X, Size.X);
+				TestEqual(Case + TEXT(": probed height"), Info.Size.Y, Size.Y);
+
+				FLargeMemoryReader Truncated(File.GetData(), File.Num() - 8);
+				TestFalse(Case + TEXT(": truncated copy rejected"), CDGOutputValidator::ProbeImage(Truncated, Info, Error));
+			}
+		}
+	}
+	return true;
+}
+
+// Writes a three-frame PNG sequence into <Saved>/CDGValidateTest/: it must
+// validate with its frame count and size; with its middle frame truncated the
+// shot must fail, name the frame, and be logged as an error.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCDGValidateImageSequenceTest, "CameraDatasetGen.Validate.ImageSequence",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCDGValidateImageSequenceTest::RunTest(const FString& Parameters)
+{
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("CDGValidateTest"));
+	IFileManager::Get().DeleteDirectory(*OutputDir, /*RequireExists=*/false, /*Tree=*/true);
+
+	const FIntPoint Size(48, 27);
+	TArray64<uint8> BGRA;
+	BGRA.SetNumUninitialized(int64(Size.X) * Size.Y * 4);
+	for (int64 i = 0; i < BGRA.Num(); ++i) BGRA[i] = uint8(i * 13);
+
+	FCDGImageWriteSettings Settings;
+	Settings.Codec = ECDGImageCodec::PNG;
+	TArray64<uint8> Png;
+	if (!TestTrue(TEXT("PNG encodes"), FCDGImageWritePool::Encode(Settings, Size, BGRA.GetData(), Png)))
+	{
+		return true;
+	}
+
+	FCDGExpectedOutput Expected;
+	Expected.ShotName     = TEXT("Seq");
+	Expected.OutputDir    = OutputDir;
+	Expected.FileNameBase = TEXT("Test.Seq");
+	Expected.Kind         = ECDGOutputKind::ImageSequence;
+	Expected.Extension    = TEXT("png");
+	Expected.Size         = Size;
+	Expected.NumFrames    = 3;
+	for (int32 Frame = 0; Frame < Expected.NumFrames; ++Frame)
+	{
+		const FString Path = FPaths::Combine(OutputDir, FString::Printf(TEXT("Test.Seq.%04d.png"), Frame));
+		TestTrue(TEXT("Frame written"), FFileHelper::SaveArrayToFile(Png, *Path));
+	}
+
+	const FCDGValidationResult Valid = CDGOutputValidator::ValidateOutput(Expected);
+	TestTrue(FString::Printf(TEXT("Complete sequence validates (%s)"), *FString::Join(Valid.Errors, TEXT("; "))), Valid.bValid);
+	TestEqual(TEXT("Frames found"), Valid.NumFrames, Expected.NumFrames);
+	TestEqual(TEXT("Files checked"), Valid.NumFilesChecked, Expected.NumFrames);
+	TestTrue(TEXT("Size found"), Valid.Size == Size);
+
+	const FString Middle = FPaths::Combine(OutputDir, TEXT("Test.Seq.0001.png"));
+	TestTrue(TEXT("Frame truncated"), FFileHelper::SaveArrayToFile(TArrayView<const uint8>(Png.GetData(), int32(Png.Num() - 8)), *Middle));
+
+	AddExpectedError(TEXT("\\[Validate\\] FAILED Test\\.Seq"), EAutomationExpectedErrorFlags::Contains, 1);
+	const FCDGValidationResult Invalid = CDGOutputValidator::ValidateOutput(Expected);
+	TestFalse(TEXT("Sequence with a truncated frame validates"), Invalid.bValid);
+	TestTrue(FString::Printf(TEXT("The error names the truncated frame (%s)"), *FString::Join(Invalid.Errors, TEXT("; "))),
+		Invalid.Errors.ContainsByPredicate([](const FString& Error) { return Error.Contains(TEXT("Test.Seq.0001.png")); }));
+	TestEqual(TEXT("Failed shots"), CDGOutputValidator::GetFailedShots({ Invalid }).Num(), 1);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,395 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MRQInterface/CDGTarShardWriter.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+
+FCDGTarShardWriter::~FCDGTarShardWriter()
+{
+	if (Archive.IsValid())
+	{
+		End();
+	}
+}
+
+FString FCDGTarShardWriter::MakeKey(const FString& Base, int32 Index)
+{
+	FString Key = FString::Printf(TEXT("%s_%06d"), *Base, Index);
+	for (TCHAR& Char : Key)
+	{
+		if (!FChar::IsAlnum(Char) && Char != TEXT('_') && Char != TEXT('-'))
+		{
+			Char = TEXT('_');
+		}
+	}
+	return Key;
+}
+
+bool FCDGTarShardWriter::Begin(const FString& InOutputDir, const FString& InPrefix, int64 InMaxShardBytes)
+{
+	Archive.Reset();
+	Shards.Reset();
+	Streams.Reset();
+	OutputDir      = InOutputDir;
+	Prefix         = InPrefix;
+	MaxShardBytes  = InMaxShardBytes > 0 ? InMaxShardBytes : DefaultMaxShardBytes;
+	IndexPath      = FPaths::Combine(OutputDir, Prefix + TEXT(".shards.json"));
+	NumSamples     = 0;
+	bFailed        = false;
+	bIndexWritten  = false;
+
+	return IFileManager::Get().MakeDirectory(*OutputDir, /*Tree=*/true);
+}
+
+void FCDGTarShardWriter::BeginStream(const FString& Name)
+{
+	FStream& Stream = Streams.AddDefaulted_GetRef();
+	Stream.Name = Name;
+}
+
+bool FCDGTarShardWriter::OpenShard()
+{
+	FShard& Shard = Shards.AddDefaulted_GetRef();
+	Shard.File = FPaths::Combine(OutputDir, FString::Printf(TEXT("%s-%06d.tar"), *Prefix, Shards.Num() - 1));
+	Archive.Reset(IFileManager::Get().CreateFileWriter(*Shard.File));
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[TarShards] Could not create %s"), *Shard.File);
+		return false;
+	}
+	return true;
+}
+
+bool FCDGTarShardWriter::CloseShard()
+{
+	if (!Archive.IsValid()) return true;
+
+	// End of archive: two zero blocks.
+	static const uint8 Zeros[1024] = {};
+	Archive->Serialize(const_cast<uint8*>(Zeros), sizeof(Zeros));
+	Shards.Last().Bytes += sizeof(Zeros);
+
+	const bool bOK = Archive->Close() && !Archive->IsError();
+	Archive.Reset();
+	return bOK;
+}
+
+bool FCDGTarShardWriter::WriteMember(const FString& Name, TConstArrayView64<uint8> Data)
+{
+	// POSIX ustar header; names over 100 bytes go into the 155-byte prefix field.
+	uint8 Header[512] = {};
+	const FTCHARToUTF8 Utf8Name(*Name);
+	const int32 NameLen = Utf8Name.Length();
+	const ANSICHAR* NamePtr = Utf8Name.Get();
+	if (NameLen <= 100)
+	{
+		FMemory::Memcpy(Header, NamePtr, NameLen);
+	}
+	else
+	{
+		int32 Split = NameLen - 101;
+		while (Split < NameLen && (Split < 0 || NamePtr[Split] != '/')) ++Split;
+		if (Split >= NameLen || Split > 155)
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[TarShards] Member name too long for ustar: %s"), *Name);
+			return false;
+		}
+		FMemory::Memcpy(Header + 345, NamePtr, Split);
+		FMemory::Memcpy(Header, NamePtr + Split + 1, NameLen - Split - 1);
+	}
+
+	auto Octal = [&Header](int32 Offset, int32 Width, int64 Value)
+	{
+		// Width - 1 zero-padded octal digits and a terminating NUL.
+		for (int32 i = Width - 2; i >= 0; --i, Value >>= 3)
+		{
+			Header[Offset + i] = uint8('0' + (Value & 7));
+		}
+	};
+
+	Octal(100, 8, 0644);                                            // mode
+	Octal(108, 8, 0);                                               // uid
+	Octal(116, 8, 0);                                               // gid
+	Octal(124, 12, Data.Num());                                     // size
+	Octal(136, 12, FDateTime::UtcNow().ToUnixTimestamp());          // mtime
+	Header[156] = '0';                                              // regular file
+	FMemory::Memcpy(Header + 257, "ustar", 6);                      // magic + NUL
+	FMemory::Memcpy(Header + 263, "00", 2);                         // version
+
+	// Checksum: byte sum with the checksum field read as spaces.
+	FMemory::Memset(Header + 148, ' ', 8);
+	uint32 Sum = 0;
+	for (uint8 Byte : Header) Sum += Byte;
+	Octal(148, 7, Sum);
+	Header[154] = 0;
+	Header[155] = ' ';
+
+	Archive->Serialize(Header, sizeof(Header));
+	Archive->Serialize(const_cast<uint8*>(Data.GetData()), Data.Num());
+
+	static const uint8 Padding[512] = {};
+	const int64 Pad = Align(Data.Num(), 512) - Data.Num();
+	if (Pad > 0)
+	{
+		Archive->Serialize(const_cast<uint8*>(Padding), Pad);
+	}
+	return !Archive->IsError();
+}
+
+bool FCDGTarShardWriter::WriteSample(const FString& Key, TConstArrayView<FCDGTarMember> Members)
+{
+	if (bFailed || bIndexWritten) return false;
+
+	int64 SampleBytes = 0;
+	for (const FCDGTarMember& Member : Members)
+	{
+		SampleBytes += GetMemberBytes(Member.Data.Num());
+	}
+
+	// Roll over before the sample, never in the middle of it.
+	const bool bShardFull = Archive.IsValid() && Shards.Last().Samples > 0
+		&& Shards.Last().Bytes + SampleBytes + 1024 > MaxShardBytes;
+	if ((bShardFull && !CloseShard()) || (!Archive.IsValid() && !OpenShard()))
+	{
+		bFailed = true;
+		return false;
+	}
+
+	for (const FCDGTarMember& Member : Members)
+	{
+		if (!WriteMember(Key + TEXT(".") + Member.Extension, Member.Data))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[TarShards] Could not write %s.%s into %s"),
+				*Key, *Member.Extension, *Shards.Last().File);
+			bFailed = true;
+			return false;
+		}
+	}
+
+	FShard& Shard = Shards.Last();
+	if (Shard.Samples == 0) Shard.FirstKey = Key;
+	Shard.LastKey = Key;
+	Shard.Bytes  += SampleBytes;
+	++Shard.Samples;
+	++NumSamples;
+	if (Streams.Num() > 0)
+	{
+		++Streams.Last().Samples;
+		Streams.Last().Shards.AddUnique(Shards.Num() - 1);
+	}
+	return true;
+}
+
+bool FCDGTarShardWriter::End()
+{
+	bFailed |= !CloseShard();
+	if (bIndexWritten) return !bFailed;
+
+	bIndexWritten = true;
+	bFailed |= !WriteIndex();
+	return !bFailed;
+}
+
+bool FCDGTarShardWriter::WriteIndex() const
+{
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Format"),        TEXT("webdataset"));
+	Root->SetNumberField(TEXT("MaxShardBytes"), MaxShardBytes);
+	Root->SetNumberField(TEXT("Samples"),       NumSamples);
+
+	TArray<TSharedPtr<FJsonValue>> ShardArray;
+	for (const FShard& Shard : Shards)
+	{
+		TSharedPtr<FJsonObject> ShardObj = MakeShared<FJsonObject>();
+		ShardObj->SetStringField(TEXT("File"),     FPaths::GetCleanFilename(Shard.File));
+		ShardObj->SetNumberField(TEXT("Samples"),  Shard.Samples);
+		ShardObj->SetNumberField(TEXT("Bytes"),    Shard.Bytes);
+		ShardObj->SetStringField(TEXT("FirstKey"), Shard.FirstKey);
+		ShardObj->SetStringField(TEXT("LastKey"),  Shard.LastKey);
+		ShardArray.Add(MakeShared<FJsonValueObject>(ShardObj));
+	}
+	Root->SetArrayField(TEXT("Shards"), ShardArray);
+
+	if (Streams.Num() > 0)
+	{
+		TArray<TSharedPtr<FJsonValue>> StreamArray;
+		for (const FStream& Stream : Streams)
+		{
+			TArray<TSharedPtr<FJsonValue>> StreamShards;
+			for (int32 ShardIndex : Stream.Shards)
+			{
+				StreamShards.Add(MakeShared<FJsonValueNumber>(ShardIndex));
+			}
+			TSharedPtr<FJsonObject> StreamObj = MakeShared<FJsonObject>();
+			StreamObj->SetStringField(TEXT("Name"),    Stream.Name);
+			StreamObj->SetNumberField(TEXT("Samples"), Stream.Samples);
+			StreamObj->SetArrayField(TEXT("Shards"),   StreamShards);
+			StreamArray.Add(MakeShared<FJsonValueObject>(StreamObj));
+		}
+		Root->SetArrayField(TEXT("Streams"), StreamArray);
+	}
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	return FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)
+		&& FFileHelper::SaveStringToFile(JsonText, *IndexPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+TArray<FString> FCDGTarShardWriter::GetOutputFiles() const
+{
+	TArray<FString> Files;
+	for (const FShard& Shard : Shards)
+	{
+		Files.Add(FPaths::ConvertRelativePathToFull(Shard.File));
+	}
+	if (bIndexWritten)
+	{
+		Files.Add(FPaths::ConvertRelativePathToFull(IndexPath));
+	}
+	return Files;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Tests
+// ─────────────────────────────────────────────────────────────────────────────
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Writes a small shard set into <Saved>/CDGTarShardsTest/ (a short name, an
+// empty member, a member of exactly one block, one needing padding and a name
+// long enough for the prefix field) and reads it back as tar would: every
+// header's checksum must be the unsigned byte sum with the checksum field as
+// spaces, stored as six octal digits, NUL, space; long names must be split at
+// a '/' into prefix and name; data must be zero-padded to 512 bytes; and the
+// archive must end in exactly two zero blocks.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCDGTarShardsUstarTest, "CameraDatasetGen.TarShards.Ustar",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCDGTarShardsUstarTest::RunTest(const FString& Parameters)
+{
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("CDGTarShardsTest"));
+	IFileManager::Get().DeleteDirectory(*OutputDir, /*RequireExists=*/false, /*Tree=*/true);
+
+	struct FExpectedMember
+	{
+		FString       Name;
+		/** Expected ustar prefix field; empty when the name fits the name field */
+		FString       Prefix;
+		TArray<uint8> Data;
+	};
+	TArray<FExpectedMember> Expected;
+	auto AddMember = [&Expected](const FString& Name, const FString& Prefix, int32 NumBytes)
+	{
+		FExpectedMember& Member = Expected.AddDefaulted_GetRef();
+		Member.Name   = Name;
+		Member.Prefix = Prefix;
+		for (int32 i = 0; i < NumBytes; ++i) Member.Data.Add(uint8(i * 31 + Name.Len()));
+	};
+	const FString ShortKey = FCDGTarShardWriter::MakeKey(TEXT("Test"), 0);
+	const FString LongDir  = FString::ChrN(80, TEXT('d'));
+	const FString LongKey  = LongDir + TEXT("/") + FCDGTarShardWriter::MakeKey(FString::ChrN(60, TEXT('e')), 1);
+	AddMember(ShortKey + TEXT(".txt"),  FString(), 5);
+	AddMember(ShortKey + TEXT(".json"), FString(), 0);
+	AddMember(LongKey + TEXT(".bin"),   LongDir,   512);
+	AddMember(LongKey + TEXT(".png"),   LongDir,   700);
+
+	FCDGTarShardWriter Writer;
+	TestTrue(TEXT("Begin"), Writer.Begin(OutputDir, TEXT("Test")));
+	TestTrue(TEXT("WriteSample (short key)"), Writer.WriteSample(ShortKey, {
+		FCDGTarMember{ TEXT("txt"),  Expected[0].Data },
+		FCDGTarMember{ TEXT("json"), Expected[1].Data } }));
+	TestTrue(TEXT("WriteSample (long key)"), Writer.WriteSample(LongKey, {
+		FCDGTarMember{ TEXT("bin"), Expected[2].Data },
+		FCDGTarMember{ TEXT("png"), Expected[3].Data } }));
+	TestTrue(TEXT("End"), Writer.End());
+	TestEqual(TEXT("Samples"), Writer.GetNumSamples(), 2);
+
+	TArray<uint8> Tar;
+	const FString ShardPath = FPaths::Combine(OutputDir, TEXT("Test-000000.tar"));
+	if (!TestTrue(TEXT("Shard reads back"), FFileHelper::LoadFileToArray(Tar, *ShardPath)))
+	{
+		return true;
+	}
+	TestTrue(TEXT("Index written"), FPaths::FileExists(FPaths::Combine(OutputDir, TEXT("Test.shards.json"))));
+	TestEqual(TEXT("Shard size is a whole number of blocks"), Tar.Num() % 512, 0);
+
+	auto ReadOctal = [](const uint8* Field, int32 Digits, int64& OutValue)
+	{
+		OutValue = 0;
+		for (int32 i = 0; i < Digits; ++i)
+		{
+			if (Field[i] < '0' || Field[i] > '7') return false;
+			OutValue = OutValue * 8 + (Field[i] - '0');
+		}
+		return true;
+	};
+	auto ReadString = [](const uint8* Field, int32 Width)
+	{
+		const ANSICHAR* Chars = reinterpret_cast<const ANSICHAR*>(Field);
+		const FUTF8ToTCHAR Converted(Chars, FCStringAnsi::Strnlen(Chars, Width));
+		return FString(Converted.Length(), Converted.Get());
+	};
+
+	int64 Offset = 0;
+	for (const FExpectedMember& Member : Expected)
+	{
+		if (!TestTrue(FString::Printf(TEXT("%s: header at offset %lld"), *Member.Name, Offset), Offset + 512 <= Tar.Num()))
+		{
+			return true;
+		}
+		const uint8* Header = Tar.GetData() + Offset;
+
+		// Checksum: six octal digits, NUL, space, equal to the byte sum with the field as spaces
+		uint32 Sum = 0;
+		for (int32 i = 0; i < 512; ++i) Sum += (i >= 148 && i < 156) ? uint32(' ') : uint32(Header[i]);
+		int64 Stored = -1;
+		TestTrue(FString::Printf(TEXT("%s: checksum field is six octal digits, NUL, space"), *Member.Name),
+			ReadOctal(Header + 148, 6, Stored) && Header[154] == 0 && Header[155] == ' ');
+		TestEqual(FString::Printf(TEXT("%s: checksum"), *Member.Name), Stored, int64(Sum));
+		TestTrue(FString::Printf(TEXT("%s: ustar magic"), *Member.Name),
+			FMemory::Memcmp(Header + 257, "ustar", 6) == 0 && FMemory::Memcmp(Header + 263, "00", 2) == 0);
+
+		// Prefix / name split
+		const FString PrefixPart = ReadString(Header + 345, 155);
+		const FString NamePart   = ReadString(Header, 100);
+		TestEqual(FString::Printf(TEXT("%s: prefix field"), *Member.Name), PrefixPart, Member.Prefix);
+		TestEqual(FString::Printf(TEXT("%s: name field"), *Member.Name), NamePart,
+			Member.Prefix.IsEmpty() ? Member.Name : Member.Name.RightChop(Member.Prefix.Len() + 1));
+
+		int64 Size = -1;
+		if (!TestTrue(FString::Printf(TEXT("%s: size field"), *Member.Name), ReadOctal(Header + 124, 11, Size) && Size == Member.Data.Num()))
+		{
+			return true;
+		}
+		const int64 Padded = Align(Size, 512);
+		if (!TestTrue(FString::Printf(TEXT("%s: data and padding inside the shard"), *Member.Name), Offset + 512 + Padded <= Tar.Num()))
+		{
+			return true;
+		}
+		TestTrue(FString::Printf(TEXT("%s: data"), *Member.Name), FMemory::Memcmp(Header + 512, Member.Data.GetData(), Size) == 0);
+
+		// Padding up to the next 512-byte block is zeros
+		bool bZeroPadding = true;
+		for (int64 i = Offset + 512 + Size; i < Offset + 512 + Padded; ++i) bZeroPadding &= Tar[i] == 0;
+		TestTrue(FString::Printf(TEXT("%s: %lld byte(s) of zero padding"), *Member.Name, Padded - Size), bZeroPadding);
+		Offset += 512 + Padded;
+	}
+
+	// End of archive: exactly two zero blocks
+	TestEqual(TEXT("Bytes after the last member"), int64(Tar.Num()) - Offset, int64(1024));
+	bool bZeroBlocks = true;
+	for (int64 i = Offset; i < Tar.Num(); ++i) bZeroBlocks &= Tar[i] == 0;
+	TestTrue(TEXT("End-of-archive blocks are zero"), bZeroBlocks);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,380 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchCheckpoint.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+const TCHAR* FCDGBatchCheckpoint::ManifestFileName = TEXT("CDGBatchCheckpoint.jsonl");
+
+// Record layout written by Append(); Load() skips records of any other
+// version (1 was the whole-file manifest with per-file outputs).
+static constexpr int32 kCheckpointVersion = 2;
+
+// Load() compacts the journal once it holds this many superseded records.
+static constexpr int32 kCompactThreshold = 256;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// State <-> string
+// ─────────────────────────────────────────────────────────────────────────────
+
+const TCHAR* FCDGBatchCheckpoint::StateToString(ECDGComboState State)
+{
+	switch (State)
+	{
+	case ECDGComboState::Completed:  return TEXT("Completed");
+	case ECDGComboState::Failed:     return TEXT("Failed");
+	case ECDGComboState::Crashed:    return TEXT("Crashed");
+	default:                         return TEXT("InProgress");
+	}
+}
+
+ECDGComboState FCDGBatchCheckpoint::StateFromString(const FString& In)
+{
+	if (In == TEXT("Completed")) return ECDGComboState::Completed;
+	if (In == TEXT("Failed"))    return ECDGComboState::Failed;
+	if (In == TEXT("Crashed"))   return ECDGComboState::Crashed;
+	return ECDGComboState::InProgress;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Records
+// ─────────────────────────────────────────────────────────────────────────────
+
+static FString EntryToJsonLine(const FCDGComboCheckpointEntry& Entry)
+{
+	TSharedPtr<FJsonObject> Obj = MakeShared<FJsonObject>();
+	Obj->SetNumberField(TEXT("Version"),   kCheckpointVersion);
+	Obj->SetStringField(TEXT("ComboKey"),  Entry.ComboKey);
+	Obj->SetNumberField(TEXT("Seed"),      Entry.Seed);
+	Obj->SetStringField(TEXT("State"),     FCDGBatchCheckpoint::StateToString(Entry.State));
+	Obj->SetStringField(TEXT("Timestamp"), Entry.Timestamp.ToIso8601());
+	if (!Entry.Error.IsEmpty())
+	{
+		Obj->SetStringField(TEXT("Error"), Entry.Error);
+	}
+	if (!Entry.OutputDir.IsEmpty())
+	{
+		Obj->SetStringField(TEXT("Dir"), Entry.OutputDir);
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Outputs;
+	Outputs.Reserve(Entry.Outputs.Num());
+	for (const FCDGComboOutputGroup& Group : Entry.Outputs)
+	{
+		TSharedPtr<FJsonObject> OutObj = MakeShared<FJsonObject>();
+		OutObj->SetStringField(TEXT("Group"), Group.Group);
+		OutObj->SetNumberField(TEXT("Files"), Group.NumFiles);
+		OutObj->SetNumberField(TEXT("Bytes"), static_cast<double>(Group.Bytes));
+		Outputs.Add(MakeShared<FJsonValueObject>(OutObj));
+	}
+	if (!Outputs.IsEmpty())
+	{
+		Obj->SetArrayField(TEXT("Outputs"), Outputs);
+	}
+
+	// One line per record: the condensed policy emits no newlines.
+	FString Line;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+	FJsonSerializer::Serialize(Obj.ToSharedRef(), Writer);
+	return Line;
+}
+
+/** False for a line that is not a record; OutVersion is 0 when the record has none. */
+static bool EntryFromJsonLine(const FString& Line, FCDGComboCheckpointEntry& Entry, int32& OutVersion)
+{
+	TSharedPtr<FJsonObject> Obj;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line);
+	if (!FJsonSerializer::Deserialize(Reader, Obj) || !Obj.IsValid()) return false;
+	if (!Obj->TryGetStringField(TEXT("ComboKey"), Entry.ComboKey)) return false;
+
+	OutVersion = 0;
+	Obj->TryGetNumberField(TEXT("Version"), OutVersion);
+	if (OutVersion != kCheckpointVersion) return true;
+
+	Obj->TryGetNumberField(TEXT("Seed"), Entry.Seed);
+
+	FString StateStr;
+	Obj->TryGetStringField(TEXT("State"), StateStr);
+	Entry.State = FCDGBatchCheckpoint::StateFromString(StateStr);
+
+	FString TimeStr;
+	if (Obj->TryGetStringField(TEXT("Timestamp"), TimeStr))
+	{
+		FDateTime::ParseIso8601(*TimeStr, Entry.Timestamp);
+	}
+	Obj->TryGetStringField(TEXT("Error"), Entry.Error);
+	Obj->TryGetStringField(TEXT("Dir"),   Entry.OutputDir);
+
+	const TArray<TSharedPtr<FJsonValue>>* Outputs = nullptr;
+	if (Obj->TryGetArrayField(TEXT("Outputs"), Outputs))
+	{
+		for (const TSharedPtr<FJsonValue>& OutVal : *Outputs)
+		{
+			const TSharedPtr<FJsonObject>* OutObj = nullptr;
+			if (!OutVal->TryGetObject(OutObj) || !OutObj) continue;
+
+			FCDGComboOutputGroup Group;
+			(*OutObj)->TryGetStringField(TEXT("Group"), Group.Group);
+			(*OutObj)->TryGetNumberField(TEXT("Files"), Group.NumFiles);
+			(*OutObj)->TryGetNumberField(TEXT("Bytes"), Group.Bytes);
+			Entry.Outputs.Add(MoveTemp(Group));
+		}
+	}
+	return true;
+}
+
+TArray<FCDGComboOutputGroup> FCDGBatchCheckpoint::SummarizeOutputs(const FString& AbsDir)
+{
+	TMap<FString, FCDGComboOutputGroup> Groups;
+	const FString DirPrefix = AbsDir / TEXT("");
+
+	IFileManager::Get().IterateDirectoryStatRecursively(*AbsDir,
+		[&Groups, &DirPrefix](const TCHAR* Path, const FFileStatData& Stat)
+		{
+			if (Stat.bIsDirectory) return true;
+
+			FString Relative = Path;
+			FPaths::MakePathRelativeTo(Relative, *DirPrefix);
+
+			// "<Level>.<Trajectory>.<Frame>.<Ext>" and "<Level>.<Trajectory>.mp4"
+			// fall into "<Level>.<Trajectory>"; anything else is its own group.
+			const FString SubDir   = FPaths::GetPath(Relative);
+			const FString FileName = FPaths::GetCleanFilename(Relative);
+			TArray<FString> Parts;
+			FileName.ParseIntoArray(Parts, TEXT("."), /*CullEmpty=*/false);
+			const FString Stem = Parts.Num() >= 3 ? Parts[0] + TEXT(".") + Parts[1] : FileName;
+			const FString Key  = SubDir.IsEmpty() ? Stem : SubDir / Stem;
+
+			FCDGComboOutputGroup& Group = Groups.FindOrAdd(Key);
+			Group.Group = Key;
+			++Group.NumFiles;
+			Group.Bytes += Stat.FileSize;
+			return true;
+		});
+
+	TArray<FCDGComboOutputGroup> Out;
+	Groups.GenerateValueArray(Out);
+	Out.Sort([](const FCDGComboOutputGroup& A, const FCDGComboOutputGroup& B) { return A.Group < B.Group; });
+	return Out;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Load / Append / Compact
+// ─────────────────────────────────────────────────────────────────────────────
+
+int32 FCDGBatchCheckpoint::Load(const FString& RootOutputDir)
+{
+	RootDir      = FPaths::ConvertRelativePathToFull(RootOutputDir);
+	ManifestPath = FPaths::Combine(RootDir, ManifestFileName);
+	Entries.Empty();
+
+	TArray<FString> Lines;
+	if (!FPaths::FileExists(ManifestPath) || !FFileHelper::LoadFileToStringArray(Lines, *ManifestPath))
+	{
+		return 0;
+	}
+
+	int32 NumRecords = 0;
+	int32 NumBad     = 0;
+	TMap<int32, int32> NumSkippedByVersion;
+	for (const FString& Line : Lines)
+	{
+		if (Line.TrimStartAndEnd().IsEmpty()) continue;
+
+		FCDGComboCheckpointEntry Entry;
+		int32 Version = 0;
+		if (!EntryFromJsonLine(Line, Entry, Version))
+		{
+			++NumBad;
+			continue;
+		}
+		++NumRecords;
+
+		// Another version's record may mean something else by its fields; the
+		// combo is treated as not started, and the next Append() supersedes it.
+		if (Version != kCheckpointVersion)
+		{
+			++NumSkippedByVersion.FindOrAdd(Version);
+			continue;
+		}
+		Entries.Add(Entry.ComboKey, MoveTemp(Entry));
+	}
+
+	if (NumBad > 0)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchCheckpoint] Skipped %d unreadable record(s) in %s"), NumBad, *ManifestPath);
+	}
+	for (const TPair<int32, int32>& Skipped : NumSkippedByVersion)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchCheckpoint] Skipped %d record(s) of version %d in %s (expected version %d); their combos will run again"),
+			Skipped.Value, Skipped.Key, *ManifestPath, kCheckpointVersion);
+	}
+	UE_LOG(LogCameraDatasetGenEditor, Log,
+		TEXT("[BatchCheckpoint] Loaded %d combo record(s) from %s"), Entries.Num(), *ManifestPath);
+
+	if (NumBad > 0 || NumRecords - Entries.Num() >= kCompactThreshold)
+	{
+		Compact();
+	}
+	return Entries.Num();
+}
+
+bool FCDGBatchCheckpoint::Append(const FCDGComboCheckpointEntry& Entry) const
+{
+	if (!IsBound()) return false;
+
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*RootDir);
+
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*ManifestPath, FILEWRITE_Append | FILEWRITE_AllowRead));
+	if (!Ar.IsValid())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchCheckpoint] Failed to open %s for append"), *ManifestPath);
+		return false;
+	}
+
+	// Written as one block so a crash leaves at most one partial line behind.
+	FTCHARToUTF8 Utf8(*(EntryToJsonLine(Entry) + TEXT("\n")));
+	Ar->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+	const bool bOK = Ar->Close() && !Ar->IsError();
+	if (!bOK)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchCheckpoint] Failed to append to %s"), *ManifestPath);
+	}
+	return bOK;
+}
+
+bool FCDGBatchCheckpoint::Compact() const
+{
+	if (!IsBound()) return false;
+
+	FString Text;
+	for (const TPair<FString, FCDGComboCheckpointEntry>& Pair : Entries)
+	{
+		Text += EntryToJsonLine(Pair.Value);
+		Text += TEXT("\n");
+	}
+
+	// Write to a sibling temp file, then rename over the journal.  The rename
+	// is atomic on the same filesystem, so readers only ever see a complete file.
+	IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
+	PF.CreateDirectoryTree(*RootDir);
+
+	const FString TempPath = ManifestPath + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(Text, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchCheckpoint] Failed to write %s"), *TempPath);
+		return false;
+	}
+
+	if (!IFileManager::Get().Move(*ManifestPath, *TempPath, /*Replace=*/true, /*EvenIfReadOnly=*/true))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchCheckpoint] Failed to move %s over %s"), *TempPath, *ManifestPath);
+		return false;
+	}
+	return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// State updates
+// ─────────────────────────────────────────────────────────────────────────────
+
+void FCDGBatchCheckpoint::MarkInProgress(const FString& ComboKey, int32 Seed)
+{
+	FCDGComboCheckpointEntry& Entry = Entries.FindOrAdd(ComboKey);
+	Entry.ComboKey  = ComboKey;
+	Entry.Seed      = Seed;
+	Entry.State     = ECDGComboState::InProgress;
+	Entry.Timestamp = FDateTime::UtcNow();
+	Entry.OutputDir.Reset();
+	Entry.Outputs.Empty();
+	Entry.Error.Reset();
+	Append(Entry);
+}
+
+void FCDGBatchCheckpoint::MarkFinished(const FString& ComboKey, int32 Seed, bool bSuccess, const FString& ComboOutputDir)
+{
+	FCDGComboCheckpointEntry& Entry = Entries.FindOrAdd(ComboKey);
+	Entry.ComboKey  = ComboKey;
+	Entry.Seed      = Seed;
+	Entry.State     = bSuccess ? ECDGComboState::Completed : ECDGComboState::Failed;
+	Entry.Timestamp = FDateTime::UtcNow();
+	Entry.OutputDir.Reset();
+	Entry.Outputs.Empty();
+	Entry.Error.Reset();
+
+	if (bSuccess)
+	{
+		const FString AbsDir = FPaths::ConvertRelativePathToFull(ComboOutputDir);
+		Entry.OutputDir = AbsDir;
+		FPaths::MakePathRelativeTo(Entry.OutputDir, *(RootDir / TEXT("")));
+		Entry.Outputs = SummarizeOutputs(AbsDir);
+
+		// A "successful" combo that produced nothing cannot be validated later.
+		if (Entry.Outputs.IsEmpty())
+		{
+			Entry.State = ECDGComboState::Failed;
+		}
+	}
+
+	Append(Entry);
+}
+
+void FCDGBatchCheckpoint::MarkCrashed(const FString& ComboKey, const FString& Error)
+{
+	// Seed is kept from the InProgress record the worker wrote.
+	FCDGComboCheckpointEntry& Entry = Entries.FindOrAdd(ComboKey);
+	Entry.ComboKey  = ComboKey;
+	Entry.State     = ECDGComboState::Crashed;
+	Entry.Timestamp = FDateTime::UtcNow();
+	Entry.OutputDir.Reset();
+	Entry.Outputs.Empty();
+	Entry.Error     = Error;
+	Append(Entry);
+}
+
+bool FCDGBatchCheckpoint::IsComboCrashed(const FString& ComboKey) const
+{
+	const FCDGComboCheckpointEntry* Entry = Entries.Find(ComboKey);
+	return Entry && Entry->State == ECDGComboState::Crashed;
+}
+
+bool FCDGBatchCheckpoint::IsComboComplete(const FString& ComboKey) const
+{
+	const FCDGComboCheckpointEntry* Entry = Entries.Find(ComboKey);
+	if (!Entry || Entry->State != ECDGComboState::Completed || Entry->Outputs.IsEmpty())
+	{
+		return false;
+	}
+
+	// One directory walk per combo; files added since are ignored.
+	const TArray<FCDGComboOutputGroup> OnDisk = SummarizeOutputs(FPaths::Combine(RootDir, Entry->OutputDir));
+	for (const FCDGComboOutputGroup& Group : Entry->Outputs)
+	{
+		if (!OnDisk.Contains(Group))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Log,
+				TEXT("[BatchCheckpoint] %s: outputs %s/%s missing or changed — will re-run"),
+				*ComboKey, *Entry->OutputDir, *Group.Group);
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,227 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchComboSampler.h"
+
+#include "Math/RandomStream.h"
+#include "Misc/Crc.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace
+{
+	/** Uniform integer in [0, Max] — Max may exceed the int32 range of FRandomStream. */
+	int64 RandUpTo(FRandomStream& Stream, int64 Max)
+	{
+		if (Max <= 0) return 0;
+		const uint64 Bits = (static_cast<uint64>(Stream.GetUnsignedInt()) << 32) | Stream.GetUnsignedInt();
+		return static_cast<int64>(Bits % static_cast<uint64>(Max + 1));
+	}
+
+	/** K distinct values from [0, Size), Floyd's algorithm: O(K) time and memory. */
+	TArray<int64> SampleWithoutReplacement(FRandomStream& Stream, int64 Size, int64 K)
+	{
+		TArray<int64> Out;
+		K = FMath::Clamp<int64>(K, 0, Size);
+		if (K == Size)
+		{
+			Out.Reserve(K);
+			for (int64 i = 0; i < Size; ++i) Out.Add(i);
+			return Out;
+		}
+
+		TSet<int64> Chosen;
+		Chosen.Reserve(K);
+		for (int64 j = Size - K; j < Size; ++j)
+		{
+			const int64 T = RandUpTo(Stream, j);
+			Chosen.Add(Chosen.Contains(T) ? j : T);
+		}
+		Out = Chosen.Array();
+		return Out;
+	}
+
+	/** Split Total over NumBins; the Total % NumBins extra units start at bin Rotation. */
+	int32 ShareOf(int32 Bin, int32 Total, int32 NumBins, int32 Rotation)
+	{
+		if (NumBins <= 0) return 0;
+		const int32 Slot = (Bin - Rotation % NumBins + NumBins) % NumBins;
+		return Total / NumBins + (Slot < Total % NumBins ? 1 : 0);
+	}
+
+	/** Random permutation of [0, N). */
+	TArray<int32> Permutation(FRandomStream& Stream, int32 N)
+	{
+		TArray<int32> P;
+		P.SetNumUninitialized(N);
+		for (int32 i = 0; i < N; ++i) P[i] = i;
+		for (int32 i = N - 1; i > 0; --i)
+		{
+			P.Swap(i, Stream.RandRange(0, i));
+		}
+		return P;
+	}
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchComboSampler
+// ─────────────────────────────────────────────────────────────────────────────
+
+void FCDGBatchComboSampler::Configure(const FCDGComboSamplingSettings& InSettings, const TArray<FName>& LevelPackages,
+                                      int32 InNumCharacters, int32 InNumAnimations)
+{
+	Settings      = InSettings;
+	NumCharacters = InNumCharacters;
+	NumAnimations = InNumAnimations;
+
+	LevelOrder.Reset();
+	for (const FName& Level : LevelPackages)
+	{
+		LevelOrder.FindOrAdd(Level, LevelOrder.Num());
+	}
+}
+
+int32 FCDGBatchComboSampler::GetLevelBudget(FName LevelPackage) const
+{
+	const int32* Order = LevelOrder.Find(LevelPackage);
+	if (!Order) return 0;
+	return ShareOf(*Order, FMath::Max(0, Settings.Budget), LevelOrder.Num(), 0);
+}
+
+int64 FCDGBatchComboSampler::GetTotalBudget() const
+{
+	return IsExhaustive() ? 0 : FMath::Max(0, Settings.Budget);
+}
+
+TArray<FIntVector> FCDGBatchComboSampler::SampleLevel(FName LevelPackage, int32 NumAnchors) const
+{
+	TArray<FIntVector> Out;   // X = anchor, Y = character, Z = animation
+	const int32* Order = LevelOrder.Find(LevelPackage);
+	if (!Order || NumAnchors <= 0 || NumCharacters <= 0 || NumAnimations <= 0) return Out;
+
+	const int64 A = NumAnchors, C = NumCharacters, N = NumAnimations;
+	const int64 ProductSize = A * C * N;
+	const int32 Share = static_cast<int32>(FMath::Min<int64>(GetLevelBudget(LevelPackage), ProductSize));
+	if (Share <= 0) return Out;
+
+	FRandomStream Stream(static_cast<int32>(HashCombine(
+		static_cast<uint32>(Settings.Seed), FCrc::StrCrc32(*LevelPackage.ToString()))));
+
+	// Linear index over (anchor fastest, then animation, then character)
+	auto Decode = [A, N](int64 Idx)
+	{
+		const int64 Rest = Idx / A;
+		return FIntVector(static_cast<int32>(Idx % A), static_cast<int32>(Rest / N), static_cast<int32>(Rest % N));
+	};
+
+	Out.Reserve(Share);
+	switch (Settings.Mode)
+	{
+	case ECDGComboSampling::Uniform:
+	{
+		for (int64 Idx : SampleWithoutReplacement(Stream, ProductSize, Share))
+		{
+			Out.Add(Decode(Idx));
+		}
+		break;
+	}
+
+	case ECDGComboSampling::Stratified:
+	{
+		// Each value of the stratum axis gets an equal cut of the level's share,
+		// drawn uniformly over the remaining two axes.
+		const int32 NumStrata = Settings.Stratum == ECDGComboStratum::Level     ? NumAnchors
+		                      : Settings.Stratum == ECDGComboStratum::Character ? NumCharacters
+		                      :                                                   NumAnimations;
+		const int64 StratumSize = ProductSize / NumStrata;
+
+		for (int32 S = 0; S < NumStrata; ++S)
+		{
+			const int32 K = ShareOf(S, Share, NumStrata, *Order);
+			for (int64 Idx : SampleWithoutReplacement(Stream, StratumSize, K))
+			{
+				switch (Settings.Stratum)
+				{
+				case ECDGComboStratum::Level:     Out.Emplace(S, static_cast<int32>(Idx / N), static_cast<int32>(Idx % N)); break;
+				case ECDGComboStratum::Character: Out.Emplace(static_cast<int32>(Idx % A), S, static_cast<int32>(Idx / A)); break;
+				case ECDGComboStratum::Animation: Out.Emplace(static_cast<int32>(Idx % A), static_cast<int32>(Idx / A), S); break;
+				}
+			}
+		}
+		break;
+	}
+
+	case ECDGComboSampling::LatinHypercube:
+	{
+		// Sample i lands in stratum P[i] of each axis; a jittered point inside
+		// that stratum is mapped back to an index on the axis.
+		const int32 Sizes[3] = { NumAnchors, NumCharacters, NumAnimations };
+		TArray<int32> Perms[3];
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Perms[Axis] = Permutation(Stream, Share);
+		}
+
+		TSet<FIntVector> Seen;
+		Seen.Reserve(Share);
+		for (int32 i = 0; i < Share; ++i)
+		{
+			int32 V[3];
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const double U = (Perms[Axis][i] + Stream.FRand()) / Share;
+				V[Axis] = FMath::Min(Sizes[Axis] - 1, FMath::FloorToInt32(U * Sizes[Axis]));
+			}
+			const FIntVector Combo(V[0], V[1], V[2]);
+			if (!Seen.Contains(Combo))
+			{
+				Seen.Add(Combo);
+				Out.Add(Combo);
+			}
+		}
+
+		// Small axes make collisions likely; top up uniformly so the share is met.
+		while (Out.Num() < Share)
+		{
+			const FIntVector Combo = Decode(RandUpTo(Stream, ProductSize - 1));
+			if (!Seen.Contains(Combo))
+			{
+				Seen.Add(Combo);
+				Out.Add(Combo);
+			}
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	// Character, then animation, then anchor — the exhaustive loop order.
+	Out.Sort([](const FIntVector& L, const FIntVector& R)
+	{
+		if (L.Y != R.Y) return L.Y < R.Y;
+		if (L.Z != R.Z) return L.Z < R.Z;
+		return L.X < R.X;
+	});
+	return Out;
+}
+
+FString FCDGBatchComboSampler::Describe() const
+{
+	switch (Settings.Mode)
+	{
+	case ECDGComboSampling::Uniform:
+		return FString::Printf(TEXT("uniform, budget %d, seed %d"), Settings.Budget, Settings.Seed);
+	case ECDGComboSampling::Stratified:
+		return FString::Printf(TEXT("stratified by %s, budget %d, seed %d"),
+			Settings.Stratum == ECDGComboStratum::Level     ? TEXT("level") :
+			Settings.Stratum == ECDGComboStratum::Character ? TEXT("character") : TEXT("animation"),
+			Settings.Budget, Settings.Seed);
+	case ECDGComboSampling::LatinHypercube:
+		return FString::Printf(TEXT("Latin hypercube, budget %d, seed %d"), Settings.Budget, Settings.Seed);
+	default:
+		return TEXT("exhaustive");
+	}
+}
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchHeartbeat.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+
+const TCHAR* FCDGBatchHeartbeat::FileName = TEXT("CDGBatchHeartbeat.json");
+
+bool FCDGBatchHeartbeat::IsOnCombo() const
+{
+	return !Subject.IsEmpty() && (Stage == TEXT("Preparing") || Stage == TEXT("Rendering"));
+}
+
+bool FCDGBatchHeartbeat::Write(const FString& Dir) const
+{
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Pid"),       Pid);
+	Root->SetStringField(TEXT("Utc"),       Utc.ToIso8601());
+	Root->SetStringField(TEXT("Stage"),     Stage);
+	Root->SetStringField(TEXT("Subject"),   Subject);
+	Root->SetNumberField(TEXT("Completed"), Completed);
+	Root->SetNumberField(TEXT("Total"),     Total);
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	if (!FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)) return false;
+
+	// Same temp + rename as the checkpoint: the supervisor never sees half a file.
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Dir);
+	const FString Path     = FPaths::Combine(Dir, FileName);
+	const FString TempPath = Path + TEXT(".tmp");
+	return FFileHelper::SaveStringToFile(JsonText, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+		&& IFileManager::Get().Move(*Path, *TempPath, /*Replace=*/true, /*EvenIfReadOnly=*/true);
+}
+
+bool FCDGBatchHeartbeat::Read(const FString& Dir, FCDGBatchHeartbeat& Out)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *FPaths::Combine(Dir, FileName)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	{
+		return false;
+	}
+
+	FString UtcStr;
+	Root->TryGetNumberField(TEXT("Pid"),       Out.Pid);
+	Root->TryGetStringField(TEXT("Utc"),       UtcStr);
+	Root->TryGetStringField(TEXT("Stage"),     Out.Stage);
+	Root->TryGetStringField(TEXT("Subject"),   Out.Subject);
+	Root->TryGetNumberField(TEXT("Completed"), Out.Completed);
+	Root->TryGetNumberField(TEXT("Total"),     Out.Total);
+	return FDateTime::ParseIso8601(*UtcStr, Out.Utc);
+}
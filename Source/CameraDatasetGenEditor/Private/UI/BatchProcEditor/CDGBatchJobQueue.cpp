@@ -0,0 +1,331 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchJobQueue.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+const TCHAR* FCDGBatchJobQueue::PendingDir          = TEXT("pending");
+const TCHAR* FCDGBatchJobQueue::ClaimedDir          = TEXT("claimed");
+const TCHAR* FCDGBatchJobQueue::DoneDir             = TEXT("done");
+const TCHAR* FCDGBatchJobQueue::FailedDir           = TEXT("failed");
+const TCHAR* FCDGBatchJobQueue::ShardsDir           = TEXT("shards");
+const TCHAR* FCDGBatchJobQueue::MergedIndexFileName = TEXT("DatasetIndex.json");
+
+namespace
+{
+	/** All *.json file names (not paths) directly inside Dir. */
+	TArray<FString> ListJobFiles(const FString& Dir)
+	{
+		TArray<FString> Names;
+		IFileManager::Get().FindFiles(Names, *(Dir / TEXT("*.json")), /*Files=*/true, /*Directories=*/false);
+		Names.Sort();
+		return Names;
+	}
+
+	/** rename() without the retry/error-dialog behaviour of IFileManager::Move's defaults. */
+	bool MoveNoRetry(const FString& Dest, const FString& Src)
+	{
+		return IFileManager::Get().Move(*Dest, *Src, /*Replace=*/false, /*EvenIfReadOnly=*/false,
+			/*Attributes=*/false, /*bDoNotRetryOrError=*/true);
+	}
+}
+
+FCDGBatchJobQueue::FCDGBatchJobQueue(const FString& InJobDir)
+	: JobDir(FPaths::ConvertRelativePathToFull(InJobDir))
+{
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Setup / planning
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool FCDGBatchJobQueue::Initialise() const
+{
+	IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
+	for (const TCHAR* Dir : { PendingDir, ClaimedDir, DoneDir, FailedDir, ShardsDir })
+	{
+		if (!PF.CreateDirectoryTree(*(JobDir / Dir)))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Error,
+				TEXT("[BatchJobs] Cannot create %s"), *(JobDir / Dir));
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FCDGBatchJobQueue::AddJob(const FCDGBatchJob& Job) const
+{
+	const FString FileName = Job.ComboKey + TEXT(".json");
+	if (FPaths::FileExists(StatePath(PendingDir, FileName)))
+	{
+		return false;
+	}
+
+	// Already claimed or finished by some worker?
+	for (const TCHAR* Dir : { ClaimedDir, DoneDir, FailedDir })
+	{
+		TArray<FString> Existing;
+		IFileManager::Get().FindFiles(Existing, *(JobDir / Dir / (Job.ComboKey + TEXT("@*.json"))), true, false);
+		if (!Existing.IsEmpty()) return false;
+	}
+
+	bPendingLevelsCached = false;
+	return WriteJob(StatePath(PendingDir, FileName), Job);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Worker side
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool FCDGBatchJobQueue::TryClaim(const FString& ComboKey, const FString& WorkerId) const
+{
+	const FString Src = StatePath(PendingDir,  ComboKey + TEXT(".json"));
+	const FString Dst = StatePath(ClaimedDir,  ComboKey + TEXT("@") + WorkerId + TEXT(".json"));
+
+	// Won or lost, the job is no longer pending for this process.
+	FString Level;
+	if (bPendingLevelsCached && PendingLevels.RemoveAndCopyValue(ComboKey, Level))
+	{
+		int32& NumPending = NumPendingPerLevel.FindChecked(Level);
+		if (--NumPending == 0)
+		{
+			NumPendingPerLevel.Remove(Level);
+		}
+	}
+
+	// Cheap pre-check so workers scanning past taken jobs don't hammer rename().
+	if (!FPaths::FileExists(Src)) return false;
+
+	return MoveNoRetry(Dst, Src);
+}
+
+void FCDGBatchJobQueue::MarkFinished(const FString& ComboKey, const FString& WorkerId, bool bSuccess) const
+{
+	const FString FileName = ComboKey + TEXT("@") + WorkerId + TEXT(".json");
+	const FString Src      = StatePath(ClaimedDir, FileName);
+	const FString Dst      = StatePath(bSuccess ? DoneDir : FailedDir, FileName);
+
+	if (!MoveNoRetry(Dst, Src))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning,
+			TEXT("[BatchJobs] Could not move claim %s to %s"), *Src, *Dst);
+	}
+}
+
+int32 FCDGBatchJobQueue::RequeueClaims(const FString& WorkerId) const
+{
+	int32 NumRequeued = 0;
+	for (const FString& FileName : ListJobFiles(JobDir / ClaimedDir))
+	{
+		FString ComboKey, Owner;
+		if (!ParseClaimFileName(FileName, ComboKey, Owner)) continue;
+		if (!WorkerId.IsEmpty() && Owner != WorkerId) continue;
+
+		if (MoveNoRetry(StatePath(PendingDir, ComboKey + TEXT(".json")), StatePath(ClaimedDir, FileName)))
+		{
+			++NumRequeued;
+		}
+	}
+	if (NumRequeued > 0)
+	{
+		bPendingLevelsCached = false;
+	}
+	return NumRequeued;
+}
+
+bool FCDGBatchJobQueue::HasPendingJobsForLevel(const FString& LevelPackage) const
+{
+	if (!bPendingLevelsCached)
+	{
+		CachePendingLevels();
+	}
+	return NumPendingPerLevel.Contains(LevelPackage);
+}
+
+void FCDGBatchJobQueue::CachePendingLevels() const
+{
+	PendingLevels.Reset();
+	NumPendingPerLevel.Reset();
+
+	for (const FString& FileName : ListJobFiles(JobDir / PendingDir))
+	{
+		FCDGBatchJob Job;
+		if (ReadJob(StatePath(PendingDir, FileName), Job))
+		{
+			// Key by file name: that is what TryClaim renames.
+			PendingLevels.Add(FileName.LeftChop(5), Job.Level);  // strip ".json"
+			++NumPendingPerLevel.FindOrAdd(Job.Level);
+		}
+	}
+	bPendingLevelsCached = true;
+}
+
+int32 FCDGBatchJobQueue::Count(const TCHAR* StateDir) const
+{
+	return ListJobFiles(JobDir / StateDir).Num();
+}
+
+FString FCDGBatchJobQueue::GetShardDir(const FString& WorkerId) const
+{
+	return JobDir / ShardsDir / WorkerId;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Merge
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool FCDGBatchJobQueue::WriteMergedIndex(int32& OutNumCombos) const
+{
+	OutNumCombos = 0;
+
+	TArray<TSharedPtr<FJsonValue>> Combos;
+	for (const FString& FileName : ListJobFiles(JobDir / DoneDir))
+	{
+		FString ComboKey, WorkerId;
+		if (!ParseClaimFileName(FileName, ComboKey, WorkerId)) continue;
+
+		FCDGBatchJob Job;
+		ReadJob(StatePath(DoneDir, FileName), Job);
+
+		const FString ComboDir  = FString(ShardsDir) / WorkerId / ComboKey;
+		const FString IndexRel  = ComboDir / (ComboKey + TEXT(".json"));
+		const FString IndexAbs  = JobDir / IndexRel;
+
+		if (!FPaths::FileExists(IndexAbs))
+		{
+			UE_LOG(LogCameraDatasetGenEditor, Warning,
+				TEXT("[BatchJobs] %s is marked done but %s is missing — left out of the index"),
+				*ComboKey, *IndexRel);
+			continue;
+		}
+
+		// Pull the trajectory count out of the per-combo index for quick stats.
+		int32 NumTrajectories = 0;
+		FString IndexText;
+		if (FFileHelper::LoadFileToString(IndexText, *IndexAbs))
+		{
+			TSharedPtr<FJsonObject> IndexRoot;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(IndexText);
+			const TArray<TSharedPtr<FJsonValue>>* Trajs = nullptr;
+			if (FJsonSerializer::Deserialize(Reader, IndexRoot) && IndexRoot.IsValid()
+				&& IndexRoot->TryGetArrayField(TEXT("Trajectories"), Trajs))
+			{
+				NumTrajectories = Trajs->Num();
+			}
+		}
+
+		TSharedPtr<FJsonObject> Obj = MakeShared<FJsonObject>();
+		Obj->SetStringField(TEXT("ComboKey"),     ComboKey);
+		Obj->SetStringField(TEXT("Shard"),        WorkerId);
+		Obj->SetStringField(TEXT("Level"),        Job.Level);
+		Obj->SetStringField(TEXT("Anchor"),       Job.Anchor);
+		Obj->SetStringField(TEXT("Character"),    Job.Character);
+		Obj->SetStringField(TEXT("Animation"),    Job.Animation);
+		Obj->SetStringField(TEXT("Index"),        IndexRel);
+		Obj->SetStringField(TEXT("Outputs"),      ComboDir / TEXT("OUTPUTS"));
+		Obj->SetNumberField(TEXT("Trajectories"), NumTrajectories);
+		Combos.Add(MakeShared<FJsonValueObject>(Obj));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Failed;
+	for (const FString& FileName : ListJobFiles(JobDir / FailedDir))
+	{
+		FString ComboKey, WorkerId;
+		if (ParseClaimFileName(FileName, ComboKey, WorkerId))
+		{
+			Failed.Add(MakeShared<FJsonValueString>(ComboKey));
+		}
+	}
+
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Version"), 1);
+	Root->SetStringField(TEXT("Created"), FDateTime::UtcNow().ToIso8601());
+	Root->SetNumberField(TEXT("Pending"), Count(PendingDir) + Count(ClaimedDir));
+	Root->SetArrayField(TEXT("Combos"), Combos);
+	Root->SetArrayField(TEXT("Failed"), Failed);
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	if (!FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)) return false;
+
+	const FString OutPath = JobDir / MergedIndexFileName;
+	if (!FFileHelper::SaveStringToFile(JsonText, *OutPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[BatchJobs] Failed to write %s"), *OutPath);
+		return false;
+	}
+
+	OutNumCombos = Combos.Num();
+	return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Job files
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool FCDGBatchJobQueue::ReadJob(const FString& FilePath, FCDGBatchJob& OutJob)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *FilePath)) return false;
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid()) return false;
+
+	Root->TryGetStringField(TEXT("ComboKey"),  OutJob.ComboKey);
+	Root->TryGetStringField(TEXT("Level"),     OutJob.Level);
+	Root->TryGetStringField(TEXT("Anchor"),    OutJob.Anchor);
+	Root->TryGetStringField(TEXT("Character"), OutJob.Character);
+	Root->TryGetStringField(TEXT("Animation"), OutJob.Animation);
+	return !OutJob.ComboKey.IsEmpty();
+}
+
+bool FCDGBatchJobQueue::WriteJob(const FString& FilePath, const FCDGBatchJob& Job)
+{
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("ComboKey"),  Job.ComboKey);
+	Root->SetStringField(TEXT("Level"),     Job.Level);
+	Root->SetStringField(TEXT("Anchor"),    Job.Anchor);
+	Root->SetStringField(TEXT("Character"), Job.Character);
+	Root->SetStringField(TEXT("Animation"), Job.Animation);
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	if (!FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)) return false;
+
+	// Write beside the target and rename in, so a worker scanning pending/
+	// never reads a half-written job.
+	const FString TempPath = FilePath + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(JsonText, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		return false;
+	}
+	return IFileManager::Get().Move(*FilePath, *TempPath, /*Replace=*/true, /*EvenIfReadOnly=*/true);
+}
+
+FString FCDGBatchJobQueue::StatePath(const TCHAR* StateDir, const FString& FileName) const
+{
+	return JobDir / StateDir / FileName;
+}
+
+bool FCDGBatchJobQueue::ParseClaimFileName(const FString& FileName, FString& OutComboKey, FString& OutWorkerId)
+{
+	const FString Base = FPaths::GetBaseFilename(FileName);
+	int32 At = INDEX_NONE;
+	if (!Base.FindLastChar(TEXT('@'), At)) return false;
+
+	OutComboKey = Base.Left(At);
+	OutWorkerId = Base.Mid(At + 1);
+	return !OutComboKey.IsEmpty() && !OutWorkerId.IsEmpty();
+}
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchJobSpec.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Dom/JsonObject.h"
+
+bool FCDGBatchJobSpec::Write(const FString& FilePath) const
+{
+	TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetNumberField(TEXT("Version"),   Version);
+	Root->SetStringField(TEXT("ComboKey"),  Job.ComboKey);
+	Root->SetStringField(TEXT("Level"),     Job.Level);
+	Root->SetStringField(TEXT("Anchor"),    Job.Anchor);
+	Root->SetStringField(TEXT("Character"), Job.Character);
+	Root->SetStringField(TEXT("Animation"), Job.Animation);
+	Root->SetNumberField(TEXT("BaseSeed"),  BaseSeed);
+	Root->SetNumberField(TEXT("Seed"),      Seed);
+
+	// Embedded as an object rather than a string so the spec stays readable.
+	TSharedPtr<FJsonObject> Generators;
+	TSharedRef<TJsonReader<>> GenReader = TJsonReaderFactory<>::Create(GeneratorsJson);
+	if (!FJsonSerializer::Deserialize(GenReader, Generators) || !Generators.IsValid())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error, TEXT("[BatchJobs] %s: generator stack is not valid JSON"), *Job.ComboKey);
+		return false;
+	}
+	Root->SetObjectField(TEXT("Generators"), Generators);
+	if (Exporter.IsValid())
+	{
+		Root->SetObjectField(TEXT("Exporter"), Exporter);
+	}
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	if (!FJsonSerializer::Serialize(Root.ToSharedRef(), Writer)) return false;
+
+	const FString TempPath = FilePath + TEXT(".tmp");
+	return FFileHelper::SaveStringToFile(JsonText, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+		&& IFileManager::Get().Move(*FilePath, *TempPath, /*Replace=*/true, /*EvenIfReadOnly=*/true);
+}
+
+bool FCDGBatchJobSpec::Read(const FString& FilePath, FCDGBatchJobSpec& Out)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *FilePath)) return false;
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid()) return false;
+
+	int32 FileVersion = 0;
+	Root->TryGetNumberField(TEXT("Version"), FileVersion);
+	if (FileVersion < 1 || FileVersion > Version)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Error,
+			TEXT("[BatchJobs] %s: unsupported job spec version %d"), *FilePath, FileVersion);
+		return false;
+	}
+
+	Root->TryGetStringField(TEXT("ComboKey"),  Out.Job.ComboKey);
+	Root->TryGetStringField(TEXT("Level"),     Out.Job.Level);
+	Root->TryGetStringField(TEXT("Anchor"),    Out.Job.Anchor);
+	Root->TryGetStringField(TEXT("Character"), Out.Job.Character);
+	Root->TryGetStringField(TEXT("Animation"), Out.Job.Animation);
+	Root->TryGetNumberField(TEXT("BaseSeed"),  Out.BaseSeed);
+	Root->TryGetNumberField(TEXT("Seed"),      Out.Seed);
+
+	const TSharedPtr<FJsonObject>* Generators = nullptr;
+	if (!Root->TryGetObjectField(TEXT("Generators"), Generators) || !Generators) return false;
+	Out.GeneratorsJson.Reset();
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Out.GeneratorsJson);
+	FJsonSerializer::Serialize(Generators->ToSharedRef(), Writer);
+
+	const TSharedPtr<FJsonObject>* Exporter = nullptr;
+	Out.Exporter = Root->TryGetObjectField(TEXT("Exporter"), Exporter) && Exporter ? *Exporter : nullptr;
+
+	return !Out.Job.ComboKey.IsEmpty() && !Out.Job.Level.IsEmpty()
+		&& !Out.Job.Character.IsEmpty() && !Out.Job.Animation.IsEmpty();
+}
@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchLogBuffer.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static_assert((FCDGBatchLogBuffer::Capacity & (FCDGBatchLogBuffer::Capacity - 1)) == 0,
+	"FCDGBatchLogBuffer::Capacity must be a power of two");
+
+FCDGBatchLogBuffer::FCDGBatchLogBuffer()
+	: Slots(MakeUnique<FSlot[]>(Capacity))
+{
+}
+
+FCDGBatchLogBuffer::~FCDGBatchLogBuffer()
+{
+	End();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Producer
+// ─────────────────────────────────────────────────────────────────────────────
+
+void FCDGBatchLogBuffer::Begin(const FString& OutputDir)
+{
+	End();
+
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*OutputDir);
+	FilePath = FPaths::Combine(OutputDir,
+		FString::Printf(TEXT("CDGBatchLog_%s.log"), *FDateTime::UtcNow().ToString(TEXT("%Y%m%d_%H%M%S"))));
+
+	File.Reset(IFileManager::Get().CreateFileWriter(*FilePath, FILEWRITE_AllowRead));
+	if (!File)
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[BatchExec] Cannot write %s — log kept in memory only"), *FilePath);
+		FilePath.Reset();
+	}
+	LinesSinceFlush = 0;
+}
+
+void FCDGBatchLogBuffer::Append(const FString& Line)
+{
+	const uint64 Seq = NextSeq.load(std::memory_order_relaxed);
+	FSlot& Slot = Slots[Seq & (Capacity - 1)];
+
+	// Invalidate, write, publish: a reader that sees the same Seq before and
+	// after copying got a consistent line.
+	Slot.Seq.store(MAX_uint64, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	Slot.Len = FMath::Min(Line.Len(), MaxLineChars);
+	FMemory::Memcpy(Slot.Text, *Line, Slot.Len * sizeof(TCHAR));
+	Slot.Seq.store(Seq, std::memory_order_release);
+	NextSeq.store(Seq + 1, std::memory_order_release);
+
+	if (File)
+	{
+		const FString Stamped = FDateTime::UtcNow().ToString(TEXT("%H:%M:%S.%s ")) + Line + LINE_TERMINATOR;
+		const FTCHARToUTF8 Utf8(*Stamped);
+		File->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+
+		if (++LinesSinceFlush >= FlushEveryLines)
+		{
+			File->Flush();
+			LinesSinceFlush = 0;
+		}
+	}
+}
+
+void FCDGBatchLogBuffer::End()
+{
+	if (File)
+	{
+		File->Flush();
+		File->Close();
+		File.Reset();
+	}
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Readers
+// ─────────────────────────────────────────────────────────────────────────────
+
+uint64 FCDGBatchLogBuffer::ReadSince(uint64 FromSeq, TArray<FString>& OutLines, int32& OutMissed) const
+{
+	OutMissed = 0;
+	const uint64 End   = NextSeq.load(std::memory_order_acquire);
+	const uint64 First = End > static_cast<uint64>(Capacity) ? End - Capacity : 0;
+
+	if (FromSeq < First)
+	{
+		OutMissed += static_cast<int32>(First - FromSeq);
+		FromSeq = First;
+	}
+
+	for (uint64 Seq = FromSeq; Seq < End; ++Seq)
+	{
+		const FSlot& Slot = Slots[Seq & (Capacity - 1)];
+		if (Slot.Seq.load(std::memory_order_acquire) != Seq)
+		{
+			++OutMissed;
+			continue;
+		}
+
+		FString Text(Slot.Len, Slot.Text);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Slot.Seq.load(std::memory_order_relaxed) != Seq)
+		{
+			++OutMissed;   // overwritten while copying
+			continue;
+		}
+		OutLines.Add(MoveTemp(Text));
+	}
+	return End;
+}
@@ -0,0 +1,225 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchMemoryGuard.h"
+#include "Generator/CDGTrajectoryGenerator.h"
+#include "Trajectory/CDGTrajectory.h"
+#include "Trajectory/CDGKeyframe.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "CineCameraActor.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "LevelSequence.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/ReferenceChainSearch.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/UObjectGlobals.h"
+
+static constexpr double kBytesPerMB = 1024.0 * 1024.0;
+
+/** Referencer chains are expensive to compute; only the first few survivors get one. */
+static constexpr int32 kMaxReferenceChainReports = 3;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Sampling / collection
+// ─────────────────────────────────────────────────────────────────────────────
+
+void FCDGBatchMemoryGuard::Emit(const FString& Message) const
+{
+	if (Log) Log(Message);
+	else     UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[BatchMemory] %s"), *Message);
+}
+
+uint64 FCDGBatchMemoryGuard::GetUsedBytes()
+{
+	return FPlatformMemory::GetStats().UsedPhysical;
+}
+
+void FCDGBatchMemoryGuard::Begin(int32 WatermarkMB, TFunction<void(const FString&)> InLog)
+{
+	Log = MoveTemp(InLog);
+
+	WatermarkBytes = WatermarkMB > 0
+		? static_cast<uint64>(WatermarkMB) * 1024 * 1024
+		: FPlatformMemory::GetStats().TotalPhysical / 10 * 6;
+
+	BaselineBytes     = GetUsedBytes();
+	PeakBytes         = BaselineBytes;
+	bCollectRequested = false;
+	NumCollections    = 0;
+	CollectionSeconds = 0.0;
+	NumSurvivors      = 0;
+	ComboSamples.Reset();
+	AwaitingCollection.Reset();
+
+	Emit(FString::Printf(TEXT("Memory: %.0f MB in use, collecting garbage above %.0f MB"),
+		BaselineBytes / kBytesPerMB, WatermarkBytes / kBytesPerMB));
+}
+
+void FCDGBatchMemoryGuard::OnComboReleased(const FString& ComboKey, const TArray<TWeakObjectPtr<UObject>>& Released)
+{
+	for (const TWeakObjectPtr<UObject>& Obj : Released)
+	{
+		AwaitingCollection.Emplace(ComboKey, Obj);
+	}
+
+	const uint64 Used = GetUsedBytes();
+	PeakBytes = FMath::Max(PeakBytes, Used);
+	ComboSamples.Add(Used);
+
+	if (Used >= WatermarkBytes && !bCollectRequested)
+	{
+		bCollectRequested = true;
+		UE_LOG(LogCameraDatasetGenEditor, Log,
+			TEXT("[BatchMemory] %.0f MB in use after %s — above watermark, collecting at next tick"),
+			Used / kBytesPerMB, *ComboKey);
+	}
+}
+
+void FCDGBatchMemoryGuard::CollectIfRequested()
+{
+	if (bCollectRequested)
+	{
+		Collect();
+	}
+}
+
+void FCDGBatchMemoryGuard::Collect()
+{
+	bCollectRequested = false;
+
+	const uint64 Before = GetUsedBytes();
+	const double Start  = FPlatformTime::Seconds();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, /*bPerformFullPurge=*/true);
+	const double Seconds = FPlatformTime::Seconds() - Start;
+	const uint64 After  = GetUsedBytes();
+
+	++NumCollections;
+	CollectionSeconds += Seconds;
+	if (!ComboSamples.IsEmpty())
+	{
+		ComboSamples.Last() = After;
+	}
+
+	Emit(FString::Printf(TEXT("Memory: garbage collected in %.2f s, %.0f MB → %.0f MB"),
+		Seconds, Before / kBytesPerMB, After / kBytesPerMB));
+
+	CheckSurvivors();
+}
+
+void FCDGBatchMemoryGuard::CheckSurvivors()
+{
+	int32 NumReported = 0;
+	for (const TPair<FString, TWeakObjectPtr<UObject>>& Entry : AwaitingCollection)
+	{
+		// Even-if-garbage: an object that is only marked but still reachable
+		// after a full purge is what leaks.
+		UObject* Obj = Entry.Value.Get(/*bEvenIfGarbage=*/true);
+		if (!Obj) continue;
+
+		++NumSurvivors;
+		Emit(FString::Printf(TEXT("  LEAK: %s %s (from %s) survived garbage collection%s"),
+			*Obj->GetClass()->GetName(), *Obj->GetPathName(), *Entry.Key,
+			Obj->IsRooted() ? TEXT(" — rooted") : TEXT("")));
+
+		if (NumReported++ < kMaxReferenceChainReports)
+		{
+			// Prints the shortest chain to LogReferenceChain.
+			FReferenceChainSearch Search(Obj,
+				EReferenceChainSearchMode::Shortest | EReferenceChainSearchMode::PrintResults);
+		}
+	}
+	AwaitingCollection.Reset();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Audit
+// ─────────────────────────────────────────────────────────────────────────────
+
+int32 FCDGBatchMemoryGuard::AuditWorld(UWorld* World, const TSet<const UObject*>& LiveObjects, bool bIncludeAssetSequences)
+{
+	int32 NumActors    = 0;
+	int32 NumSequences = 0;
+	int32 NumRooted    = 0;
+	TArray<FString> Examples;
+
+	auto Note = [&Examples](const UObject* Obj)
+	{
+		if (Examples.Num() < 5) Examples.Add(Obj->GetName());
+	};
+
+	if (World)
+	{
+		for (TActorIterator<ACDGTrajectory> It(World); It; ++It)
+		{
+			if (!LiveObjects.Contains(*It)) { ++NumActors; Note(*It); }
+		}
+		for (TActorIterator<ACDGKeyframe> It(World); It; ++It)
+		{
+			if (!LiveObjects.Contains(*It)) { ++NumActors; Note(*It); }
+		}
+		// Batch cameras are labelled Cam_<Trajectory>; other cine cameras belong to the level.
+		for (TActorIterator<ACineCameraActor> It(World); It; ++It)
+		{
+			if (It->GetActorLabel().StartsWith(TEXT("Cam_")) && !LiveObjects.Contains(*It)) { ++NumActors; Note(*It); }
+		}
+	}
+
+	for (TObjectIterator<ULevelSequence> It; It; ++It)
+	{
+		if (!IsValid(*It) || LiveObjects.Contains(*It)) continue;
+
+		const FString PackageName = It->GetOutermost()->GetName();
+		if (PackageName.StartsWith(TEXT("/Engine/Transient/CDGBatch/"))
+			|| (bIncludeAssetSequences && PackageName.StartsWith(TEXT("/Game/CDGBatch_Temp/"))))
+		{
+			++NumSequences;
+			Note(*It);
+		}
+	}
+
+	for (TObjectIterator<UCDGTrajectoryGenerator> It; It; ++It)
+	{
+		if (It->IsRooted() && It->GetWorld() == World) { ++NumRooted; Note(*It); }
+	}
+
+	const int32 Total = NumActors + NumSequences + NumRooted;
+	if (Total > 0)
+	{
+		Emit(FString::Printf(TEXT("  LEAK: %d actor(s), %d sequence(s), %d rooted generator(s) outlived their combos (e.g. %s)"),
+			NumActors, NumSequences, NumRooted, *FString::Join(Examples, TEXT(", "))));
+	}
+	return Total;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Summary
+// ─────────────────────────────────────────────────────────────────────────────
+
+TArray<FString> FCDGBatchMemoryGuard::Summary() const
+{
+	TArray<FString> Lines;
+	const uint64 Final = GetUsedBytes();
+
+	Lines.Add(FString::Printf(TEXT("Memory: baseline %.0f MB, peak %.0f MB, final %.0f MB; %d collection(s) in %.1f s; %d leaked object(s)"),
+		BaselineBytes / kBytesPerMB, PeakBytes / kBytesPerMB, Final / kBytesPerMB,
+		NumCollections, CollectionSeconds, NumSurvivors));
+
+	// Least-squares slope over the second half of the run: ~0 on a plateau.
+	const int32 First = ComboSamples.Num() / 2;
+	const int32 N     = ComboSamples.Num() - First;
+	if (N >= 4)
+	{
+		double SumX = 0.0, SumY = 0.0, SumXY = 0.0, SumXX = 0.0;
+		for (int32 i = 0; i < N; ++i)
+		{
+			const double X = i;
+			const double Y = ComboSamples[First + i] / kBytesPerMB;
+			SumX += X; SumY += Y; SumXY += X * Y; SumXX += X * X;
+		}
+		const double Slope = (N * SumXY - SumX * SumY) / FMath::Max(1e-9, N * SumXX - SumX * SumX);
+		Lines.Add(FString::Printf(TEXT("Memory trend over the last %d combo(s): %+.2f MB per combo"), N, Slope));
+	}
+	return Lines;
+}
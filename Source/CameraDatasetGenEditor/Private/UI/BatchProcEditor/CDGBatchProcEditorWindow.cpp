@@ -1012,6 +1012,12 @@ FReply SBatchProcEditorWindow::OnStartBatchProcClicked()
 	Input.GeneratorConfig = GeneratorConfig;
 	Input.ExporterConfig  = ExporterConfig;
 
+	// Sampling is edited on the batch config asset itself.
+	if (LoadedBatchConfig.IsValid())
+	{
+		Input.Sampling = LoadedBatchConfig->Sampling;
+	}
+
 	// ── Create and start service ─────────────────────────────────────────────
 	BatchProgress      = 0;
 	BatchProgressTotal = 0;
@@ -1021,6 +1027,7 @@ FReply SBatchProcEditorWindow::OnStartBatchProcClicked()
 
 	// ── Open the floating progress window ────────────────────────────────────
 	ProgressWidget = SNew(SBatchProgressWindow)
+		.Service(ActiveBatchService.Get())
 		.OnCancelRequested(FSimpleDelegate::CreateSP(
 			this, &SBatchProcEditorWindow::OnCancelBatchProcClicked_Internal));
 
@@ -1032,29 +1039,12 @@ FReply SBatchProcEditorWindow::OnStartBatchProcClicked()
 	ProgressWidget->OpenWindow(ParentWin);
 
 	// ── Wire delegates ────────────────────────────────────────────────────────
+	// The progress window polls the service for progress and log lines itself.
 	ActiveBatchService->OnProgressUpdated.AddLambda(
 		[this](int32 Completed, int32 Total)
 		{
 			BatchProgress      = Completed;
 			BatchProgressTotal = Total;
-			if (ProgressWidget.IsValid())
-				ProgressWidget->UpdateProgress(Completed, Total);
-		});
-
-	ActiveBatchService->OnDetailedProgressUpdated.AddLambda(
-		[this](const FBatchDetailedProgress& Progress)
-		{
-			BatchProgress      = Progress.ComboCurrent;
-			BatchProgressTotal = Progress.ComboTotal;
-			if (ProgressWidget.IsValid())
-				ProgressWidget->UpdateDetailedProgress(Progress);
-		});
-
-	ActiveBatchService->OnLogMessage.AddLambda(
-		[this](const FString& Msg)
-		{
-			if (ProgressWidget.IsValid())
-				ProgressWidget->AddLog(Msg);
 		});
 
 	ActiveBatchService->OnBatchCompleted.AddLambda(
@@ -1,8 +1,11 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "UI/BatchProcEditor/CDGBatchProcExecService.h"
+#include "UI/BatchProcEditor/CDGBatchTelemetry.h"
+#include "UI/BatchProcEditor/CDGBatchComboSampler.h"
 #include "Config/GeneratorStackConfig.h"
 #include "Config/LevelSeqExportConfig.h"
+#include "Config/BatchProcConfig.h"
 #include "Generator/CDGTrajectoryGenerator.h"
 #include "Generator/CDGPositioningGenerator.h"
 #include "Generator/CDGMovementGenerator.h"
@@ -10,8 +13,8 @@
 #include "Trajectory/CDGTrajectory.h"
 #include "Trajectory/CDGKeyframe.h"
 #include "Trajectory/CDGTrajectorySubsystem.h"
-#include "LevelSequenceInterface/CDGLevelSeqSubsystem.h"
 #include "MRQInterface/CDGMRQInterface.h"
+#include "LevelSequenceInterface/CDGSequenceBuilder.h"
 #include "IO/TrajectorySL.h"
 #include "Anchor/CDGLevelSceneAnchor.h"
 #include "Anchor/CDGCharacterAnchor.h"
@@ -66,12 +69,19 @@
 #include "Misc/FileHelper.h"
 
 // Notifications
+#include "Framework/Application/SlateApplication.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
-// Ticker (deferred next-combo start)
+// Ticker (combo pipeline)
 #include "Containers/Ticker.h"
 
+// Async prefetch
+#include "Engine/StreamableManager.h"
+
+// Telemetry
+#include "ProfilingDebugging/MiscTrace.h"
+
 #define LOCTEXT_NAMESPACE "CDGBatchProcExecService"
 
 static constexpr double kTickResolution = 24000.0;
@@ -115,9 +125,11 @@ namespace
 	 *   3. NewObject   – create a fresh package + asset directly (no dialog path)
 	 *
 	 * When an existing sequence is found (cases 1/2) its MovieScene is cleared so
-	 * the caller receives a blank slate.
+	 * the caller receives a blank slate.  New shots are copies of ShotBuilder's
+	 * shot template when one is given.
 	 */
-	ULevelSequence* ForceGetOrCreateLevelSequence(const FString& PackageName, const FString& AssetName)
+	ULevelSequence* ForceGetOrCreateLevelSequence(const FString& PackageName, const FString& AssetName,
+	                                              const FCDGSequenceBuilder* ShotBuilder = nullptr)
 	{
 		const FString ObjectPath = PackageName + TEXT(".") + AssetName;
 
@@ -159,66 +171,97 @@ namespace
 		UPackage* Pkg = CreatePackage(*PackageName);
 		if (!Pkg) return nullptr;
 
-		Seq = NewObject<ULevelSequence>(Pkg, *AssetName, RF_Public | RF_Standalone);
+		if (ShotBuilder)
+		{
+			Seq = ShotBuilder->CreateShotSequence(Pkg, *AssetName, RF_Public | RF_Standalone);
+		}
+		else
+		{
+			Seq = NewObject<ULevelSequence>(Pkg, *AssetName, RF_Public | RF_Standalone);
+			if (Seq) Seq->Initialize();
+		}
 		if (!Seq) return nullptr;
 
-		Seq->Initialize();
-
 		// Notify the asset registry so the new asset shows up in the Content Browser.
 		FAssetRegistryModule::AssetCreated(Seq);
 
 		return Seq;
 	}
 
+	/** Content folder for combo sequences kept as assets (bKeepExportedLevelSequence). */
+	const TCHAR* const kAssetSequenceRoot     = TEXT("/Game/CDGBatch_Temp/");
+
 	/**
-	 * Fully delete a UObject asset: unload the package from memory and delete
-	 * the .uasset file on disk.  Safe to call even if the asset is not loaded.
+	 * Root for throw-away combo sequences.  Packages under it are created in
+	 * memory only: never registered with the asset registry, never saved, and
+	 * collected by GC once the combo lets go of them.
 	 */
-	void ForceDeleteAsset(const FString& PackageName)
-	{
-#if WITH_EDITOR
-		const FString ShortName  = FPackageName::GetShortName(PackageName);
-		const FString ObjectPath = PackageName + TEXT(".") + ShortName;
+	const TCHAR* const kTransientSequenceRoot = TEXT("/Engine/Transient/CDGBatch/");
 
-		// Ensure the object is in memory so we can mark it + its package.
-		UObject* Asset = FindObject<UObject>(nullptr, *ObjectPath);
-		if (!Asset)
-			Asset = LoadObject<UObject>(nullptr, *ObjectPath);
+	/**
+	 * Free PackageName (and the sequence inside it) for reuse.  Nothing is on
+	 * disk or in the registry, so this is just a rename out of the way plus
+	 * MarkAsGarbage — the objects go with the next GC.
+	 */
+	void ReleaseTransientSequence(const FString& PackageName)
+	{
+		UPackage* Package = FindObject<UPackage>(nullptr, *PackageName);
+		if (!Package) return;
 
-		if (Asset)
+		const FString ObjectPath = PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+		if (ULevelSequence* Seq = FindObject<ULevelSequence>(nullptr, *ObjectPath))
 		{
-			UPackage* Package = Asset->GetOutermost();
-			if (Asset->IsRooted()) Asset->RemoveFromRoot();
-
-			// Rename the asset to the transient package so that FindObject can
-			// no longer locate it by the original path on the next combo.
-			// MarkAsGarbage() alone only sets EInternalObjectFlags::Garbage;
-			// the object stays in the name hash and FindObject still returns it
-			// until the GC traversal sets Unreachable.  Moving to the transient
-			// package breaks the path lookup immediately.
-			Asset->Rename(nullptr, GetTransientPackage(),
+			ClearMovieScene(Seq->GetMovieScene());
+			Seq->Rename(nullptr, GetTransientPackage(),
 				REN_DontCreateRedirectors | REN_ForceNoResetLoaders | REN_NonTransactional);
-			Asset->MarkAsGarbage();
-
-			if (Package && Package != GetTransientPackage())
-			{
-				// Rename the package itself so CreatePackage can produce a fresh
-				// one with the original name on the next combo.
-				Package->Rename(nullptr, nullptr,
-					REN_DontCreateRedirectors | REN_ForceNoResetLoaders | REN_NonTransactional);
-				Package->ClearFlags(RF_Standalone);
-				Package->MarkAsGarbage();
-			}
+			Seq->MarkAsGarbage();
 		}
 
-		// Delete the .uasset file regardless of whether the object was in memory.
-		FString PackageFilename;
-		if (FPackageName::TryConvertLongPackageNameToFilename(
-				PackageName, PackageFilename, FPackageName::GetAssetPackageExtension()))
+		Package->Rename(nullptr, nullptr,
+			REN_DontCreateRedirectors | REN_ForceNoResetLoaders | REN_NonTransactional);
+		Package->MarkAsGarbage();
+	}
+
+	/**
+	 * Create a blank in-memory sequence at PackageName.AssetName.  The
+	 * package path still follows the <Master>_Shot_<Traj> layout, so
+	 * CDGMRQInterface finds the shots the same way as saved ones.  Shots are
+	 * copies of ShotBuilder's shot template when one is given.
+	 */
+	ULevelSequence* CreateTransientLevelSequence(const FString& PackageName, const FString& AssetName,
+	                                             const FCDGSequenceBuilder* ShotBuilder = nullptr)
+	{
+		ReleaseTransientSequence(PackageName);
+
+		UPackage* Pkg = CreatePackage(*PackageName);
+		if (!Pkg) return nullptr;
+		Pkg->SetFlags(RF_Transient);
+
+		if (ShotBuilder)
 		{
-			FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*PackageFilename);
+			return ShotBuilder->CreateShotSequence(Pkg, *AssetName, RF_Public | RF_Transient);
 		}
-#endif
+
+		ULevelSequence* Seq = NewObject<ULevelSequence>(Pkg, *AssetName, RF_Public | RF_Transient);
+		if (!Seq) return nullptr;
+
+		Seq->Initialize();
+		return Seq;
+	}
+
+	/** Transient or asset-backed sequence for one combo, see FBatchComboWork::bTransientSequences. */
+	ULevelSequence* GetOrCreateComboSequence(const FString& AssetName, bool bTransient)
+	{
+		return bTransient
+			? CreateTransientLevelSequence(kTransientSequenceRoot + AssetName, AssetName)
+			: ForceGetOrCreateLevelSequence(kAssetSequenceRoot + AssetName, AssetName);
+	}
+
+	/** Mark an asset-backed sequence dirty and queue it for writing to disk. */
+	void SaveSequenceAsset(FCDGBatchSaveQueue& Queue, ULevelSequence* Seq)
+	{
+		Seq->MarkPackageDirty();
+		Queue.Save(Seq);
 	}
 }
 
@@ -233,6 +276,56 @@ UCDGBatchProcExecService* UCDGBatchProcExecService::Create(UObject* Outer, const
 	return Service;
 }
 
+bool UCDGBatchProcExecService::BuildInputFromConfig(const UBatchProcConfig* Config, FBatchProcInput& OutInput)
+{
+	if (!Config) return false;
+
+	IAssetRegistry& AR = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	auto Resolve = [&AR](const TArray<FSoftObjectPath>& Paths, TArray<FAssetData>& Out, const TCHAR* Label)
+	{
+		Out.Empty(Paths.Num());
+		for (const FSoftObjectPath& Path : Paths)
+		{
+			FAssetData Data = AR.GetAssetByObjectPath(Path);
+			if (Data.IsValid())
+			{
+				Out.Add(Data);
+			}
+			else
+			{
+				UE_LOG(LogCameraDatasetGenEditor, Warning,
+					TEXT("[BatchExec] %s asset not found in registry: %s — skipped"), Label, *Path.ToString());
+			}
+		}
+	};
+
+	Resolve(Config->Levels,         OutInput.Levels,     TEXT("Level"));
+	Resolve(Config->SkeletalMeshes, OutInput.Characters, TEXT("Character"));
+	Resolve(Config->Animations,     OutInput.Animations, TEXT("Animation"));
+
+	OutInput.GeneratorConfig = Config->GeneratorConfig;
+	OutInput.ExporterConfig  = Config->ExporterConfig;
+	OutInput.Sampling        = Config->Sampling;
+
+	return !OutInput.Levels.IsEmpty()
+		&& !OutInput.Characters.IsEmpty()
+		&& !OutInput.Animations.IsEmpty()
+		&& OutInput.GeneratorConfig.IsValid();
+}
+
+FString UCDGBatchProcExecService::ComposeComboKey(
+	const FAssetData& Level,
+	const FString& AnchorLabel,
+	const FAssetData& Character,
+	const FAssetData& Animation)
+{
+	return Sanitise(FPackageName::GetShortName(Level.PackageName.ToString()))
+		+ TEXT("_") + Sanitise(AnchorLabel)
+		+ TEXT("_") + Sanitise(FPackageName::GetShortName(Character.PackageName.ToString()))
+		+ TEXT("_") + Sanitise(FPackageName::GetShortName(Animation.PackageName.ToString()));
+}
+
 void UCDGBatchProcExecService::Start()
 {
 	if (bStarted)
@@ -243,14 +336,53 @@ void UCDGBatchProcExecService::Start()
 	bStarted      = true;
 	bIsRunning    = true;
 	bCancelled    = false;
+
+	// Level shares follow the configured order, before the loaded level moves up.
+	{
+		TArray<FName> LevelPackages;
+		for (const FAssetData& Level : Input.Levels) LevelPackages.Add(Level.PackageName);
+		Sampler.Configure(Input.Sampling, LevelPackages, Input.Characters.Num(), Input.Animations.Num());
+	}
+
 	TotalCombos   = ComputeTotalCombos();
 	CompletedCombos = 0;
+	SkippedCombos   = 0;
+	Stats           = FBatchPipelineStats();
+	RenderSlotFreeSince = 0.0;
+
+	PutLoadedLevelFirst();
+	Telemetry.Begin(GetRootOutputDir());
+	LogBuffer.Begin(GetRootOutputDir());
+	LatestProgress = FBatchDetailedProgress();
+
+	TWeakObjectPtr<UCDGBatchProcExecService> WeakThis(this);
+	MemoryGuard.Begin(Input.MemoryWatermarkMB, [WeakThis](const FString& Msg)
+	{
+		if (WeakThis.IsValid()) WeakThis->BroadcastLog(Msg);
+	});
+	SaveQueue.Begin([WeakThis](const FString& Msg)
+	{
+		if (WeakThis.IsValid()) WeakThis->BroadcastLog(Msg);
+	});
+
+	const int32 NumRecords = Checkpoint.Load(GetRootOutputDir());
+	if (NumRecords > 0)
+	{
+		BroadcastLog(FString::Printf(TEXT("Checkpoint journal found (%d combo record(s)) — %s"),
+			NumRecords, Input.bResumeFromCheckpoint
+				? TEXT("completed combos will be skipped")
+				: TEXT("resume disabled, re-running everything")));
+	}
 
 	UE_LOG(LogCameraDatasetGenEditor, Log,
 		TEXT("[BatchExec] Starting batch: %d level(s), combinatorial total ≈ %d"),
 		Input.Levels.Num(), TotalCombos);
 
 	BroadcastLog(FString::Printf(TEXT("Starting batch — %d level(s)"), Input.Levels.Num()));
+	if (!Sampler.IsExhaustive())
+	{
+		BroadcastLog(FString::Printf(TEXT("Sampling combos: %s"), *Sampler.Describe()));
+	}
 
 	CurrentLevelIdx = 0;
 	BeginProcessLevel();
@@ -277,6 +409,16 @@ void UCDGBatchProcExecService::BeginProcessLevel()
 	const FAssetData& LevelAsset = Input.Levels[CurrentLevelIdx];
 	const FString PackageName    = LevelAsset.PackageName.ToString();
 
+	// Sharded runs: don't pay for a level load when no combo in it is left.
+	if (Input.ShouldProcessLevel && !Input.ShouldProcessLevel(LevelAsset))
+	{
+		BroadcastLog(FString::Printf(TEXT("Level %d/%d: %s — no work left for this worker, skipping"),
+			CurrentLevelIdx + 1, Input.Levels.Num(), *FPackageName::GetShortName(PackageName)));
+		++CurrentLevelIdx;
+		BeginProcessLevel();
+		return;
+	}
+
 	BroadcastLog(FString::Printf(TEXT("Opening level %d/%d: %s"),
 		CurrentLevelIdx + 1, Input.Levels.Num(), *FPackageName::GetShortName(PackageName)));
 
@@ -296,10 +438,26 @@ void UCDGBatchProcExecService::BeginProcessLevel()
 			return;
 		}
 
-		// Synchronous level load — blocks the editor while loading
-		FEditorFileUtils::LoadMap(Filename, /*bLoadAsTemplate=*/false, /*bShowProgress=*/true);
+		// Synchronous level load — blocks the editor while loading.  Most of
+		// its dependencies were streamed in by PrefetchNextLevel while the
+		// previous level rendered, so this mostly just instantiates the world.
+		// No progress dialog when running headless (commandlet has no Slate).
+		Beat(TEXT("LoadingLevel"), PackageName);
+		const double LoadStart = FPlatformTime::Seconds();
+		{
+			FCDGBatchStageScope Timing(Telemetry, FString(), ECDGBatchStage::LevelLoad,
+				FPackageName::GetShortName(PackageName));
+			FEditorFileUtils::LoadMap(Filename, /*bLoadAsTemplate=*/false,
+				/*bShowProgress=*/!IsRunningCommandlet());
+		}
+		const double LoadSeconds = FPlatformTime::Seconds() - LoadStart;
+		Stats.LevelLoadSeconds += LoadSeconds;
+		BroadcastLog(FString::Printf(TEXT("  Level loaded in %.1f s"), LoadSeconds));
 	}
 
+	// The loaded world now references whatever was prefetched for it.
+	LevelPrefetchHandle.Reset();
+
 	DiscoverAnchorsAndBeginCombos();
 }
 
@@ -314,32 +472,36 @@ void UCDGBatchProcExecService::DiscoverAnchorsAndBeginCombos()
 		return;
 	}
 
-	// ── Wipe any leftover CDG actors from a previous run on this level ─────────
 	{
-		UCDGTrajectorySubsystem* TrajSys = World->GetSubsystem<UCDGTrajectorySubsystem>();
-		if (TrajSys)
+		FCDGBatchStageScope Timing(Telemetry, FString(), ECDGBatchStage::AnchorDiscovery, World->GetMapName());
+
+		// ── Wipe any leftover CDG actors from a previous run on this level ─────────
 		{
-			for (const FName& Name : TrajSys->GetTrajectoryNames())
-				TrajSys->DeleteTrajectory(Name);
-		}
+			UCDGTrajectorySubsystem* TrajSys = World->GetSubsystem<UCDGTrajectorySubsystem>();
+			if (TrajSys)
+			{
+				for (const FName& Name : TrajSys->GetTrajectoryNames())
+					TrajSys->DeleteTrajectory(Name);
+			}
 
-		// Destroy orphaned keyframe actors not caught by the subsystem
-		TArray<ACDGKeyframe*> OrphanKFs;
-		for (TActorIterator<ACDGKeyframe> It(World); It; ++It) OrphanKFs.Add(*It);
-		for (ACDGKeyframe* KF : OrphanKFs) World->EditorDestroyActor(KF, true);
+			// Destroy orphaned keyframe actors not caught by the subsystem
+			TArray<ACDGKeyframe*> OrphanKFs;
+			for (TActorIterator<ACDGKeyframe> It(World); It; ++It) OrphanKFs.Add(*It);
+			for (ACDGKeyframe* KF : OrphanKFs) World->EditorDestroyActor(KF, true);
 
-		// Destroy any cine-camera actors left over from a previous export
-		TArray<ACineCameraActor*> OrphanCams;
-		for (TActorIterator<ACineCameraActor> It(World); It; ++It) OrphanCams.Add(*It);
-		for (ACineCameraActor* Cam : OrphanCams) World->EditorDestroyActor(Cam, true);
+			// Destroy any cine-camera actors left over from a previous export
+			TArray<ACineCameraActor*> OrphanCams;
+			for (TActorIterator<ACineCameraActor> It(World); It; ++It) OrphanCams.Add(*It);
+			for (ACineCameraActor* Cam : OrphanCams) World->EditorDestroyActor(Cam, true);
 
-		BroadcastLog(TEXT("  Cleaned up leftover CDG actors from previous run."));
-	}
+			BroadcastLog(TEXT("  Cleaned up leftover CDG actors from previous run."));
+		}
 
-	CurrentAnchors.Empty();
-	for (ACDGLevelSceneAnchor* Anchor : GetAnchors(World))
-	{
-		CurrentAnchors.Add(Anchor);
+		CurrentAnchors.Empty();
+		for (ACDGLevelSceneAnchor* Anchor : GetAnchors(World))
+		{
+			CurrentAnchors.Add(Anchor);
+		}
 	}
 
 	if (CurrentAnchors.IsEmpty())
@@ -358,43 +520,153 @@ void UCDGBatchProcExecService::DiscoverAnchorsAndBeginCombos()
 	CurrentCharacterIdx = 0;
 	CurrentAnimIdx      = 0;
 
-	BeginNextCombo();
+	if (!Sampler.IsExhaustive())
+	{
+		LevelSamples   = Sampler.SampleLevel(Input.Levels[CurrentLevelIdx].PackageName, CurrentAnchors.Num());
+		LevelSampleIdx = 0;
+		BroadcastLog(FString::Printf(TEXT("  Sampled %d of %d combo(s) in this level"), LevelSamples.Num(),
+			CurrentAnchors.Num() * Input.Characters.Num() * Input.Animations.Num()));
+
+		if (LevelSamples.IsEmpty())
+		{
+			++CurrentLevelIdx;
+			BeginProcessLevel();
+			return;
+		}
+		CurrentAnchorIdx    = LevelSamples[0].X;
+		CurrentCharacterIdx = LevelSamples[0].Y;
+		CurrentAnimIdx      = LevelSamples[0].Z;
+	}
+
+	PrefetchUpcomingAssets();
+	PrefetchNextLevel();
+	StartLevelPipeline();
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Combo loop
+// Combo pipeline
 // ─────────────────────────────────────────────────────────────────────────────
 
-void UCDGBatchProcExecService::BeginNextCombo()
+TArray<ACDGTrajectory*> FBatchComboWork::GetTrajectories() const
 {
-	if (bCancelled)
+	TArray<ACDGTrajectory*> Out;
+	Out.Reserve(Trajectories.Num());
+	for (const TWeakObjectPtr<ACDGTrajectory>& T : Trajectories)
 	{
-		Finish(false);
-		return;
+		if (T.IsValid()) Out.Add(T.Get());
 	}
+	return Out;
+}
 
-	if (CurrentAnchorIdx >= CurrentAnchors.Num())
-	{
-		// All anchors done for this level — move to next level
-		++CurrentLevelIdx;
-		BeginProcessLevel();
-		return;
-	}
+void UCDGBatchProcExecService::StartLevelPipeline()
+{
+	bLevelCombosExhausted = false;
 
-	OnProgressUpdated.Broadcast(CompletedCombos, TotalCombos);
-	ExecuteCurrentCombo();
+	TWeakObjectPtr<UCDGBatchProcExecService> WeakThis = this;
+	PipelineTickHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateLambda([WeakThis](float DeltaTime) -> bool
+		{
+			UCDGBatchProcExecService* S = WeakThis.Get();
+			return S ? S->TickPipeline(DeltaTime) : false;
+		}),
+		0.f); // every tick
 }
 
-void UCDGBatchProcExecService::ExecuteCurrentCombo()
+bool UCDGBatchProcExecService::TickPipeline(float /*DeltaTime*/)
 {
+	// Safe point for a requested collection: no raw UObject pointers are held
+	// here, unlike inside PrepareCurrentCombo or the MRQ callbacks.
+	MemoryGuard.CollectIfRequested();
+
+	// Keeps the heartbeat fresh through long renders (throttled inside).
+	BeatRenderState();
+
+	// Checkpoint finished combos whose kept sequences have reached the disk.
+	RecordSavedCombos();
+
 	UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+
+	// ── a. Tear down one rendered combo per tick ──────────────────────────────
+	// Spread over ticks so cleanup never delays the start of the next render.
+	if (!CleanupQueue.IsEmpty())
+	{
+		TSharedPtr<FBatchComboWork> Done = CleanupQueue[0];
+		CleanupQueue.RemoveAt(0);
+		CleanupCombo(*Done, World);
+	}
+
+	// OnExecutorFinished fires before MRQ clears its active executor, so the
+	// executor itself is checked too — starting a render while it is still set
+	// hits the "already rendering" guard and silently drops the combo.
+	const bool bRenderBusy = !RenderingCombos.IsEmpty() || CDGMRQInterface::IsRenderInProgress();
+
 	if (!World)
 	{
+		if (bRenderBusy) return true;
 		BroadcastLog(TEXT("  ERROR: World became invalid — aborting."));
+		DrainPipeline(nullptr);
+		PipelineTickHandle.Reset();
 		Finish(false);
-		return;
+		return false;
+	}
+
+	// ── b. Cancellation: let the in-flight render finish, drop the rest ───────
+	if (bCancelled)
+	{
+		if (bRenderBusy) return true;
+		DrainPipeline(World);
+		PipelineTickHandle.Reset();
+		Finish(false);
+		return false;
+	}
+
+	// ── c. Keep MRQ busy ──────────────────────────────────────────────────────
+	// With MaxCombosPerRender > 1 an idle MRQ waits until a full batch is
+	// prepared (or the level has nothing more to offer) before starting.
+	const int32 BatchSize = FMath::Max(1, Input.MaxCombosPerRender);
+	if (!bRenderBusy && !ReadyCombos.IsEmpty()
+		&& (ReadyCombos.Num() >= BatchSize || bLevelCombosExhausted || IsRenderBatchFull()))
+	{
+		StartRenderBatch(TakeRenderBatch());
+		return true;
+	}
+
+	// ── d. Prepare ahead, one combo per tick ─────────────────────────────────
+	const int32 MaxReady = bRenderBusy
+		? FMath::Max(BatchSize, Input.PipelineLookAhead)
+		: BatchSize;
+	if (!bLevelCombosExhausted && ReadyCombos.Num() < MaxReady)
+	{
+		if (TSharedPtr<FBatchComboWork> Prepared = PrepareCurrentCombo(World))
+		{
+			Prepared->SaveTicket = SaveQueue.GetLastTicket();
+			ReadyCombos.Add(Prepared);
+		}
+		BeatRenderState();
+		bLevelCombosExhausted = !AdvanceComboIndices();
+		if (!bLevelCombosExhausted)
+		{
+			PrefetchUpcomingAssets();
+		}
+		return true;
+	}
+
+	// ── e. Level drained → next level ────────────────────────────────────────
+	if (bLevelCombosExhausted && !bRenderBusy && ReadyCombos.IsEmpty() && CleanupQueue.IsEmpty())
+	{
+		DestroyCharacterPool(World);
+		AuditLeftovers(World);
+		PipelineTickHandle.Reset();
+		++CurrentLevelIdx;
+		BeginProcessLevel();
+		return false;
 	}
 
+	return true;
+}
+
+TSharedPtr<FBatchComboWork> UCDGBatchProcExecService::PrepareCurrentCombo(UWorld* World)
+{
 	// ── Gather combo elements ─────────────────────────────────────────────────
 	ACDGLevelSceneAnchor* Anchor = CurrentAnchors.IsValidIndex(CurrentAnchorIdx) ?
 		CurrentAnchors[CurrentAnchorIdx].Get() : nullptr;
@@ -402,95 +674,161 @@ void UCDGBatchProcExecService::ExecuteCurrentCombo()
 	if (!Anchor)
 	{
 		BroadcastLog(TEXT("  WARNING: Anchor became invalid — skipping."));
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return nullptr;
 	}
 
 	const FAssetData& CharAsset = Input.Characters[CurrentCharacterIdx];
 	const FAssetData& AnimAsset = Input.Animations[CurrentAnimIdx];
 
 	// ── Build combo key ───────────────────────────────────────────────────────
-	const FString LevelShortName = Sanitise(FPackageName::GetShortName(
-		Input.Levels[CurrentLevelIdx].PackageName.ToString()));
-	const FString AnchorName     = Sanitise(Anchor->GetActorNameOrLabel());
 	const FString CharShortName  = Sanitise(FPackageName::GetShortName(CharAsset.PackageName.ToString()));
 	const FString AnimShortName  = Sanitise(FPackageName::GetShortName(AnimAsset.PackageName.ToString()));
 
-	const FString ComboKey = MakeComboKey(LevelShortName, AnchorName, CharShortName, AnimShortName);
+	const FString ComboKey = ComposeComboKey(
+		Input.Levels[CurrentLevelIdx], Anchor->GetActorNameOrLabel(), CharAsset, AnimAsset);
 
-	BroadcastLog(FString::Printf(TEXT("  Combo [%d/%d]: %s"), CompletedCombos + 1, TotalCombos, *ComboKey));
-	BroadcastDetailedProgress(0, 0); // shots not yet known
+	// ── Sharded runs: only combos this process manages to claim ─────────────
+	if (Input.ClaimCombo && !Input.ClaimCombo(ComboKey))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Verbose, TEXT("[BatchExec] %s taken by another worker"), *ComboKey);
+		return nullptr;
+	}
+
+	// Combos ahead of this one: queued for render plus the one rendering now.
+	const int32 ComboNumber = CompletedCombos + ReadyCombos.Num() + RenderingCombos.Num() + 1;
+
+	// ── Supervised runs: never retry a combo that took a worker down ────────
+	if (Input.bResumeFromCheckpoint && Checkpoint.IsComboCrashed(ComboKey))
+	{
+		BroadcastLog(FString::Printf(TEXT("  Combo [%d/%d]: %s — crashed a previous worker, skipping"),
+			ComboNumber, TotalCombos, *ComboKey));
+		++SkippedCombos;
+		++CompletedCombos;
+		OnProgressUpdated.Broadcast(CompletedCombos, TotalCombos);
+		OnComboFinished.Broadcast(ComboKey, false);
+		return nullptr;
+	}
+
+	// ── Resume: skip combos a previous run already finished ──────────────────
+	if (Input.bResumeFromCheckpoint && Checkpoint.IsComboComplete(ComboKey))
+	{
+		BroadcastLog(FString::Printf(TEXT("  Combo [%d/%d]: %s — already completed, skipping"),
+			ComboNumber, TotalCombos, *ComboKey));
+		++SkippedCombos;
+		++CompletedCombos;
+		OnProgressUpdated.Broadcast(CompletedCombos, TotalCombos);
+		OnComboFinished.Broadcast(ComboKey, true);
+		return nullptr;
+	}
+
+	BroadcastLog(FString::Printf(TEXT("  Combo [%d/%d]: %s — preparing"), ComboNumber, TotalCombos, *ComboKey));
+	Beat(TEXT("Preparing"), ComboKey);
+
+	TSharedPtr<FBatchComboWork> Combo = MakeShared<FBatchComboWork>();
+	Combo->AnchorIdx    = CurrentAnchorIdx;
+	Combo->CharacterIdx = CurrentCharacterIdx;
+	Combo->AnimIdx      = CurrentAnimIdx;
+	Combo->ComboKey     = ComboKey;
+	Combo->OutputDir    = FPaths::Combine(GetRootOutputDir(), ComboKey);
+	Combo->FPS          = Input.ExporterConfig.IsValid() ? Input.ExporterConfig->FPS : 30;
+	Combo->Seed         = MakeComboSeed(ComboKey);
+	Combo->bTransientSequences = !(Input.ExporterConfig.IsValid() && Input.ExporterConfig->bKeepExportedLevelSequence);
+
+	// Seed the global RNG so the spawn offset and every generator draw for this
+	// combo is reproducible; the seed is recorded in the checkpoint journal.
+	FMath::RandInit(Combo->Seed);
+	Checkpoint.MarkInProgress(ComboKey, Combo->Seed);
+
+	// Shared failure tail: undo whatever was created and hand collision back
+	// to the combo that is rendering.
+	auto Fail = [this, &Combo, World](const FString& Msg) -> TSharedPtr<FBatchComboWork>
+	{
+		BroadcastLog(Msg);
+		DestroyGenerators();
+		CleanupCombo(*Combo, World);
+		Checkpoint.MarkFinished(Combo->ComboKey, Combo->Seed, /*bSuccess=*/false, Combo->OutputDir);
+		SetActiveCharacter(OnScreenCombo.Get());
+		OnComboFinished.Broadcast(Combo->ComboKey, false);
+		return nullptr;
+	};
 
 	// ── Resolve assets ────────────────────────────────────────────────────────
-	UBlueprint* CharBP = Cast<UBlueprint>(CharAsset.GetAsset());
+	// Normally already resident through PrefetchUpcomingAssets; a miss means
+	// GetAsset blocks (and flushes the in-flight async request).
+	const bool bPrefetched = CharAsset.IsAssetLoaded() && AnimAsset.IsAssetLoaded();
+	++(bPrefetched ? Stats.PrefetchHits : Stats.PrefetchMisses);
+
+	const double AssetLoadStart = FPlatformTime::Seconds();
+	UBlueprint*      CharBP = Cast<UBlueprint>(CharAsset.GetAsset());
+	UAnimationAsset* Anim   = Cast<UAnimationAsset>(AnimAsset.GetAsset());
+	Stats.AssetLoadSeconds += FPlatformTime::Seconds() - AssetLoadStart;
+
 	if (!CharBP || !CharBP->GeneratedClass)
 	{
-		BroadcastLog(FString::Printf(TEXT("    ERROR: Cannot load character blueprint %s — skipping."), *CharShortName));
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return Fail(FString::Printf(TEXT("    ERROR: Cannot load character blueprint %s — skipping."), *CharShortName));
 	}
 
-	UAnimationAsset* Anim = Cast<UAnimationAsset>(AnimAsset.GetAsset());
 	if (!Anim)
 	{
-		BroadcastLog(FString::Printf(TEXT("    ERROR: Cannot load animation %s — skipping."), *AnimShortName));
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return Fail(FString::Printf(TEXT("    ERROR: Cannot load animation %s — skipping."), *AnimShortName));
 	}
 
-	const int32 FPS = Input.ExporterConfig.IsValid() ? Input.ExporterConfig->FPS : 30;
-
 	// ── 1. Spawn character ────────────────────────────────────────────────────
-	AActor* Character = SpawnCharacterAtAnchor(World, Anchor, CharBP->GeneratedClass);
+	AActor* Character = nullptr;
+	{
+		FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::CharacterSpawn);
+		Character = SpawnCharacterAtAnchor(World, Anchor, CurrentCharacterIdx, CharBP->GeneratedClass);
+	}
 	if (!Character)
 	{
-		BroadcastLog(FString::Printf(TEXT("    ERROR: Failed to spawn character — skipping.")));
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return Fail(TEXT("    ERROR: Failed to spawn character — skipping."));
 	}
-	SpawnedCharacter = Character;
-	BroadcastLog(FString::Printf(TEXT("    Spawned character: %s"), *Character->GetActorNameOrLabel()));
+	Combo->Character = Character;
+
+	// Stays hidden until its own render starts (PIE duplicates the editor
+	// world per shot, so a visible prepared character would appear in the
+	// current combo's frames).  Only this character collides while the
+	// generators trace against the scene.
+	Character->SetActorHiddenInGame(true);
+	SetActiveCharacter(Combo.Get());
+	BroadcastLog(FString::Printf(TEXT("    Placed character: %s"), *Character->GetActorNameOrLabel()));
 
 	// ── 2. Create reference sequence ─────────────────────────────────────────
-	ULevelSequence* RefSeq = CreateReferenceSequence(World, Character, Anim, ComboKey, FPS);
+	ULevelSequence* RefSeq = nullptr;
+	{
+		FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::RefSequence);
+		RefSeq = CreateReferenceSequence(World, Character, Anim, *Combo);
+	}
 	if (!RefSeq)
 	{
-		BroadcastLog(TEXT("    ERROR: Failed to create reference sequence — skipping."));
-		DestroySpawnedCharacter(World);
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return Fail(TEXT("    ERROR: Failed to create reference sequence — skipping."));
 	}
-	CurrentRefSequence = RefSeq;
+	Combo->RefSequence = RefSeq;
 	BroadcastLog(FString::Printf(TEXT("    Reference sequence created: %s"), *RefSeq->GetPathName()));
 
 	// ── 3. Instantiate generators and set reference ───────────────────────────
-	InstantiateGenerators(World, RefSeq, Character);
+	{
+		FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::GeneratorInstantiate);
+		InstantiateGenerators(World, RefSeq, Character);
+	}
 	if (PositioningGenerators.IsEmpty() && MovementGenerators.IsEmpty())
 	{
-		BroadcastLog(TEXT("    ERROR: No generators could be instantiated — skipping."));
-		DeleteReferenceSequence();
-		DestroySpawnedCharacter(World);
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return Fail(TEXT("    ERROR: No generators could be instantiated — skipping."));
 	}
 
 	// ── 4. Run generators ─────────────────────────────────────────────────────
-	TArray<ACDGTrajectory*> Trajectories = RunGenerators(World);
+	TArray<ACDGTrajectory*> Trajectories = RunGenerators(World, ComboKey);
+	for (ACDGTrajectory* T : Trajectories)
+	{
+		Combo->Trajectories.Add(T);
+	}
+	// Generators are not needed past this point; free them before the next
+	// combo is prepared.
+	DestroyGenerators();
+
 	if (Trajectories.IsEmpty())
 	{
-		BroadcastLog(TEXT("    WARNING: Generators produced no trajectories — skipping."));
-		DestroyGenerators();
-		DeleteReferenceSequence();
-		DestroySpawnedCharacter(World);
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		return Fail(TEXT("    WARNING: Generators produced no trajectories — skipping."));
 	}
 	BroadcastLog(FString::Printf(TEXT("    Generated %d trajectory/ies."), Trajectories.Num()));
 	// Extrapolate global total: assume every remaining combo produces the same
@@ -500,137 +838,399 @@ void UCDGBatchProcExecService::ExecuteCurrentCombo()
 	//                   + this_combo_shots × remaining_combos_including_this_one
 	TotalShotsKnown = TotalShotsRendered
 		+ Trajectories.Num() * FMath::Max(1, TotalCombos - CompletedCombos);
-	BroadcastDetailedProgress(0, Trajectories.Num()); // shots generated, render pending
 
 	// ── 5. Export trajectories to level sequence ──────────────────────────────
-	ULevelSequence* MasterSeq = ExportTrajectoriesAsLevelSequence(World, RefSeq, Trajectories, FPS);
-	if (!MasterSeq)
+	bool bExported = false;
 	{
-		BroadcastLog(TEXT("    ERROR: Level sequence export failed — skipping."));
-		CleanupComboAssets(World);
-		DestroyGenerators();
-		DeleteReferenceSequence();
-		DestroySpawnedCharacter(World);
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
-		return;
+		FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::SequenceExport);
+		bExported = ExportTrajectoriesAsLevelSequence(World, *Combo, Trajectories) != nullptr;
+	}
+	if (!bExported)
+	{
+		return Fail(TEXT("    ERROR: Level sequence export failed — skipping."));
 	}
 
-	// ── 6. Build render config ────────────────────────────────────────────────
-	const FString RootOutputDir = Input.ExporterConfig.IsValid()
-		? Input.ExporterConfig->OutputDirectory
-		: FPaths::ProjectSavedDir() / TEXT("BatchProcOutput");
+	SetActiveCharacter(OnScreenCombo.Get());
+	return Combo;
+}
 
+bool UCDGBatchProcExecService::IsRenderBatchFull() const
+{
+	if (Input.MaxFramesPerRender <= 0) return false;
+
+	int32 Frames = 0;
+	for (const TSharedPtr<FBatchComboWork>& Combo : ReadyCombos)
+	{
+		Frames += Combo->NumFrames;
+	}
+	return Frames >= Input.MaxFramesPerRender;
+}
+
+TArray<TSharedPtr<FBatchComboWork>> UCDGBatchProcExecService::TakeRenderBatch()
+{
+	// Always at least one combo, then as many as the combo / frame budgets allow.
+	const int32 BatchSize = FMath::Max(1, Input.MaxCombosPerRender);
+	TArray<TSharedPtr<FBatchComboWork>> Batch;
+	int32 Frames = 0;
+
+	while (!ReadyCombos.IsEmpty() && Batch.Num() < BatchSize)
+	{
+		const int32 NextFrames = ReadyCombos[0]->NumFrames;
+		if (!Batch.IsEmpty() && Input.MaxFramesPerRender > 0 && Frames + NextFrames > Input.MaxFramesPerRender)
+		{
+			break;
+		}
+		Frames += NextFrames;
+		Batch.Add(ReadyCombos[0]);
+		ReadyCombos.RemoveAt(0);
+	}
+	return Batch;
+}
+
+FTrajectoryRenderConfig UCDGBatchProcExecService::MakeRenderConfig(const FBatchComboWork& Combo) const
+{
 	FTrajectoryRenderConfig RenderConfig;
-	RenderConfig.DestinationRootDir      = RootOutputDir;
-	RenderConfig.LevelNameOverride       = ComboKey;   // output → <RootDir>/<ComboKey>/OUTPUTS/
-	RenderConfig.bExportIndexJSON        = false;      // we write our own named JSON
+	RenderConfig.DestinationRootDir      = GetRootOutputDir();
+	RenderConfig.LevelNameOverride       = Combo.ComboKey;    // output → <RootDir>/<ComboKey>/OUTPUTS/
+	RenderConfig.bExportIndexJSON        = false;             // we write our own named JSON
 	RenderConfig.bOverwriteExistingOutput = Input.ExporterConfig.IsValid()
 		? Input.ExporterConfig->bOverwriteExisting : false;
 	RenderConfig.OutputResolutionOverride = FIntPoint(
 		Input.ExporterConfig.IsValid() ? Input.ExporterConfig->ResolutionWidth  : 1920,
 		Input.ExporterConfig.IsValid() ? Input.ExporterConfig->ResolutionHeight : 1080);
-	RenderConfig.OutputFramerateOverride  = FPS;
+	RenderConfig.OutputFramerateOverride  = Combo.FPS;
 	RenderConfig.ExportFormat             = Input.ExporterConfig.IsValid()
 		? Input.ExporterConfig->ExportFormat : ECDGRenderOutputFormat::PNG_Sequence;
 	RenderConfig.SpatialSampleCount       = Input.ExporterConfig.IsValid()
 		? Input.ExporterConfig->SpatialSampleCount  : 1;
 	RenderConfig.TemporalSampleCount      = Input.ExporterConfig.IsValid()
 		? Input.ExporterConfig->TemporalSampleCount : 1;
+	RenderConfig.FrameSink                = Input.ExporterConfig.IsValid()
+		? Input.ExporterConfig->FrameSink : ECDGFrameSinkKind::None;
+	RenderConfig.FramesPerChunk           = Input.ExporterConfig.IsValid()
+		? Input.ExporterConfig->FramesPerChunk : 300;
+	RenderConfig.ShardSizeMB              = Input.ExporterConfig.IsValid()
+		? Input.ExporterConfig->ShardSizeMB : 1024;
+	RenderConfig.ImageWrite               = Input.ExporterConfig.IsValid()
+		? Input.ExporterConfig->ImageWrite : FCDGImageWriteSettings();
+	RenderConfig.VideoEncode              = Input.ExporterConfig.IsValid()
+		? Input.ExporterConfig->VideoEncode : FCDGVideoEncodeSettings();
+	return RenderConfig;
+}
+
+void UCDGBatchProcExecService::ShowComboOnScreen(const TSharedPtr<FBatchComboWork>& Combo)
+{
+	// Only the combo MRQ is about to render may be visible in the PIE world.
+	if (OnScreenCombo.IsValid() && OnScreenCombo != Combo)
+	{
+		if (AActor* Previous = OnScreenCombo->Character.Get())
+		{
+			Previous->SetActorHiddenInGame(true);
+		}
+	}
+
+	OnScreenCombo = Combo;
+	if (AActor* Character = Combo->Character.Get())
+	{
+		Character->SetActorHiddenInGame(false);
+	}
+	BeatRenderState();
+
+	// The render spans many frames, so it is timed here and in FinishCombo
+	// rather than with a CPU scope.
+	if (Input.bRenderOutputs)
+	{
+		Combo->RenderStartSeconds = FPlatformTime::Seconds();
+		TRACE_BOOKMARK(TEXT("CDGBatch render begin %s"), *Combo->ComboKey);
+	}
+	SetActiveCharacter(Combo.Get());
+
+	OnProgressUpdated.Broadcast(CompletedCombos, TotalCombos);
+	BroadcastDetailedProgress(*Combo, Combo->ShotsRendered, Combo->Trajectories.Num());
+}
+
+void UCDGBatchProcExecService::StartRenderBatch(const TArray<TSharedPtr<FBatchComboWork>>& Batch)
+{
+	if (Batch.IsEmpty()) return;
+
+	RenderingCombos = Batch;
+
+	// Stall metric: how long the render slot sat empty before this batch.
+	if (RenderSlotFreeSince > 0.0)
+	{
+		const double Gap = FPlatformTime::Seconds() - RenderSlotFreeSince;
+		++Stats.NumRenderGaps;
+		Stats.TotalGapSeconds += Gap;
+		Stats.MaxGapSeconds    = FMath::Max(Stats.MaxGapSeconds, Gap);
+		if (Gap >= 1.0)
+		{
+			BroadcastLog(FString::Printf(TEXT("  Pipeline stall: render slot idle %.1f s before %s"),
+				Gap, *Batch[0]->ComboKey));
+		}
+	}
+
+	// Export-only runs (headless / no GPU) finish the combos right here.
+	if (!Input.bRenderOutputs)
+	{
+		for (const TSharedPtr<FBatchComboWork>& Combo : Batch)
+		{
+			ShowComboOnScreen(Combo);
+			BroadcastLog(FString::Printf(TEXT("  %s: rendering disabled — writing index only."), *Combo->ComboKey));
+			FinishCombo(Combo, /*bSuccess=*/true);
+		}
+		return;
+	}
+
+	// ── One MRQ queue for the whole batch ────────────────────────────────────
+	TOptional<FCDGBatchStageScope> SetupTiming;
+	SetupTiming.Emplace(Telemetry, Batch[0]->ComboKey, ECDGBatchStage::RenderSetup,
+		FString::Printf(TEXT("%d combo(s)"), Batch.Num()));
+
+	TArray<FCDGRenderBatchEntry> Entries;
+	int32 ShotCount  = 0;
+	int32 FrameCount = 0;
+	for (const TSharedPtr<FBatchComboWork>& Combo : Batch)
+	{
+		FCDGRenderBatchEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.MasterSequence = Combo->MasterSequence.Get();
+		Entry.Trajectories   = Combo->GetTrajectories();
+		Entry.Config         = MakeRenderConfig(*Combo);
+		++Combo->RenderAttempts;
+
+		// A re-render only redoes the shots whose outputs failed validation,
+		// over the broken files: MRQ would otherwise write " (2)" copies next
+		// to them and the retry could never validate.  Tar shards are the
+		// exception: the combo's shots share one shard set, which a re-render
+		// writes anew, so every shot goes into it again.
+		if (!Combo->InvalidShots.IsEmpty())
+		{
+			Entry.Config.bOverwriteExistingOutput = true;
+			const TArray<FString> InvalidShots = MoveTemp(Combo->InvalidShots);
+			Combo->InvalidShots.Reset();
+			Entry.Trajectories.RemoveAll([&InvalidShots, bSharedShards = Entry.Config.FrameSink == ECDGFrameSinkKind::TarShards](const ACDGTrajectory* Trajectory)
+			{
+				return !Trajectory || (!bSharedShards && !InvalidShots.Contains(Trajectory->TrajectoryName.ToString()));
+			});
+		}
+		ShotCount  += Entry.Trajectories.Num();
+		FrameCount += Combo->NumFrames;
+	}
 
-	// ── 7. Start render (async — continuation fires in lambda) ────────────────
-	// Capture everything by value / weak-ptr.
-	// ShotCount is captured NOW so the callback never depends on mutable state
-	// (CreatedShotSequencePaths is emptied during cleanup before the ticker fires).
-	const FString ComboOutputDir = FPaths::Combine(RootOutputDir, ComboKey);
-	const int32   FPSCapture     = FPS;
-	const int32   ShotCount      = Trajectories.Num();
+	BroadcastLog(FString::Printf(TEXT("  Rendering %d combo(s) in one session — %d shot(s), %d frame(s), %d combo(s) prepared ahead"),
+		Batch.Num(), ShotCount, FrameCount, ReadyCombos.Num()));
 
+	// The combos are captured by shared pointer so they outlive their queue
+	// slots; the service itself only by weak pointer.
 	TWeakObjectPtr<UCDGBatchProcExecService> WeakThis = this;
 
-	// Per-shot callback: fires as each individual MRQ job (shot) finishes.
-	// Captures ShotCount so the per-combo ShotCurrent/ShotTotal stays correct.
-	TSharedPtr<int32> ComboShotsDone = MakeShared<int32>(0);
+	FCDGRenderBatchCallbacks Callbacks;
+	Callbacks.OnEntryStarted = [WeakThis, Batch](int32 EntryIdx)
+	{
+		if (UCDGBatchProcExecService* Self = WeakThis.Get())
+		{
+			Self->BroadcastLog(FString::Printf(TEXT("  Rendering %s"), *Batch[EntryIdx]->ComboKey));
+			Self->ShowComboOnScreen(Batch[EntryIdx]);
+		}
+	};
+	Callbacks.OnShotRendered = [WeakThis, Batch](int32 EntryIdx)
+	{
+		if (UCDGBatchProcExecService* Self = WeakThis.Get())
+		{
+			FBatchComboWork& Combo = *Batch[EntryIdx];
+			++Combo.ShotsRendered;
+			++Self->TotalShotsRendered;
+			Self->BroadcastDetailedProgress(Combo, Combo.ShotsRendered, Combo.Trajectories.Num());
+		}
+	};
+	Callbacks.OnEntryFinished = [WeakThis, Batch](int32 EntryIdx, bool bSuccess)
+	{
+		UCDGBatchProcExecService* Self = WeakThis.Get();
+		if (!Self) return;
+
+		if (!bSuccess && Self->RequeueInvalidShots(Batch[EntryIdx]))
+		{
+			return;
+		}
+		Self->BroadcastLog(FString::Printf(TEXT("    Render %s: %s"),
+			bSuccess ? TEXT("completed") : TEXT("FAILED"), *Batch[EntryIdx]->ComboKey));
+		Self->FinishCombo(Batch[EntryIdx], bSuccess);
+	};
+	Callbacks.OnOutputsInvalid = [Batch](int32 EntryIdx, const TArray<FString>& FailedShots)
+	{
+		Batch[EntryIdx]->InvalidShots = FailedShots;
+	};
+
+	const bool bRenderStarted = CDGMRQInterface::RenderTrajectoryBatch(Entries, MoveTemp(Callbacks));
+	SetupTiming.Reset();
+
+	if (!bRenderStarted)
+	{
+		BroadcastLog(TEXT("    ERROR: Failed to start MRQ render — cleaning up and skipping."));
+		for (const TSharedPtr<FBatchComboWork>& Combo : Batch)
+		{
+			FinishCombo(Combo, /*bSuccess=*/false);
+		}
+	}
+}
+
+bool UCDGBatchProcExecService::RequeueInvalidShots(const TSharedPtr<FBatchComboWork>& Combo)
+{
+	const int32 MaxAttempts = FMath::Max(1, Input.MaxRenderAttempts);
+	if (Combo->InvalidShots.IsEmpty() || bCancelled || Combo->RenderAttempts >= MaxAttempts)
+	{
+		Combo->InvalidShots.Reset();
+		return false;
+	}
+
+	BroadcastLog(FString::Printf(TEXT("    Output check failed for %d shot(s) of %s — re-rendering (attempt %d of %d): %s"),
+		Combo->InvalidShots.Num(), *Combo->ComboKey, Combo->RenderAttempts + 1, MaxAttempts,
+		*FString::Join(Combo->InvalidShots, TEXT(", "))));
+
+	// Each attempt is its own Render row; the next one starts timing when MRQ
+	// reaches the combo again.
+	if (Combo->RenderStartSeconds > 0.0)
+	{
+		Telemetry.Record(Combo->ComboKey, ECDGBatchStage::Render, Combo->RenderStartSeconds,
+			FPlatformTime::Seconds() - Combo->RenderStartSeconds, TEXT("retry"));
+		Combo->RenderStartSeconds = 0.0;
+	}
+
+	// The shots are counted again as they re-render (all of them for a shared tar shard set).
+	const bool bSharedShards = Input.ExporterConfig.IsValid() && Input.ExporterConfig->FrameSink == ECDGFrameSinkKind::TarShards;
+	const int32 NumRerendered = bSharedShards ? Combo->ShotsRendered : Combo->InvalidShots.Num();
+	Combo->ShotsRendered = FMath::Max(0, Combo->ShotsRendered - NumRerendered);
+	TotalShotsRendered   = FMath::Max(0, TotalShotsRendered - NumRerendered);
+
+	// Ahead of everything prepared since; the combo's actors stay in the scene.
+	if (RenderingCombos.Remove(Combo) > 0 && RenderingCombos.IsEmpty())
+	{
+		RenderSlotFreeSince = FPlatformTime::Seconds();
+	}
+	ReadyCombos.Insert(Combo, 0);
+	return true;
+}
+
+void UCDGBatchProcExecService::FinishCombo(const TSharedPtr<FBatchComboWork>& Combo, bool bSuccess)
+{
+	if (Combo->RenderStartSeconds > 0.0)
+	{
+		const double Now = FPlatformTime::Seconds();
+		Telemetry.Record(Combo->ComboKey, ECDGBatchStage::Render, Combo->RenderStartSeconds,
+			Now - Combo->RenderStartSeconds, bSuccess ? TEXT("ok") : TEXT("failed"));
+		TRACE_BOOKMARK(TEXT("CDGBatch render end %s"), *Combo->ComboKey);
+	}
+
+	// a. Write combo index JSON while the trajectories still exist
+	if (bSuccess)
+	{
+		FCDGBatchStageScope Timing(Telemetry, Combo->ComboKey, ECDGBatchStage::IndexWrite);
+		WriteComboIndexJson(*Combo);
+	}
+
+	// b. Record the outcome (and output sizes) before anything else can crash.
+	//    Kept sequences were queued while the combo was prepared; their writes
+	//    overlapped the render and must be on disk before the combo counts.
+	//    Usually they are; otherwise the record waits on a background fence
+	//    rather than on the saves of the combos prepared since.
+	if (SaveQueue.IsWritten(Combo->SaveTicket))
+	{
+		RecordComboFinished(Combo, bSuccess);
+	}
+	else
+	{
+		AwaitingSaves.Emplace(Combo, bSuccess);
+		SaveQueue.FenceAsync();
+	}
+
+	// c. Take the character out of the scene now so the next combo's PIE
+	//    sessions never see it; the actual teardown runs on later ticks.
+	if (AActor* Character = Combo->Character.Get())
+	{
+		Character->SetActorHiddenInGame(true);
+		Character->SetActorEnableCollision(false);
+	}
+
+	if (OnScreenCombo == Combo)
+	{
+		OnScreenCombo.Reset();
+	}
+	if (RenderingCombos.Remove(Combo) > 0 && RenderingCombos.IsEmpty())
+	{
+		RenderSlotFreeSince = FPlatformTime::Seconds();
+	}
+	CleanupQueue.Add(Combo);
+
+	// d. Advance counters
+	++CompletedCombos;
+	OnProgressUpdated.Broadcast(CompletedCombos, TotalCombos);
+}
+
+void UCDGBatchProcExecService::RecordComboFinished(const TSharedPtr<FBatchComboWork>& Combo, bool bSuccess)
+{
+	Checkpoint.MarkFinished(Combo->ComboKey, Combo->Seed, bSuccess, Combo->OutputDir);
+	OnComboFinished.Broadcast(Combo->ComboKey, bSuccess);
+}
+
+void UCDGBatchProcExecService::RecordSavedCombos()
+{
+	if (AwaitingSaves.IsEmpty()) return;
 
-	auto OnShotRendered = [WeakThis, ComboShotsDone, ShotCount]()
+	for (int32 i = 0; i < AwaitingSaves.Num(); )
 	{
-		if (UCDGBatchProcExecService* Self = WeakThis.Get())
+		if (SaveQueue.IsWritten(AwaitingSaves[i].Key->SaveTicket))
 		{
-			++(*ComboShotsDone);
-			++Self->TotalShotsRendered;
-			Self->BroadcastDetailedProgress(*ComboShotsDone, ShotCount);
+			const TPair<TSharedPtr<FBatchComboWork>, bool> Done = AwaitingSaves[i];
+			AwaitingSaves.RemoveAt(i);
+			RecordComboFinished(Done.Key, Done.Value);
 		}
-	};
-
-	bool bRenderStarted = CDGMRQInterface::RenderTrajectoriesWithSequence(
-		MasterSeq, Trajectories, RenderConfig,
-		[WeakThis, ComboOutputDir, ComboKey, FPSCapture, ShotCount](bool bSuccess)
+		else
 		{
-			if (!WeakThis.IsValid()) return;
-			UCDGBatchProcExecService* Self = WeakThis.Get();
+			++i;
+		}
+	}
+	if (!AwaitingSaves.IsEmpty())
+	{
+		SaveQueue.FenceAsync();
+	}
+}
 
-			Self->BroadcastLog(FString::Printf(
-				TEXT("    Render %s: %s"),
-				bSuccess ? TEXT("completed") : TEXT("FAILED"),
-				*ComboKey));
+void UCDGBatchProcExecService::DrainPipeline(UWorld* World)
+{
+	for (const TSharedPtr<FBatchComboWork>& Combo : ReadyCombos)
+	{
+		CleanupCombo(*Combo, World);
+	}
+	ReadyCombos.Empty();
 
-			UWorld* W = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	for (const TSharedPtr<FBatchComboWork>& Combo : CleanupQueue)
+	{
+		CleanupCombo(*Combo, World);
+	}
+	CleanupQueue.Empty();
 
-			// 7a. Write combo index JSON
-			if (bSuccess && W)
-			{
-				Self->WriteComboIndexJson(ComboOutputDir, ComboKey, FPSCapture);
-			}
+	DestroyGenerators();
+	DestroyCharacterPool(World);
+}
 
-			// 7b. Clean up this combo's assets and actors
-			Self->CleanupComboAssets(W);
-			Self->DestroyGenerators();
-			Self->DeleteReferenceSequence();
-			Self->DestroySpawnedCharacter(W);
-
-			// 7c. Advance counters
-			++Self->CompletedCombos;
-			Self->OnProgressUpdated.Broadcast(Self->CompletedCombos, Self->TotalCombos);
-
-			// 7d. Defer advancement to the next combo by one engine tick.
-			//
-			// OnExecutorFinished fires DURING the MRQ executor's shutdown, before
-			// the subsystem clears its ActiveExecutor pointer.  If we call
-			// RenderTrajectoriesWithSequence immediately from here it hits the
-			// "already rendering" guard and returns false, causing every combo
-			// after the first to be silently skipped.  A one-tick deferral lets
-			// the executor fully release before we attempt the next render.
-			FTSTicker::GetCoreTicker().AddTicker(
-				FTickerDelegate::CreateLambda([WeakThis](float) -> bool
-				{
-					if (UCDGBatchProcExecService* S = WeakThis.Get())
-					{
-						if (!S->AdvanceComboIndices())
-						{
-							++S->CurrentLevelIdx;
-							S->BeginProcessLevel();
-						}
-						else
-						{
-							S->BeginNextCombo();
-						}
-					}
-					return false; // single-shot
-				}),
-				0.f); // fire on the very next tick
-		},
-		MoveTemp(OnShotRendered)); // per-shot callback bound to OnMoviePipelineWorkFinished
+void UCDGBatchProcExecService::SetActiveCharacter(FBatchComboWork* Active)
+{
+	auto Apply = [Active](FBatchComboWork* Combo)
+	{
+		if (Combo && Combo->Character.IsValid())
+		{
+			Combo->Character->SetActorEnableCollision(Combo == Active);
+		}
+	};
 
-	if (!bRenderStarted)
+	for (const TSharedPtr<FBatchComboWork>& Combo : RenderingCombos)
 	{
-		BroadcastLog(TEXT("    ERROR: Failed to start MRQ render — cleaning up and skipping."));
-		CleanupComboAssets(World);
-		DestroyGenerators();
-		DeleteReferenceSequence();
-		DestroySpawnedCharacter(World);
-		if (!AdvanceComboIndices()) { ++CurrentLevelIdx; BeginProcessLevel(); }
-		else BeginNextCombo();
+		Apply(Combo.Get());
 	}
+	for (const TSharedPtr<FBatchComboWork>& Combo : ReadyCombos)
+	{
+		Apply(Combo.Get());
+	}
+	Apply(Active);
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -640,6 +1240,7 @@ void UCDGBatchProcExecService::ExecuteCurrentCombo()
 AActor* UCDGBatchProcExecService::SpawnCharacterAtAnchor(
 	UWorld* World,
 	ACDGLevelSceneAnchor* Anchor,
+	int32 CharacterIdx,
 	UClass* CharacterClass)
 {
 	if (!World || !Anchor || !CharacterClass) return nullptr;
@@ -654,11 +1255,41 @@ AActor* UCDGBatchProcExecService::SpawnCharacterAtAnchor(
 		SpawnXY.Y += FMath::Sin(Angle) * Dist;
 	}
 
-	FActorSpawnParameters Params;
-	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	// Reuse an idle actor of this character: skips component registration,
+	// physics and render state creation.
+	AActor* Character = nullptr;
+	if (TArray<TWeakObjectPtr<AActor>>* Idle = IdleCharacters.Find(CharacterIdx))
+	{
+		while (!Character && !Idle->IsEmpty())
+		{
+			Character = Idle->Pop().Get();
+		}
+	}
+
+	if (Character)
+	{
+		Character->SetActorLocationAndRotation(SpawnXY, FRotator::ZeroRotator, /*bSweep=*/false, nullptr,
+			ETeleportType::ResetPhysics);
+
+		// Drop whatever pose or animation binding the previous combo left.
+		TArray<USkeletalMeshComponent*> SkelComps;
+		Character->GetComponents<USkeletalMeshComponent>(SkelComps);
+		for (USkeletalMeshComponent* SkelComp : SkelComps)
+		{
+			SkelComp->Stop();
+			SkelComp->InitAnim(/*bForceReinit=*/true);
+		}
+		++Stats.CharacterReuses;
+	}
+	else
+	{
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
-	AActor* Character = World->SpawnActor<AActor>(CharacterClass, SpawnXY, FRotator::ZeroRotator, Params);
-	if (!Character) return nullptr;
+		Character = World->SpawnActor<AActor>(CharacterClass, SpawnXY, FRotator::ZeroRotator, Params);
+		if (!Character) return nullptr;
+		PooledCharacters.Add(Character);
+	}
 
 	// Actor roots are often at the capsule centre, not the feet.
 	// Measure how far the root sits above the bounding-box bottom, then shift
@@ -673,19 +1304,41 @@ AActor* UCDGBatchProcExecService::SpawnCharacterAtAnchor(
 	return Character;
 }
 
+void UCDGBatchProcExecService::ReleaseCharacter(FBatchComboWork& Combo)
+{
+	if (AActor* Character = Combo.Character.Get())
+	{
+		Character->SetActorHiddenInGame(true);
+		Character->SetActorEnableCollision(false);
+		IdleCharacters.FindOrAdd(Combo.CharacterIdx).Add(Character);
+	}
+	Combo.Character.Reset();
+}
+
+void UCDGBatchProcExecService::DestroyCharacterPool(UWorld* World)
+{
+	if (World)
+	{
+		for (const TWeakObjectPtr<AActor>& Character : PooledCharacters)
+		{
+			if (Character.IsValid()) World->EditorDestroyActor(Character.Get(), true);
+		}
+	}
+	PooledCharacters.Empty();
+	IdleCharacters.Empty();
+}
+
 ULevelSequence* UCDGBatchProcExecService::CreateReferenceSequence(
 	UWorld* World,
 	AActor* Character,
 	UAnimationAsset* Anim,
-	const FString& ComboKey,
-	int32 FPS)
+	const FBatchComboWork& Combo)
 {
 	if (!World || !Character || !Anim) return nullptr;
 
-	const FString SeqName    = TEXT("CDGBatchRefSeq_") + ComboKey;
-	const FString SeqPkgName = TEXT("/Game/CDGBatch_Temp/") + SeqName;
-
-	ULevelSequence* RefSeq = ForceGetOrCreateLevelSequence(SeqPkgName, SeqName);
+	const int32 FPS = Combo.FPS;
+	ULevelSequence* RefSeq = GetOrCreateComboSequence(
+		TEXT("CDGBatchRefSeq_") + Combo.ComboKey, Combo.bTransientSequences);
 	if (!RefSeq) return nullptr;
 
 	UMovieScene* MS = RefSeq->GetMovieScene();
@@ -740,16 +1393,12 @@ ULevelSequence* UCDGBatchProcExecService::CreateReferenceSequence(
 		}
 	}
 
-	RefSeq->MarkPackageDirty();
-
-	// Persist so CDGLevelSeqSubsystem / shot sequences can reference it
-	UPackage* Pkg = RefSeq->GetOutermost();
-	const FString PkgFilename = FPackageName::LongPackageNameToFilename(
-		Pkg->GetName(), FPackageName::GetAssetPackageExtension());
-
-	FSavePackageArgs SaveArgs;
-	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
-	UPackage::SavePackage(Pkg, RefSeq, *PkgFilename, SaveArgs);
+	// Generators and shots only use the object itself, so a transient
+	// reference sequence never has to touch the disk.
+	if (!Combo.bTransientSequences)
+	{
+		SaveSequenceAsset(SaveQueue, RefSeq);
+	}
 
 	return RefSeq;
 }
@@ -852,7 +1501,7 @@ void UCDGBatchProcExecService::InstantiateGenerators(
 		PositioningGenerators.Num(), MovementGenerators.Num(), EffectsGenerators.Num()));
 }
 
-TArray<ACDGTrajectory*> UCDGBatchProcExecService::RunGenerators(UWorld* World)
+TArray<ACDGTrajectory*> UCDGBatchProcExecService::RunGenerators(UWorld* World, const FString& ComboKey)
 {
 	// Helper: re-outer a generator to the current world
 	auto PrepareGen = [World](UCDGTrajectoryGenerator* Gen)
@@ -874,7 +1523,12 @@ TArray<ACDGTrajectory*> UCDGBatchProcExecService::RunGenerators(UWorld* World)
 		if (!PosGen) continue;
 		PrepareGen(PosGen);
 
-		const TArray<FCDGCameraPlacement> Placements = PosGen->GeneratePlacements();
+		TArray<FCDGCameraPlacement> Placements;
+		{
+			FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::GeneratorRun,
+				PosGen->GetGeneratorName().ToString());
+			Placements = PosGen->GeneratePlacements();
+		}
 
 		UE_LOG(LogCameraDatasetGenEditor, Log,
 			TEXT("[BatchExec] %s produced %d placement(s)"),
@@ -887,7 +1541,12 @@ TArray<ACDGTrajectory*> UCDGBatchProcExecService::RunGenerators(UWorld* World)
 			if (!MovGen) continue;
 			PrepareGen(MovGen);
 
-			TArray<ACDGTrajectory*> Created = MovGen->GenerateMovement(Placements);
+			TArray<ACDGTrajectory*> Created;
+			{
+				FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::GeneratorRun,
+					MovGen->GetGeneratorName().ToString());
+				Created = MovGen->GenerateMovement(Placements);
+			}
 			AllTrajectories.Append(Created);
 
 			UE_LOG(LogCameraDatasetGenEditor, Log,
@@ -903,7 +1562,11 @@ TArray<ACDGTrajectory*> UCDGBatchProcExecService::RunGenerators(UWorld* World)
 	{
 		if (!FxGen) continue;
 		PrepareGen(FxGen);
-		FxGen->ApplyEffects(AllTrajectories);
+		{
+			FCDGBatchStageScope Timing(Telemetry, ComboKey, ECDGBatchStage::GeneratorRun,
+				FxGen->GetGeneratorName().ToString());
+			FxGen->ApplyEffects(AllTrajectories);
+		}
 		UE_LOG(LogCameraDatasetGenEditor, Log,
 			TEXT("[BatchExec] %s applied effects to %d trajectory/ies"),
 			*FxGen->GetGeneratorName().ToString(), AllTrajectories.Num());
@@ -914,33 +1577,25 @@ TArray<ACDGTrajectory*> UCDGBatchProcExecService::RunGenerators(UWorld* World)
 
 ULevelSequence* UCDGBatchProcExecService::ExportTrajectoriesAsLevelSequence(
 	UWorld* World,
-	ULevelSequence* RefSeq,
-	const TArray<ACDGTrajectory*>& Trajectories,
-	int32 FPS)
+	FBatchComboWork& Combo,
+	const TArray<ACDGTrajectory*>& Trajectories)
 {
+	ULevelSequence* RefSeq = Combo.RefSequence.Get();
 	if (!World || !RefSeq || Trajectories.IsEmpty()) return nullptr;
 
-	UCDGLevelSeqSubsystem* LevelSeqSys = World->GetSubsystem<UCDGLevelSeqSubsystem>();
-	if (!LevelSeqSys) return nullptr;
-
-	// Get / create the master sequence
-	LevelSeqSys->InitLevelSequence();
-	ULevelSequence* MasterSeq = LevelSeqSys->GetActiveLevelSequence();
+	// One master per combo (instead of the level's active sequence) so a
+	// prepared combo never overwrites the shots of the one being rendered.
+	// Shots are named <MasterName>_Shot_<Traj> and therefore unique too.
+	const FString MasterName = TEXT("CDGBatchSeq_") + Combo.ComboKey;
+	ULevelSequence* MasterSeq = GetOrCreateComboSequence(MasterName, Combo.bTransientSequences);
 	if (!MasterSeq) return nullptr;
+	Combo.MasterSequence = MasterSeq;
 
-	const FFrameRate FrameRate(FPS, 1);
+	const FFrameRate FrameRate(Combo.FPS, 1);
 	UMovieScene* MasterMS = MasterSeq->GetMovieScene();
 	MasterMS->SetDisplayRate(FrameRate);
 	MasterMS->SetTickResolutionDirectly(FFrameRate(kTickResolution, 1));
 
-	// Clear master's existing tracks — copy first to avoid mutating while iterating
-	TArray<UMovieSceneTrack*> MasterTracksToRemove = MasterMS->GetTracks();
-	for (UMovieSceneTrack* T : MasterTracksToRemove) MasterMS->RemoveTrack(*T);
-	for (int32 i = MasterMS->GetSpawnableCount() - 1; i >= 0; --i)
-		MasterMS->RemoveSpawnable(MasterMS->GetSpawnable(i).GetGuid());
-	for (int32 i = MasterMS->GetPossessableCount() - 1; i >= 0; --i)
-		MasterMS->RemovePossessable(MasterMS->GetPossessable(i).GetGuid());
-
 	UMovieSceneCinematicShotTrack* ShotTrack = MasterMS->AddTrack<UMovieSceneCinematicShotTrack>();
 	if (!ShotTrack) return nullptr;
 
@@ -948,7 +1603,7 @@ ULevelSequence* UCDGBatchProcExecService::ExportTrajectoriesAsLevelSequence(
 	const FString MasterPackagePath  = FPackageName::GetLongPackagePath(MasterPackageName);
 	const FString MasterSeqShortName = FPackageName::GetShortName(MasterPackageName);
 
-	CreatedShotSequencePaths.Empty();
+	Combo.ShotSequencePaths.Empty();
 
 	// STEP 3 contract: every shot's duration MUST equal the reference sequence
 	// (which is the animation's length), regardless of how the movement
@@ -983,12 +1638,38 @@ ULevelSequence* UCDGBatchProcExecService::ExportTrajectoriesAsLevelSequence(
 	// shot independently because each job is bound to its own ShotSequence.
 	int32 ShotRowIndex = 0;
 
-	for (ACDGTrajectory* Trajectory : Trajectories)
+	// Key values only depend on the keyframes: snapshot them here, bake every
+	// trajectory's channels on the task graph, and only create the sequence
+	// objects and assign whole channels in the loop below.
+	FCDGShotLayout ShotLayout;
+	ShotLayout.KeyReduction = FCDGKeyReduction::FromConfig(Input.ExporterConfig.Get());
+	const FCDGSequenceBuilder Builder(ShotLayout, FrameRate, kTickResolution);
+	TArray<FCDGCameraKeySnapshot> KeySnapshots;
+	KeySnapshots.SetNum(Trajectories.Num());
+	for (int32 TrajIdx = 0; TrajIdx < Trajectories.Num(); ++TrajIdx)
+	{
+		if (Trajectories[TrajIdx])
+		{
+			KeySnapshots[TrajIdx] = Builder.Capture(*Trajectories[TrajIdx]);
+		}
+	}
+	TArray<FCDGBakedCameraKeys> BakedKeys;
+	const FCDGSequenceBuilder::FBakeStats BakeStats = Builder.BakeAll(KeySnapshots, BakedKeys);
+	if (ShotLayout.KeyReduction.bEnabled)
+	{
+		BroadcastLog(FString::Printf(TEXT("  Key reduction (%s): %s"),
+			*Combo.ComboKey, *BakeStats.ToString()));
+	}
+
+	for (int32 TrajIdx = 0; TrajIdx < Trajectories.Num(); ++TrajIdx)
 	{
+		ACDGTrajectory* Trajectory = Trajectories[TrajIdx];
 		if (!Trajectory) continue;
 
 		// ── Create (or reuse) shot sequence ──────────────────────────────────
-		// ForceGetOrCreateLevelSequence handles every case without dialogs:
+		// New shots are copies of the builder's shot template, so bindings and
+		// tracks already exist.  Transient shots are always new.  For kept
+		// shots ForceGetOrCreateLevelSequence handles every case without dialogs:
 		//   • in-memory object (previous combo this session)
 		//   • on-disk asset not yet loaded (leftover from a prior session / manual export)
 		//   • genuinely new asset
@@ -996,231 +1677,35 @@ ULevelSequence* UCDGBatchProcExecService::ExportTrajectoriesAsLevelSequence(
 			*MasterSeqShortName, *Trajectory->TrajectoryName.ToString());
 		const FString ShotPackageName = MasterPackagePath / ShotName;
 
-		ULevelSequence* ShotSeq = ForceGetOrCreateLevelSequence(ShotPackageName, ShotName);
+		ULevelSequence* ShotSeq = Combo.bTransientSequences
+			? CreateTransientLevelSequence(ShotPackageName, ShotName, &Builder)
+			: ForceGetOrCreateLevelSequence(ShotPackageName, ShotName, &Builder);
 		if (!ShotSeq) continue;
 
 		UMovieScene* ShotMS = ShotSeq->GetMovieScene();
 		ShotSeq->Modify();
 		ShotMS->Modify();
-		ShotMS->SetDisplayRate(FrameRate);
-		ShotMS->SetTickResolutionDirectly(FFrameRate(kTickResolution, 1));
-
-		// ── Camera possessable + transform track ─────────────────────────────
-		const FString CameraName = FString::Printf(TEXT("Cam_%s"), *Trajectory->TrajectoryName.ToString());
-
-		// Destroy leftover cameras
-		for (TActorIterator<ACineCameraActor> It(World); It; ++It)
-		{
-			if (It->GetActorLabel() == CameraName)
-			{
-				World->EditorDestroyActor(*It, true);
-				break;
-			}
-		}
-
-		FActorSpawnParameters CamSpawnParams;
-		ACineCameraActor* CameraActor = World->SpawnActor<ACineCameraActor>(
-			ACineCameraActor::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, CamSpawnParams);
-		if (!CameraActor) continue;
-		CameraActor->SetActorLabel(CameraName);
-
-		FGuid CameraGuid = ShotMS->AddPossessable(CameraActor->GetActorLabel(), CameraActor->GetClass());
-		ShotSeq->BindPossessableObject(CameraGuid, *CameraActor, World);
-
-		// Camera cut track
-		if (UMovieSceneCameraCutTrack* CutTrack = ShotMS->AddTrack<UMovieSceneCameraCutTrack>())
-		{
-			if (UMovieSceneCameraCutSection* CutSec =
-				Cast<UMovieSceneCameraCutSection>(CutTrack->CreateNewSection()))
-			{
-				CutSec->SetRange(TRange<FFrameNumber>(0, DurationTicks));
-				CutSec->SetCameraGuid(CameraGuid);
-				CutTrack->AddSection(*CutSec);
-			}
-		}
-
-		// Transform track — bake from trajectory keyframes
-		if (UMovieScene3DTransformTrack* TformTrack =
-			ShotMS->AddTrack<UMovieScene3DTransformTrack>(CameraGuid))
-		{
-			if (UMovieScene3DTransformSection* TformSec =
-				Cast<UMovieScene3DTransformSection>(TformTrack->CreateNewSection()))
-			{
-				TformTrack->AddSection(*TformSec);
-				TformSec->SetRange(TRange<FFrameNumber>(0, DurationTicks));
-
-				FMovieSceneChannelProxy& ChProxy = TformSec->GetChannelProxy();
-				TArrayView<FMovieSceneDoubleChannel*> DoubleChans =
-					ChProxy.GetChannels<FMovieSceneDoubleChannel>();
-
-				if (DoubleChans.Num() >= 6)
-				{
-					TArray<ACDGKeyframe*> KFs = Trajectory->GetSortedKeyframes();
-					double CurTime = 0.0;
-
-					auto AddKeyToChannel = [](FMovieSceneDoubleChannel* Ch, FFrameNumber T,
-					                          double V, ECDGInterpolationMode Mode)
-					{
-						if (!Ch) return;
-						ERichCurveInterpMode IM; ERichCurveTangentMode TM;
-						switch (Mode)
-						{
-						case ECDGInterpolationMode::Linear:   IM = RCIM_Linear;   TM = RCTM_Auto; break;
-						case ECDGInterpolationMode::Constant: IM = RCIM_Constant; TM = RCTM_Auto; break;
-						default:                              IM = RCIM_Cubic;    TM = RCTM_Auto; break;
-						}
-						if (IM == RCIM_Constant)     Ch->AddConstantKey(T, V);
-						else if (IM == RCIM_Linear)  Ch->AddLinearKey(T, V);
-						else                         Ch->AddCubicKey(T, V, TM);
-					};
-
-					for (int32 k = 0; k < KFs.Num(); ++k)
-					{
-						ACDGKeyframe* KF = KFs[k];
-						if (!KF) continue;
-						if (k > 0) CurTime += KF->TimeToCurrentFrame;
-
-						const FFrameNumber KT = FFrameNumber(
-							static_cast<int32>(CurTime * kTickResolution));
-						const FTransform Xform = KF->GetKeyframeTransform();
-						const FVector  Loc     = Xform.GetLocation();
-						const FRotator Rot     = Xform.GetRotation().Rotator();
-						const bool bStay       = KF->TimeAtCurrentFrame > KINDA_SMALL_NUMBER;
-
-						const ECDGInterpolationMode PM = bStay ?
-							ECDGInterpolationMode::Constant : KF->InterpolationSettings.PositionInterpMode;
-						const ECDGInterpolationMode RM = bStay ?
-							ECDGInterpolationMode::Constant : KF->InterpolationSettings.RotationInterpMode;
-
-						AddKeyToChannel(DoubleChans[0], KT, Loc.X, PM);
-						AddKeyToChannel(DoubleChans[1], KT, Loc.Y, PM);
-						AddKeyToChannel(DoubleChans[2], KT, Loc.Z, PM);
-						AddKeyToChannel(DoubleChans[3], KT, Rot.Roll,  RM);
-						AddKeyToChannel(DoubleChans[4], KT, Rot.Pitch, RM);
-						AddKeyToChannel(DoubleChans[5], KT, Rot.Yaw,   RM);
-
-						if (bStay)
-						{
-							CurTime += KF->TimeAtCurrentFrame;
-							const FFrameNumber KT2 = FFrameNumber(
-								static_cast<int32>(CurTime * kTickResolution));
-							AddKeyToChannel(DoubleChans[0], KT2, Loc.X, KF->InterpolationSettings.PositionInterpMode);
-							AddKeyToChannel(DoubleChans[1], KT2, Loc.Y, KF->InterpolationSettings.PositionInterpMode);
-							AddKeyToChannel(DoubleChans[2], KT2, Loc.Z, KF->InterpolationSettings.PositionInterpMode);
-							AddKeyToChannel(DoubleChans[3], KT2, Rot.Roll,  KF->InterpolationSettings.RotationInterpMode);
-							AddKeyToChannel(DoubleChans[4], KT2, Rot.Pitch, KF->InterpolationSettings.RotationInterpMode);
-							AddKeyToChannel(DoubleChans[5], KT2, Rot.Yaw,   KF->InterpolationSettings.RotationInterpMode);
-						}
-					}
-				}
-			}
-		}
+		Builder.PrepareMovieScene(*ShotMS);
 
-		// Lens tracks on camera component
-		if (UCineCameraComponent* CamComp = CameraActor->GetCineCameraComponent())
-		{
-			FGuid CompGuid = ShotMS->AddPossessable(CamComp->GetName(), CamComp->GetClass());
-			if (FMovieScenePossessable* CP = ShotMS->FindPossessable(CompGuid))
-				CP->SetParent(CameraGuid, ShotMS);
-			ShotSeq->BindPossessableObject(CompGuid, *CamComp, CameraActor);
+		// ── Camera, camera cut, transform and lens tracks ────────────────────
+		const FCDGSequenceBuilder::FBuiltShot Shot =
+			Builder.BuildCameraShot(World, *ShotSeq, KeySnapshots[TrajIdx], BakedKeys[TrajIdx], DurationTicks);
+		if (!Shot.Camera) continue;
+		Combo.Cameras.Add(Shot.Camera);
 
-			TArray<ACDGKeyframe*> KFs = Trajectory->GetSortedKeyframes();
+		// ── Character animation: the reference sequence as a subsequence ─────
+		// It already binds the character and its skeletal animation tracks;
+		// playing it under every shot avoids a copy of them per shot.
+		FCDGSequenceBuilder::AddSharedSubSequence(*ShotSeq, *RefSeq, DurationTicks);
 
-			auto AddLensTrack = [&](const FName& PropName, const FString& PropPath,
-			                        TFunction<float(const ACDGKeyframe*)> ValueGetter)
-			{
-				UMovieSceneFloatTrack* Track = ShotMS->AddTrack<UMovieSceneFloatTrack>(CompGuid);
-				if (!Track) return;
-				Track->SetPropertyNameAndPath(PropName, PropPath);
-				UMovieSceneFloatSection* Sec = Cast<UMovieSceneFloatSection>(Track->CreateNewSection());
-				if (!Sec) return;
-				Track->AddSection(*Sec);
-				Sec->SetRange(TRange<FFrameNumber>(0, DurationTicks));
-				FMovieSceneFloatChannel& Ch = Sec->GetChannel();
-				double T = 0.0;
-				for (int32 k = 0; k < KFs.Num(); ++k)
-				{
-					if (!KFs[k]) continue;
-					if (k > 0) T += KFs[k]->TimeToCurrentFrame;
-					Ch.AddLinearKey(FFrameNumber(static_cast<int32>(T * kTickResolution)),
-					                ValueGetter(KFs[k]));
-					if (KFs[k]->TimeAtCurrentFrame > KINDA_SMALL_NUMBER)
-					{
-						T += KFs[k]->TimeAtCurrentFrame;
-						Ch.AddLinearKey(FFrameNumber(static_cast<int32>(T * kTickResolution)),
-						                ValueGetter(KFs[k]));
-					}
-				}
-			};
-
-			AddLensTrack(
-				GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentFocalLength),
-				TEXT("CurrentFocalLength"),
-				[](const ACDGKeyframe* KF) { return KF->LensSettings.FocalLength; });
-
-			AddLensTrack(
-				GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentAperture),
-				TEXT("CurrentAperture"),
-				[](const ACDGKeyframe* KF) { return KF->LensSettings.Aperture; });
-		}
+		ShotMS->SetPlaybackRange(TRange<FFrameNumber>(0, DurationTicks));
 
-		// ── Copy character animation from ref sequence into shot ──────────────
-		// Bind the character possessable (same actor, different binding in this shot)
-		if (SpawnedCharacter.IsValid())
+		// Persist shot sequence (kept sequences only)
+		if (!Combo.bTransientSequences)
 		{
-			AActor* CharActor = SpawnedCharacter.Get();
-			FGuid CopyCharGuid = ShotMS->AddPossessable(
-				CharActor->GetActorNameOrLabel(), CharActor->GetClass());
-			ShotSeq->BindPossessableObject(CopyCharGuid, *CharActor, World);
-
-			TArray<USkeletalMeshComponent*> SkelComps;
-			CharActor->GetComponents<USkeletalMeshComponent>(SkelComps);
-
-			for (USkeletalMeshComponent* SkelComp : SkelComps)
-			{
-				if (!SkelComp) continue;
-				FGuid CopySkelGuid = ShotMS->AddPossessable(SkelComp->GetName(), SkelComp->GetClass());
-				if (FMovieScenePossessable* P = ShotMS->FindPossessable(CopySkelGuid))
-					P->SetParent(CopyCharGuid, ShotMS);
-				ShotSeq->BindPossessableObject(CopySkelGuid, *SkelComp, CharActor);
-
-				// Copy anim track from ref sequence by duplicating
-				TArray<UMovieSceneTrack*> RefTracks;
-				if (UMovieScene* RefMS = RefSeq->GetMovieScene())
-				{
-				// Find the skeletal animation tracks on this component in the ref sequence
-				const UMovieScene* ConstRefMS = RefMS;
-				for (const FMovieSceneBinding& RefBinding : ConstRefMS->GetBindings())
-					{
-						// Match by component name
-						FString BindingName;
-						if (const FMovieScenePossessable* Poss = RefMS->FindPossessable(RefBinding.GetObjectGuid()))
-							BindingName = Poss->GetName();
-						if (BindingName != SkelComp->GetName()) continue;
-
-						for (UMovieSceneTrack* Track : RefBinding.GetTracks())
-						{
-							if (!Track->IsA<UMovieSceneSkeletalAnimationTrack>()) continue;
-							if (UMovieSceneTrack* Dup = DuplicateObject<UMovieSceneTrack>(Track, ShotMS))
-							{
-								ShotMS->AddGivenTrack(Dup, CopySkelGuid);
-							}
-						}
-					}
-				}
-			}
+			SaveSequenceAsset(SaveQueue, ShotSeq);
 		}
 
-		ShotMS->SetPlaybackRange(TRange<FFrameNumber>(0, DurationTicks));
-		ShotSeq->MarkPackageDirty();
-
-		// Persist shot sequence
-		const FString ShotPkgFilename = FPackageName::LongPackageNameToFilename(
-			ShotSeq->GetOutermost()->GetName(), FPackageName::GetAssetPackageExtension());
-		FSavePackageArgs SaveArgs;
-		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
-		UPackage::SavePackage(ShotSeq->GetOutermost(), ShotSeq, *ShotPkgFilename, SaveArgs);
-
 		// Add to master cinematic shot track at frame 0 on its own row so
 		// shots are stacked instead of stitched end-to-end.
 		if (UMovieSceneSubSection* SubSection =
@@ -1229,35 +1714,35 @@ ULevelSequence* UCDGBatchProcExecService::ExportTrajectoriesAsLevelSequence(
 			SubSection->SetRowIndex(ShotRowIndex++);
 		}
 
-		CreatedShotSequencePaths.Add(ShotSeq->GetOutermost()->GetName());
+		Combo.ShotSequencePaths.Add(ShotSeq->GetOutermost()->GetName());
 	}
 
 	// All shots share the same duration (the animation length), so the master's
 	// playback range is simply that single duration.
 	MasterMS->SetPlaybackRange(TRange<FFrameNumber>(0, FFrameNumber(DurationTicks)));
-	MasterSeq->MarkPackageDirty();
 
-	// Persist master
-	const FString MasterPkgFilename = FPackageName::LongPackageNameToFilename(
-		MasterSeq->GetOutermost()->GetName(), FPackageName::GetAssetPackageExtension());
-	FSavePackageArgs MasterSaveArgs;
-	MasterSaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
-	UPackage::SavePackage(MasterSeq->GetOutermost(), MasterSeq, *MasterPkgFilename, MasterSaveArgs);
+	// Persist master (kept sequences only)
+	if (!Combo.bTransientSequences)
+	{
+		SaveSequenceAsset(SaveQueue, MasterSeq);
+	}
+
+	// Render budget bookkeeping (MaxFramesPerRender)
+	const int32 FramesPerShot = FMath::CeilToInt(DurationTicks / kTickResolution * Combo.FPS);
+	Combo.NumFrames = FramesPerShot * ShotRowIndex;
 
 	return MasterSeq;
 }
 
-void UCDGBatchProcExecService::WriteComboIndexJson(
-	const FString& ComboOutputDir,
-	const FString& ComboKey,
-	int32 FPS)
+void UCDGBatchProcExecService::WriteComboIndexJson(const FBatchComboWork& Combo)
 {
 	IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
-	if (!PF.DirectoryExists(*ComboOutputDir))
-		PF.CreateDirectoryTree(*ComboOutputDir);
+	if (!PF.DirectoryExists(*Combo.OutputDir))
+		PF.CreateDirectoryTree(*Combo.OutputDir);
 
-	const FString JSONPath = FPaths::Combine(ComboOutputDir, ComboKey + TEXT(".json"));
-	const bool bOK = TrajectorySL::SaveAllTrajectories(JSONPath, FPS, /*bPrettyPrint=*/true);
+	// Only this combo's trajectories — prepared combos share the world.
+	const FString JSONPath = FPaths::Combine(Combo.OutputDir, Combo.ComboKey + TEXT(".json"));
+	const bool bOK = TrajectorySL::SaveTrajectories(JSONPath, Combo.GetTrajectories(), Combo.FPS, /*bPrettyPrint=*/true);
 
 	if (bOK)
 		BroadcastLog(FString::Printf(TEXT("    Index JSON written: %s"), *JSONPath));
@@ -1265,74 +1750,145 @@ void UCDGBatchProcExecService::WriteComboIndexJson(
 		BroadcastLog(FString::Printf(TEXT("    WARNING: Failed to write index JSON: %s"), *JSONPath));
 }
 
-void UCDGBatchProcExecService::CleanupComboAssets(UWorld* World)
+void UCDGBatchProcExecService::CleanupCombo(FBatchComboWork& Combo, UWorld* World)
 {
-	if (!World) return;
+	// Everything this combo created should be gone after the next collection.
+	// Kept (on-disk) sequences are meant to outlive the combo.
+	// The character actor goes back to the pool, not to the collector.
+	TArray<TWeakObjectPtr<UObject>> Released;
+	for (const TWeakObjectPtr<ACDGTrajectory>& WeakTraj : Combo.Trajectories)
+	{
+		if (ACDGTrajectory* Traj = WeakTraj.Get())
+		{
+			Released.Add(Traj);
+			for (ACDGKeyframe* KF : Traj->GetSortedKeyframes())
+			{
+				if (KF) Released.Add(KF);
+			}
+		}
+	}
+	for (const TWeakObjectPtr<AActor>& Cam : Combo.Cameras)
+	{
+		Released.Add(Cam);
+	}
+	if (Combo.bTransientSequences)
+	{
+		Released.Add(Combo.MasterSequence);
+		Released.Add(Combo.RefSequence);
+		for (const FString& ShotPkg : Combo.ShotSequencePaths)
+		{
+			const FString ObjectPath = ShotPkg + TEXT(".") + FPackageName::GetShortName(ShotPkg);
+			Released.Add(FindObject<ULevelSequence>(nullptr, *ObjectPath));
+		}
+	}
+	Released.RemoveAll([](const TWeakObjectPtr<UObject>& Obj) { return !Obj.IsValid(); });
 
-	// ── Delete trajectory + keyframe actors ───────────────────────────────────
-	UCDGTrajectorySubsystem* TrajSys = World->GetSubsystem<UCDGTrajectorySubsystem>();
-	if (TrajSys)
 	{
-		for (const FName& Name : TrajSys->GetTrajectoryNames())
-			TrajSys->DeleteTrajectory(Name);
+		FCDGBatchStageScope Timing(Telemetry, Combo.ComboKey, ECDGBatchStage::Cleanup);
+		CleanupComboObjects(Combo, World);
 	}
 
-	TArray<ACDGKeyframe*> Orphans;
-	for (TActorIterator<ACDGKeyframe> It(World); It; ++It) Orphans.Add(*It);
-	for (ACDGKeyframe* KF : Orphans) World->EditorDestroyActor(KF, true);
+	MemoryGuard.OnComboReleased(Combo.ComboKey, Released);
 
-	// ── Delete camera actors created during export ─────────────────────────────
-	TArray<ACineCameraActor*> Cameras;
-	for (TActorIterator<ACineCameraActor> It(World); It; ++It) Cameras.Add(*It);
-	for (ACineCameraActor* Cam : Cameras) World->EditorDestroyActor(Cam, true);
+	// A combo's rows are complete once it is torn down.
+	Telemetry.Flush();
+}
 
-	// ── Delete shot sequence assets ───────────────────────────────────────────
-	// Disconnect shots from the master first so they have no hard references,
-	// then fully unload + delete each one.
-	UCDGLevelSeqSubsystem* LevelSeqSys = World->GetSubsystem<UCDGLevelSeqSubsystem>();
-	if (LevelSeqSys)
+void UCDGBatchProcExecService::CleanupComboObjects(FBatchComboWork& Combo, UWorld* World)
+{
+	// ── Delete trajectory + keyframe actors ───────────────────────────────────
+	// Keyframes first: DeleteTrajectoryActor would otherwise re-home each of
+	// them into a fresh single-keyframe trajectory.
+	UCDGTrajectorySubsystem* TrajSys = World ? World->GetSubsystem<UCDGTrajectorySubsystem>() : nullptr;
+	for (const TWeakObjectPtr<ACDGTrajectory>& WeakTraj : Combo.Trajectories)
 	{
-		if (ULevelSequence* MasterSeq = LevelSeqSys->GetActiveLevelSequence())
+		ACDGTrajectory* Traj = WeakTraj.Get();
+		if (!Traj) continue;
+
+		if (World)
 		{
-			if (UMovieScene* MasterMS = MasterSeq->GetMovieScene())
+			for (ACDGKeyframe* KF : Traj->GetSortedKeyframes())
 			{
-				TArray<UMovieSceneTrack*> TracksToRemove = MasterMS->GetTracks();
-				for (UMovieSceneTrack* T : TracksToRemove) MasterMS->RemoveTrack(*T);
+				if (KF) World->EditorDestroyActor(KF, true);
 			}
 		}
+
+		if (IsValid(Traj))
+		{
+			if (TrajSys) TrajSys->DeleteTrajectoryActor(Traj);
+			else         Traj->Destroy();
+		}
 	}
+	Combo.Trajectories.Empty();
 
-	for (const FString& ShotPkg : CreatedShotSequencePaths)
+	// ── Delete camera actors created during export ─────────────────────────────
+	for (const TWeakObjectPtr<AActor>& Cam : Combo.Cameras)
 	{
-		ForceDeleteAsset(ShotPkg);
+		if (Cam.IsValid() && World) World->EditorDestroyActor(Cam.Get(), true);
 	}
-	CreatedShotSequencePaths.Empty();
+	Combo.Cameras.Empty();
 
-	// ── Delete master sequence non-interactively ─────────────────────────────
-	// We bypass LevelSeqSys->DeleteLevelSequence() here because it internally
-	// calls ObjectTools::DeleteAssets which can show confirmation dialogs and is
-	// unsafe to call from within the MRQ OnExecutorFinished callback chain.
-	// Instead we ForceDeleteAsset the master directly and reset the subsystem.
-	if (LevelSeqSys)
+	// ── Release shot, master and reference sequences ──────────────────────────
+	// Transient sequences are only unhooked for GC.  Kept ones
+	// (bKeepExportedLevelSequence) stay on disk as the user asked.
+	if (Combo.bTransientSequences)
 	{
-		const FString MasterPkgName = LevelSeqSys->GetSequencePackageName();
-		if (!MasterPkgName.IsEmpty())
+		// Master first so the shots lose their last hard reference.
+		if (Combo.MasterSequence.IsValid())
+		{
+			ReleaseTransientSequence(Combo.MasterSequence->GetOutermost()->GetName());
+		}
+
+		for (const FString& ShotPkg : Combo.ShotSequencePaths)
+		{
+			ReleaseTransientSequence(ShotPkg);
+		}
+
+		if (Combo.RefSequence.IsValid())
 		{
-			ForceDeleteAsset(MasterPkgName);
+			ReleaseTransientSequence(Combo.RefSequence->GetOutermost()->GetName());
 		}
-		// Tell the subsystem its sequence is gone so InitLevelSequence() will
-		// create a fresh one for the next combo.
-		LevelSeqSys->ResetActiveSequence();
 	}
+	Combo.ShotSequencePaths.Empty();
+	Combo.MasterSequence.Reset();
+	Combo.RefSequence.Reset();
+
+	// ── Return the character to the pool ─────────────────────────────────────
+	ReleaseCharacter(Combo);
 }
 
-void UCDGBatchProcExecService::DestroySpawnedCharacter(UWorld* World)
+void UCDGBatchProcExecService::AuditLeftovers(UWorld* World)
 {
-	if (SpawnedCharacter.IsValid() && World)
+	// Objects of combos that are still prepared, rendering or awaiting cleanup
+	// are legitimately alive.
+	TSet<const UObject*> LiveObjects;
+	auto AddCombo = [&LiveObjects](const TSharedPtr<FBatchComboWork>& Combo)
 	{
-		World->EditorDestroyActor(SpawnedCharacter.Get(), true);
-	}
-	SpawnedCharacter.Reset();
+		if (!Combo.IsValid()) return;
+		for (const TWeakObjectPtr<ACDGTrajectory>& WeakTraj : Combo->Trajectories)
+		{
+			if (ACDGTrajectory* Traj = WeakTraj.Get())
+			{
+				LiveObjects.Add(Traj);
+				for (ACDGKeyframe* KF : Traj->GetSortedKeyframes()) LiveObjects.Add(KF);
+			}
+		}
+		for (const TWeakObjectPtr<AActor>& Cam : Combo->Cameras) LiveObjects.Add(Cam.Get());
+		LiveObjects.Add(Combo->MasterSequence.Get());
+		LiveObjects.Add(Combo->RefSequence.Get());
+		for (const FString& ShotPkg : Combo->ShotSequencePaths)
+		{
+			const FString ObjectPath = ShotPkg + TEXT(".") + FPackageName::GetShortName(ShotPkg);
+			LiveObjects.Add(FindObject<ULevelSequence>(nullptr, *ObjectPath));
+		}
+	};
+	for (const TSharedPtr<FBatchComboWork>& Combo : ReadyCombos)     AddCombo(Combo);
+	for (const TSharedPtr<FBatchComboWork>& Combo : RenderingCombos) AddCombo(Combo);
+	for (const TSharedPtr<FBatchComboWork>& Combo : CleanupQueue)    AddCombo(Combo);
+
+	// Asset sequences are left alone when the user asked to keep them.
+	const bool bKeepsAssets = Input.ExporterConfig.IsValid() && Input.ExporterConfig->bKeepExportedLevelSequence;
+	MemoryGuard.AuditWorld(World, LiveObjects, !bKeepsAssets);
 }
 
 void UCDGBatchProcExecService::DestroyGenerators()
@@ -1350,52 +1906,146 @@ void UCDGBatchProcExecService::DestroyGenerators()
 	EffectsGenerators.Empty();
 }
 
-void UCDGBatchProcExecService::DeleteReferenceSequence()
-{
-	if (CurrentRefSequence.IsValid())
-	{
-		const FString PkgName = CurrentRefSequence->GetOutermost()->GetName();
-		CurrentRefSequence.Reset();
-		ForceDeleteAsset(PkgName);
-	}
-}
-
 // ─────────────────────────────────────────────────────────────────────────────
 // Index advancing
 // ─────────────────────────────────────────────────────────────────────────────
 
 bool UCDGBatchProcExecService::AdvanceComboIndices()
 {
-	// Advance innermost (Anim) first
+	if (!Sampler.IsExhaustive())
+	{
+		if (++LevelSampleIdx >= LevelSamples.Num()) return false;
+		CurrentAnchorIdx    = LevelSamples[LevelSampleIdx].X;
+		CurrentCharacterIdx = LevelSamples[LevelSampleIdx].Y;
+		CurrentAnimIdx      = LevelSamples[LevelSampleIdx].Z;
+		return true;
+	}
+
+	// Advance innermost (Anchor) first: anchors are already in the loaded
+	// level, so the character and animation only change every N anchors.
+	++CurrentAnchorIdx;
+	if (CurrentAnchorIdx < CurrentAnchors.Num()) return true;
+
+	CurrentAnchorIdx = 0;
 	++CurrentAnimIdx;
 	if (CurrentAnimIdx < Input.Animations.Num()) return true;
 
 	CurrentAnimIdx = 0;
 	++CurrentCharacterIdx;
-	if (CurrentCharacterIdx < Input.Characters.Num()) return true;
-
-	CurrentCharacterIdx = 0;
-	++CurrentAnchorIdx;
-	// Returns false when anchor index is exhausted (caller should move to next level)
-	return CurrentAnchorIdx < CurrentAnchors.Num();
+	// Returns false when character index is exhausted (caller should move to next level)
+	return CurrentCharacterIdx < Input.Characters.Num();
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Helpers
+// Prefetch
 // ─────────────────────────────────────────────────────────────────────────────
 
-FString UCDGBatchProcExecService::MakeComboKey(
-	const FString& LevelShortName,
-	const FString& AnchorName,
-	const FString& CharShortName,
-	const FString& AnimShortName) const
+void UCDGBatchProcExecService::PutLoadedLevelFirst()
+{
+	UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	if (!World) return;
+
+	const FName LoadedPackage = World->GetOutermost()->GetFName();
+	const int32 Idx = Input.Levels.IndexOfByPredicate([LoadedPackage](const FAssetData& Level)
+	{
+		return Level.PackageName == LoadedPackage;
+	});
+
+	if (Idx > 0)
+	{
+		const FAssetData Loaded = Input.Levels[Idx];
+		Input.Levels.RemoveAt(Idx);
+		Input.Levels.Insert(Loaded, 0);
+		BroadcastLog(FString::Printf(TEXT("%s is already open — processing it first"),
+			*FPackageName::GetShortName(LoadedPackage)));
+	}
+}
+
+void UCDGBatchProcExecService::PrefetchNextLevel()
+{
+	LevelPrefetchHandle.Reset();
+
+	const int32 NextIdx = CurrentLevelIdx + 1;
+	if (!Input.Levels.IsValidIndex(NextIdx)) return;
+
+	// Only the direct hard dependencies are listed; their own dependencies
+	// come along with the async load.  The map package itself is left to
+	// LoadMap, which has to create the editor world anyway.
+	IAssetRegistry& AR = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FName> Dependencies;
+	AR.GetDependencies(Input.Levels[NextIdx].PackageName, Dependencies,
+		UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+	TArray<FSoftObjectPath> Paths;
+	for (const FName& Dependency : Dependencies)
+	{
+		if (Dependency.ToString().StartsWith(TEXT("/Script/"))) continue;
+
+		TArray<FAssetData> Assets;
+		AR.GetAssetsByPackageName(Dependency, Assets);
+		for (const FAssetData& Asset : Assets)
+		{
+			if (!Asset.IsAssetLoaded()) Paths.Add(Asset.GetSoftObjectPath());
+		}
+	}
+
+	if (Paths.IsEmpty()) return;
+
+	LevelPrefetchHandle = Streamable.RequestAsyncLoad(Paths, FStreamableDelegate(),
+		FStreamableManager::DefaultAsyncLoadPriority);
+	BroadcastLog(FString::Printf(TEXT("  Prefetching %d asset(s) for %s"),
+		Paths.Num(), *FPackageName::GetShortName(Input.Levels[NextIdx].PackageName)));
+}
+
+void UCDGBatchProcExecService::PrefetchUpcomingAssets()
 {
-	return LevelShortName
-		+ TEXT("_") + AnchorName
-		+ TEXT("_") + CharShortName
-		+ TEXT("_") + AnimShortName;
+	const FIntPoint Pair(CurrentCharacterIdx, CurrentAnimIdx);
+	if (Pair == PrefetchedPair) return;
+	PrefetchedPair = Pair;
+
+	// The pair after this one; wraps to the first pair of the next level.
+	int32 NextChar = CurrentCharacterIdx;
+	int32 NextAnim = CurrentAnimIdx + 1;
+	if (NextAnim >= Input.Animations.Num())
+	{
+		NextAnim = 0;
+		NextChar = (NextChar + 1) % FMath::Max(1, Input.Characters.Num());
+	}
+
+	// Sampled runs skip pairs: take the next pair actually selected.
+	if (!Sampler.IsExhaustive())
+	{
+		for (int32 i = LevelSampleIdx + 1; i < LevelSamples.Num(); ++i)
+		{
+			if (FIntPoint(LevelSamples[i].Y, LevelSamples[i].Z) != Pair)
+			{
+				NextChar = LevelSamples[i].Y;
+				NextAnim = LevelSamples[i].Z;
+				break;
+			}
+		}
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	auto AddPath = [&Paths](const TArray<FAssetData>& Assets, int32 Idx)
+	{
+		if (Assets.IsValidIndex(Idx)) Paths.AddUnique(Assets[Idx].GetSoftObjectPath());
+	};
+	AddPath(Input.Characters, CurrentCharacterIdx);
+	AddPath(Input.Animations, CurrentAnimIdx);
+	AddPath(Input.Characters, NextChar);
+	AddPath(Input.Animations, NextAnim);
+
+	// Request the new set before dropping the old handle so assets shared by
+	// both are never released in between.
+	AssetPrefetchHandle = Streamable.RequestAsyncLoad(Paths, FStreamableDelegate(),
+		FStreamableManager::AsyncLoadHighPriority);
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+// Helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
 FVector UCDGBatchProcExecService::FindGroundPosition(
 	UWorld* World,
 	const FVector& Centre,
@@ -1439,6 +2089,12 @@ TArray<ACDGLevelSceneAnchor*> UCDGBatchProcExecService::GetAnchors(UWorld* World
 
 int32 UCDGBatchProcExecService::ComputeTotalCombos() const
 {
+	// Sampled runs: the budget (levels with fewer combos than their share give less).
+	if (!Sampler.IsExhaustive())
+	{
+		return static_cast<int32>(FMath::Min<int64>(Sampler.GetTotalBudget(), MAX_int32));
+	}
+
 	// We can't know anchor count until levels are loaded, so this is an estimate.
 	// We refine dynamically; this just provides an early total-guess for the progress bar.
 	// Use 1 anchor per level as a minimum estimate.
@@ -1447,22 +2103,89 @@ int32 UCDGBatchProcExecService::ComputeTotalCombos() const
 	       FMath::Max(1, Input.Animations.Num());
 }
 
+FString UCDGBatchProcExecService::ResolveRootOutputDir(const FBatchProcInput& InInput)
+{
+	return InInput.ExporterConfig.IsValid() && !InInput.ExporterConfig->OutputDirectory.IsEmpty()
+		? InInput.ExporterConfig->OutputDirectory
+		: FPaths::ProjectSavedDir() / TEXT("BatchProcOutput");
+}
+
+FString UCDGBatchProcExecService::GetRootOutputDir() const
+{
+	return ResolveRootOutputDir(Input);
+}
+
+void UCDGBatchProcExecService::Beat(const TCHAR* Stage, const FString& Subject)
+{
+	const FDateTime Now = FDateTime::UtcNow();
+	if (Heartbeat.Stage == Stage && Heartbeat.Subject == Subject
+		&& (Now - Heartbeat.Utc).GetTotalSeconds() < HeartbeatInterval)
+	{
+		return;
+	}
+
+	Heartbeat.Pid       = FPlatformProcess::GetCurrentProcessId();
+	Heartbeat.Utc       = Now;
+	Heartbeat.Stage     = Stage;
+	Heartbeat.Subject   = Subject;
+	Heartbeat.Completed = CompletedCombos;
+	Heartbeat.Total     = TotalCombos;
+	Heartbeat.Write(GetRootOutputDir());
+}
+
+void UCDGBatchProcExecService::BeatRenderState()
+{
+	if (OnScreenCombo.IsValid())
+	{
+		Beat(TEXT("Rendering"), OnScreenCombo->ComboKey);
+	}
+	else
+	{
+		Beat(TEXT("Idle"), FString());
+	}
+}
+
+int32 UCDGBatchProcExecService::MakeComboSeed(const FString& ComboKey) const
+{
+	if (const int32* Pinned = Input.PinnedComboSeeds.Find(ComboKey))
+	{
+		return *Pinned;
+	}
+	return ComputeComboSeed(ComboKey, Input.BaseSeed);
+}
+
+int32 UCDGBatchProcExecService::ComputeComboSeed(const FString& ComboKey, int32 BaseSeed)
+{
+	// StrCrc32 is stable across runs and platforms (unlike GetTypeHash on FString).
+	return static_cast<int32>(HashCombine(FCrc::StrCrc32(*ComboKey), static_cast<uint32>(BaseSeed)));
+}
+
 void UCDGBatchProcExecService::BroadcastLog(const FString& Msg)
 {
 	UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[BatchExec] %s"), *Msg);
+	LogBuffer.Append(Msg);
 	OnLogMessage.Broadcast(Msg);
 }
 
-void UCDGBatchProcExecService::BroadcastDetailedProgress(int32 ShotCurrent, int32 ShotTotal)
+FBatchDetailedProgress UCDGBatchProcExecService::GetProgressSnapshot() const
+{
+	FBatchDetailedProgress Snapshot = LatestProgress;
+	Snapshot.ComboCurrent = CompletedCombos;
+	Snapshot.ComboTotal   = TotalCombos;
+	return Snapshot;
+}
+
+void UCDGBatchProcExecService::BroadcastDetailedProgress(const FBatchComboWork& Combo, int32 ShotCurrent, int32 ShotTotal)
 {
+	// Reports the combo being rendered, not the loop indices (which run ahead).
 	FBatchDetailedProgress D;
 	D.LevelCurrent        = CurrentLevelIdx + 1;
 	D.LevelTotal          = Input.Levels.Num();
-	D.AnchorCurrent       = CurrentAnchorIdx + 1;
+	D.AnchorCurrent       = Combo.AnchorIdx + 1;
 	D.AnchorTotal         = CurrentAnchors.Num();
-	D.CharacterCurrent    = CurrentCharacterIdx + 1;
+	D.CharacterCurrent    = Combo.CharacterIdx + 1;
 	D.CharacterTotal      = Input.Characters.Num();
-	D.AnimCurrent         = CurrentAnimIdx + 1;
+	D.AnimCurrent         = Combo.AnimIdx + 1;
 	D.AnimTotal           = Input.Animations.Num();
 	D.ShotCurrent         = ShotCurrent;
 	D.ShotTotal           = ShotTotal;
@@ -1470,6 +2193,7 @@ void UCDGBatchProcExecService::BroadcastDetailedProgress(int32 ShotCurrent, int3
 	D.ComboTotal          = TotalCombos;
 	D.GlobalShotsRendered = TotalShotsRendered;
 	D.GlobalShotsTotal    = TotalShotsKnown;
+	LatestProgress = D;
 	OnDetailedProgressUpdated.Broadcast(D);
 }
 
@@ -1477,14 +2201,62 @@ void UCDGBatchProcExecService::Finish(bool bSuccess)
 {
 	bIsRunning = false;
 
-	FNotificationInfo Info(bSuccess
-		? LOCTEXT("BatchDoneNotif",     "Batch processing completed successfully.")
-		: LOCTEXT("BatchCancelNotif",   "Batch processing was cancelled or failed."));
-	Info.ExpireDuration       = 5.f;
-	Info.bUseSuccessFailIcons = true;
-	FSlateNotificationManager::Get().AddNotification(Info);
+	if (FSlateApplication::IsInitialized())
+	{
+		FNotificationInfo Info(bSuccess
+			? LOCTEXT("BatchDoneNotif",     "Batch processing completed successfully.")
+			: LOCTEXT("BatchCancelNotif",   "Batch processing was cancelled or failed."));
+		Info.ExpireDuration       = 5.f;
+		Info.bUseSuccessFailIcons = true;
+		FSlateNotificationManager::Get().AddNotification(Info);
+	}
+
+	if (SkippedCombos > 0)
+	{
+		BroadcastLog(FString::Printf(TEXT("%d combo(s) skipped from checkpoint."), SkippedCombos));
+	}
+
+	BroadcastLog(FString::Printf(
+		TEXT("Pipeline: render slot idle %.1f s over %d gap(s) (max %.1f s); level loads %.1f s; "
+		     "blocking asset loads %.1f s (%d prefetch hit(s), %d miss(es)); %d character actor reuse(s)"),
+		Stats.TotalGapSeconds, Stats.NumRenderGaps, Stats.MaxGapSeconds, Stats.LevelLoadSeconds,
+		Stats.AssetLoadSeconds, Stats.PrefetchHits, Stats.PrefetchMisses, Stats.CharacterReuses));
+
+	// Barrier for kept sequences still being written
+	if (SaveQueue.GetNumPending() > 0 || (Input.ExporterConfig.IsValid() && Input.ExporterConfig->bKeepExportedLevelSequence))
+	{
+		SaveQueue.Flush();
+		BroadcastLog(TEXT("Sequence saves: ") + SaveQueue.Summary());
+	}
+	RecordSavedCombos();
+
+	// Per-stage timing summary
+	Telemetry.Flush();
+	BroadcastLog(FString::Printf(TEXT("Stage timings (%s):"), *Telemetry.GetCsvPath()));
+	for (const FString& Line : Telemetry.Summary())
+	{
+		BroadcastLog(TEXT("  ") + Line);
+	}
+
+	// Nothing may stay pinned once the batch is over.
+	LevelPrefetchHandle.Reset();
+	AssetPrefetchHandle.Reset();
+	PrefetchedPair = FIntPoint(INDEX_NONE, INDEX_NONE);
 
+	// Final collection, leak audit and memory summary
+	MemoryGuard.Collect();
+	AuditLeftovers(GEditor ? GEditor->GetEditorWorldContext().World() : nullptr);
+	for (const FString& Line : MemoryGuard.Summary())
+	{
+		BroadcastLog(Line);
+	}
 	BroadcastLog(bSuccess ? TEXT("Batch complete.") : TEXT("Batch stopped."));
+	Beat(TEXT("Finished"), FString());
+	if (!LogBuffer.GetFilePath().IsEmpty())
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[BatchExec] Full log: %s"), *LogBuffer.GetFilePath());
+	}
+	LogBuffer.End();
 	OnBatchCompleted.Broadcast(bSuccess);
 }
 
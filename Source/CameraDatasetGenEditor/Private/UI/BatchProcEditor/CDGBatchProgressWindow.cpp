@@ -12,6 +12,7 @@
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Notifications/SProgressBar.h"
+#include "Widgets/Views/STableRow.h"
 
 #define LOCTEXT_NAMESPACE "CDGBatchProgressWindow"
 
@@ -34,6 +35,8 @@ static FText DimText(int32 Cur, int32 Tot)
 void SBatchProgressWindow::Construct(const FArguments& InArgs)
 {
 	OnCancelRequested = InArgs._OnCancelRequested;
+	Service           = InArgs._Service;
+	NextLogSeq        = Service.IsValid() ? Service->GetLogBuffer().GetNextSeq() : 0;
 
 	// Shared small-font style
 	const FSlateFontInfo SmallFont     = FAppStyle::GetFontStyle("SmallFont");
@@ -206,23 +209,36 @@ void SBatchProgressWindow::Construct(const FArguments& InArgs)
 				]
 			]
 
-			// ── Row 3: last log line ─────────────────────────────────────────
+			// ── Row 3: log ───────────────────────────────────────────────────
 			+ SVerticalBox::Slot()
-			.AutoHeight()
+			.FillHeight(1.f)
 			[
-				SNew(STextBlock)
-				.Text_Lambda([this]()
-				{
-					return Log.IsEmpty()
-						? FText::GetEmpty()
-						: FText::FromString(Log.Last());
-				})
-				.Font(FAppStyle::GetFontStyle("SmallFont"))
-				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
-				.AutoWrapText(true)
+				SNew(SBorder)
+				.BorderImage(FAppStyle::GetBrush("ToolPanel.DarkGroupBorder"))
+				.Padding(4.f)
+				[
+					SAssignNew(LogListView, SListView<TSharedPtr<FString>>)
+					.ListItemsSource(&LogRows)
+					.OnGenerateRow(this, &SBatchProgressWindow::MakeLogRow)
+					.SelectionMode(ESelectionMode::None)
+				]
 			]
 		]
 	];
+
+	RegisterActiveTimer(1.f / PollRate,
+		FWidgetActiveTimerDelegate::CreateSP(this, &SBatchProgressWindow::Poll));
+}
+
+TSharedRef<ITableRow> SBatchProgressWindow::MakeLogRow(TSharedPtr<FString> Line, const TSharedRef<STableViewBase>& Owner)
+{
+	return SNew(STableRow<TSharedPtr<FString>>, Owner)
+	[
+		SNew(STextBlock)
+		.Text(FText::FromString(*Line))
+		.Font(FAppStyle::GetFontStyle("SmallFont"))
+		.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+	];
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -257,25 +273,63 @@ FText SBatchProgressWindow::MakeShotPercentText() const
 // State update
 // ─────────────────────────────────────────────────────────────────────────────
 
-void SBatchProgressWindow::UpdateDetailedProgress(const FBatchDetailedProgress& InProgress)
+EActiveTimerReturnType SBatchProgressWindow::Poll(double /*InCurrentTime*/, float /*InDeltaTime*/)
 {
-	Detail = InProgress;
+	const UCDGBatchProcExecService* Batch = Service.Get();
+	if (!Batch)
+	{
+		return EActiveTimerReturnType::Stop;
+	}
+
+	if (!bDone)
+	{
+		Detail = Batch->GetProgressSnapshot();
+	}
+
+	TArray<FString> Lines;
+	int32 Missed = 0;
+	NextLogSeq = Batch->GetLogBuffer().ReadSince(NextLogSeq, Lines, Missed);
+	if (Missed > 0)
+	{
+		Lines.Insert(FString::Printf(TEXT("… %d line(s) not shown — full log in %s"),
+			Missed, *Batch->GetLogBuffer().GetFilePath()), 0);
+	}
+	AppendLogRows(MoveTemp(Lines));
+
+	return bDone ? EActiveTimerReturnType::Stop : EActiveTimerReturnType::Continue;
 }
 
-void SBatchProgressWindow::UpdateProgress(int32 Completed, int32 Total)
+void SBatchProgressWindow::AppendLogRows(TArray<FString>&& Lines)
 {
-	Detail.ComboCurrent = Completed;
-	Detail.ComboTotal   = Total;
+	if (Lines.IsEmpty()) return;
+
+	for (FString& Line : Lines)
+	{
+		LogRows.Add(MakeShared<FString>(MoveTemp(Line)));
+	}
+
+	// Trim in chunks so the front of the array isn't shifted on every refresh.
+	if (LogRows.Num() > MaxLogRows + MaxLogRows / 4)
+	{
+		LogRows.RemoveAt(0, LogRows.Num() - MaxLogRows);
+	}
+
+	if (LogListView.IsValid())
+	{
+		LogListView->RequestListRefresh();
+		LogListView->ScrollToBottom();
+	}
 }
 
 void SBatchProgressWindow::AddLog(const FString& Msg)
 {
-	Log.Add(Msg);
-	if (Log.Num() > 200) Log.RemoveAt(0, Log.Num() - 200);
+	AppendLogRows({ Msg });
 }
 
 void SBatchProgressWindow::MarkCompleted(bool bSuccess)
 {
+	// Pick up the final lines and counters before the timer stops.
+	Poll(0.0, 0.f);
 	bDone = true;
 	Detail.ComboCurrent = Detail.ComboTotal;
 	if (Detail.ShotTotal > 0)         Detail.ShotCurrent      = Detail.ShotTotal;
@@ -299,7 +353,7 @@ TSharedPtr<SWindow> SBatchProgressWindow::OpenWindow(TSharedPtr<SWindow> ParentW
 
 	TSharedRef<SWindow> NewWindow = SNew(SWindow)
 		.Title(LOCTEXT("WindowTitle", "Batch Processing Progress"))
-		.ClientSize(FVector2D(620.f, 110.f))
+		.ClientSize(FVector2D(680.f, 320.f))
 		.SizingRule(ESizingRule::FixedSize)
 		.SupportsMaximize(false)
 		.SupportsMinimize(false)
@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchSaveQueue.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+static constexpr double kBytesPerMB = 1024.0 * 1024.0;
+
+void FCDGBatchSaveQueue::Emit(const FString& Message) const
+{
+	if (Log) Log(Message);
+	else UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("[BatchExec] %s"), *Message);
+}
+
+void FCDGBatchSaveQueue::Begin(TFunction<void(const FString&)> InLog, int32 InMaxPending)
+{
+	Flush();
+
+	Log              = MoveTemp(InLog);
+	MaxPending       = InMaxPending > 0 ? InMaxPending : DefaultMaxPending;
+	NumSaved         = 0;
+	NumFailed        = 0;
+	BytesSaved       = 0;
+	SerializeSeconds = 0.0;
+	WaitSeconds      = 0.0;
+}
+
+bool FCDGBatchSaveQueue::Save(UObject* Asset)
+{
+	if (!Asset) return false;
+
+	if (GetNumPending() >= MaxPending)
+	{
+		Flush();
+	}
+
+	UPackage* Package = Asset->GetOutermost();
+	const FString Filename = FPackageName::LongPackageNameToFilename(
+		Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags     = SAVE_Async | SAVE_NoError;
+	SaveArgs.bSlowTask     = false;
+
+	const double Start = FPlatformTime::Seconds();
+	const FSavePackageResultStruct Result = UPackage::Save(Package, Asset, *Filename, SaveArgs);
+	SerializeSeconds += FPlatformTime::Seconds() - Start;
+
+	if (Result.Result != ESavePackageResult::Success)
+	{
+		++NumFailed;
+		Emit(FString::Printf(TEXT("  WARNING: Could not save %s"), *Package->GetName()));
+		return false;
+	}
+
+	++LastTicket;
+	++NumSaved;
+	BytesSaved += Result.TotalFileSize;
+	return true;
+}
+
+namespace
+{
+	void AdvanceWrittenTicket(std::atomic<int64>& WrittenTicket, int64 Ticket)
+	{
+		int64 Current = WrittenTicket.load();
+		while (Current < Ticket && !WrittenTicket.compare_exchange_weak(Current, Ticket))
+		{
+		}
+	}
+}
+
+void FCDGBatchSaveQueue::Flush()
+{
+	if (GetNumPending() == 0) return;
+
+	const double Start = FPlatformTime::Seconds();
+	UPackage::WaitForAsyncFileWrites();
+	WaitSeconds += FPlatformTime::Seconds() - Start;
+	AdvanceWrittenTicket(Fence->WrittenTicket, LastTicket);
+}
+
+void FCDGBatchSaveQueue::FenceAsync()
+{
+	if (IsWritten(LastTicket) || Fence->bRunning.exchange(true)) return;
+
+	// The engine only offers a wait for all outstanding writes.  Once it
+	// returns, every write queued before this call is on disk.
+	Async(EAsyncExecution::ThreadPool, [Fence = Fence, Ticket = LastTicket]()
+	{
+		UPackage::WaitForAsyncFileWrites();
+		AdvanceWrittenTicket(Fence->WrittenTicket, Ticket);
+		Fence->bRunning = false;
+	});
+}
+
+FString FCDGBatchSaveQueue::Summary() const
+{
+	return FString::Printf(TEXT("%d package(s), %.1f MB: %.1f s serializing, %.1f s waiting on writes (%d failed)"),
+		NumSaved, BytesSaved / kBytesPerMB, SerializeSeconds, WaitSeconds, NumFailed);
+}
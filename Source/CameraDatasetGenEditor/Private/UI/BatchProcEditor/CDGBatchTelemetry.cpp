@@ -0,0 +1,158 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/BatchProcEditor/CDGBatchTelemetry.h"
+#include "LogCameraDatasetGenEditor.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace
+{
+	/** Nearest-rank percentile of an already sorted array. */
+	double Percentile(const TArray<double>& Sorted, double P)
+	{
+		if (Sorted.IsEmpty()) return 0.0;
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Rank];
+	}
+
+	/** Quote a CSV field if it contains a separator, quote or newline. */
+	FString CsvField(const FString& In)
+	{
+		if (!In.Contains(TEXT(",")) && !In.Contains(TEXT("\"")) && !In.Contains(TEXT("\n")))
+		{
+			return In;
+		}
+		return TEXT("\"") + In.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchTelemetry
+// ─────────────────────────────────────────────────────────────────────────────
+
+const TCHAR* FCDGBatchTelemetry::StageName(ECDGBatchStage Stage)
+{
+	switch (Stage)
+	{
+	case ECDGBatchStage::LevelLoad:            return TEXT("LevelLoad");
+	case ECDGBatchStage::AnchorDiscovery:      return TEXT("AnchorDiscovery");
+	case ECDGBatchStage::CharacterSpawn:       return TEXT("CharacterSpawn");
+	case ECDGBatchStage::RefSequence:          return TEXT("RefSequence");
+	case ECDGBatchStage::GeneratorInstantiate: return TEXT("GeneratorInstantiate");
+	case ECDGBatchStage::GeneratorRun:         return TEXT("GeneratorRun");
+	case ECDGBatchStage::SequenceExport:       return TEXT("SequenceExport");
+	case ECDGBatchStage::RenderSetup:          return TEXT("RenderSetup");
+	case ECDGBatchStage::Render:               return TEXT("Render");
+	case ECDGBatchStage::IndexWrite:           return TEXT("IndexWrite");
+	case ECDGBatchStage::Cleanup:              return TEXT("Cleanup");
+	default:                                   return TEXT("Unknown");
+	}
+}
+
+void FCDGBatchTelemetry::Begin(const FString& OutputDir)
+{
+	for (TArray<double>& StageSamples : Samples)
+	{
+		StageSamples.Reset();
+	}
+	PendingRows.Reset();
+
+	UtcAtBegin     = FDateTime::UtcNow();
+	SecondsAtBegin = FPlatformTime::Seconds();
+
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*OutputDir);
+	CsvPath = FPaths::Combine(OutputDir,
+		FString::Printf(TEXT("CDGBatchTiming_%s.csv"), *UtcAtBegin.ToString(TEXT("%Y%m%d_%H%M%S"))));
+
+	if (!FFileHelper::SaveStringToFile(FString(TEXT("ComboKey,Stage,Detail,Seconds,StartUtc\n")), *CsvPath,
+			FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogCameraDatasetGenEditor, Warning, TEXT("[BatchTiming] Cannot write %s — timings are logged only"), *CsvPath);
+		CsvPath.Reset();
+	}
+}
+
+void FCDGBatchTelemetry::Record(const FString& ComboKey, ECDGBatchStage Stage, double StartSeconds, double Seconds,
+                                const FString& Detail)
+{
+	Samples[static_cast<int32>(Stage)].Add(Seconds);
+
+	const FDateTime StartUtc = UtcAtBegin + FTimespan::FromSeconds(StartSeconds - SecondsAtBegin);
+	PendingRows += FString::Printf(TEXT("%s,%s,%s,%.6f,%s\n"),
+		*CsvField(ComboKey), StageName(Stage), *CsvField(Detail), Seconds, *StartUtc.ToIso8601());
+}
+
+void FCDGBatchTelemetry::Flush()
+{
+	if (PendingRows.IsEmpty() || CsvPath.IsEmpty()) return;
+
+	FFileHelper::SaveStringToFile(PendingRows, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM,
+		&IFileManager::Get(), FILEWRITE_Append);
+	PendingRows.Reset();
+}
+
+TArray<FString> FCDGBatchTelemetry::Summary() const
+{
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("%-22s %6s %10s %9s %9s %9s %9s %9s"),
+		TEXT("Stage"), TEXT("Count"), TEXT("Total s"), TEXT("Mean"), TEXT("p50"), TEXT("p90"), TEXT("p99"), TEXT("Max")));
+
+	for (int32 i = 0; i < static_cast<int32>(ECDGBatchStage::Num); ++i)
+	{
+		if (Samples[i].IsEmpty()) continue;
+
+		TArray<double> Sorted = Samples[i];
+		Sorted.Sort();
+
+		double Total = 0.0;
+		for (double S : Sorted) Total += S;
+
+		Lines.Add(FString::Printf(TEXT("%-22s %6d %10.2f %9.3f %9.3f %9.3f %9.3f %9.3f"),
+			StageName(static_cast<ECDGBatchStage>(i)), Sorted.Num(), Total, Total / Sorted.Num(),
+			Percentile(Sorted, 0.50), Percentile(Sorted, 0.90), Percentile(Sorted, 0.99), Sorted.Last()));
+	}
+	return Lines;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchStageScope
+// ─────────────────────────────────────────────────────────────────────────────
+
+FCDGBatchStageScope::FCDGBatchStageScope(FCDGBatchTelemetry& InTelemetry, const FString& InComboKey,
+                                         ECDGBatchStage InStage, const FString& InDetail)
+	: Telemetry(InTelemetry)
+	, ComboKey(InComboKey)
+	, Detail(InDetail)
+	, Stage(InStage)
+	, StartSeconds(FPlatformTime::Seconds())
+{
+#if CPUPROFILERTRACE_ENABLED
+	if (UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel))
+	{
+		FCpuProfilerTrace::OutputBeginDynamicEvent(
+			*FString::Printf(TEXT("CDGBatch.%s"), FCDGBatchTelemetry::StageName(Stage)));
+		bTraceEvent = true;
+	}
+#endif
+}
+
+FCDGBatchStageScope::~FCDGBatchStageScope()
+{
+#if CPUPROFILERTRACE_ENABLED
+	if (bTraceEvent)
+	{
+		FCpuProfilerTrace::OutputEndEvent();
+	}
+#endif
+	Telemetry.Record(ComboKey, Stage, StartSeconds, FPlatformTime::Seconds() - StartSeconds, Detail);
+}
@@ -6,6 +6,7 @@
 #include "Trajectory/CDGKeyframe.h"
 #include "Anchor/CDGCharacterAnchor.h"
 #include "LevelSequenceInterface/CDGLevelSeqSubsystem.h"
+#include "LevelSequenceInterface/CDGSequenceBuilder.h"
 #include "MRQInterface/CDGMRQInterface.h"
 #include "IO/TrajectorySL.h"
 #include "LogCameraDatasetGenEditor.h"
@@ -933,6 +934,52 @@ bool SLevelSeqExporterWindow::DoesFormatRequireFFmpeg() const
 // CopyBaseShotNonCameraTracks (unchanged logic)
 // ---------------------------------------------------------------------------
 
+ULevelSequence* SLevelSeqExporterWindow::CreateBaseShotContentSequence(const FString& PackageName) const
+{
+    if (!BaseShotSequence.IsValid()) return nullptr;
+    UMovieScene* SourceShotMovieScene = BaseShotSequence->GetMovieScene();
+    if (!SourceShotMovieScene) return nullptr;
+
+    const FString AssetName = FPackageName::GetShortName(PackageName);
+    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+    FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(FSoftObjectPath(PackageName + TEXT(".") + AssetName));
+    ULevelSequence* ContentSequence = AssetData.IsValid() ? Cast<ULevelSequence>(AssetData.GetAsset()) : nullptr;
+
+    if (!ContentSequence)
+    {
+        UPackage* Package = CreatePackage(*PackageName);
+        if (!Package) return nullptr;
+        ContentSequence = NewObject<ULevelSequence>(Package, *AssetName, RF_Public | RF_Standalone | RF_Transactional);
+        if (!ContentSequence) return nullptr;
+        ContentSequence->Initialize();
+        FAssetRegistryModule::AssetCreated(ContentSequence);
+    }
+
+    UMovieScene* ContentMovieScene = ContentSequence->GetMovieScene();
+    if (!ContentMovieScene) return nullptr;
+
+    ContentSequence->Modify();
+    ContentMovieScene->Modify();
+    {
+        TArray<UMovieSceneTrack*> ExistingTracks = ContentMovieScene->GetTracks();
+        for (UMovieSceneTrack* Track : ExistingTracks) ContentMovieScene->RemoveTrack(*Track);
+        for (int32 i = ContentMovieScene->GetSpawnableCount() - 1; i >= 0; --i)
+            ContentMovieScene->RemoveSpawnable(ContentMovieScene->GetSpawnable(i).GetGuid());
+        for (int32 i = ContentMovieScene->GetPossessableCount() - 1; i >= 0; --i)
+            ContentMovieScene->RemovePossessable(ContentMovieScene->GetPossessable(i).GetGuid());
+    }
+
+    // Same timebase as the base shot, so its tracks copy across unchanged and
+    // the shots' subsequence sections map time correctly.
+    ContentMovieScene->SetDisplayRate(SourceShotMovieScene->GetDisplayRate());
+    ContentMovieScene->SetTickResolutionDirectly(SourceShotMovieScene->GetTickResolution());
+    ContentMovieScene->SetPlaybackRange(SourceShotMovieScene->GetPlaybackRange());
+
+    CopyBaseShotNonCameraTracks(ContentMovieScene);
+    ContentSequence->MarkPackageDirty();
+    return ContentSequence;
+}
+
 bool SLevelSeqExporterWindow::IsCameraBinding(UMovieScene* MovieScene, const FGuid& BindingGuid, const FString& BindingName)
 {
     if (!MovieScene) return false;
@@ -1221,18 +1268,45 @@ ULevelSequence* SLevelSeqExporterWindow::PerformExport()
         }
     }
 
-    IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
     FString MasterPackagePath = FPackageName::GetLongPackagePath(MasterSequence->GetOutermost()->GetName());
 
+    // Snapshot every trajectory (fitted to the base shot when there is one),
+    // then bake all camera keys in parallel before touching any sequence.
+    FCDGShotLayout ShotLayout;
+    ShotLayout.Focus = ECDGShotFocus::BakedDistance;
+    ShotLayout.KeyReduction = FCDGKeyReduction::FromConfig(LoadedConfig.Get());
+    const FCDGSequenceBuilder Builder(ShotLayout, FrameRate, TickResolution);
+
+    const bool bUseBaseShotTiming = BaseShotSequence.IsValid() && BaseShotDurationSeconds > KINDA_SMALL_NUMBER;
+    TArray<int32> ShotDurationsInTicks;
+    TArray<FCDGCameraKeySnapshot> KeySnapshots;
     for (ACDGTrajectory* Trajectory : TrajectoriesToExport)
     {
         const double TrajectoryDuration = Trajectory->GetTrajectoryDuration();
-        const bool bUseBaseShotTiming = BaseShotSequence.IsValid() && BaseShotDurationSeconds > KINDA_SMALL_NUMBER;
         const double OutputShotDuration = bUseBaseShotTiming ? BaseShotDurationSeconds : TrajectoryDuration;
         const double TrajectoryTimeScale = (TrajectoryDuration > KINDA_SMALL_NUMBER) ? (OutputShotDuration / TrajectoryDuration) : 1.0;
-        const int32 DurationInTicks = FMath::Max(1, FMath::RoundToInt(OutputShotDuration * TickResolution));
+        ShotDurationsInTicks.Add(FMath::Max(1, FMath::RoundToInt(OutputShotDuration * TickResolution)));
+        KeySnapshots.Add(Builder.Capture(*Trajectory, TrajectoryTimeScale));
+    }
+    // The base shot's non-camera tracks live once, in a sequence every shot
+    // plays as a subsequence, rather than being copied into each shot.
+    const FString MasterSequenceName = FPackageName::GetShortName(MasterSequence->GetOutermost()->GetName());
+    ULevelSequence* BaseContentSequence = BaseShotSequence.IsValid()
+        ? CreateBaseShotContentSequence(MasterPackagePath / (MasterSequenceName + TEXT("_BaseContent")))
+        : nullptr;
+
+    TArray<FCDGBakedCameraKeys> BakedKeys;
+    const FCDGSequenceBuilder::FBakeStats BakeStats = Builder.BakeAll(KeySnapshots, BakedKeys);
+    if (ShotLayout.KeyReduction.bEnabled)
+    {
+        UE_LOG(LogCameraDatasetGenEditor, Log, TEXT("Key reduction: %s"), *BakeStats.ToString());
+    }
+
+    for (int32 TrajIdx = 0; TrajIdx < TrajectoriesToExport.Num(); ++TrajIdx)
+    {
+        ACDGTrajectory* Trajectory = TrajectoriesToExport[TrajIdx];
+        const int32 DurationInTicks = ShotDurationsInTicks[TrajIdx];
 
-        const FString MasterSequenceName = FPackageName::GetShortName(MasterSequence->GetOutermost()->GetName());
         FString ShotName = FString::Printf(TEXT("%s_Shot_%s"), *MasterSequenceName, *Trajectory->TrajectoryName.ToString());
         FString PackageName = MasterPackagePath / ShotName;
 
@@ -1244,26 +1318,20 @@ ULevelSequence* SLevelSeqExporterWindow::PerformExport()
             ShotSequence = Cast<ULevelSequence>(AssetData.GetAsset());
         }
 
+        // New shots are copies of the builder's shot template: bindings,
+        // tracks and sections are already in place.
+        bool bFromTemplate = false;
         if (!ShotSequence)
         {
-            UFactory* Factory = nullptr;
-            for (TObjectIterator<UClass> It; It; ++It)
+            if (UPackage* ShotPackage = CreatePackage(*PackageName))
             {
-                UClass* CurrentClass = *It;
-                if (CurrentClass->IsChildOf(UFactory::StaticClass()) && !CurrentClass->HasAnyClassFlags(CLASS_Abstract))
+                ShotSequence = Builder.CreateShotSequence(ShotPackage, *ShotName, RF_Public | RF_Standalone | RF_Transactional);
+                if (ShotSequence)
                 {
-                    UFactory* TestFactory = Cast<UFactory>(CurrentClass->GetDefaultObject());
-                    if (TestFactory && TestFactory->CanCreateNew() && TestFactory->SupportedClass == ULevelSequence::StaticClass())
-                    {
-                        Factory = TestFactory;
-                        break;
-                    }
+                    FAssetRegistryModule::AssetCreated(ShotSequence);
+                    bFromTemplate = true;
                 }
             }
-            if (Factory)
-            {
-                ShotSequence = Cast<ULevelSequence>(AssetTools.CreateAsset(ShotName, MasterPackagePath, ULevelSequence::StaticClass(), Factory));
-            }
         }
 
         if (!ShotSequence)
@@ -1281,9 +1349,9 @@ ULevelSequence* SLevelSeqExporterWindow::PerformExport()
 
         ShotSequence->Modify();
         ShotMovieScene->Modify();
-        ShotMovieScene->SetDisplayRate(FrameRate);
-        ShotMovieScene->SetTickResolutionDirectly(FFrameRate(TickResolution, 1));
+        Builder.PrepareMovieScene(*ShotMovieScene);
 
+        if (!bFromTemplate)
         {
             TArray<UMovieSceneTrack*> ExistingTracks = ShotMovieScene->GetTracks();
             for (UMovieSceneTrack* Track : ExistingTracks) ShotMovieScene->RemoveTrack(*Track);
@@ -1293,235 +1361,17 @@ ULevelSequence* SLevelSeqExporterWindow::PerformExport()
                 ShotMovieScene->RemovePossessable(ShotMovieScene->GetPossessable(i).GetGuid());
         }
 
-        CopyBaseShotNonCameraTracks(ShotMovieScene);
-
-        UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
-        if (!World) { UE_LOG(LogTemp, Error, TEXT("No valid world context.")); continue; }
-
-        FString CameraName = FString::Printf(TEXT("Cam_%s"), *Trajectory->TrajectoryName.ToString());
-        ACineCameraActor* CameraActor = nullptr;
-
-        for (TActorIterator<ACineCameraActor> It(World); It; ++It)
-        {
-            if (It->GetActorLabel() == CameraName)
-            {
-                World->EditorDestroyActor(*It, true);
-                break;
-            }
-        }
-
-        FActorSpawnParameters SpawnParams;
-        CameraActor = World->SpawnActor<ACineCameraActor>(ACineCameraActor::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
-        if (CameraActor) CameraActor->SetActorLabel(CameraName);
-        if (!CameraActor) { UE_LOG(LogTemp, Error, TEXT("Failed to spawn camera actor: %s"), *CameraName); continue; }
-
-        FGuid CameraGuid = ShotMovieScene->AddPossessable(CameraActor->GetActorLabel(), CameraActor->GetClass());
-        ShotSequence->BindPossessableObject(CameraGuid, *CameraActor, World);
-
-        UMovieSceneCameraCutTrack* CameraCutTrack = ShotMovieScene->AddTrack<UMovieSceneCameraCutTrack>();
-        if (CameraCutTrack)
+        if (BaseContentSequence)
         {
-            UMovieSceneCameraCutSection* CutSection = Cast<UMovieSceneCameraCutSection>(CameraCutTrack->CreateNewSection());
-            if (CutSection)
-            {
-                CutSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-                CutSection->SetCameraGuid(CameraGuid);
-                CameraCutTrack->AddSection(*CutSection);
-            }
+            FCDGSequenceBuilder::AddSharedSubSequence(*ShotSequence, *BaseContentSequence, DurationInTicks);
         }
 
-        UMovieScene3DTransformTrack* TransformTrack = ShotMovieScene->AddTrack<UMovieScene3DTransformTrack>(CameraGuid);
-        if (TransformTrack)
-        {
-            UMovieScene3DTransformSection* TransformSection = Cast<UMovieScene3DTransformSection>(TransformTrack->CreateNewSection());
-            if (TransformSection)
-            {
-                TransformTrack->AddSection(*TransformSection);
-                TransformSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-
-                FMovieSceneChannelProxy& ChannelProxy = TransformSection->GetChannelProxy();
-                TArrayView<FMovieSceneDoubleChannel*> DoubleChannels = ChannelProxy.GetChannels<FMovieSceneDoubleChannel>();
-
-                if (DoubleChannels.Num() >= 6)
-                {
-                    TArray<ACDGKeyframe*> TrajectoryKeyframes = Trajectory->GetSortedKeyframes();
-                    double CurrentTimeSeconds = 0.0;
-
-                    auto ConvertInterpMode = [](ECDGInterpolationMode Mode, ERichCurveInterpMode& OutInterpMode, ERichCurveTangentMode& OutTangentMode)
-                    {
-                        switch (Mode)
-                        {
-                        case ECDGInterpolationMode::Linear:
-                            OutInterpMode = RCIM_Linear; OutTangentMode = RCTM_Auto; break;
-                        case ECDGInterpolationMode::Constant:
-                            OutInterpMode = RCIM_Constant; OutTangentMode = RCTM_Auto; break;
-                        case ECDGInterpolationMode::Cubic:
-                        case ECDGInterpolationMode::CubicClamped:
-                            OutInterpMode = RCIM_Cubic; OutTangentMode = RCTM_Auto; break;
-                        case ECDGInterpolationMode::CustomTangent:
-                            OutInterpMode = RCIM_Cubic; OutTangentMode = RCTM_User; break;
-                        default:
-                            OutInterpMode = RCIM_Cubic; OutTangentMode = RCTM_Auto; break;
-                        }
-                    };
-
-                    auto AddKeyToChannel = [&](FMovieSceneDoubleChannel* Channel, FFrameNumber Time, double Value, ECDGInterpolationMode Mode)
-                    {
-                        if (!Channel) return;
-                        ERichCurveInterpMode InterpMode; ERichCurveTangentMode TangentMode;
-                        ConvertInterpMode(Mode, InterpMode, TangentMode);
-                        if (InterpMode == RCIM_Constant)       Channel->AddConstantKey(Time, Value);
-                        else if (InterpMode == RCIM_Linear)    Channel->AddLinearKey(Time, Value);
-                        else                                    Channel->AddCubicKey(Time, Value, TangentMode);
-                    };
-
-                    for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-                    {
-                        ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-                        if (!Keyframe) continue;
-
-                        if (k > 0) CurrentTimeSeconds += (Keyframe->TimeToCurrentFrame * TrajectoryTimeScale);
-                        FFrameNumber KeyTime = FFrameNumber(static_cast<int32>(CurrentTimeSeconds * TickResolution));
-
-                        FTransform KeyTransform = Keyframe->GetKeyframeTransform();
-                        FVector Loc = KeyTransform.GetLocation();
-                        FRotator Rot = KeyTransform.GetRotation().Rotator();
-                        const bool bHasStay = Keyframe->TimeAtCurrentFrame > KINDA_SMALL_NUMBER;
-
-                        ECDGInterpolationMode PosMode = bHasStay ? ECDGInterpolationMode::Constant : Keyframe->InterpolationSettings.PositionInterpMode;
-                        ECDGInterpolationMode RotMode = bHasStay ? ECDGInterpolationMode::Constant : Keyframe->InterpolationSettings.RotationInterpMode;
-
-                        AddKeyToChannel(DoubleChannels[0], KeyTime, Loc.X, PosMode);
-                        AddKeyToChannel(DoubleChannels[1], KeyTime, Loc.Y, PosMode);
-                        AddKeyToChannel(DoubleChannels[2], KeyTime, Loc.Z, PosMode);
-                        AddKeyToChannel(DoubleChannels[3], KeyTime, Rot.Roll, RotMode);
-                        AddKeyToChannel(DoubleChannels[4], KeyTime, Rot.Pitch, RotMode);
-                        AddKeyToChannel(DoubleChannels[5], KeyTime, Rot.Yaw, RotMode);
-
-                        if (bHasStay)
-                        {
-                            CurrentTimeSeconds += (Keyframe->TimeAtCurrentFrame * TrajectoryTimeScale);
-                            FFrameNumber EndKeyTime = FFrameNumber(static_cast<int32>(CurrentTimeSeconds * TickResolution));
-                            PosMode = Keyframe->InterpolationSettings.PositionInterpMode;
-                            RotMode = Keyframe->InterpolationSettings.RotationInterpMode;
-                            AddKeyToChannel(DoubleChannels[0], EndKeyTime, Loc.X, PosMode);
-                            AddKeyToChannel(DoubleChannels[1], EndKeyTime, Loc.Y, PosMode);
-                            AddKeyToChannel(DoubleChannels[2], EndKeyTime, Loc.Z, PosMode);
-                            AddKeyToChannel(DoubleChannels[3], EndKeyTime, Rot.Roll, RotMode);
-                            AddKeyToChannel(DoubleChannels[4], EndKeyTime, Rot.Pitch, RotMode);
-                            AddKeyToChannel(DoubleChannels[5], EndKeyTime, Rot.Yaw, RotMode);
-                        }
-                    }
-                }
-            }
-        }
+        UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+        if (!World) { UE_LOG(LogTemp, Error, TEXT("No valid world context.")); continue; }
 
-        UCineCameraComponent* CameraComponent = CameraActor->GetCineCameraComponent();
-        if (CameraComponent)
+        if (!Builder.BuildCameraShot(World, *ShotSequence, KeySnapshots[TrajIdx], BakedKeys[TrajIdx], DurationInTicks).Camera)
         {
-            FGuid ComponentGuid = ShotMovieScene->AddPossessable(CameraComponent->GetName(), CameraComponent->GetClass());
-            FMovieScenePossessable* ChildPossessable = ShotMovieScene->FindPossessable(ComponentGuid);
-            if (ChildPossessable) ChildPossessable->SetParent(CameraGuid, ShotMovieScene);
-            ShotSequence->BindPossessableObject(ComponentGuid, *CameraComponent, CameraActor);
-
-            TArray<ACDGKeyframe*> TrajectoryKeyframes = Trajectory->GetSortedKeyframes();
-            const bool bAnyFocusOverride = TrajectoryKeyframes.ContainsByPredicate([](const ACDGKeyframe* Keyframe)
-            {
-                return Keyframe && (Keyframe->LensSettings.AutofocusTargetActor.Get() != nullptr || Keyframe->LensSettings.bUseManualFocusDistance);
-            });
-            CameraComponent->FocusSettings.FocusMethod = bAnyFocusOverride ? ECameraFocusMethod::Manual : ECameraFocusMethod::Disable;
-
-            auto AddLensKeyWithStay = [&](FMovieSceneFloatChannel& Channel, double& CurTime, const ACDGKeyframe* Keyframe, float Value)
-            {
-                const FFrameNumber KeyTime = FFrameNumber(static_cast<int32>(CurTime * TickResolution));
-                const bool bHasStay = Keyframe->TimeAtCurrentFrame > KINDA_SMALL_NUMBER;
-                if (bHasStay)
-                {
-                    Channel.AddConstantKey(KeyTime, Value);
-                    CurTime += (Keyframe->TimeAtCurrentFrame * TrajectoryTimeScale);
-                    Channel.AddLinearKey(FFrameNumber(static_cast<int32>(CurTime * TickResolution)), Value);
-                }
-                else
-                {
-                    Channel.AddLinearKey(KeyTime, Value);
-                }
-            };
-
-            // Focal length
-            if (UMovieSceneFloatTrack* FocalLengthTrack = ShotMovieScene->AddTrack<UMovieSceneFloatTrack>(ComponentGuid))
-            {
-                FocalLengthTrack->SetPropertyNameAndPath(GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentFocalLength), "CurrentFocalLength");
-                UMovieSceneFloatSection* FocalSection = Cast<UMovieSceneFloatSection>(FocalLengthTrack->CreateNewSection());
-                FocalLengthTrack->AddSection(*FocalSection);
-                FocalSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-                FMovieSceneFloatChannel& FocalChannel = FocalSection->GetChannel();
-                double CurTime = 0.0;
-                for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-                {
-                    const ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-                    if (!Keyframe) continue;
-                    if (k > 0) CurTime += (Keyframe->TimeToCurrentFrame * TrajectoryTimeScale);
-                    AddLensKeyWithStay(FocalChannel, CurTime, Keyframe, Keyframe->LensSettings.FocalLength);
-                }
-            }
-
-            // Aperture
-            if (UMovieSceneFloatTrack* ApertureTrack = ShotMovieScene->AddTrack<UMovieSceneFloatTrack>(ComponentGuid))
-            {
-                ApertureTrack->SetPropertyNameAndPath(GET_MEMBER_NAME_CHECKED(UCineCameraComponent, CurrentAperture), "CurrentAperture");
-                UMovieSceneFloatSection* ApertureSection = Cast<UMovieSceneFloatSection>(ApertureTrack->CreateNewSection());
-                ApertureTrack->AddSection(*ApertureSection);
-                ApertureSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-                FMovieSceneFloatChannel& ApertureChannel = ApertureSection->GetChannel();
-                double CurTime = 0.0;
-                for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-                {
-                    const ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-                    if (!Keyframe) continue;
-                    if (k > 0) CurTime += (Keyframe->TimeToCurrentFrame * TrajectoryTimeScale);
-                    AddLensKeyWithStay(ApertureChannel, CurTime, Keyframe, Keyframe->LensSettings.Aperture);
-                }
-            }
-
-            // Manual focus distance
-            if (UMovieSceneFloatTrack* ManualFocusTrack = ShotMovieScene->AddTrack<UMovieSceneFloatTrack>(ComponentGuid))
-            {
-                ManualFocusTrack->SetPropertyNameAndPath(TEXT("FocusSettings.ManualFocusDistance"), TEXT("FocusSettings.ManualFocusDistance"));
-                UMovieSceneFloatSection* ManualFocusSection = Cast<UMovieSceneFloatSection>(ManualFocusTrack->CreateNewSection());
-                ManualFocusTrack->AddSection(*ManualFocusSection);
-                ManualFocusSection->SetRange(TRange<FFrameNumber>(0, DurationInTicks));
-                FMovieSceneFloatChannel& ManualFocusChannel = ManualFocusSection->GetChannel();
-                double CurTime = 0.0;
-                for (int32 k = 0; k < TrajectoryKeyframes.Num(); ++k)
-                {
-                    const ACDGKeyframe* Keyframe = TrajectoryKeyframes[k];
-                    if (!Keyframe) continue;
-                    if (k > 0) CurTime += (Keyframe->TimeToCurrentFrame * TrajectoryTimeScale);
-
-                    const FVector CameraLocation = Keyframe->GetKeyframeTransform().GetLocation();
-                    float FocusDistance = 0.0f;
-                    if (const AActor* AutofocusTargetActor = Keyframe->LensSettings.AutofocusTargetActor.Get())
-                    {
-                        FVector FocusTargetLocation = AutofocusTargetActor->GetActorLocation();
-                        TArray<UCDGCharacterAnchor*> AnchorComponents;
-                        AutofocusTargetActor->GetComponents<UCDGCharacterAnchor>(AnchorComponents);
-                        for (const UCDGCharacterAnchor* AnchorComponent : AnchorComponents)
-                        {
-                            if (AnchorComponent && AnchorComponent->Type == Keyframe->LensSettings.AutofocusTargetAnchorType)
-                            {
-                                FocusTargetLocation = AnchorComponent->GetComponentLocation();
-                                break;
-                            }
-                        }
-                        FocusDistance = FVector::Distance(CameraLocation, FocusTargetLocation);
-                    }
-                    else if (Keyframe->LensSettings.bUseManualFocusDistance)
-                    {
-                        FocusDistance = Keyframe->LensSettings.FocusDistance;
-                    }
-                    AddLensKeyWithStay(ManualFocusChannel, CurTime, Keyframe, FocusDistance);
-                }
-            }
+            continue;
         }
 
         ShotMovieScene->SetPlaybackRange(TRange<FFrameNumber>(0, DurationInTicks));
@@ -0,0 +1,133 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CDGBatchCommandlet.generated.h"
+
+class UCDGBatchProcExecService;
+class UGeneratorStackConfig;
+class ULevelSeqExportConfig;
+class FCDGBatchJobQueue;
+struct FCDGBatchJob;
+struct FBatchProcInput;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// UCDGBatchCommandlet
+//
+// Runs the same Levels × Anchors × Characters × Animations loop as the Batch
+// Processing window, without Slate.  Progress is reported on stdout.
+//
+// Usage:
+//   UnrealEditor-Cmd <Project>.uproject -run=CDGBatch
+//       -Config=/Game/Batch/MyBatch.MyBatch       (UBatchProcConfig asset)
+//    |  -ConfigFile=/abs/path/batch.json          (JSON, see below)
+//    |  -JobSpec=/abs/path/<ComboKey>.json        (one combo, see Render farms)
+//      [-OutputDir=/abs/path]                     (overrides exporter config)
+//      [-Render]                                  (render via MRQ; needs a GPU)
+//      [-NoResume]                                (ignore CDGBatchCheckpoint.jsonl)
+//      [-Seed=<int>]                              (base seed mixed into each combo)
+//      [-LookAhead=<n>]                           (combos prepared while rendering; 0 = serial)
+//      [-CombosPerRender=<n>] [-FramesPerRender=<n>]  (combos per MRQ executor session)
+//      [-RenderAttempts=<n>]                      (renders per combo while shots fail validation; default 2)
+//      [-MemWatermarkMB=<n>]                      (GC between combos above this; default 60 % of RAM)
+//      [-Sample=Uniform|Stratified|LatinHypercube -SampleBudget=<n>
+//       [-SampleBy=Level|Character|Animation] [-SampleSeed=<int>]]  (run a subset of the combos)
+//      [-Supervise [-HeartbeatTimeout=<s>] [-MaxRestarts=<n>]]  (run in a child process;
+//                        restart it on crash / hang, skipping the combo it died on)
+//      [-nullrhi -unattended -stdout]
+//
+// Without -Render each combo is generated, exported and indexed only, which
+// works on machines with no GPU (-nullrhi).
+//
+// Sharded runs (several processes on one host, see FCDGBatchJobQueue):
+//   ... -JobDir=/abs/jobs -Plan [-Spawn=<n> [-GPUs=<k>]]   coordinator: write
+//                        pending/ jobs; with -Spawn also launch n workers,
+//                        wait for them and merge
+//   ... -JobDir=/abs/jobs -Worker=<id>                     claim and run jobs,
+//                        output to <JobDir>/shards/<id>/
+//   ... -JobDir=/abs/jobs -Merge                           write DatasetIndex.json
+//
+// Render farms (any number of machines sharing a filesystem, see FCDGBatchJobSpec):
+//   ... -Config=... -ExportJobs=/abs/specs [-Seed=<int>]   write one
+//                        <ComboKey>.json per combo: assets, seed, generator
+//                        stack and exporter settings
+//   ... -JobSpec=/abs/specs/<ComboKey>.json [-Render]       run (or re-run)
+//                        exactly that combo, output to
+//                        <OutputDirectory>/shards/<ComboKey>/
+//
+// JSON file layout:
+//   {
+//     "levels":          [ "/Game/Maps/L1.L1", ... ],
+//     "characters":      [ "/Game/Chars/BP_A.BP_A", ... ],
+//     "animations":      [ "/Game/Anims/Walk.Walk", ... ],
+//     "sampling":        { "Mode": "Stratified", "Budget": 500, "Stratum": "Character", "Seed": 7 },  (optional)
+//     "generatorConfig": "/Game/Cfg/GenStack.GenStack",
+//       or "generators": { "positioning": [...], "movement": [...], "effects": [...] },
+//     "exporterConfig":  "/Game/Cfg/Export.Export",
+//       or "exporter":   { "FPS": 30, "OutputDirectory": "...", ... }
+//   }
+// ─────────────────────────────────────────────────────────────────────────────
+UCLASS()
+class CAMERADATASETGENEDITOR_API UCDGBatchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCDGBatchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Fill Input from a UBatchProcConfig asset path. */
+	bool LoadInputFromAsset(const FString& AssetPath, FBatchProcInput& OutInput) const;
+
+	/** Fill Input from a JSON batch description on disk. */
+	bool LoadInputFromJsonFile(const FString& FilePath, FBatchProcInput& OutInput);
+
+	/**
+	 * Fill Input with the single combo of a job spec, pin its seed and point
+	 * the output at <spec OutputDirectory>/shards/<ComboKey>.
+	 */
+	bool LoadInputFromJobSpec(const FString& FilePath, FBatchProcInput& OutInput, FString& OutComboKey);
+
+	/** Point Input at a transient copy of the exporter config with OutputDir. */
+	void OverrideOutputDir(FBatchProcInput& Input, const FString& OutputDir);
+
+	/**
+	 * Load every level, enumerate its anchors and call Visit for each combo the
+	 * batch would run (sampled batches: the sampled ones).  Returns the count.
+	 */
+	int32 EnumerateCombos(const FBatchProcInput& Input, TFunctionRef<void(const FCDGBatchJob&)> Visit) const;
+
+	/** Queue one job per combo. */
+	bool PlanJobs(const FBatchProcInput& Input, const FCDGBatchJobQueue& Queue) const;
+
+	/** Write one self-contained FCDGBatchJobSpec per combo into SpecDir. */
+	bool ExportJobSpecs(const FBatchProcInput& Input, const FString& SpecDir) const;
+
+	/** Launch NumWorkers child commandlets on this host, wait, then merge. */
+	int32 RunSpawnedWorkers(const FString& Params, const FCDGBatchJobQueue& Queue, int32 NumWorkers) const;
+
+	/**
+	 * Run this batch in a child commandlet and restart it (resuming from the
+	 * checkpoint) whenever it dies or its heartbeat goes stale.  The combo the
+	 * heartbeat names is recorded as crashed, with the child's last log lines.
+	 */
+	int32 RunSupervised(const FString& Params, const FString& OutputDir,
+	                    const TSharedPtr<FCDGBatchJobQueue>& Queue, const FString& WorkerId) const;
+
+	/** Write the merged dataset index; non-zero when jobs failed or remain. */
+	int32 RunMerge(const FCDGBatchJobQueue& Queue) const;
+
+	/** Tick the core ticker (and the engine when rendering) until the service finishes. */
+	void PumpUntilFinished(UCDGBatchProcExecService* Service, bool bTickEngine) const;
+
+	/** Configs created from inline JSON; held here so GC keeps them alive. */
+	UPROPERTY(Transient)
+	TObjectPtr<UGeneratorStackConfig> InlineGeneratorConfig;
+
+	UPROPERTY(Transient)
+	TObjectPtr<ULevelSeqExportConfig> InlineExporterConfig;
+};
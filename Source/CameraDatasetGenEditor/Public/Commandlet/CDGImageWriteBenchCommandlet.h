@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CDGImageWriteBenchCommandlet.generated.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// UCDGImageWriteBenchCommandlet
+//
+// Pushes synthetic frames through FCDGImageWritePool and reports frames per
+// second, output size and how long the producer was stalled, once per codec
+// setting.  No level, rendering or GPU involved.  Every written frame is read
+// back through CDGOutputValidator's header probe; a write failure, a missing
+// frame or a frame that does not probe as its codec and size fails the run,
+// and any failed run makes the commandlet exit with code 1.
+//
+// Usage:
+//   UnrealEditor-Cmd <Project>.uproject -run=CDGImageWriteBench
+//      [-Codecs=PNG,QOI,BMP]          (comma separated; default all three)
+//      [-Levels=1,3,6]                (PNG zlib levels to sweep; default 3)
+//      [-Filter=Adaptive]             (None, Sub, Up, Average, Paeth, Adaptive)
+//      [-Workers=<n>] [-Queue=<n>]    (0 = pool defaults)
+//      [-Frames=120] [-Width=1920] [-Height=1080] [-Alpha]
+//      [-OutputDir=/abs/path]         (default <Saved>/CDGImageWriteBench)
+//      [-Keep]                        (keep the written frames)
+//      [-nullrhi -unattended -stdout]
+// ─────────────────────────────────────────────────────────────────────────────
+UCLASS()
+class CAMERADATASETGENEDITOR_API UCDGImageWriteBenchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCDGImageWriteBenchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -7,6 +7,56 @@
 #include "Config/LevelSeqExportConfig.h"
 #include "BatchProcConfig.generated.h"
 
+/** How the combinations of a batch are chosen. */
+UENUM(BlueprintType)
+enum class ECDGComboSampling : uint8
+{
+	/** Every level × anchor × character × animation combination. */
+	Exhaustive,
+	/** Budget combos drawn uniformly at random, without replacement. */
+	Uniform,
+	/** Budget split evenly across the values of one axis (see Stratum). */
+	Stratified,
+	/** Latin hypercube over the anchor, character and animation axes. */
+	LatinHypercube
+};
+
+/** Axis whose values each receive an equal share of a stratified budget. */
+UENUM(BlueprintType)
+enum class ECDGComboStratum : uint8
+{
+	/** Equal share per level, and per anchor within each level. */
+	Level,
+	Character,
+	Animation
+};
+
+/**
+ * Combo sampling for batches whose full Cartesian product is too large to
+ * render.  Selection is deterministic for a given Seed and asset list.
+ */
+USTRUCT(BlueprintType)
+struct CAMERADATASETGENEDITOR_API FCDGComboSamplingSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sampling")
+	ECDGComboSampling Mode = ECDGComboSampling::Exhaustive;
+
+	/** Total number of combos to run across all levels (ignored when exhaustive). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sampling",
+		meta = (ClampMin = "1", EditCondition = "Mode != ECDGComboSampling::Exhaustive"))
+	int32 Budget = 1000;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sampling",
+		meta = (EditCondition = "Mode == ECDGComboSampling::Stratified"))
+	ECDGComboStratum Stratum = ECDGComboStratum::Character;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sampling",
+		meta = (EditCondition = "Mode != ECDGComboSampling::Exhaustive"))
+	int32 Seed = 0;
+};
+
 /**
  * Content-browser asset that persists a full batch processing job:
  * a set of levels, skeletal-mesh characters, and animations to process,
@@ -30,6 +80,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Assets")
 	TArray<FSoftObjectPath> Animations;
 
+	/** Which level × anchor × character × animation combos to run */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Assets")
+	FCDGComboSamplingSettings Sampling;
+
 	/** Generator stack config to use for trajectory generation */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config Assets")
 	TObjectPtr<UGeneratorStackConfig> GeneratorConfig;
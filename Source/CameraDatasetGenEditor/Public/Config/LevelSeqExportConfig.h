@@ -53,6 +53,26 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Render Settings")
 	bool bOverwriteExisting = false;
 
+	/** Stream frames into a sink (encoder pipe, raw / YUV chunks) instead of writing image files */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Render Settings")
+	ECDGFrameSinkKind FrameSink = ECDGFrameSinkKind::None;
+
+	/** Frames per file for the raw / YUV chunk sinks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Render Settings", meta = (ClampMin = "1"))
+	int32 FramesPerChunk = 300;
+
+	/** Size cap of one tar shard for the tar shard sink, in MB; a level's shots share one shard set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Render Settings", meta = (ClampMin = "1"))
+	int32 ShardSizeMB = 1024;
+
+	/** Encoder for image sequence formats; anything but Engine writes through the plugin's worker pool */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Render Settings")
+	FCDGImageWriteSettings ImageWrite;
+
+	/** FFmpeg location and encoder options for video output */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Render Settings")
+	FCDGVideoEncodeSettings VideoEncode;
+
 	// ---- Quality Settings ----
 
 	/** Spatial (anti-aliasing) sample count */
@@ -63,6 +83,28 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality Settings", meta = (ClampMin = "1", ClampMax = "32"))
 	int32 TemporalSampleCount = 1;
 
+	// ---- Key Reduction ----
+
+	/** Drop camera keys that the remaining keys reproduce within the tolerances below (at rendered frames) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Key Reduction")
+	bool bReduceKeys = false;
+
+	/** Largest allowed camera position error, in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Key Reduction", meta = (ClampMin = "0.0", EditCondition = "bReduceKeys"))
+	float LocationTolerance = 0.1f;
+
+	/** Largest allowed camera rotation error, in degrees */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Key Reduction", meta = (ClampMin = "0.0", EditCondition = "bReduceKeys"))
+	float RotationTolerance = 0.05f;
+
+	/** Largest allowed focal length (mm) and aperture (f-stop) error */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Key Reduction", meta = (ClampMin = "0.0", EditCondition = "bReduceKeys"))
+	float LensTolerance = 0.01f;
+
+	/** Largest allowed focus distance error, in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Key Reduction", meta = (ClampMin = "0.0", EditCondition = "bReduceKeys"))
+	float FocusTolerance = 1.0f;
+
 	// ---- Other ----
 
 	/** Keep the exported Level Sequence asset after rendering completes */
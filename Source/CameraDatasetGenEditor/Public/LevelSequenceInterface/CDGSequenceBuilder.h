@@ -0,0 +1,235 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Channels/MovieSceneDoubleChannel.h"
+#include "Channels/MovieSceneFloatChannel.h"
+#include "Misc/FrameRate.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Trajectory/CDGKeyframe.h"
+
+class ACDGTrajectory;
+class ACineCameraActor;
+class ULevelSeqExportConfig;
+class UCineCameraComponent;
+class ULevelSequence;
+class UMovieScene;
+class UWorld;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGSequenceBuilder  —  the one place trajectories become shot sequences
+//
+// Used by the Level Sequence Exporter window, the batch processor and the MRQ
+// interface.  Work is split by thread affinity:
+//
+//   Capture()         game thread  — copy what the keys need out of the
+//                                    keyframe actors (FCDGCameraKeySnapshot)
+//   Bake()/BakeAll()  any thread   — turn snapshots into sorted per-channel
+//                                    key arrays, seconds → ticks done here once
+//   CreateShotSequence() game thread — duplicate a per-builder shot template
+//                                    that already holds every binding, track
+//                                    and section of a camera shot
+//   BuildCameraShot() game thread  — camera actor, bindings, tracks (found in
+//                                    the template copy, added otherwise); each
+//                                    channel filled with one Set() call and a
+//                                    single tangent pass
+//
+// What differs between the callers (camera naming, focus handling) is an
+// FCDGShotLayout, not a separate code path.
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** How a shot camera focuses. */
+enum class ECDGShotFocus : uint8
+{
+	/** Leave the camera's focus settings alone. */
+	Untouched,
+	/** Bake the distance to each key's autofocus anchor (or its manual distance) into ManualFocusDistance. */
+	BakedDistance,
+	/** Track the first key's autofocus anchor live; otherwise bake manual distances. */
+	TrackAnchor,
+};
+
+/**
+ * Optional key reduction: per channel, keep the fewest of the baked keys whose
+ * auto-tangent cubic still matches the full curve within tolerance at every
+ * sample (two per display frame).  Hold keys and the first/last key are kept.
+ */
+struct FCDGKeyReduction
+{
+	bool   bEnabled          = false;
+	double LocationTolerance = 0.1;    // cm
+	double RotationTolerance = 0.05;   // degrees
+	double LensTolerance     = 0.01;   // mm of focal length, f-stops
+	double FocusTolerance    = 1.0;    // cm
+
+	/** The Key Reduction settings of Config; disabled when Config is null. */
+	static FCDGKeyReduction FromConfig(const ULevelSeqExportConfig* Config);
+};
+
+/** Per-caller shape of the shots a builder creates. */
+struct FCDGShotLayout
+{
+	/** Camera actor label: <CameraLabelPrefix><TrajectoryName> */
+	FString CameraLabelPrefix = TEXT("Cam_");
+
+	/** Also use the label as the actor's object name. */
+	bool bNameCameraActor = false;
+
+	ECDGShotFocus Focus = ECDGShotFocus::Untouched;
+
+	FCDGKeyReduction KeyReduction;
+};
+
+/** Plain-data copy of a trajectory's sorted keyframes. */
+struct FCDGCameraKeySnapshot
+{
+	struct FKey
+	{
+		float                 TimeToCurrentFrame = 0.f;   // seconds, already time-scaled
+		float                 TimeAtCurrentFrame = 0.f;
+		FVector               Location = FVector::ZeroVector;
+		FRotator              Rotation = FRotator::ZeroRotator;
+		ECDGInterpolationMode PositionMode = ECDGInterpolationMode::Cubic;
+		ECDGInterpolationMode RotationMode = ECDGInterpolationMode::Cubic;
+		float                 FocalLength   = 35.f;
+		float                 Aperture      = 2.8f;
+		float                 FocusDistance = 0.f;        // autofocus anchor, else manual, else 0
+		bool                  bFocusOverride = false;     // autofocus target or manual distance set
+	};
+
+	FString      TrajectoryName;
+	TArray<FKey> Keys;
+
+	/** First key's autofocus target (ECDGShotFocus::TrackAnchor), in actor space. */
+	TWeakObjectPtr<AActor> FocusTrackActor;
+	FVector                FocusTrackOffset = FVector::ZeroVector;
+};
+
+/** Channel-ready keys for one shot camera. */
+struct FCDGBakedCameraKeys
+{
+	template<typename ValueType>
+	struct TCurve
+	{
+		TArray<FFrameNumber> Times;
+		TArray<ValueType>    Values;
+	};
+
+	/** Location X/Y/Z, then Roll/Pitch/Yaw — the 3D transform section's channel order. */
+	TCurve<FMovieSceneDoubleValue> Transform[6];
+	TCurve<FMovieSceneFloatValue>  FocalLength;
+	TCurve<FMovieSceneFloatValue>  Aperture;
+	/** Empty unless the layout bakes focus. */
+	TCurve<FMovieSceneFloatValue>  FocusDistance;
+
+	int32 NumKeys() const;
+};
+
+class CAMERADATASETGENEDITOR_API FCDGSequenceBuilder
+{
+public:
+	static constexpr double DefaultTickResolution = 24000.0;
+
+	FCDGSequenceBuilder(const FCDGShotLayout& InLayout, const FFrameRate& InDisplayRate,
+	                    double InTickResolution = DefaultTickResolution);
+
+	/** Display rate and tick resolution on a (new or reused) movie scene. */
+	void PrepareMovieScene(UMovieScene& MovieScene) const;
+
+	/** Seconds → ticks at this builder's tick resolution. */
+	FFrameNumber SecondsToTicks(double Seconds) const;
+
+	/** Game thread only.  TimeScale stretches every key interval (shot fitting). */
+	FCDGCameraKeySnapshot Capture(const ACDGTrajectory& Trajectory, double TimeScale = 1.0) const;
+
+	/** Keys before and after reduction, for the export log. */
+	struct FBakeStats
+	{
+		int64 NumBaked   = 0;
+		int64 NumReduced = 0;
+
+		FBakeStats& operator+=(const FBakeStats& Other);
+		/** "12345 → 678 keys (5.5 %)" */
+		FString ToString() const;
+	};
+
+	/** Thread-safe: touches nothing but Snapshot.  Reduces keys when the layout asks for it. */
+	FCDGBakedCameraKeys Bake(const FCDGCameraKeySnapshot& Snapshot, FBakeStats* OutStats = nullptr) const;
+
+	/**
+	 * Bake every snapshot on the task graph, then reduce every channel of every
+	 * shot as its own task.  Out matches Snapshots index for index.
+	 */
+	FBakeStats BakeAll(TArrayView<const FCDGCameraKeySnapshot> Snapshots, TArray<FCDGBakedCameraKeys>& Out) const;
+
+	/**
+	 * New shot sequence Outer.Name, duplicated from this builder's shot
+	 * template (built on first use): display rate, tick resolution, the camera
+	 * and lens bindings and every track and section BuildCameraShot() writes
+	 * are already there, so building the shot only binds the camera and
+	 * overwrites channels and ranges.  Flags replace the template's.
+	 */
+	ULevelSequence* CreateShotSequence(UObject* Outer, FName Name, EObjectFlags Flags) const;
+
+	struct FBuiltShot
+	{
+		ACineCameraActor* Camera = nullptr;
+		FGuid             CameraGuid;
+	};
+
+	/**
+	 * Spawn the shot camera (replacing a leftover one with the same label),
+	 * bind it into Sequence and write its camera cut, transform and lens
+	 * tracks over [0, DurationTicks).  The template's bindings and tracks are
+	 * reused when Sequence came from CreateShotSequence(), as is an existing
+	 * camera cut track.
+	 */
+	FBuiltShot BuildCameraShot(UWorld* World, ULevelSequence& Sequence,
+	                           const FCDGCameraKeySnapshot& Snapshot, const FCDGBakedCameraKeys& Keys,
+	                           int32 DurationTicks) const;
+
+	/**
+	 * Play Shared under Shot as a subsequence over [0, DurationTicks), so
+	 * content every shot has in common (character animation, base shot
+	 * tracks) lives once instead of being duplicated into each shot.  A
+	 * subsequence track already in Shot is re-pointed.
+	 */
+	static void AddSharedSubSequence(ULevelSequence& Shot, ULevelSequence& Shared, int32 DurationTicks);
+
+	/** Keys assigned by BuildCameraShot() so far. */
+	int64 GetNumKeysWritten() const { return NumKeysWritten; }
+
+	const FCDGShotLayout& GetLayout() const { return Layout; }
+	double GetTickResolution() const { return TickResolution; }
+
+	/** Replace a channel's keys in one call, then run one tangent pass. */
+	static void ApplyCurve(FMovieSceneDoubleChannel& Channel, const FCDGBakedCameraKeys::TCurve<FMovieSceneDoubleValue>& Curve);
+	static void ApplyCurve(FMovieSceneFloatChannel& Channel, const FCDGBakedCameraKeys::TCurve<FMovieSceneFloatValue>& Curve);
+
+private:
+	/** Seconds → ticks and interpolation modes; no reduction. */
+	FCDGBakedCameraKeys BakeKeys(const FCDGCameraKeySnapshot& Snapshot) const;
+
+	/** Reduce channel Index of Keys (0-5 transform, 6 focal length, 7 aperture, 8 focus). */
+	void ReduceChannel(FCDGBakedCameraKeys& Keys, int32 Index) const;
+	static constexpr int32 NumChannels = 9;
+
+	void ApplyFocus(ULevelSequence& Sequence, UMovieScene& MovieScene, const FGuid& ComponentGuid,
+	                UCineCameraComponent& CameraComponent, const FCDGCameraKeySnapshot& Snapshot,
+	                const FCDGBakedCameraKeys& Keys, int32 DurationTicks) const;
+
+	/** Add the tracks and sections of a camera shot to an empty template. */
+	void BuildShotTemplate() const;
+
+	FCDGShotLayout Layout;
+	FFrameRate     DisplayRate;
+	double         TickResolution;
+
+	/** Game thread only; see CreateShotSequence(). */
+	mutable TStrongObjectPtr<ULevelSequence> ShotTemplate;
+	mutable FGuid TemplateCameraGuid;
+	mutable FGuid TemplateComponentGuid;
+
+	mutable int64  NumKeysWritten = 0;
+};
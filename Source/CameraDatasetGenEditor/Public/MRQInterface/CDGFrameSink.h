@@ -0,0 +1,249 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+#include "MRQInterface/CDGMRQInterface.h"
+#include "MRQInterface/CDGTarShardWriter.h"
+#include "Async/Future.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// ICDGFrameSink  —  where rendered frames go when they skip image files
+//
+// UCDGMoviePipelineFrameSinkOutput hands every rendered frame of a shot to
+// a sink: Begin() once per shot, Write() per frame in render order, End()
+// when the shot is done, and Finish() once after the last shot.  Sinks know
+// nothing about MRQ or the GPU, so any of them can be driven with synthetic
+// buffers (the CameraDatasetGen.FrameSink automation test does).
+//
+// Built-in sinks (MakeFrameSink):
+//   EncoderPipe  raw BGRA frames piped into a local encoder process
+//                (FFmpeg) that writes <BaseName>.mp4
+//   RawChunks    frames as-is into <BaseName>.<chunk>.raw files
+//   YUVChunks    8-bit frames as planar YUV 4:2:0 (BT.601, limited range)
+//                into <BaseName>.<chunk>.yuv, 37.5 % of the BGRA size
+//   TarShards    8-bit frames encoded as images (PNG by default) and stored
+//                with their per-frame metadata as WebDataset samples in
+//                size-capped <Set>-<shard>.tar files (FCDGTarShardWriter);
+//                shots given the same ShardSetName fill one shared set,
+//                closed by CloseTarShardSets()
+//   Custom       whatever SetCustomFrameSinkFactory() returns
+//
+// Both chunked sinks also write <BaseName>.frames.json describing the
+// layout: width, height, pixel format, frame rate, frame count and chunks.
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** Memory layout of a frame's pixels; rows top to bottom, no padding. */
+enum class ECDGFramePixelFormat : uint8
+{
+	BGRA8,     // FColor
+	RGBA16F,   // FFloat16Color
+	RGBA32F,   // FLinearColor
+};
+
+CAMERADATASETGENEDITOR_API int32 GetFramePixelBytes(ECDGFramePixelFormat Format);
+CAMERADATASETGENEDITOR_API const TCHAR* GetFramePixelFormatName(ECDGFramePixelFormat Format);
+
+/** One shot's stream of frames. */
+struct FCDGFrameStreamInfo
+{
+	/** Directory the sink writes into. */
+	FString              OutputDir;
+	/** File name without extension, e.g. <LevelName>.<TrajectoryName> */
+	FString              BaseName;
+	FIntPoint            Size      = FIntPoint::ZeroValue;
+	FFrameRate           FrameRate = FFrameRate(30, 1);
+	ECDGFramePixelFormat Format    = ECDGFramePixelFormat::BGRA8;
+	/** Optional JSON object per frame, in stream order; TarShards stores it next to the image */
+	TArray<FString>      FrameMetadata;
+
+	int64 GetFrameBytes() const { return int64(Size.X) * Size.Y * GetFramePixelBytes(Format); }
+};
+
+struct FCDGFrame
+{
+	int32                  FrameNumber = 0;
+	/** Exactly FCDGFrameStreamInfo::GetFrameBytes() bytes. */
+	TConstArrayView<uint8> Pixels;
+};
+
+class CAMERADATASETGENEDITOR_API ICDGFrameSink
+{
+public:
+	virtual ~ICDGFrameSink() = default;
+
+	/** Start a stream; false when the sink cannot take this format or output. */
+	virtual bool Begin(const FCDGFrameStreamInfo& Info) = 0;
+
+	/** False once the stream has failed; later frames are dropped. */
+	virtual bool Write(const FCDGFrame& Frame) = 0;
+
+	/** Flush and close the stream; false when its output is incomplete. */
+	virtual bool End() = 0;
+
+	/** After the last stream: close what outlives a stream; false when that output is incomplete. */
+	virtual bool Finish() { return true; }
+
+	/** Files the last stream produced (absolute paths). */
+	virtual TArray<FString> GetOutputFiles() const { return {}; }
+};
+
+/** Settings for MakeFrameSink(). */
+struct FCDGFrameSinkSettings
+{
+	ECDGFrameSinkKind Kind = ECDGFrameSinkKind::None;
+	/** EncoderPipe: encoder executable and its output arguments (codec, quality), see CDGMRQInterface::Internal::MakeEncoderPipeArgs.  Empty leaves the codec to the encoder. */
+	FString EncoderPath;
+	FString EncoderArgs;
+	/** Raw / YUV chunks: frames per file. */
+	int32   FramesPerChunk = 300;
+	/** TarShards: image encoding (Engine picks PNG) and shard size cap */
+	FCDGImageWriteSettings ImageWrite;
+	int32   ShardSizeMB = 1024;
+	/**
+	 * TarShards: set shared by every sink writing into the same directory
+	 * under this name, so shards fill up across shots; it stays open until
+	 * CloseTarShardSets().  Empty gives the sink a set of its own, named
+	 * after its first stream and closed by Finish().
+	 */
+	FString ShardSetName;
+};
+
+/** Null for ECDGFrameSinkKind::None, or Custom without a factory. */
+CAMERADATASETGENEDITOR_API TUniquePtr<ICDGFrameSink> MakeFrameSink(const FCDGFrameSinkSettings& Settings);
+
+/** Factory used for ECDGFrameSinkKind::Custom; pass nullptr to clear it. */
+CAMERADATASETGENEDITOR_API void SetCustomFrameSinkFactory(TFunction<TUniquePtr<ICDGFrameSink>()> Factory);
+
+/**
+ * Close the shared tar shard sets open in OutputDir (every set when empty):
+ * last shard and the merged <ShardSetName>.shards.json.  Game thread only.
+ * @return false when a set failed to write
+ */
+CAMERADATASETGENEDITOR_API bool CloseTarShardSets(const FString& OutputDir = FString());
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Built-in sinks
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** Pipes BGRA8 frames into an encoder's stdin; the encoder writes <BaseName>.mp4. */
+class CAMERADATASETGENEDITOR_API FCDGEncoderPipeFrameSink : public ICDGFrameSink
+{
+public:
+	FCDGEncoderPipeFrameSink(const FString& InEncoderPath, const FString& InEncoderArgs);
+	virtual ~FCDGEncoderPipeFrameSink() override;
+
+	virtual bool Begin(const FCDGFrameStreamInfo& Info) override;
+	virtual bool Write(const FCDGFrame& Frame) override;
+	virtual bool End() override;
+	virtual TArray<FString> GetOutputFiles() const override { return { OutputPath }; }
+
+private:
+	void Close();
+
+	FString EncoderPath;
+	FString EncoderArgs;
+	FString OutputPath;
+	int64   FrameBytes = 0;
+	bool    bFailed    = false;
+
+	FProcHandle Process;
+	void* StdinRead  = nullptr;
+	void* StdinWrite = nullptr;
+};
+
+/** Writes frames into fixed-size chunk files, optionally converted to YUV 4:2:0. */
+class CAMERADATASETGENEDITOR_API FCDGChunkedFileFrameSink : public ICDGFrameSink
+{
+public:
+	FCDGChunkedFileFrameSink(bool bInYUV420, int32 InFramesPerChunk);
+	virtual ~FCDGChunkedFileFrameSink() override;
+
+	virtual bool Begin(const FCDGFrameStreamInfo& Info) override;
+	virtual bool Write(const FCDGFrame& Frame) override;
+	virtual bool End() override;
+	virtual TArray<FString> GetOutputFiles() const override;
+
+	/** BGRA8 → planar Y, U, V (4:2:0, BT.601 limited range); odd sizes round chroma up. */
+	static void ConvertBGRA8ToI420(const uint8* Src, FIntPoint Size, TArray<uint8>& Out);
+
+private:
+	bool OpenChunk();
+	bool WriteManifest() const;
+
+	bool  bYUV420;
+	int32 FramesPerChunk;
+
+	FCDGFrameStreamInfo    Info;
+	TUniquePtr<FArchive>   Chunk;
+	TArray<FString>        ChunkFiles;
+	FString                ManifestPath;
+	TArray<uint8>          Converted;
+	int32 FramesInChunk = 0;
+	int32 NumFrames     = 0;
+	int32 FirstFrame    = INDEX_NONE;
+	bool  bFailed       = false;
+};
+
+/** Forwards every frame to a callback; returning false fails the stream. */
+class CAMERADATASETGENEDITOR_API FCDGCallbackFrameSink : public ICDGFrameSink
+{
+public:
+	using FOnFrame = TFunction<bool(const FCDGFrameStreamInfo& /*Info*/, const FCDGFrame& /*Frame*/)>;
+
+	explicit FCDGCallbackFrameSink(FOnFrame InOnFrame, TFunction<bool(const FCDGFrameStreamInfo&)> InOnEnd = nullptr);
+
+	virtual bool Begin(const FCDGFrameStreamInfo& InInfo) override;
+	virtual bool Write(const FCDGFrame& Frame) override;
+	virtual bool End() override;
+
+private:
+	FOnFrame OnFrame;
+	TFunction<bool(const FCDGFrameStreamInfo&)> OnEnd;
+	FCDGFrameStreamInfo Info;
+	bool bFailed = false;
+};
+
+/**
+ * Encodes frames on worker tasks (in order, a few in flight) and writes each
+ * as a <key>.<ext> + <key>.json sample into WebDataset tar shards.  Keys
+ * start with the stream's BaseName, so shots sharing a set stay apart, and
+ * the set's index lists each stream's samples and shards.
+ */
+class CAMERADATASETGENEDITOR_API FCDGTarShardFrameSink : public ICDGFrameSink
+{
+public:
+	FCDGTarShardFrameSink(const FCDGImageWriteSettings& InImageWrite, int32 InShardSizeMB, const FString& InShardSetName = FString());
+	virtual ~FCDGTarShardFrameSink() override;
+
+	virtual bool Begin(const FCDGFrameStreamInfo& InInfo) override;
+	virtual bool Write(const FCDGFrame& Frame) override;
+	virtual bool End() override;
+	virtual bool Finish() override;
+	virtual TArray<FString> GetOutputFiles() const override;
+
+private:
+	struct FPendingFrame
+	{
+		int32                     FrameNumber = 0;
+		int32                     StreamIndex = 0;
+		TFuture<TArray64<uint8>>  Image;
+	};
+
+	/** Wait for the oldest encode and append its sample. */
+	bool WriteOldest();
+
+	FCDGImageWriteSettings ImageWrite;
+	int64                  MaxShardBytes;
+	int32                  MaxInFlight;
+	FString                ShardSetName;
+
+	FCDGFrameStreamInfo    Info;
+	/** The shared set, or the sink's own one when ShardSetName is empty */
+	TSharedPtr<FCDGTarShardWriter> Writer;
+	TArray<FPendingFrame>  Pending;
+	int32                  NumFrames  = 0;
+	int32                  NumWritten = 0;
+	bool                   bFailed    = false;
+};
@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "CDGImageWritePool.generated.h"
+
+class FQueuedThreadPool;
+class FEvent;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGImageWritePool  —  bounded worker pool that encodes and writes frames
+//
+// UCDGMoviePipelineImageWriteOutput hands every rendered 8-bit frame to
+// Enqueue(); a worker encodes it (PNG, QOI or BMP, see Encode()) and writes
+// the file.  At most MaxQueuedFrames frames are held at once — Enqueue()
+// blocks until a worker frees a slot, which stalls the renderer instead of
+// letting frames pile up in memory.  Flush() is the barrier at shot end.
+//
+// The encoders are self-contained so the compression level and PNG row
+// filter can be chosen per job; CDGImageWriteBench (commandlet) runs them
+// on synthetic frames without rendering.
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** Image file encoder used for rendered frames */
+UENUM(BlueprintType)
+enum class ECDGImageCodec : uint8
+{
+	/** MRQ's own writers for the export format */
+	Engine UMETA(DisplayName = "Engine (MRQ writers)"),
+
+	/** PNG, configurable zlib level and row filter */
+	PNG UMETA(DisplayName = "PNG"),
+
+	/** QOI, lossless and far cheaper to encode than PNG, larger files */
+	QOI UMETA(DisplayName = "QOI"),
+
+	/** Uncompressed BMP */
+	BMP UMETA(DisplayName = "BMP")
+};
+
+/** PNG row filter (PNG spec, section 9) */
+UENUM(BlueprintType)
+enum class ECDGPNGFilter : uint8
+{
+	None,
+	Sub,
+	Up,
+	Average,
+	Paeth,
+	/** Per row, the filter with the smallest sum of absolute differences (libpng's default) */
+	Adaptive
+};
+
+/**
+ * How the plugin's image write pool encodes frames
+ */
+USTRUCT(BlueprintType)
+struct CAMERADATASETGENEDITOR_API FCDGImageWriteSettings
+{
+	GENERATED_BODY()
+
+	/** Engine keeps MRQ's image outputs; anything else writes 8-bit PNG / BMP exports through the pool (EXR keeps MRQ's writer) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write")
+	ECDGImageCodec Codec = ECDGImageCodec::Engine;
+
+	/** zlib level: 0 stores, 1 is fastest, 9 is smallest */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write", meta = (ClampMin = "0", ClampMax = "9"))
+	int32 PNGCompressionLevel = 3;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write")
+	ECDGPNGFilter PNGFilter = ECDGPNGFilter::Adaptive;
+
+	/** Keep the alpha channel; off writes RGB, which is smaller */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write")
+	bool bWriteAlpha = false;
+
+	/** Encoder threads (0 = logical cores minus two) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write", meta = (ClampMin = "0"))
+	int32 NumWorkers = 0;
+
+	/** Frames queued or encoding before the renderer waits (0 = twice the workers) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write", meta = (ClampMin = "0"))
+	int32 MaxQueuedFrames = 0;
+};
+
+/** Counters for one pool, summed over its workers. */
+struct FCDGImageWriteStats
+{
+	int32  NumWritten    = 0;
+	int32  NumFailed     = 0;
+	int64  RawBytes      = 0;
+	int64  FileBytes     = 0;
+	/** Worker time, summed over threads */
+	double EncodeSeconds = 0.0;
+	double WriteSeconds  = 0.0;
+	/** Time Enqueue() spent waiting for a free slot */
+	double StallSeconds  = 0.0;
+
+	/** "<n> frame(s), <MB> MB (<x> % of raw): <s> s encoding, <s> s writing, <s> s stalled (<k> failed)" */
+	FString ToString() const;
+};
+
+class CAMERADATASETGENEDITOR_API FCDGImageWritePool
+{
+public:
+	explicit FCDGImageWritePool(const FCDGImageWriteSettings& InSettings);
+	~FCDGImageWritePool();
+
+	FCDGImageWritePool(const FCDGImageWritePool&) = delete;
+	FCDGImageWritePool& operator=(const FCDGImageWritePool&) = delete;
+
+	/**
+	 * Queue one BGRA8 frame (FColor layout, Size.X * Size.Y * 4 bytes) for
+	 * Filename; the extension is added here.  Blocks while the queue is full.
+	 */
+	void Enqueue(const FString& FilenameNoExt, FIntPoint Size, TArray64<uint8>&& BGRA);
+
+	/** Block until every queued frame is written. */
+	void Flush();
+
+	bool IsIdle() const { return InFlight.load() == 0; }
+
+	int32 GetNumWorkers() const { return NumWorkers; }
+	int32 GetMaxQueuedFrames() const { return MaxQueued; }
+	FCDGImageWriteStats GetStats() const;
+
+	/** "png", "qoi" or "bmp" */
+	static const TCHAR* GetExtension(ECDGImageCodec Codec);
+
+	/** Encode one BGRA8 frame into a complete file image.  False for Engine. */
+	static bool Encode(const FCDGImageWriteSettings& Settings, FIntPoint Size, const uint8* BGRA, TArray64<uint8>& Out);
+
+	static void EncodePNG(FIntPoint Size, const uint8* BGRA, bool bAlpha, int32 Level, ECDGPNGFilter Filter, TArray64<uint8>& Out);
+	static void EncodeQOI(FIntPoint Size, const uint8* BGRA, bool bAlpha, TArray64<uint8>& Out);
+	static void EncodeBMP(FIntPoint Size, const uint8* BGRA, bool bAlpha, TArray64<uint8>& Out);
+
+private:
+	class FWriteWork;
+
+	/** Worker side: encode, write, count, free the slot. */
+	void Process(const FString& Filename, FIntPoint Size, const TArray64<uint8>& BGRA);
+
+	FCDGImageWriteSettings Settings;
+	int32 NumWorkers = 1;
+	int32 MaxQueued  = 2;
+
+	FQueuedThreadPool* Workers   = nullptr;
+	FEvent*            SlotFreed = nullptr;
+	std::atomic<int32> InFlight { 0 };
+
+	mutable FCriticalSection StatsLock;
+	FCDGImageWriteStats      Stats;
+};
@@ -3,12 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MRQInterface/CDGImageWritePool.h"
 #include "CDGMRQInterface.generated.h"
 
 class ACDGTrajectory;
 class ULevelSequence;
 class UMoviePipelineQueue;
 class UMoviePipelineExecutorJob;
+struct FCDGExpectedOutput;
+struct FCDGValidationResult;
 
 /**
  * Output format options for trajectory rendering
@@ -38,6 +41,66 @@ enum class ECDGRenderOutputFormat : uint8
 	FinalCutProXML UMETA(DisplayName = "Final Cut Pro XML")
 };
 
+/**
+ * Where rendered frames go instead of image files (see ICDGFrameSink)
+ */
+UENUM(BlueprintType)
+enum class ECDGFrameSinkKind : uint8
+{
+	/** Image files (and the command line encoder for video formats) */
+	None UMETA(DisplayName = "Image Files"),
+
+	/** Raw frames piped straight into FFmpeg, MP4 output */
+	EncoderPipe UMETA(DisplayName = "Encoder Pipe (MP4)"),
+
+	/** Uncompressed frames in chunked .raw files */
+	RawChunks UMETA(DisplayName = "Raw Chunks"),
+
+	/** 8-bit frames as YUV 4:2:0 in chunked .yuv files */
+	YUVChunks UMETA(DisplayName = "YUV 4:2:0 Chunks"),
+
+	/** 8-bit frames encoded as images, with per-frame metadata, in WebDataset tar shards */
+	TarShards UMETA(DisplayName = "WebDataset Tar Shards"),
+
+	/** Sink registered with SetCustomFrameSinkFactory() */
+	Custom UMETA(DisplayName = "Custom")
+};
+
+/**
+ * FFmpeg settings for video output (H.264 / command line encoder and the
+ * encoder pipe frame sink).  Only portable encoder options: no hardware
+ * encoders, so the same settings work on every machine.
+ */
+USTRUCT(BlueprintType)
+struct FCDGVideoEncodeSettings
+{
+	GENERATED_BODY()
+
+	/** FFmpeg executable, or a directory containing it.  Empty searches the bundled locations, then PATH */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+	FString EncoderPath;
+
+	/** Preferred video codec; falls back to libopenh264, then mpeg4 when the local FFmpeg lacks it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+	FString VideoCodec = TEXT("libx264");
+
+	/** Constant rate factor for libx264 / libx265 (0 lossless, 51 worst) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video", meta = (ClampMin = "0", ClampMax = "51"))
+	int32 CRF = 18;
+
+	/** x264 / x265 preset, ultrafast ... veryslow */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+	FString Preset = TEXT("slow");
+
+	/** Encoder threads (0 = FFmpeg decides) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video", meta = (ClampMin = "0"))
+	int32 Threads = 0;
+
+	/** Appended to the generated encoder arguments */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Video")
+	FString ExtraArgs;
+};
+
 /**
  * Configuration for rendering trajectories via Movie Render Queue
  */
@@ -87,6 +150,65 @@ struct FTrajectoryRenderConfig
 	/** Temporal sample count for motion blur */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quality")
 	int32 TemporalSampleCount = 1;
+
+	/**
+	 * Hand rendered frames to an in-process sink instead of writing image
+	 * files; ExportFormat is then ignored.  EncoderPipe needs FFmpeg and falls
+	 * back to ExportFormat without it.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
+	ECDGFrameSinkKind FrameSink = ECDGFrameSinkKind::None;
+
+	/** Frames per file for the raw / YUV chunk sinks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "1"))
+	int32 FramesPerChunk = 300;
+
+	/** Size cap of one tar shard for the tar shard sink, in MB; a level's shots share one shard set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = "1"))
+	int32 ShardSizeMB = 1024;
+
+	/**
+	 * Encoder for image sequence formats.  Anything but Engine writes PNG,
+	 * QOI or BMP through the plugin's worker pool instead of MRQ's writers
+	 * (ExportFormat then only decides image sequence vs. video).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
+	FCDGImageWriteSettings ImageWrite;
+
+	/** FFmpeg location and encoder options for video formats and the encoder pipe */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output")
+	FCDGVideoEncodeSettings VideoEncode;
+};
+
+/**
+ * One master sequence's shots inside a multi-sequence render
+ * (CDGMRQInterface::RenderTrajectoryBatch).
+ */
+struct FCDGRenderBatchEntry
+{
+	ULevelSequence*         MasterSequence = nullptr;
+	TArray<ACDGTrajectory*> Trajectories;
+	/** Output settings for this entry; LevelNameOverride picks its folder. */
+	FTrajectoryRenderConfig Config;
+};
+
+/** Per-entry progress callbacks for CDGMRQInterface::RenderTrajectoryBatch. */
+struct FCDGRenderBatchCallbacks
+{
+	/** Before the first shot of an entry starts (its PIE world is not created yet). */
+	TFunction<void(int32 /*EntryIdx*/)>                 OnEntryStarted;
+	/** After each shot (MRQ job) of an entry. */
+	TFunction<void(int32 /*EntryIdx*/)>                 OnShotRendered;
+	/**
+	 * Once per entry: after its last shot and the validation of its outputs,
+	 * or when it was rejected / never ran.  bSuccess is false when any shot's
+	 * output is missing or broken.
+	 */
+	TFunction<void(int32 /*EntryIdx*/, bool /*bSuccess*/)> OnEntryFinished;
+	/** Before OnEntryFinished, with the shots (trajectory names) whose output failed validation. */
+	TFunction<void(int32 /*EntryIdx*/, const TArray<FString>& /*FailedShots*/)> OnOutputsInvalid;
+	/** Once, when the executor finishes (entries still being validated finish after it). */
+	TFunction<void(bool /*bSuccess*/)>                  OnCompleted;
 };
 
 /**
@@ -148,7 +270,26 @@ namespace CDGMRQInterface
 		TFunction<void(bool)>  OnCompleted,
 		TFunction<void()>      OnShotRendered = nullptr);
 
+	/**
+	 * Render the shots of several master sequences as one MRQ queue in a single
+	 * executor session, so executor start-up and hand-over between sequences
+	 * are paid once instead of per sequence.  Jobs run in entry order.
+	 *
+	 * Returns false when nothing could be started; no callback fires then.
+	 * Otherwise OnEntryFinished fires exactly once per entry — immediately
+	 * (from inside this call) for entries that failed validation.
+	 */
+	CAMERADATASETGENEDITOR_API bool RenderTrajectoryBatch(
+		const TArray<FCDGRenderBatchEntry>& Entries,
+		FCDGRenderBatchCallbacks Callbacks);
+
 	// Helper functions
+	/**
+	 * True while a Movie Render Queue executor is active.  A new render request
+	 * is rejected until this returns false.
+	 */
+	CAMERADATASETGENEDITOR_API bool IsRenderInProgress();
+
 	namespace Internal
 	{
 		/**
@@ -156,9 +297,12 @@ namespace CDGMRQInterface
 		 * @param Trajectory - The trajectory to find sequence for
 		 * @param LevelName - Name of the level
 		 * @param OutSequence - The found sequence
+		 * @param MasterSequence - Master the shot was exported under; when null the
+		 *                         level sequence subsystem's active master is used
 		 * @return true if found
 		 */
-		bool FindExistingShotSequence(ACDGTrajectory* Trajectory, const FString& LevelName, ULevelSequence*& OutSequence);
+		bool FindExistingShotSequence(ACDGTrajectory* Trajectory, const FString& LevelName, ULevelSequence*& OutSequence,
+			const ULevelSequence* MasterSequence = nullptr);
 
 		/**
 		 * Validate that a shot sequence matches the trajectory
@@ -210,6 +354,13 @@ namespace CDGMRQInterface
 		 */
 		bool IsVideoFormat(ECDGRenderOutputFormat Format);
 
+		/**
+		 * Whether frames go through the plugin's image write pool rather than MRQ's writers
+		 * @param Config - Rendering configuration
+		 * @return true for an 8-bit image sequence (PNG / BMP) with a pool codec picked; EXR keeps MRQ's HDR writer
+		 */
+		bool UsesImageWritePool(const FTrajectoryRenderConfig& Config);
+
 		/**
 		 * Export Index.json for rendered trajectories
 		 * @param OutputDir - Directory where Index.json will be saved
@@ -219,6 +370,16 @@ namespace CDGMRQInterface
 		 */
 		bool ExportIndexJSON(const FString& OutputDir, const TArray<ACDGTrajectory*>& Trajectories, int32 FPS);
 
+		/**
+		 * Per-frame entries of a trajectory's index (the Frames array of Index.json),
+		 * one condensed JSON object per frame, tagged with level and trajectory name
+		 * @param Trajectory - Trajectory being rendered
+		 * @param FPS - Frames per second
+		 * @param LevelName - Output level name
+		 * @return One JSON string per frame, empty on failure
+		 */
+		TArray<FString> MakeFrameMetadata(ACDGTrajectory* Trajectory, int32 FPS, const FString& LevelName);
+
 		/**
 		 * Setup output directory structure
 		 * @param RootDir - Root output directory
@@ -228,17 +389,63 @@ namespace CDGMRQInterface
 		FString SetupOutputDirectory(const FString& RootDir, const FString& LevelName);
 
 		/**
-		 * Ensure FFmpeg is available (download if necessary)
-		 * @param OutFFmpegPath - Path to FFmpeg executable if found/downloaded
+		 * Find a local FFmpeg: ConfiguredPath first, then the bundled locations
+		 * for this platform, then every PATH entry.  A candidate counts only if
+		 * "ffmpeg -version" runs.  Never downloads anything.
+		 * @param OutFFmpegPath - Path to the FFmpeg executable if found
+		 * @param ConfiguredPath - Executable or directory to try first (optional)
 		 * @return true if FFmpeg is available, false otherwise
 		 */
-		bool EnsureFFmpegAvailable(FString& OutFFmpegPath);
+		bool EnsureFFmpegAvailable(FString& OutFFmpegPath, const FString& ConfiguredPath = FString());
+
+		/**
+		 * Pick the video codec FFmpeg can actually encode with
+		 * @param FFmpegPath - FFmpeg executable
+		 * @param Preferred - Codec to use when available
+		 * @return Preferred, else libx264, libopenh264 or mpeg4, whichever the build lists first
+		 */
+		FString PickVideoCodec(const FString& FFmpegPath, const FString& Preferred);
+
+		/**
+		 * Encoder quality arguments for a codec, e.g. "-crf 18 -preset slow -threads 8 -pix_fmt yuv420p -movflags +faststart"
+		 * @param Settings - Video encode settings
+		 * @param VideoCodec - Codec the arguments are for (CRF / preset only apply to libx264 / libx265)
+		 * @return Argument string
+		 */
+		FString MakeVideoEncodeArgs(const FCDGVideoEncodeSettings& Settings, const FString& VideoCodec);
+
+		/**
+		 * Output arguments for the encoder pipe frame sink: the picked codec and its quality arguments
+		 * @param FFmpegPath - FFmpeg executable the sink pipes into
+		 * @param Settings - Video encode settings
+		 * @return e.g. "-c:v libx264 -crf 18 -preset slow -pix_fmt yuv420p -movflags +faststart"
+		 */
+		FString MakeEncoderPipeArgs(const FString& FFmpegPath, const FCDGVideoEncodeSettings& Settings);
 		
 		/**
-		 * Validate that MP4 files were created successfully and clean up PNG frames
-		 * @param OutputDir - Directory containing rendered output
-		 * @return Number of PNG files cleaned up
+		 * Describe what a configured job will write, for CDGOutputValidator
+		 * @param ShotSequence - The shot being rendered (its playback range gives the frame count)
+		 * @param Trajectory - The trajectory being rendered
+		 * @param Config - Rendering configuration
+		 * @param LevelName - Name of the current level
+		 * @param OutExpected - Output file name, kind, size and frame count
+		 * @return false when the output cannot be checked (custom frame sink)
+		 */
+		bool MakeExpectedOutput(ULevelSequence* ShotSequence, ACDGTrajectory* Trajectory, const FTrajectoryRenderConfig& Config,
+			const FString& LevelName, FCDGExpectedOutput& OutExpected);
+
+		/**
+		 * Log the outcome of an output validation
+		 * @param Results - Validation results of the render's shots
+		 * @return true when every shot validated
+		 */
+		bool ReportInvalidOutputs(const TArray<FCDGValidationResult>& Results);
+
+		/**
+		 * Whether a job's frame sink failed to start, write or finish a stream
+		 * @param Job - Finished MRQ job
+		 * @return true when the job has a frame sink output that did not succeed
 		 */
-		int32 ValidateAndCleanupVideoOutput(const FString& OutputDir);
+		bool FrameSinkFailed(const UMoviePipelineExecutorJob* Job);
 	}
 }
@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoviePipelineOutputBase.h"
+#include "MRQInterface/CDGFrameSink.h"
+#include "CDGMoviePipelineFrameSinkOutput.generated.h"
+
+/**
+ * MRQ output that streams each shot's frames into an ICDGFrameSink instead
+ * of writing an image file per frame.  Only the first render pass is sent;
+ * the encoder pipe and YUV sinks take 8-bit frames, so float passes are
+ * quantized before they are handed over.
+ *
+ * Added by CDGMRQInterface::Internal::ConfigureMoviePipelineJob when
+ * FTrajectoryRenderConfig::FrameSink is set.
+ *
+ * A sink that cannot start, write or finish a stream fails the job: the
+ * pipeline is shut down with an error while frames are still coming in, and
+ * Succeeded() is checked when the job's work is reported finished.
+ */
+UCLASS(BlueprintType)
+class CAMERADATASETGENEDITOR_API UCDGMoviePipelineFrameSinkOutput : public UMoviePipelineOutputBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	ECDGFrameSinkKind SinkKind = ECDGFrameSinkKind::EncoderPipe;
+
+	/** Directory the sink writes into */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	FString OutputDirectory;
+
+	/** Output name without extension; later shots get ".shot<N>" appended */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	FString FileNameBase = TEXT("Frames");
+
+	/** Encoder executable for the encoder pipe (FFmpeg) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	FString EncoderPath;
+
+	/** Encoder output arguments, placed between the raw input and the output file; empty leaves the codec to the encoder */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	FString EncoderArgs;
+
+	/** Frames per file for the raw / YUV chunk sinks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink", meta = (ClampMin = "1"))
+	int32 FramesPerChunk = 300;
+
+	/** Tar shards: how frames are encoded (Engine picks PNG) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	FCDGImageWriteSettings ImageWrite;
+
+	/** Tar shards: size cap of one shard, in MB */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink", meta = (ClampMin = "1"))
+	int32 ShardSizeMB = 1024;
+
+	/** Tar shards: set shared with the other jobs writing into OutputDirectory under this name (closed by CloseTarShardSets); empty gives the job a set of its own */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Sink")
+	FString ShardSetName;
+
+	/** Tar shards: one JSON object per rendered frame (the trajectory index's Frames entries) */
+	UPROPERTY(Transient)
+	TArray<FString> FrameMetadata;
+
+	/** True when every stream so far ended complete; checked by CDGMRQInterface when the job finishes */
+	bool Succeeded() const { return !bAnyFailed; }
+
+protected:
+	virtual void OnReceiveImageDataImpl(FMoviePipelineMergerOutputFrame* InMergedOutputFrame) override;
+	virtual void OnShotFinishedImpl(const UMoviePipelineExecutorShot* InShot, const bool bFlushToDisk) override;
+	virtual void BeginFinalizeImpl() override;
+#if WITH_EDITOR
+	virtual FText GetDisplayText() const override { return NSLOCTEXT("CDGMoviePipeline", "FrameSinkDisplayName", "CDG Frame Sink"); }
+#endif
+
+private:
+	bool BeginStream(int32 ShotIndex, FIntPoint Size, ECDGFramePixelFormat Format);
+	void EndStream();
+	/** Log why the stream failed and shut the pipeline down with an error. */
+	void FailStream(const FString& Reason);
+
+	TUniquePtr<ICDGFrameSink> Sink;
+	int32 StreamShotIndex = INDEX_NONE;
+	int32 NumFrames       = 0;
+	bool  bStreamFailed   = false;
+	bool  bAnyFailed      = false;
+	bool  bShutdownRequested = false;
+};
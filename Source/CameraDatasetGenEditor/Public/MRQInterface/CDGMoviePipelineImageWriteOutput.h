@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoviePipelineOutputBase.h"
+#include "MRQInterface/CDGImageWritePool.h"
+#include "CDGMoviePipelineImageWriteOutput.generated.h"
+
+/**
+ * MRQ image sequence output backed by FCDGImageWritePool: frames of the
+ * first render pass are quantized to 8 bits and encoded on the pool's
+ * workers as <FileNameBase>.<frame>.<ext>.  When the pool is full the
+ * renderer waits for a free slot.
+ *
+ * Added by CDGMRQInterface::Internal::ConfigureMoviePipelineJob for image
+ * sequence formats when FTrajectoryRenderConfig::ImageWrite.Codec is not
+ * Engine.
+ */
+UCLASS(BlueprintType)
+class CAMERADATASETGENEDITOR_API UCDGMoviePipelineImageWriteOutput : public UMoviePipelineOutputBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write")
+	FCDGImageWriteSettings Settings;
+
+	/** Directory the frames are written into */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write")
+	FString OutputDirectory;
+
+	/** File name before the frame number, e.g. <LevelName>.<TrajectoryName> */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write")
+	FString FileNameBase = TEXT("Frame");
+
+	/** Digits the frame number is padded to (MRQ's default is 4) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Image Write", meta = (ClampMin = "1"))
+	int32 ZeroPadFrameNumbers = 4;
+
+protected:
+	virtual void OnReceiveImageDataImpl(FMoviePipelineMergerOutputFrame* InMergedOutputFrame) override;
+	virtual void OnShotFinishedImpl(const UMoviePipelineExecutorShot* InShot, const bool bFlushToDisk) override;
+	virtual void BeginFinalizeImpl() override;
+	virtual bool HasFinishedProcessingImpl() override;
+#if WITH_EDITOR
+	virtual FText GetDisplayText() const override { return NSLOCTEXT("CDGMoviePipeline", "ImageWriteDisplayName", "CDG Image Write Pool"); }
+#endif
+
+private:
+	TUniquePtr<FCDGImageWritePool> Pool;
+};
@@ -0,0 +1,143 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// CDGOutputValidator  —  checks rendered outputs from their file headers
+//
+// After a render every shot's output is compared with what the job was set up
+// to produce: the clip or each frame must exist, be non-empty, have the
+// render resolution and (within one frame) the shot's frame count.  Nothing
+// is decoded and no external tool is run; the probes read headers only:
+//   MP4   box tree: mvhd duration, the video trak's tkhd size, stsz/stts
+//         sample count, and a non-empty mdat; a box running past the end of
+//         the file means the clip is truncated
+//   PNG   IHDR size and the trailing IEND chunk
+//   BMP   size fields and the file size recorded in the header
+//   QOI   header size and the end marker
+//   EXR   dataWindow
+//   Tar   every ustar header checksum, members per key, image member headers
+//   Raw / YUV chunks: the .frames.json manifest against the chunk file sizes
+//
+// ValidateAsync() runs one task per shot on the thread pool and reports back
+// on the game thread.  Shots that fail are listed in
+// <OUTPUTS>/CDGValidation.json so they can be queued for a re-render.  A clip
+// that validates has its intermediate frames (<Base>.*.png) deleted on the
+// worker.
+//
+// The probes are pure functions of an archive, so sample files (or bytes in a
+// FMemoryReader) exercise them without a renderer or encoder; the
+// CameraDatasetGen.Validate automation tests do.  Console:
+//   CDG.Validate.Probe <File>     print what the header probes find
+//   CDG.Validate.Dir <OUTPUTS>    validate every output found in a directory
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** Header facts of one file. */
+struct FCDGMediaInfo
+{
+	/** "mp4", "png", "bmp", "qoi" or "exr" */
+	FString   Format;
+	FIntPoint Size = FIntPoint::ZeroValue;
+	/** Samples in the first video track; 1 for an image */
+	int32     NumFrames = 0;
+	double    DurationSeconds = 0.0;
+};
+
+enum class ECDGOutputKind : uint8
+{
+	/** <Base>.mp4 */
+	Video,
+	/** <Base>.<Frame>.<Extension> */
+	ImageSequence,
+	/** <Base>.frames.json plus its .raw / .yuv chunks */
+	Chunks,
+	/** <Base>.shards.json plus its tar shards, or one shot's samples in a shared set */
+	TarShards
+};
+
+/** What one shot was set up to produce. */
+struct FCDGExpectedOutput
+{
+	/** Name reported for a failed shot (the trajectory name) */
+	FString        ShotName;
+	/** The OUTPUTS directory */
+	FString        OutputDir;
+	/** "<Level>.<Trajectory>" */
+	FString        FileNameBase;
+	ECDGOutputKind Kind = ECDGOutputKind::ImageSequence;
+	/** Tar shards: the set the shot's samples went into, FileNameBase naming its stream; empty checks the whole <FileNameBase> set */
+	FString        ShardSetName;
+	/** Image sequences: file extension without the dot */
+	FString        Extension = TEXT("png");
+	/** 0 skips the size check */
+	FIntPoint      Size = FIntPoint::ZeroValue;
+	/** 0 skips the frame count check */
+	int32          NumFrames = 0;
+	/** Video: delete <Base>.*.png once the clip validates */
+	bool           bDeleteIntermediates = false;
+};
+
+struct FCDGValidationResult
+{
+	FString         ShotName;
+	FString         FileNameBase;
+	bool            bValid = false;
+	/** Frames found (video samples, images, chunk frames or tar samples) */
+	int32           NumFrames = 0;
+	FIntPoint       Size = FIntPoint::ZeroValue;
+	int32           NumFilesChecked = 0;
+	int32           NumIntermediatesDeleted = 0;
+	TArray<FString> Errors;
+};
+
+namespace CDGOutputValidator
+{
+	/** File name of the report written next to the outputs. */
+	CAMERADATASETGENEDITOR_API extern const TCHAR* ReportFileName;
+
+	/** Rendered frame counts may differ from the expected count by this much (tick rounding). */
+	constexpr int32 FrameCountTolerance = 1;
+
+	/**
+	 * Read an MP4 / MOV box tree
+	 * @param Ar - Archive positioned anywhere; the whole archive is the file
+	 * @param Out - Size, frame count and duration of the first video track
+	 * @param OutError - Why the file was rejected
+	 * @return true when the file has a moov with a video track and a non-empty mdat
+	 */
+	CAMERADATASETGENEDITOR_API bool ProbeMP4(FArchive& Ar, FCDGMediaInfo& Out, FString& OutError);
+
+	/**
+	 * Read a PNG, BMP, QOI or EXR header (detected from the magic bytes)
+	 * @param Ar - Archive holding the whole image file
+	 * @param Out - Format and size
+	 * @param OutError - Why the file was rejected
+	 * @return true when the header is valid and the file is not truncated
+	 */
+	CAMERADATASETGENEDITOR_API bool ProbeImage(FArchive& Ar, FCDGMediaInfo& Out, FString& OutError);
+
+	/** ProbeMP4 / ProbeImage on a file, picked by the file's magic bytes. */
+	CAMERADATASETGENEDITOR_API bool ProbeFile(const FString& Path, FCDGMediaInfo& Out, FString& OutError);
+
+	/** Check one shot's output; an invalid one is logged as an error.  Blocking file I/O; safe on any thread. */
+	CAMERADATASETGENEDITOR_API FCDGValidationResult ValidateOutput(const FCDGExpectedOutput& Expected);
+
+	/**
+	 * Validate shots on the thread pool, write the report into each OUTPUTS
+	 * directory, then call OnValidated on the game thread with one result per
+	 * expected output (same order).
+	 */
+	CAMERADATASETGENEDITOR_API void ValidateAsync(TArray<FCDGExpectedOutput> Expected,
+		TFunction<void(const TArray<FCDGValidationResult>&)> OnValidated);
+
+	/** Write <OutputDir>/CDGValidation.json for the results. */
+	CAMERADATASETGENEDITOR_API bool WriteReport(const FString& OutputDir, const TArray<FCDGValidationResult>& Results);
+
+	/** Names of the shots that failed, in result order. */
+	CAMERADATASETGENEDITOR_API TArray<FString> GetFailedShots(const TArray<FCDGValidationResult>& Results);
+
+	/** Outputs found in an OUTPUTS directory, with nothing expected of their size or length. */
+	CAMERADATASETGENEDITOR_API TArray<FCDGExpectedOutput> DiscoverOutputs(const FString& OutputDir);
+}
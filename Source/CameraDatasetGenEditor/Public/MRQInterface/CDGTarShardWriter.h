@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGTarShardWriter  —  samples into size-capped tar shards (WebDataset layout)
+//
+// Each sample is a key plus a few members that are stored back to back as
+// <key>.<ext> (e.g. <key>.png and <key>.json), which is how WebDataset
+// groups files into samples.  Shards are plain POSIX ustar archives named
+//   <Prefix>-000000.tar, <Prefix>-000001.tar, ...
+// and a new shard starts before a sample would push the current one past
+// MaxShardBytes (a sample is never split; an oversized sample gets a shard
+// of its own).  End() closes the last shard and writes <Prefix>.shards.json:
+//   { "Format": "webdataset", "MaxShardBytes", "Samples",
+//     "Shards": [ { "File", "Samples", "Bytes", "FirstKey", "LastKey" } ],
+//     "Streams": [ { "Name", "Samples", "Shards": [ <shard index> ] } ] }
+// Streams is only written when samples were grouped with BeginStream(), so
+// one set can hold several shots and still say which shards hold each.
+//
+// Keys may contain '/' but no '.', since WebDataset splits the key at the
+// first dot of the file name; MakeKey() builds a safe one.
+//
+// The CameraDatasetGen.TarShards.Ustar automation test writes a small shard
+// set and checks its ustar headers, padding and end blocks the way tar reads
+// them.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct FCDGTarMember
+{
+	/** Extension without the dot, e.g. "png" */
+	FString                  Extension;
+	TConstArrayView64<uint8> Data;
+};
+
+class CAMERADATASETGENEDITOR_API FCDGTarShardWriter
+{
+public:
+	static constexpr int64 DefaultMaxShardBytes = 1024ll * 1024 * 1024;
+
+	~FCDGTarShardWriter();
+
+	/** Start a shard set.  MaxShardBytes <= 0 picks DefaultMaxShardBytes. */
+	bool Begin(const FString& OutputDir, const FString& Prefix, int64 MaxShardBytes = DefaultMaxShardBytes);
+
+	/** List the samples written from now on under Name in the index's Streams. */
+	void BeginStream(const FString& Name);
+
+	/** Append one sample; false once a write has failed. */
+	bool WriteSample(const FString& Key, TConstArrayView<FCDGTarMember> Members);
+
+	/** Close the open shard and write the shard index. */
+	bool End();
+
+	/** Absolute paths of every shard so far, then the index once End() has run. */
+	TArray<FString> GetOutputFiles() const;
+
+	int32 GetNumSamples() const { return NumSamples; }
+	bool  IsOpen() const { return !OutputDir.IsEmpty() && !bIndexWritten; }
+
+	/** "<Base>_<Index>" with every character WebDataset would misread replaced by '_'. */
+	static FString MakeKey(const FString& Base, int32 Index);
+
+private:
+	struct FShard
+	{
+		FString File;
+		int32   Samples = 0;
+		int64   Bytes   = 0;
+		FString FirstKey;
+		FString LastKey;
+	};
+
+	struct FStream
+	{
+		FString       Name;
+		int32         Samples = 0;
+		TArray<int32> Shards;
+	};
+
+	bool OpenShard();
+	bool CloseShard();
+	bool WriteMember(const FString& Name, TConstArrayView64<uint8> Data);
+	bool WriteIndex() const;
+
+	/** Size in the archive: 512-byte header plus data padded to 512. */
+	static int64 GetMemberBytes(int64 DataBytes) { return 512 + Align(DataBytes, 512); }
+
+	FString OutputDir;
+	FString Prefix;
+	FString IndexPath;
+	int64   MaxShardBytes = DefaultMaxShardBytes;
+
+	TUniquePtr<FArchive> Archive;
+	TArray<FShard>       Shards;
+	TArray<FStream>      Streams;
+	int32                NumSamples = 0;
+	bool                 bFailed    = false;
+	bool                 bIndexWritten = false;
+};
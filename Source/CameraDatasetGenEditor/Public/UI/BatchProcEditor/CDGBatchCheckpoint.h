@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchCheckpoint  —  on-disk journal that lets a batch resume after a crash
+//
+// One JSON record per line, appended to <OutputDirectory>/CDGBatchCheckpoint.jsonl
+// on every state change; the last record of a combo wins:
+//   {"Version":2,"ComboKey":"Level_Anchor_Char_Anim","Seed":123456,
+//    "State":"Completed" | "InProgress" | "Failed" | "Crashed",
+//    "Timestamp":"2026-01-01T00:00:00.000Z",
+//    "Error":"<why it crashed + worker log tail>",                    (Crashed only)
+//    "Dir":"<ComboKey>",
+//    "Outputs":[ {"Group":"OUTPUTS/Level.Traj","Files":120,"Bytes":123456}, ... ]}
+//
+// Outputs are aggregated per clip / shot (files named "<Level>.<Trajectory>.*"
+// share a group), so a record stays small however many frames a shot has,
+// and a state change costs one short append rather than a manifest rewrite.
+// A line cut short by a crash is skipped on load, and so is a record of
+// another Version (with a warning; its combo runs again).  Load() rewrites the
+// journal with one record per combo (temp file + rename) once superseded
+// records pile up.  Paths are relative to the journal directory.
+//
+// "Crashed" is written by the batch supervisor (-Supervise) for the combo a
+// worker was on when it died or hung; resumed runs skip those combos instead
+// of crashing on them again.
+// ─────────────────────────────────────────────────────────────────────────────
+
+enum class ECDGComboState : uint8
+{
+	InProgress,
+	Completed,
+	Failed,
+	Crashed
+};
+
+/** Files of one clip / shot under a combo's output directory. */
+struct FCDGComboOutputGroup
+{
+	/** "<SubDir>/<Level>.<Trajectory>", relative to the combo directory */
+	FString Group;
+	int32   NumFiles = 0;
+	int64   Bytes    = 0;
+
+	bool operator==(const FCDGComboOutputGroup& Other) const
+	{
+		return Group == Other.Group && NumFiles == Other.NumFiles && Bytes == Other.Bytes;
+	}
+};
+
+struct FCDGComboCheckpointEntry
+{
+	FString                      ComboKey;
+	int32                        Seed  = 0;
+	ECDGComboState               State = ECDGComboState::InProgress;
+	FDateTime                    Timestamp;
+	/** Combo output directory, relative to the journal directory */
+	FString                      OutputDir;
+	/** Sorted by Group */
+	TArray<FCDGComboOutputGroup> Outputs;
+	FString                      Error;
+};
+
+class CAMERADATASETGENEDITOR_API FCDGBatchCheckpoint
+{
+public:
+	/** File name of the journal inside the batch output directory. */
+	static const TCHAR* ManifestFileName;
+
+	/**
+	 * Bind the checkpoint to RootOutputDir and read any existing journal.
+	 * Returns the number of combos loaded (0 for a fresh run).
+	 */
+	int32 Load(const FString& RootOutputDir);
+
+	/** Atomically rewrite the journal with one record per combo (temp file + rename). */
+	bool Compact() const;
+
+	/** Record that ComboKey has started with the given seed. */
+	void MarkInProgress(const FString& ComboKey, int32 Seed);
+
+	/**
+	 * Record the outcome of ComboKey.  On success the files under
+	 * ComboOutputDir are summed per clip / shot so a later run can validate them.
+	 */
+	void MarkFinished(const FString& ComboKey, int32 Seed, bool bSuccess, const FString& ComboOutputDir);
+
+	/**
+	 * True when ComboKey was completed by a previous run and its output
+	 * directory still holds the recorded file count and bytes for every group.
+	 */
+	bool IsComboComplete(const FString& ComboKey) const;
+
+	/** Record that a worker crashed or hung on ComboKey, with the reason. */
+	void MarkCrashed(const FString& ComboKey, const FString& Error);
+
+	/** True when a supervisor recorded ComboKey as having taken a worker down. */
+	bool IsComboCrashed(const FString& ComboKey) const;
+
+	/** Entry for ComboKey, or nullptr. */
+	const FCDGComboCheckpointEntry* Find(const FString& ComboKey) const { return Entries.Find(ComboKey); }
+
+	bool IsBound() const { return !ManifestPath.IsEmpty(); }
+	const FString& GetManifestPath() const { return ManifestPath; }
+
+	static const TCHAR* StateToString(ECDGComboState State);
+	static ECDGComboState StateFromString(const FString& In);
+
+	/** Sum the files under AbsDir per clip / shot, sorted by group. */
+	static TArray<FCDGComboOutputGroup> SummarizeOutputs(const FString& AbsDir);
+
+private:
+	/** Append Entry as one journal line. */
+	bool Append(const FCDGComboCheckpointEntry& Entry) const;
+
+	FString ManifestPath;
+	FString RootDir;
+	TMap<FString, FCDGComboCheckpointEntry> Entries;
+};
@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Config/BatchProcConfig.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchComboSampler  —  picks a subset of the batch's combinations
+//
+// Anchor counts are only known once a level is loaded, so sampling is done a
+// level at a time: the budget is split evenly over the levels up front, and
+// SampleLevel() draws that level's share once its anchors are discovered.
+// Only the selected combos are ever stored — O(budget), never the product.
+//
+// Within a level, with A anchors, C characters and N animations:
+//   Uniform         share drawn without replacement from all A·C·N combos
+//   Stratified      share split evenly over the stratum's values (anchors
+//                   for Level, else characters or animations); remainders
+//                   rotate with the level so totals even out across levels
+//   LatinHypercube  each axis cut into <share> equal strata, permuted
+//                   independently, so every anchor / character / animation
+//                   is used a near-equal number of times
+//
+// Every level draws from its own FRandomStream seeded with Seed and the
+// level's package name, so the same combos come out regardless of level order,
+// resumes or which shard worker asks.  Samples are returned sorted by
+// (character, animation, anchor) to keep asset reuse between combos.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class CAMERADATASETGENEDITOR_API FCDGBatchComboSampler
+{
+public:
+	/** LevelPackages in the batch's configured order (fixes each level's share). */
+	void Configure(const FCDGComboSamplingSettings& InSettings, const TArray<FName>& LevelPackages,
+	               int32 InNumCharacters, int32 InNumAnimations);
+
+	bool IsExhaustive() const { return Settings.Mode == ECDGComboSampling::Exhaustive; }
+
+	/** Combos LevelPackage may contribute (before capping at its product size). */
+	int32 GetLevelBudget(FName LevelPackage) const;
+
+	/** Upper bound on the number of combos across all levels. */
+	int64 GetTotalBudget() const;
+
+	/** Selected (Anchor, Character, Animation) indices for one level. */
+	TArray<FIntVector> SampleLevel(FName LevelPackage, int32 NumAnchors) const;
+
+	/** Short description for logs, e.g. "stratified by character, budget 500, seed 7". */
+	FString Describe() const;
+
+private:
+	FCDGComboSamplingSettings Settings;
+	TMap<FName, int32>        LevelOrder;
+	int32                     NumCharacters = 0;
+	int32                     NumAnimations = 0;
+};
@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchHeartbeat  —  liveness file a batch worker keeps fresh
+//
+// <OutputDirectory>/CDGBatchHeartbeat.json:
+//   {
+//     "Pid": 1234,
+//     "Utc": "2026-01-01T00:00:00.000Z",
+//     "Stage": "Preparing" | "Rendering" | "LoadingLevel" | "Idle" | "Finished",
+//     "Subject": "<ComboKey, or level package while loading>",
+//     "Completed": 12, "Total": 40
+//   }
+//
+// The service rewrites it (temp file + rename) whenever the stage or subject
+// changes and at least every UCDGBatchProcExecService::HeartbeatInterval
+// seconds while the game thread is alive.  The batch supervisor reads it to
+// spot hung workers and to tell which combo a dead worker was on.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct CAMERADATASETGENEDITOR_API FCDGBatchHeartbeat
+{
+	static const TCHAR* FileName;
+
+	uint32    Pid = 0;
+	FDateTime Utc;
+	FString   Stage;
+	FString   Subject;
+	int32     Completed = 0;
+	int32     Total     = 0;
+
+	/** True when Stage names a combo (Subject is a ComboKey). */
+	bool IsOnCombo() const;
+
+	bool Write(const FString& Dir) const;
+
+	/** False when there is no readable heartbeat in Dir. */
+	static bool Read(const FString& Dir, FCDGBatchHeartbeat& Out);
+};
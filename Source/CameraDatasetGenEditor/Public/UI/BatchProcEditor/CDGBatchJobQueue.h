@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchJobQueue  —  file-based job list shared by sharded batch workers
+//
+// Lets several editor processes on one host split a batch between them with
+// nothing but a directory:
+//
+//   <JobDir>/
+//     pending/<ComboKey>.json                 one file per combo (FCDGBatchJob)
+//     claimed/<ComboKey>@<WorkerId>.json      moved here by the claiming worker
+//     done/<ComboKey>@<WorkerId>.json
+//     failed/<ComboKey>@<WorkerId>.json
+//     shards/<WorkerId>/<ComboKey>/...        per-worker output directory
+//     DatasetIndex.json                       written by the merge step
+//
+// A claim is a rename out of pending/.  rename() is atomic on a single
+// filesystem, so exactly one worker wins each job; the losers' rename fails
+// because the source is already gone.  JobDir must therefore not span
+// filesystems (no copy fallback).
+// ─────────────────────────────────────────────────────────────────────────────
+
+/** One combo to execute, by asset path. */
+struct FCDGBatchJob
+{
+	FString ComboKey;
+	FString Level;      // UWorld package name
+	FString Anchor;     // ACDGLevelSceneAnchor label
+	FString Character;  // character Blueprint object path
+	FString Animation;  // animation object path
+};
+
+class CAMERADATASETGENEDITOR_API FCDGBatchJobQueue
+{
+public:
+	static const TCHAR* PendingDir;
+	static const TCHAR* ClaimedDir;
+	static const TCHAR* DoneDir;
+	static const TCHAR* FailedDir;
+	static const TCHAR* ShardsDir;
+	static const TCHAR* MergedIndexFileName;
+
+	explicit FCDGBatchJobQueue(const FString& InJobDir);
+
+	/** Create the state sub-directories.  Returns false if JobDir is unusable. */
+	bool Initialise() const;
+
+	/**
+	 * Write Job to pending/ unless its combo is already known in any state
+	 * (re-planning an existing job dir only adds new combos).
+	 */
+	bool AddJob(const FCDGBatchJob& Job) const;
+
+	/**
+	 * Atomically claim ComboKey for WorkerId.  False when not pending any more.
+	 * Either way the combo leaves this process's pending-per-level counts.
+	 */
+	bool TryClaim(const FString& ComboKey, const FString& WorkerId) const;
+
+	/** Move WorkerId's claim on ComboKey to done/ or failed/. */
+	void MarkFinished(const FString& ComboKey, const FString& WorkerId, bool bSuccess) const;
+
+	/**
+	 * Return claims to pending/ — those of WorkerId only, or every claim when
+	 * WorkerId is empty.  Used when a worker restarts after a crash.
+	 */
+	int32 RequeueClaims(const FString& WorkerId = FString()) const;
+
+	/**
+	 * True when at least one pending job targets LevelPackage.  pending/ is
+	 * read once on the first call and the counts are then kept up to date by
+	 * TryClaim (AddJob and RequeueClaims drop them for a re-read), so other
+	 * workers' claims only show up as failed TryClaim calls.  Game thread only.
+	 */
+	bool HasPendingJobsForLevel(const FString& LevelPackage) const;
+
+	/** Number of job files in one of the state directories (PendingDir, ...). */
+	int32 Count(const TCHAR* StateDir) const;
+
+	/** Output directory for WorkerId's shard. */
+	FString GetShardDir(const FString& WorkerId) const;
+
+	/**
+	 * Merge every finished combo across all shards into one
+	 * <JobDir>/DatasetIndex.json listing each combo's shard, index JSON and
+	 * OUTPUTS folder (paths relative to JobDir).
+	 */
+	bool WriteMergedIndex(int32& OutNumCombos) const;
+
+	const FString& GetJobDir() const { return JobDir; }
+
+	static bool ReadJob(const FString& FilePath, FCDGBatchJob& OutJob);
+	static bool WriteJob(const FString& FilePath, const FCDGBatchJob& Job);
+
+private:
+	FString StatePath(const TCHAR* StateDir, const FString& FileName) const;
+
+	/** Split "<ComboKey>@<WorkerId>.json" into its parts. */
+	static bool ParseClaimFileName(const FString& FileName, FString& OutComboKey, FString& OutWorkerId);
+
+	/** Read every pending job once into PendingLevels / NumPendingPerLevel. */
+	void CachePendingLevels() const;
+
+	FString JobDir;
+
+	/** ComboKey → level of the jobs pending when the cache was built, minus those claimed since */
+	mutable TMap<FString, FString> PendingLevels;
+	mutable TMap<FString, int32>   NumPendingPerLevel;
+	mutable bool                   bPendingLevelsCached = false;
+};
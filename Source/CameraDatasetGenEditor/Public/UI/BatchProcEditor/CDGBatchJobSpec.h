@@ -0,0 +1,47 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UI/BatchProcEditor/CDGBatchJobQueue.h"
+
+class FJsonObject;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchJobSpec  —  one combo, self-contained, for external schedulers
+//
+// <SpecDir>/<ComboKey>.json:
+//   {
+//     "Version":   1,
+//     "ComboKey":  "...", "Level": "/Game/Maps/L1", "Anchor": "Anchor_0",
+//     "Character": "/Game/Chars/BP_A.BP_A", "Animation": "/Game/Anims/Walk.Walk",
+//     "BaseSeed":  0,
+//     "Seed":      123456789,           (resolved combo seed, pinned on replay)
+//     "Generators": { "positioning": [...], "movement": [...], "effects": [...] },
+//     "Exporter":   { ...ULevelSeqExportConfig properties... }
+//   }
+//
+// Unlike queue job files (which only name the combo and rely on the worker's
+// own batch config), a spec carries everything needed to reproduce the combo,
+// so any machine that can see the project and the spec can run or re-run it.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct CAMERADATASETGENEDITOR_API FCDGBatchJobSpec
+{
+	static constexpr int32 Version = 1;
+
+	FCDGBatchJob Job;
+	int32        BaseSeed = 0;
+	int32        Seed     = 0;
+
+	/** UGeneratorStackConfig::GeneratorsJson */
+	FString GeneratorsJson;
+
+	/** ULevelSeqExportConfig properties (FJsonObjectConverter layout). */
+	TSharedPtr<FJsonObject> Exporter;
+
+	bool Write(const FString& FilePath) const;
+
+	/** False when the file is missing, malformed or from a newer version. */
+	static bool Read(const FString& FilePath, FCDGBatchJobSpec& Out);
+};
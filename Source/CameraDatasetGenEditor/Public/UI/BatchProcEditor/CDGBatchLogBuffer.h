@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchLogBuffer  —  bounded batch log for the UI, full log on disk
+//
+// Every line goes two ways:
+//   • appended to <OutputDir>/CDGBatchLog_<yyyymmdd_hhmmss>.log (complete,
+//     flushed every FlushEveryLines lines and on End());
+//   • written into a fixed ring of Capacity slots that viewers poll with
+//     ReadSince().  Memory and per-line cost never grow with run length;
+//     lines a slow viewer missed are counted, not queued.
+//
+// Single producer, any number of readers, no locks: each slot carries the
+// sequence number of the line it holds and is re-validated after copying, so
+// a reader racing the producer drops the overwritten line instead of reading
+// a torn one.  Ring lines are truncated to MaxLineChars; the file is not.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class CAMERADATASETGENEDITOR_API FCDGBatchLogBuffer
+{
+public:
+	static constexpr int32 Capacity        = 2048;   // power of two
+	static constexpr int32 MaxLineChars    = 255;
+	static constexpr int32 FlushEveryLines = 64;
+
+	FCDGBatchLogBuffer();
+	~FCDGBatchLogBuffer();
+
+	FCDGBatchLogBuffer(const FCDGBatchLogBuffer&) = delete;
+	FCDGBatchLogBuffer& operator=(const FCDGBatchLogBuffer&) = delete;
+
+	/** Open a fresh log file in OutputDir.  The ring keeps its sequence numbers. */
+	void Begin(const FString& OutputDir);
+
+	/** Append one line (producer thread only — the game thread). */
+	void Append(const FString& Line);
+
+	/** Flush and close the log file. */
+	void End();
+
+	/** Sequence number the next appended line will get. */
+	uint64 GetNextSeq() const { return NextSeq.load(std::memory_order_acquire); }
+
+	/**
+	 * Append every line with sequence >= FromSeq still in the ring to OutLines.
+	 * OutMissed counts lines overwritten before they could be read.  Returns
+	 * the sequence to pass next time.
+	 */
+	uint64 ReadSince(uint64 FromSeq, TArray<FString>& OutLines, int32& OutMissed) const;
+
+	const FString& GetFilePath() const { return FilePath; }
+
+private:
+	struct FSlot
+	{
+		std::atomic<uint64> Seq { MAX_uint64 };
+		int32               Len = 0;
+		TCHAR               Text[MaxLineChars];
+	};
+
+	TUniquePtr<FSlot[]>  Slots;
+	std::atomic<uint64>  NextSeq { 0 };
+
+	TUniquePtr<FArchive> File;
+	FString              FilePath;
+	int32                LinesSinceFlush = 0;
+};
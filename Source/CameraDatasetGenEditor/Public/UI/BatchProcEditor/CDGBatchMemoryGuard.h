@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UWorld;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchMemoryGuard  —  keeps long batch runs on a memory plateau
+//
+// After each combo is torn down the service hands over weak pointers to
+// everything that combo created.  The guard samples process memory and, once
+// used physical memory crosses the watermark, asks for a full garbage
+// collection at the next safe point (CollectIfRequested, called from the top
+// of the pipeline tick where no raw UObject pointers are held).
+//
+// Leak detection:
+//   • After every collection, any released object that still resolves —
+//     even as garbage — is reported together with one referencer chain.
+//   • AuditWorld() counts leftovers that no live combo owns: CDG trajectory,
+//     keyframe and camera actors, batch sequences and rooted generators.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class CAMERADATASETGENEDITOR_API FCDGBatchMemoryGuard
+{
+public:
+	/** WatermarkMB <= 0 picks 60 % of physical memory. */
+	void Begin(int32 WatermarkMB, TFunction<void(const FString&)> InLog);
+
+	/** Record what ComboKey's cleanup released and sample memory. */
+	void OnComboReleased(const FString& ComboKey, const TArray<TWeakObjectPtr<UObject>>& Released);
+
+	/** Run the collection requested by OnComboReleased, if any. */
+	void CollectIfRequested();
+
+	/** Unconditional full collection plus survivor check. */
+	void Collect();
+
+	/**
+	 * Report CDG objects in World that no combo in LiveObjects owns.  Rooted
+	 * generators are only reported: the generator editor window roots its
+	 * own instances too.  Returns the number of leftovers found.
+	 */
+	int32 AuditWorld(UWorld* World, const TSet<const UObject*>& LiveObjects, bool bIncludeAssetSequences);
+
+	/** Baseline / peak / final memory, collections and growth trend. */
+	TArray<FString> Summary() const;
+
+	static uint64 GetUsedBytes();
+
+private:
+	void CheckSurvivors();
+	void Emit(const FString& Message) const;
+
+	TFunction<void(const FString&)> Log;
+
+	uint64 WatermarkBytes = 0;
+	uint64 BaselineBytes  = 0;
+	uint64 PeakBytes      = 0;
+	bool   bCollectRequested = false;
+
+	int32  NumCollections     = 0;
+	double CollectionSeconds  = 0.0;
+	int32  NumSurvivors       = 0;
+
+	/** Used memory after each combo (post-collection when one ran). */
+	TArray<uint64> ComboSamples;
+
+	/** Released since the last collection, with the combo that owned them. */
+	TArray<TPair<FString, TWeakObjectPtr<UObject>>> AwaitingCollection;
+};
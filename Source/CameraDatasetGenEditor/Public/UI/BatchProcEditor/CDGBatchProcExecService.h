@@ -5,6 +5,16 @@
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
 #include "AssetRegistry/AssetData.h"
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "UI/BatchProcEditor/CDGBatchCheckpoint.h"
+#include "UI/BatchProcEditor/CDGBatchTelemetry.h"
+#include "UI/BatchProcEditor/CDGBatchMemoryGuard.h"
+#include "UI/BatchProcEditor/CDGBatchComboSampler.h"
+#include "UI/BatchProcEditor/CDGBatchLogBuffer.h"
+#include "UI/BatchProcEditor/CDGBatchHeartbeat.h"
+#include "UI/BatchProcEditor/CDGBatchSaveQueue.h"
+#include "MRQInterface/CDGMRQInterface.h"
 #include "CDGBatchProcExecService.generated.h"
 
 class UGeneratorStackConfig;
@@ -16,6 +26,7 @@ class UCDGMovementGenerator;
 class UCDGEffectsGenerator;
 class ACDGLevelSceneAnchor;
 class ACDGTrajectory;
+class UBatchProcConfig;
 
 // ─────────────────────────────────────────────────────────────────────────────
 // FBatchDetailedProgress  —  per-dimension counters broadcast each combo step
@@ -41,6 +52,27 @@ struct FBatchDetailedProgress
 	int32 GlobalShotsTotal    = 0;
 };
 
+// ─────────────────────────────────────────────────────────────────────────────
+// FBatchPipelineStats  —  where the batch spent time not rendering
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct FBatchPipelineStats
+{
+	/** Gaps between one combo leaving the render slot and the next entering it. */
+	int32  NumRenderGaps       = 0;
+	double TotalGapSeconds     = 0.0;
+	double MaxGapSeconds       = 0.0;
+	/** Synchronous LoadMap time. */
+	double LevelLoadSeconds    = 0.0;
+	/** Time spent blocking on character / animation loads during prepare. */
+	double AssetLoadSeconds    = 0.0;
+	/** Combos whose character and animation were already resident. */
+	int32  PrefetchHits        = 0;
+	int32  PrefetchMisses      = 0;
+	/** Combos that got a pooled character actor instead of spawning one. */
+	int32  CharacterReuses     = 0;
+};
+
 // ─────────────────────────────────────────────────────────────────────────────
 // FBatchProcInput  —  everything the batch processor needs to run
 // ─────────────────────────────────────────────────────────────────────────────
@@ -62,6 +94,117 @@ struct FBatchProcInput
 
 	/** Export / render settings (FPS, resolution, format, output directory …) */
 	TWeakObjectPtr<ULevelSeqExportConfig> ExporterConfig;
+
+	/**
+	 * When false, each combo stops after generation, sequence export and the
+	 * index JSON — no MRQ render is started.  Lets the headless commandlet run
+	 * the batch on machines without a GPU (-nullrhi).
+	 */
+	bool bRenderOutputs = true;
+
+	/**
+	 * Skip combos that the checkpoint manifest in the output directory records
+	 * as completed and whose outputs still validate.  The manifest is written
+	 * either way.
+	 */
+	bool bResumeFromCheckpoint = true;
+
+	/** Mixed with each combo key to derive the per-combo random seed. */
+	int32 BaseSeed = 0;
+
+	/** Seeds pinned by job specs (ComboKey → seed); other combos derive theirs. */
+	TMap<FString, int32> PinnedComboSeeds;
+
+	/** Run a sampled subset of the combos instead of all of them. */
+	FCDGComboSamplingSettings Sampling;
+
+	/**
+	 * How many combos (within the loaded level) are generated and exported
+	 * ahead while the current one renders.  0 runs strictly one at a time.
+	 */
+	int32 PipelineLookAhead = 1;
+
+	/**
+	 * Render up to this many prepared combos as one MRQ queue in a single
+	 * executor session, so executor start-up and the hand-over between
+	 * combos are paid once per batch.  1 renders each combo on its own.
+	 */
+	int32 MaxCombosPerRender = 1;
+
+	/** Also close a batch once it holds this many frames (0 = no limit). */
+	int32 MaxFramesPerRender = 0;
+
+	/**
+	 * Renders per combo: shots whose output fails validation (missing,
+	 * truncated, wrong size or length) are queued for another render until
+	 * the combo has been rendered this many times.  1 never re-renders.
+	 */
+	int32 MaxRenderAttempts = 2;
+
+	/**
+	 * Run a full garbage collection between combos once used physical memory
+	 * exceeds this many MB.  0 uses 60 % of the machine's physical memory.
+	 */
+	int32 MemoryWatermarkMB = 0;
+
+	/**
+	 * Hooks for sharded multi-process runs (see FCDGBatchJobQueue).  When set,
+	 * a level is only opened if ShouldProcessLevel returns true, and a combo
+	 * only runs if ClaimCombo claims it for this process.
+	 */
+	TFunction<bool(const FAssetData& /*Level*/)> ShouldProcessLevel;
+	TFunction<bool(const FString& /*ComboKey*/)> ClaimCombo;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FBatchComboWork  —  one combo travelling through prepare → render → cleanup
+//
+// With look-ahead several combos are alive at once, so everything a combo
+// creates is recorded here instead of in service-wide members.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct FBatchComboWork
+{
+	// Loop position, for progress display
+	int32 AnchorIdx    = 0;
+	int32 CharacterIdx = 0;
+	int32 AnimIdx      = 0;
+
+	FString ComboKey;
+	/** <RootOutputDir>/<ComboKey> */
+	FString OutputDir;
+	int32   Seed = 0;
+	int32   FPS  = 30;
+	/**
+	 * True unless the exporter config keeps the exported sequences: ref,
+	 * master and shot sequences then live in unregistered in-memory packages
+	 * and are left to GC, instead of being saved to and deleted from
+	 * /Game/CDGBatch_Temp.
+	 */
+	bool    bTransientSequences = true;
+
+	TWeakObjectPtr<AActor>                 Character;
+	TWeakObjectPtr<ULevelSequence>         RefSequence;
+	TWeakObjectPtr<ULevelSequence>         MasterSequence;
+	TArray<TWeakObjectPtr<ACDGTrajectory>> Trajectories;
+	TArray<TWeakObjectPtr<AActor>>         Cameras;
+	/** Shot package names, deleted during cleanup. */
+	TArray<FString>                        ShotSequencePaths;
+
+	/** Frames across all shots, counted against MaxFramesPerRender. */
+	int32 NumFrames     = 0;
+	int32 ShotsRendered = 0;
+	/** When MRQ reached this combo's first shot in the current render attempt; 0 until then. */
+	double RenderStartSeconds = 0.0;
+	/** Renders started for this combo, counted against MaxRenderAttempts. */
+	int32 RenderAttempts = 0;
+	/** Shots whose output failed validation; a re-render covers only these. */
+	TArray<FString> InvalidShots;
+	/** Save-queue ticket of the last kept sequence queued while preparing; the checkpoint record waits for it. */
+	int64 SaveTicket = 0;
+
+	/** Trajectories still alive, in generation order. */
+	TArray<ACDGTrajectory*> GetTrajectories() const;
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -69,23 +212,50 @@ struct FBatchProcInput
 //
 // Drives the nested batch loop:
 //
-//   FOR lv IN Levels:
+//   FOR lv IN Levels:                   ← the level already open goes first
 //     Open level lv
-//     FOR sc IN SceneAnchors:           ← discovered in lv
-//       FOR ch IN Characters:
-//         Spawn ch at ground-casted position within sc.DispersionRadius
-//         FOR anim IN Animations:
+//     FOR ch IN Characters:
+//       FOR anim IN Animations:
+//         FOR sc IN SceneAnchors:         ← discovered in lv
+//           Spawn ch at ground-casted position within sc.DispersionRadius
 //           Create reference level-seq  (ch animated by anim, duration = anim)
 //           Instantiate generators from config; set refSeq + ch actor
 //           Run generator stack → ACDGTrajectory actors
 //           Export trajectories to shot sequences (ch animation in each shot)
 //           Render via MRQ → <OutputDir>/<ComboKey>/OUTPUTS/
 //           Write  <OutputDir>/<ComboKey>/<ComboKey>.json
-//           Clear all trajectory actors and level sequences
-//         Destroy ch actor
+//           Record combo in <OutputDir>/CDGBatchCheckpoint.jsonl
+//           Delete the combo's actors and level sequences (the character
+//           actor is pooled per level and reused by later combos)
+//
+// Within a level the combos are pipelined (TickPipeline): while MRQ renders
+// combo N, up to Input.PipelineLookAhead following combos are prepared (spawn
+// → generate → export), one per tick.  With Input.MaxCombosPerRender > 1
+// several prepared combos are rendered as one MRQ queue, and each combo's
+// character is revealed as MRQ reaches its first shot.  Prepared characters stay hidden in
+// game and non-colliding until their own render starts, so they never show
+// up in another combo's PIE session.  Finished combos are torn down one per
+// tick after their render completes.
+//
+// With Input.Sampling set, only the combos FCDGBatchComboSampler selects for
+// each level are run, in the same loop order.
+//
+// Anchors are the innermost loop so consecutive combos share a character and
+// animation.  While a level runs, the next level's hard dependencies and the
+// next (character, animation) pair are streamed in asynchronously through an
+// FStreamableManager, so neither LoadMap nor the prepare step has to block on
+// them.  Time MRQ sits idle between combos is collected in FBatchPipelineStats.
+//
+// Every stage of every combo is timed through FCDGBatchTelemetry
+// (CDGBatchTiming_*.csv next to the checkpoint, plus Insights scopes); the
+// per-stage percentiles are logged when the batch finishes.
 //
 // Output file structure:
 //   ExporterConfig.OutputDirectory/
+//     CDGBatchCheckpoint.jsonl           (resume journal, see FCDGBatchCheckpoint)
+//     CDGBatchTiming_<utc>.csv           (per-stage timings, see FCDGBatchTelemetry)
+//     CDGBatchLog_<utc>.log              (full batch log, see FCDGBatchLogBuffer)
+//     CDGBatchHeartbeat.json             (liveness for the supervisor, see FCDGBatchHeartbeat)
 //     {Level}_{Anchor}_{Character}_{Anim}/
 //       {Level}_{Anchor}_{Character}_{Anim}.json
 //       OUTPUTS/
@@ -107,6 +277,32 @@ public:
 	 */
 	static UCDGBatchProcExecService* Create(UObject* Outer, const FBatchProcInput& Input);
 
+	/**
+	 * Resolve a UBatchProcConfig asset's soft paths through the asset registry
+	 * into an FBatchProcInput.  Unresolvable entries are skipped with a warning.
+	 * Returns false when the config lacks levels, characters, animations or a
+	 * generator config.
+	 */
+	static bool BuildInputFromConfig(const UBatchProcConfig* Config, FBatchProcInput& OutInput);
+
+	/**
+	 * The key a combo is known by everywhere (output folder, checkpoint, job
+	 * files): <Level>_<Anchor>_<Character>_<Anim>, sanitised for file names.
+	 */
+	static FString ComposeComboKey(const FAssetData& Level,
+	                               const FString& AnchorLabel,
+	                               const FAssetData& Character,
+	                               const FAssetData& Animation);
+
+	/** Seed a combo gets from BaseSeed unless pinned in Input.PinnedComboSeeds. */
+	static int32 ComputeComboSeed(const FString& ComboKey, int32 BaseSeed);
+
+	/** Input.ExporterConfig's OutputDirectory, or Saved/BatchProcOutput when unset. */
+	static FString ResolveRootOutputDir(const FBatchProcInput& InInput);
+
+	/** Longest gap between heartbeat writes while the game thread is alive (s). */
+	static constexpr double HeartbeatInterval = 5.0;
+
 	/** Begin execution.  Must be called at most once per instance. */
 	void Start();
 
@@ -115,6 +311,18 @@ public:
 
 	bool IsRunning() const { return bIsRunning; }
 
+	const FBatchPipelineStats& GetPipelineStats() const { return Stats; }
+
+	/**
+	 * Bounded log ring for viewers to poll (the full log is streamed to
+	 * CDGBatchLog_*.log).  Cheaper than OnLogMessage for UIs: they read at
+	 * their own rate instead of reacting to every line.
+	 */
+	const FCDGBatchLogBuffer& GetLogBuffer() const { return LogBuffer; }
+
+	/** Latest detailed progress with the current combo counters filled in. */
+	FBatchDetailedProgress GetProgressSnapshot() const;
+
 	// ── Progress / completion delegates ──────────────────────────────────────
 
 	/** Fired whenever a combo starts: (completedCombos, totalCombos) */
@@ -137,6 +345,13 @@ public:
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnDetailedProgressUpdated, const FBatchDetailedProgress&);
 	FOnDetailedProgressUpdated OnDetailedProgressUpdated;
 
+	/**
+	 * Fired once per combo this process took on, after its outcome is final
+	 * (rendered, failed, or skipped because the checkpoint already had it).
+	 */
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnComboFinished, const FString& /*ComboKey*/, bool /*bSuccess*/);
+	FOnComboFinished OnComboFinished;
+
 private:
 	// ── Input / state ────────────────────────────────────────────────────────
 
@@ -154,12 +369,27 @@ private:
 	int32 CurrentCharacterIdx = 0;
 	int32 CurrentAnimIdx      = 0;
 
-	// Per-combo live objects (cleared after each combo)
-	TWeakObjectPtr<AActor>         SpawnedCharacter;
-	TWeakObjectPtr<ULevelSequence> CurrentRefSequence;
-	TArray<FString>                CreatedShotSequencePaths; // collected during export, deleted afterwards
-
-	// Generator instances re-created for each level (world must be the outer)
+	// Character actors of the current level, by Input.Characters index.  One
+	// actor per combo in flight; released ones are reset and handed to the
+	// next combo with the same character instead of being destroyed.
+	TMap<int32, TArray<TWeakObjectPtr<AActor>>> IdleCharacters;
+	TArray<TWeakObjectPtr<AActor>>              PooledCharacters;
+
+	// Sampled runs: the current level's selected combos, walked in order
+	FCDGBatchComboSampler Sampler;
+	TArray<FIntVector>    LevelSamples;   // (Anchor, Character, Animation)
+	int32                 LevelSampleIdx = 0;
+
+	// Combo pipeline for the current level
+	TArray<TSharedPtr<FBatchComboWork>> ReadyCombos;     // prepared, waiting for MRQ
+	TArray<TSharedPtr<FBatchComboWork>> RenderingCombos; // owned by the active MRQ render batch
+	TSharedPtr<FBatchComboWork>         OnScreenCombo;   // the batch entry MRQ is rendering now
+	TArray<TSharedPtr<FBatchComboWork>> CleanupQueue;    // rendered, awaiting teardown
+	TArray<TPair<TSharedPtr<FBatchComboWork>, bool>> AwaitingSaves; // finished, kept sequences still being written
+	bool                                bLevelCombosExhausted = false;
+	FTSTicker::FDelegateHandle          PipelineTickHandle;
+
+	// Generator instances re-created for each combo (world must be the outer)
 	// Separated by pipeline stage: Positioning → Movement → Effects
 	TArray<TObjectPtr<UCDGPositioningGenerator>> PositioningGenerators;
 	TArray<TObjectPtr<UCDGMovementGenerator>>    MovementGenerators;
@@ -173,30 +403,142 @@ private:
 	/** Cumulative shots whose MRQ render has completed. */
 	int32 TotalShotsRendered = 0;
 
+	// Resume support
+	FCDGBatchCheckpoint Checkpoint;
+	int32 SkippedCombos = 0;
+
+	// Prefetching and stall tracking
+	FStreamableManager            Streamable;
+	TSharedPtr<FStreamableHandle> LevelPrefetchHandle;   // next level's dependencies
+	TSharedPtr<FStreamableHandle> AssetPrefetchHandle;   // current + next (character, animation)
+	FIntPoint                     PrefetchedPair = FIntPoint(INDEX_NONE, INDEX_NONE);
+	/** When the render slot last became free; 0 before the first combo. */
+	double                        RenderSlotFreeSince = 0.0;
+	FBatchPipelineStats           Stats;
+
+	// Per-stage timings (CSV + Insights scopes)
+	FCDGBatchTelemetry            Telemetry;
+
+	// Watermark-driven GC and leak reporting
+	FCDGBatchMemoryGuard          MemoryGuard;
+
+	// Liveness file for the batch supervisor
+	FCDGBatchHeartbeat            Heartbeat;
+
+	// Background writes of kept sequences (bKeepExportedLevelSequence)
+	FCDGBatchSaveQueue            SaveQueue;
+
+	// Log ring + log file, and the last progress broadcast, for polling viewers
+	FCDGBatchLogBuffer            LogBuffer;
+	FBatchDetailedProgress        LatestProgress;
+
 	// ── Top-level step machine ───────────────────────────────────────────────
 
 	void BeginProcessLevel();
 	void DiscoverAnchorsAndBeginCombos();
-	void BeginNextCombo();
-	void ExecuteCurrentCombo();
+
+	// ── Combo pipeline ───────────────────────────────────────────────────────
+
+	/** Register TickPipeline with the core ticker for the freshly loaded level. */
+	void StartLevelPipeline();
+
+	/**
+	 * One pipeline step per tick: tear down one finished combo, start the next
+	 * render when MRQ is idle, or prepare one more combo ahead.  Moves to the
+	 * next level once the current one is drained.  Returns false to unregister.
+	 */
+	bool TickPipeline(float DeltaTime);
+
+	/**
+	 * Spawn, generate and export the combo at the current indices.
+	 * Returns nullptr when the combo is skipped (checkpoint) or fails.
+	 */
+	TSharedPtr<FBatchComboWork> PrepareCurrentCombo(UWorld* World);
+
+	/** True once the ready combos reach Input.MaxFramesPerRender. */
+	bool IsRenderBatchFull() const;
+
+	/** Pop the next render batch off ReadyCombos (at least one combo). */
+	TArray<TSharedPtr<FBatchComboWork>> TakeRenderBatch();
+
+	/** Hand every combo in Batch to MRQ as one queue / executor session. */
+	void StartRenderBatch(const TArray<TSharedPtr<FBatchComboWork>>& Batch);
+
+	/**
+	 * Called as MRQ moves on to Combo's shots: hide the previous combo's
+	 * character and reveal this one before its PIE world is duplicated.
+	 */
+	void ShowComboOnScreen(const TSharedPtr<FBatchComboWork>& Combo);
+
+	/** Render settings for one combo, output under <RootDir>/<ComboKey>/. */
+	FTrajectoryRenderConfig MakeRenderConfig(const FBatchComboWork& Combo) const;
+
+	/**
+	 * Render finished (or export-only combo reached the render step): write
+	 * the index JSON, record the checkpoint, hide the character and queue the
+	 * combo for teardown.
+	 */
+	void FinishCombo(const TSharedPtr<FBatchComboWork>& Combo, bool bSuccess);
+
+	/**
+	 * Render finished but some shots failed output validation: put the combo
+	 * back at the front of ReadyCombos to re-render just those shots.
+	 * @return false when the combo is out of attempts (or nothing failed
+	 *         validation) and should be finished as failed
+	 */
+	bool RequeueInvalidShots(const TSharedPtr<FBatchComboWork>& Combo);
+
+	/** Checkpoint Combo's outcome and announce it (OnComboFinished). */
+	void RecordComboFinished(const TSharedPtr<FBatchComboWork>& Combo, bool bSuccess);
+
+	/** Record the AwaitingSaves combos whose sequences are on disk; fence the rest. */
+	void RecordSavedCombos();
+
+	/** Delete everything Combo created (timed), then flush its timing rows. */
+	void CleanupCombo(FBatchComboWork& Combo, UWorld* World);
+
+	/** Delete everything Combo created: actors, transient sequences, character. */
+	void CleanupComboObjects(FBatchComboWork& Combo, UWorld* World);
+	/** Report batch objects in World not owned by any combo still in flight. */
+	void AuditLeftovers(UWorld* World);
+
+	/** Clean up every queued combo immediately (cancel / abort / level change). */
+	void DrainPipeline(UWorld* World);
+
+	/**
+	 * Enable collision on Active's character only; every other live combo
+	 * character is made non-colliding so it can't affect traces or physics.
+	 */
+	void SetActiveCharacter(FBatchComboWork* Active);
 
 	// ── Per-combo steps ──────────────────────────────────────────────────────
 
-	/** Spawn character BP at a randomly ray-cast ground position within sc radius. */
+	/**
+	 * Place a character at a random point within the anchor's dispersion
+	 * radius — an idle pooled actor of Input.Characters[CharacterIdx] when
+	 * there is one, otherwise a freshly spawned CharacterClass.
+	 */
 	AActor* SpawnCharacterAtAnchor(UWorld* World,
 	                               ACDGLevelSceneAnchor* Anchor,
+	                               int32 CharacterIdx,
 	                               UClass* CharacterClass);
 
+	/** Hide a combo's character and return it to the pool. */
+	void ReleaseCharacter(FBatchComboWork& Combo);
+
+	/** Destroy every pooled character actor (level change / end of batch). */
+	void DestroyCharacterPool(UWorld* World);
+
 	/**
 	 * Create a temporary reference level sequence whose duration equals the
 	 * animation's play length and that binds the character + animation track.
-	 * The sequence is stored at /Game/CDGBatch_Temp/<ComboKey>_RefSeq.
+	 * Named CDGBatchRefSeq_<ComboKey>; in memory only unless the combo keeps
+	 * its sequences, in which case it is saved under /Game/CDGBatch_Temp/.
 	 */
 	ULevelSequence* CreateReferenceSequence(UWorld* World,
 	                                        AActor* Character,
 	                                        class UAnimationAsset* Anim,
-	                                        const FString& ComboKey,
-	                                        int32 FPS);
+	                                        const FBatchComboWork& Combo);
 
 	/** Instantiate generators from GeneratorStackConfig with World as outer. */
 	void InstantiateGenerators(UWorld* World,
@@ -204,49 +546,51 @@ private:
 	                           AActor* Character);
 
 	/** Run all generator instances, return created ACDGTrajectory actors. */
-	TArray<ACDGTrajectory*> RunGenerators(UWorld* World);
+	TArray<ACDGTrajectory*> RunGenerators(UWorld* World, const FString& ComboKey);
 
 	/**
-	 * Export the current trajectory actors to a master+shot level sequence.
-	 * RefSeq is used as the base shot (its non-camera tracks are copied into
-	 * each shot so the character animation is present during rendering).
-	 * Returns the master sequence, or nullptr on failure.
-	 * Populates CreatedShotSequencePaths with all created shot package names.
+	 * Export the combo's trajectory actors to its own master+shot level
+	 * sequences (transient, or under /Game/CDGBatch_Temp/ when kept).  Every
+	 * shot plays the reference sequence as one shared subsequence
+	 * (FCDGSequenceBuilder::AddSharedSubSequence) so the character animates
+	 * during rendering without a copy of its tracks per shot.  Fills
+	 * Combo.MasterSequence, Cameras and ShotSequencePaths; returns the master,
+	 * or nullptr on failure.
 	 */
 	ULevelSequence* ExportTrajectoriesAsLevelSequence(UWorld* World,
-	                                                  ULevelSequence* RefSeq,
-	                                                  const TArray<ACDGTrajectory*>& Trajectories,
-	                                                  int32 FPS);
+	                                                  FBatchComboWork& Combo,
+	                                                  const TArray<ACDGTrajectory*>& Trajectories);
 
 	/**
-	 * Write <ComboKey>.json at ComboOutputDir (same level as OUTPUTS/).
-	 * Uses TrajectorySL to serialise all trajectories in the world.
+	 * Write <ComboKey>.json in the combo's output dir (same level as OUTPUTS/).
+	 * Uses TrajectorySL to serialise the combo's trajectories.
 	 */
-	void WriteComboIndexJson(const FString& ComboOutputDir,
-	                         const FString& ComboKey,
-	                         int32 FPS);
-
-	/** Delete all ACDGTrajectory+ACDGKeyframe actors and the master+shot sequences. */
-	void CleanupComboAssets(UWorld* World);
-
-	/** Destroy the spawned character actor. */
-	void DestroySpawnedCharacter(UWorld* World);
+	void WriteComboIndexJson(const FBatchComboWork& Combo);
 
 	/** Destroy all transient generator instances. */
 	void DestroyGenerators();
 
-	/** Delete the reference sequence asset. */
-	void DeleteReferenceSequence();
-
-	/** Advance (Anim → Char → Anchor) indices; returns false if level is exhausted. */
+	/**
+	 * Advance (Anchor → Anim → Char) indices, or to the next sampled combo;
+	 * returns false if level is exhausted.
+	 */
 	bool AdvanceComboIndices();
 
-	// ── Helpers ──────────────────────────────────────────────────────────────
+	// ── Prefetch ─────────────────────────────────────────────────────────────
+
+	/** Move the level open in the editor to the front of Input.Levels. */
+	void PutLoadedLevelFirst();
 
-	FString MakeComboKey(const FString& LevelShortName,
-	                     const FString& AnchorName,
-	                     const FString& CharShortName,
-	                     const FString& AnimShortName) const;
+	/** Async-load the hard dependencies of the level after the current one. */
+	void PrefetchNextLevel();
+
+	/**
+	 * Keep the current (character, animation) pair resident and async-load the
+	 * pair that follows once the anchors are exhausted.
+	 */
+	void PrefetchUpcomingAssets();
+
+	// ── Helpers ──────────────────────────────────────────────────────────────
 
 	/** Vertical line-trace to find ground below Centre+offset, within Radius. */
 	FVector FindGroundPosition(UWorld* World,
@@ -259,7 +603,22 @@ private:
 
 	int32 ComputeTotalCombos() const;
 
+	/** ExporterConfig.OutputDirectory, or Saved/BatchProcOutput when unset. */
+	FString GetRootOutputDir() const;
+
+	/**
+	 * Rewrite the heartbeat when Stage / Subject change, or when the last write
+	 * is HeartbeatInterval old.
+	 */
+	void Beat(const TCHAR* Stage, const FString& Subject);
+
+	/** Beat with the render slot's state: the on-screen combo, or idle. */
+	void BeatRenderState();
+
+	/** Deterministic per-combo seed: pinned, else derived from the key and Input.BaseSeed. */
+	int32 MakeComboSeed(const FString& ComboKey) const;
+
 	void BroadcastLog(const FString& Msg);
-	void BroadcastDetailedProgress(int32 ShotCurrent, int32 ShotTotal);
+	void BroadcastDetailedProgress(const FBatchComboWork& Combo, int32 ShotCurrent, int32 ShotTotal);
 	void Finish(bool bSuccess);
 };
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
 #include "UI/BatchProcEditor/CDGBatchProcExecService.h"  // FBatchDetailedProgress
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -15,8 +16,15 @@
 // │  [Level 1/2] – [Anchor 1/3] – [Char 1/1] – [Anim 2/4]  [Cancel]│
 // │  ────────────────────────────────────────────  Shot 0/6 — 37%   │
 // │  [█████████████████░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░░] │
-// │  Rendering Batch01_Anchor0_BP_Char_Walk …                        │
+// │  ┌ log (virtualised list, newest at the bottom) ───────────────┐ │
+// │  │ Combo [3/24]: Batch01_Anchor0_BP_Char_Walk — preparing      │ │
+// │  └─────────────────────────────────────────────────────────────┘ │
 // └──────────────────────────────────────────────────────────────────┘
+//
+// The window polls the service at PollRate instead of reacting to every
+// broadcast: progress is a snapshot, log lines are read from the service's
+// FCDGBatchLogBuffer ring.  The list keeps at most MaxLogRows rows, so the
+// cost per refresh stays flat however long the batch runs.
 // ─────────────────────────────────────────────────────────────────────────────
 class SBatchProgressWindow : public SCompoundWidget
 {
@@ -26,19 +34,19 @@ public:
 	{}
 		/** Called when the user presses Cancel (or the window is closed). */
 		SLATE_EVENT(FSimpleDelegate, OnCancelRequested)
+		/** Batch to poll for progress and log lines. */
+		SLATE_ARGUMENT(TWeakObjectPtr<UCDGBatchProcExecService>, Service)
 	SLATE_END_ARGS()
 
+	/** UI refreshes per second. */
+	static constexpr float PollRate   = 10.f;
+	static constexpr int32 MaxLogRows = FCDGBatchLogBuffer::Capacity;
+
 	void Construct(const FArguments& InArgs);
 
 	// ── State update API ────────────────────────────────────────────────────
 
-	/** Full per-dimension update — call from OnDetailedProgressUpdated. */
-	void UpdateDetailedProgress(const FBatchDetailedProgress& InProgress);
-
-	/** Overall combo counter only (used as fallback / initial update). */
-	void UpdateProgress(int32 Completed, int32 Total);
-
-	/** Append a log message; the window shows only the last line. */
+	/** Append a line of the window's own to the log list. */
 	void AddLog(const FString& Msg);
 
 	/** Switch the Cancel button to "Close" and freeze the bar at 100 %. */
@@ -50,9 +58,20 @@ public:
 	void CloseWindow();
 
 private:
+	/** Active-timer callback: pull progress and new log lines from the service. */
+	EActiveTimerReturnType Poll(double InCurrentTime, float InDeltaTime);
+
+	void AppendLogRows(TArray<FString>&& Lines);
+
+	TSharedRef<ITableRow> MakeLogRow(TSharedPtr<FString> Line, const TSharedRef<STableViewBase>& Owner);
+
 	FBatchDetailedProgress Detail;
 	bool            bDone = false;
-	TArray<FString> Log;
+
+	TWeakObjectPtr<UCDGBatchProcExecService>   Service;
+	uint64                                     NextLogSeq = 0;
+	TArray<TSharedPtr<FString>>                LogRows;
+	TSharedPtr<SListView<TSharedPtr<FString>>> LogListView;
 
 	FSimpleDelegate OnCancelRequested;
 	TWeakPtr<SWindow> OwningSWindow;
@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchSaveQueue  —  background file writes for kept batch sequences
+//
+// With bKeepExportedLevelSequence every combo saves its reference, shot and
+// master sequences.  Save() serializes the package on the game thread (the
+// engine requires it) but hands the file write to the engine's async writer
+// (SAVE_Async), so the pipeline carries on preparing and rendering while the
+// bytes go to disk.
+//
+// Bounded: once MaxPending writes are outstanding the next Save() waits for
+// them first, which caps the serialized packages held in memory.
+//
+// Every Save() takes a ticket.  A combo remembers the last ticket of its own
+// saves and is recorded as finished once IsWritten(Ticket) holds; FenceAsync()
+// waits for the engine's writes on a worker thread, so a combo never waits on
+// the saves of the combos prepared after it.  Flush() is the blocking
+// barrier, for the end of the batch and cancellation.
+// ─────────────────────────────────────────────────────────────────────────────
+
+class CAMERADATASETGENEDITOR_API FCDGBatchSaveQueue
+{
+public:
+	static constexpr int32 DefaultMaxPending = 32;
+
+	/** Reset counters.  MaxPending <= 0 picks DefaultMaxPending. */
+	void Begin(TFunction<void(const FString&)> InLog, int32 InMaxPending = DefaultMaxPending);
+
+	/** Serialize Asset's package and queue its file write.  False when the save failed. */
+	bool Save(UObject* Asset);
+
+	/** Block until every queued write is on disk. */
+	void Flush();
+
+	/** Ticket of the most recent Save(); 0 before the first. */
+	int64 GetLastTicket() const { return LastTicket; }
+
+	/** True once every write up to and including Ticket is on disk. */
+	bool IsWritten(int64 Ticket) const { return Ticket <= Fence->WrittenTicket.load(); }
+
+	/**
+	 * Wait for the writes queued so far on a worker thread; IsWritten() turns
+	 * true for their tickets when it is done.  No-op while one is running.
+	 */
+	void FenceAsync();
+
+	int32 GetNumPending() const { return static_cast<int32>(LastTicket - Fence->WrittenTicket.load()); }
+
+	/** "<n> package(s), <MB> MB: <s> s serializing, <s> s waiting on writes (<k> failed)" */
+	FString Summary() const;
+
+private:
+	void Emit(const FString& Message) const;
+
+	TFunction<void(const FString&)> Log;
+
+	struct FFenceState
+	{
+		std::atomic<int64> WrittenTicket { 0 };
+		std::atomic<bool>  bRunning { false };
+	};
+	/** Shared with a running fence task, which may outlive the queue. */
+	TSharedRef<FFenceState, ESPMode::ThreadSafe> Fence = MakeShared<FFenceState, ESPMode::ThreadSafe>();
+
+	int32  MaxPending       = DefaultMaxPending;
+	int64  LastTicket       = 0;
+	int32  NumSaved         = 0;
+	int32  NumFailed        = 0;
+	int64  BytesSaved       = 0;
+	double SerializeSeconds = 0.0;
+	double WaitSeconds      = 0.0;
+};
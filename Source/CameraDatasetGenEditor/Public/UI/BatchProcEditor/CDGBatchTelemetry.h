@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchTelemetry  —  per-stage timings of a batch run
+//
+// Every timed step of the batch loop is appended as one row to
+//   <OutputDir>/CDGBatchTiming_<yyyymmdd_hhmmss>.csv
+//     ComboKey,Stage,Detail,Seconds,StartUtc
+// (level-wide stages leave ComboKey empty; generator runs put the generator
+// name in Detail).  Synchronous stages are also emitted as Unreal Insights
+// CPU scopes named "CDGBatch.<Stage>"; the asynchronous render stage gets a
+// trace bookmark at each end instead, since it spans many frames.
+//
+// Summary() returns count / total / mean / p50 / p90 / p99 / max per stage.
+// ─────────────────────────────────────────────────────────────────────────────
+
+enum class ECDGBatchStage : uint8
+{
+	LevelLoad,
+	AnchorDiscovery,
+	CharacterSpawn,
+	RefSequence,
+	GeneratorInstantiate,
+	GeneratorRun,
+	SequenceExport,
+	RenderSetup,
+	Render,
+	IndexWrite,
+	Cleanup,
+
+	Num
+};
+
+class CAMERADATASETGENEDITOR_API FCDGBatchTelemetry
+{
+public:
+	static const TCHAR* StageName(ECDGBatchStage Stage);
+
+	/** Start a new run; rows go to a fresh timestamped CSV in OutputDir. */
+	void Begin(const FString& OutputDir);
+
+	/** Add one sample.  Buffered until Flush(). */
+	void Record(const FString& ComboKey, ECDGBatchStage Stage, double StartSeconds, double Seconds,
+	            const FString& Detail = FString());
+
+	/** Append the buffered rows to the CSV. */
+	void Flush();
+
+	/** Human-readable per-stage table with percentiles, one line per stage. */
+	TArray<FString> Summary() const;
+
+	const FString& GetCsvPath() const { return CsvPath; }
+
+private:
+	FString       CsvPath;
+	FString       PendingRows;
+	/** Wall-clock origin so StartSeconds (FPlatformTime) can be written as UTC. */
+	FDateTime     UtcAtBegin;
+	double        SecondsAtBegin = 0.0;
+	TArray<double> Samples[static_cast<int32>(ECDGBatchStage::Num)];
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// FCDGBatchStageScope  —  times one synchronous stage (RAII)
+// ─────────────────────────────────────────────────────────────────────────────
+
+class CAMERADATASETGENEDITOR_API FCDGBatchStageScope
+{
+public:
+	FCDGBatchStageScope(FCDGBatchTelemetry& InTelemetry, const FString& InComboKey, ECDGBatchStage InStage,
+	                    const FString& InDetail = FString());
+	~FCDGBatchStageScope();
+
+	FCDGBatchStageScope(const FCDGBatchStageScope&) = delete;
+	FCDGBatchStageScope& operator=(const FCDGBatchStageScope&) = delete;
+
+private:
+	FCDGBatchTelemetry& Telemetry;
+	FString             ComboKey;
+	FString             Detail;
+	ECDGBatchStage      Stage;
+	double              StartSeconds;
+	bool                bTraceEvent = false;
+};
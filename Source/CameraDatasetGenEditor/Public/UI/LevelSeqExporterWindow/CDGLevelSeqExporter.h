@@ -65,6 +65,9 @@ private:
     void CopyBaseShotNonCameraTracks(UMovieScene* TargetShotMovieScene) const;
     static bool IsCameraBinding(UMovieScene* MovieScene, const FGuid& BindingGuid, const FString& BindingName);
 
+    /** Get-or-create PackageName holding the base shot's non-camera tracks, shared by every exported shot */
+    ULevelSequence* CreateBaseShotContentSequence(const FString& PackageName) const;
+
     // ----- Render / output format -----
     TSharedRef<SWidget> MakeOutputFormatWidget(TSharedPtr<ECDGRenderOutputFormat> InItem);
     FText GetOutputFormatText() const;